@@ -0,0 +1,192 @@
+#!/usr/bin/python
+
+# Reports where the RAM goes, from the linker map file (Debug/EQUiSatOS.map):
+# .data / .bss per module (object file), per group of things we tune (task
+# stacks, equistacks, message buffer, RS tables, trace buffers, mutex profiling
+# tables, ...), and the largest symbols, against the size of RAM.
+#
+#   python ram_report.py [map file] [number of symbols to list]
+#
+# Symbols come from the input section names (we build with -fdata-sections, so
+# each variable has its own, statics included) or, for common symbols, from
+# the addresses listed under them. The free stack each task has actually
+# needed is reported by the satellite (see sample_stack_min_free).
+
+import re
+import sys
+
+MAP_LOCATION = sys.argv[1] if len(sys.argv) > 1 else "./Debug/EQUiSatOS.map"
+NUM_SYMBOLS = int(sys.argv[2]) if len(sys.argv) > 2 else 25
+RAM_REGION = "ram"
+
+# group name, then a regex on the symbol and one on the module (either matching)
+GROUPS = [
+    ("task stacks",     r"_task_stack$|^uxIdleTaskStack$|^uxTimerTaskStack$", None),
+    ("task TCBs",       r"_task_buffer$|_task_tcb$", None),
+    ("equistacks",      r"_equistack_arr$|_equistack$", None),
+    ("mutexes",         r"_mutex(_d)?$", None),
+    ("message buffer",  r"^msg_buffer$", None),
+    ("RS tables",       None, r"rscode"),
+    # (function statics like trace_ring get a numeric suffix: trace_ring.1234)
+    ("trace buffers",   r"^trace_ring(\.\d+)?$", r"TraceRecorder"),
+    ("mutex profiling", None, r"mutex_profiling\.o"),
+    ("FreeRTOS kernel", None, r"freertos"),
+    ("ASF drivers",     None, r"/ASF/"),
+    ("C library",       None, r"\.a\(|libc|libgcc"),
+    ("system stack",    r"^\(\.stack\)$", None),
+]
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+))?")
+INPUT_SECTION = re.compile(r"^ (\.\S+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*))?$")
+WRAPPED_INPUT = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+SYMBOL = re.compile(r"^\s+0x([0-9a-f]+)\s+([A-Za-z_][\w.$]*)$")
+MEMORY_REGION = re.compile(r"^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)")
+
+
+def module_name(path):
+    # (archive members are listed as lib.a(member.o))
+    path = path.replace("\\", "/")
+    return re.sub(r"^(\.\./)+", "", path)
+
+
+def parse_map(lines):
+    ram_start, ram_size = None, None
+    out_sections = []   # [name, addr, size]
+    in_sections = []    # [kind, name, addr, size, module, [(addr, symbol)]]
+    in_memory_config = False
+    pending_out, pending_in = None, None
+
+    for line in lines:
+        line = line.rstrip("\r\n")
+        if line.startswith("Memory Configuration"):
+            in_memory_config = True
+            continue
+        if line.startswith("Linker script and memory map"):
+            in_memory_config = False
+            continue
+        if in_memory_config:
+            m = MEMORY_REGION.match(line)
+            if m and m.group(1) == RAM_REGION:
+                ram_start, ram_size = int(m.group(2), 16), int(m.group(3), 16)
+            continue
+
+        # (section names too long for their column wrap onto the next line)
+        if pending_out is not None:
+            m = re.match(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)", line)
+            if m:
+                out_sections.append([pending_out, int(m.group(1), 16), int(m.group(2), 16)])
+            pending_out = None
+            continue
+        if pending_in is not None:
+            m = WRAPPED_INPUT.match(line)
+            if m:
+                in_sections.append([pending_in, pending_in, int(m.group(1), 16),
+                                    int(m.group(2), 16), module_name(m.group(3)), []])
+            pending_in = None
+            continue
+
+        m = OUTPUT_SECTION.match(line)
+        if m:
+            if m.group(2) is None:
+                pending_out = m.group(1)
+            else:
+                out_sections.append([m.group(1), int(m.group(2), 16), int(m.group(3), 16)])
+            continue
+        m = INPUT_SECTION.match(line)
+        if m:
+            if m.group(2) is None:
+                pending_in = m.group(1)
+            else:
+                in_sections.append([m.group(1), m.group(1), int(m.group(2), 16),
+                                    int(m.group(3), 16), module_name(m.group(4)), []])
+            continue
+        m = SYMBOL.match(line)
+        if m and in_sections:
+            in_sections[-1][5].append((int(m.group(1), 16), m.group(2)))
+
+    assert ram_start is not None, "no '%s' memory region in the map file" % RAM_REGION
+    return ram_start, ram_size, out_sections, in_sections
+
+
+def section_kind(name):
+    if name == "COMMON" or name.startswith(".bss"):
+        return ".bss"
+    return ".data"
+
+
+def section_symbols(section):
+    # [(symbol, size)] making up an input section
+    name, addr, size, symbols = section[1], section[2], section[3], section[5]
+    if size == 0:
+        return []
+    if name != "COMMON":
+        # .bss.foo / .data.foo is foo (which the symbol list misses if it's static)
+        m = re.match(r"^\.(?:bss|data|ramfunc)\.(.+)$", name)
+        return [(m.group(1) if m else "(%s)" % name, size)]
+    result = []
+    symbols = sorted(s for s in symbols if addr <= s[0] < addr + size)
+    for i, (sym_addr, sym) in enumerate(symbols):
+        end = symbols[i + 1][0] if i + 1 < len(symbols) else addr + size
+        result.append((sym, end - sym_addr))
+    return result
+
+
+def group_of(symbol, module):
+    for group, sym_re, mod_re in GROUPS:
+        if sym_re is not None and re.search(sym_re, symbol):
+            return group
+        if mod_re is not None and re.search(mod_re, module):
+            return group
+    return "(other)"
+
+
+def main():
+    with open(MAP_LOCATION, "r") as f:
+        ram_start, ram_size, out_sections, in_sections = parse_map(f)
+
+    def in_ram(addr):
+        return ram_start <= addr < ram_start + ram_size
+
+    modules = {}    # module: [data, bss]
+    groups = {}
+    symbols = []    # (size, symbol, module, kind)
+    for section in in_sections:
+        if not in_ram(section[2]) or section[3] == 0:
+            continue
+        kind, module = section_kind(section[1]), section[4]
+        modules.setdefault(module, [0, 0])[0 if kind == ".data" else 1] += section[3]
+        for sym, size in section_symbols(section):
+            symbols.append((size, sym, module, kind))
+            group = group_of(sym, module)
+            groups[group] = groups.get(group, 0) + size
+
+    # whatever of the RAM output sections isn't input sections (the system stack, alignment)
+    used = 0
+    for name, addr, size in out_sections:
+        if not in_ram(addr) or size == 0:
+            continue
+        used += size
+        inputs = sum(s[3] for s in in_sections if addr <= s[2] < addr + size)
+        if size > inputs:
+            sym = "(%s)" % name
+            symbols.append((size - inputs, sym, "(linker)", name))
+            group = group_of(sym, "(linker)")
+            groups[group] = groups.get(group, 0) + size - inputs
+
+    print("RAM: %d / %d bytes used (%d free)" % (used, ram_size, ram_size - used))
+
+    print("\n%-56s %8s %8s %8s" % ("module", ".data", ".bss", "total"))
+    for module, (data, bss) in sorted(modules.items(), key=lambda m: -sum(m[1])):
+        print("%-56s %8d %8d %8d" % (module[-56:], data, bss, data + bss))
+
+    print("\n%-24s %8s %6s" % ("group", "bytes", "RAM"))
+    for group, size in sorted(groups.items(), key=lambda g: -g[1]):
+        print("%-24s %8d %5.1f%%" % (group, size, 100.0 * size / ram_size))
+
+    print("\n%-40s %8s %-6s %s" % ("largest symbols", "bytes", "", "module"))
+    for size, sym, module, kind in sorted(symbols, reverse=True)[:NUM_SYMBOLS]:
+        print("%-40s %8d %-6s %s" % (sym[:40], size, kind, module))
+
+
+if __name__ == "__main__":
+    main()
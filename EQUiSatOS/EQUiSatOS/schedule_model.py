@@ -0,0 +1,454 @@
+#!/usr/bin/python
+
+# Task phasing: how the periodic tasks' start offsets (rtos_tasks_offsets.h)
+# line up their holds on the shared mutexes (the I2C bus / IR power, the
+# processor ADC, the hardware state, the MRAM and the critical action mutex).
+# For each satellite state, simulates a day of the tasks running in that state
+# on their periods, priorities and offsets (with priority inheritance, and
+# freed mutexes going to the highest priority waiter), and reports how often a
+# take found the mutex held (collisions), the longest and total waits, and
+# each task's worst response time (from when it was due to the end of its run).
+#
+#   python schedule_model.py [--usage FILE] [--optimize] [--check] [src directory]
+#
+#   --usage FILE  what each task holds per run (replaces the USAGE estimates
+#                 below for the tasks in it); one step per line:
+#                     TASK_NAME  mutex[,mutex...] or -  ms  cpu|io|rx
+#                 steps run in order; a step holds its mutexes throughout (and
+#                 takes them in order); cpu steps need the processor, io steps
+#                 don't (I2C / SPI transfers, delays) and rx steps wait for
+#                 uplinks until ms before the task's next run
+#   --optimize    searches for offsets that keep the holds apart and (if they
+#                 pass the checks) writes them to rtos_tasks_offsets.h
+#   --check       exits with an error if a response time or mutex wait is
+#                 over its bound (RESPONSE_BOUNDS, LOCK_TIMEOUTS below)
+#
+# The search minimizes how much the tasks' hold windows overlap (padded by
+# GUARD_MS for jitter) over a day, which only depends on the offsets mod the
+# gcd of each pair's periods, so it's quick; the simulation then checks the
+# result. The USAGE holds are estimates; telem_locks (in the telemetry decoder)
+# reports the longest hold seen on each mutex in flight and telem_runtime the
+# processor time per task, to measure them by.
+
+import argparse
+import os
+import re
+import sys
+
+from tickless_model import STATES, read_defines, value, read_tasks, task_states, period_ms
+
+CPU, IO, RX = "cpu", "io", "rx"
+DAY_MS = 24 * 60 * 60 * 1000
+
+# per task, the steps of a run: (mutexes held, ms, kind)
+USAGE = {
+    "WATCHDOG_TASK":                [((), 1, CPU)],
+    # (reading the battery charging signals)
+    "STATE_HANDLING_TASK":          [(("i2c_irpow",), 15, IO), ((), 5, CPU)],
+    "ANTENNA_DEPLOY_TASK":          [((), 2, CPU)],
+    "BATTERY_CHARGING_TASK":        [(("i2c_irpow",), 15, IO), (("processor_adc",), 40, IO),
+                                     ((), 20, CPU), (("hardware_state",), 5, CPU)],
+    # (power the radio, plan and write the first packet, transmit, note it in the
+    # downlink ledger, take uplinks, power the radio down)
+    "TRANSMIT_TASK":                [(("hardware_state",), 5, CPU), ((), 20, CPU),
+                                     (("critical_action",), 2500, IO), (("mram_spi_cache",), 10, IO),
+                                     ((), 1000, RX), (("hardware_state",), 5, CPU)],
+    # (three flashes, reading through each)
+    "FLASH_ACTIVATE_TASK":          [((), 5, CPU)] + 3 * [
+                                     (("critical_action",), 10, CPU),
+                                     (("critical_action", "i2c_irpow", "processor_adc"), 200, IO),
+                                     (("critical_action",), 1000, IO)] + [((), 5, CPU)],
+    # (IR power coming on, then the reads)
+    "IDLE_DATA_TASK":               [(("i2c_irpow",), 400, IO), (("i2c_irpow", "processor_adc"), 30, IO),
+                                     ((), 5, CPU)],
+    "LOW_POWER_DATA_TASK":          [(("i2c_irpow",), 400, IO), (("i2c_irpow", "processor_adc"), 30, IO),
+                                     ((), 5, CPU)],
+    "ATTITUDE_DATA_TASK":           [(("i2c_irpow", "processor_adc"), 150, IO), ((), 500, IO),
+                                     (("i2c_irpow",), 150, IO), ((), 10, CPU)],
+    "PERSISTENT_DATA_BACKUP_TASK":  [((), 5, CPU), (("mram_spi_cache",), 60, IO)],
+}
+
+PRIORITIES = {
+    "WATCHDOG_TASK":                "TASK_WATCHDOG_PRIORITY",
+    "STATE_HANDLING_TASK":          "TASK_STATE_HANDLING_PRIORITY",
+    "ANTENNA_DEPLOY_TASK":          "TASK_ANTENNA_DEPLOY_PRIORITY",
+    "BATTERY_CHARGING_TASK":        "TASK_BATTERY_CHARGING_PRIORITY",
+    "TRANSMIT_TASK":                "TASK_TRANSMIT_PRIORITY",
+    "FLASH_ACTIVATE_TASK":          "TASK_FLASH_ACTIVATE_PRIORITY",
+    "IDLE_DATA_TASK":               "TASK_IDLE_DATA_RD_PRIORITY",
+    "LOW_POWER_DATA_TASK":          "TASK_LOW_POWER_DATA_RD_PRIORITY",
+    "ATTITUDE_DATA_TASK":           "TASK_ATTITUDE_DATA_DATA_RD_PRIORITY",
+    "PERSISTENT_DATA_BACKUP_TASK":  "TASK_PERSISTENT_DATA_BACKUP_PRIORITY",
+}
+
+# a run must finish within this of being due (by default, its period)
+RESPONSE_BOUNDS = {
+    "IDLE_DATA_TASK":               "IDLE_DATA_MAX_READ_TIME",
+    "LOW_POWER_DATA_TASK":          "LOW_POWER_DATA_MAX_READ_TIME",
+    "ATTITUDE_DATA_TASK":           "ATTITUDE_DATA_MAX_READ_TIME",
+}
+# and a take must get its mutex before timing out
+LOCK_TIMEOUTS = {
+    "critical_action":  "CRITICAL_MUTEX_WAIT_TIME_TICKS",
+    "i2c_irpow":        "HARDWARE_MUTEX_WAIT_TIME_TICKS",
+    "processor_adc":    "HARDWARE_MUTEX_WAIT_TIME_TICKS",
+    "hardware_state":   "HARDWARE_STATE_MUTEX_WAIT_TIME_TICKS",
+    "mram_spi_cache":   "MRAM_SPI_MUTEX_WAIT_TIME_TICKS",
+}
+
+# offsets the search leaves alone (the watchdog's has to be small)
+FIXED = ["WATCHDOG_TASK", "ANTENNA_DEPLOY_TASK"]
+OFFSET_MIN_MS = 100
+OFFSET_MAX_MS = 60000
+OFFSET_STEP_MS = 100
+GUARD_MS = 250
+
+OFFSETS_HEADER = os.path.join("rtos_tasks", "rtos_tasks_offsets.h")
+# carried over into the generated header
+NOTES = {
+    "WATCHDOG_TASK":                "high-freq; should be small",
+    "ANTENNA_DEPLOY_TASK":          "high-freq",
+}
+
+
+def read_usage(path):
+    usage = {}
+    with open(path) as f:
+        for line in f:
+            line = line.split("#")[0].split()
+            if not line:
+                continue
+            task, locks, ms, kind = line
+            if kind not in (CPU, IO, RX):
+                raise ValueError("%s: unknown step kind %s" % (task, kind))
+            locks = () if locks == "-" else tuple(locks.split(","))
+            usage.setdefault(task, []).append((locks, int(ms), kind))
+    return usage
+
+
+def read_priorities(path):
+    # the priority classes are an enum
+    with open(path) as f:
+        text = re.sub(r"//.*", "", f.read())
+    enum = re.search(r"enum\s*{([^}]*DATA_READ_PRIORITY[^}]*)}", text).group(1)
+    classes, n = {}, 0
+    for name in enum.split(","):
+        name = name.strip()
+        if not name:
+            continue
+        if "=" in name:
+            name, n = name.split("=")[0].strip(), int(name.split("=")[1])
+        classes[name] = n
+        n += 1
+    return classes
+
+
+class Model:
+    def __init__(self, src, usage):
+        config = os.path.join(src, "rtos_tasks", "rtos_tasks_config.h")
+        self.src = src
+        self.defines = read_defines(
+            config,
+            os.path.join(src, OFFSETS_HEADER),
+            os.path.join(src, "runnable_configurations", "satellite_state_control.h"),
+            os.path.join(src, "sensor_drivers", "sensor_read_commands.h"),
+            os.path.join(src, "data_handling", "persistent_storage.h"))
+        self.defines.setdefault("portTICK_PERIOD_MS", "1")
+        for name, n in read_priorities(config).items():
+            self.defines.setdefault(name, str(n))
+        self.tasks = read_tasks(config)
+        self.usage = dict(USAGE, **usage)
+        self.priority = dict((t, value(self.defines, PRIORITIES[t])) for t in self.tasks)
+        self.offsets = dict((t, value(self.defines, t + "_FREQ_OFFSET")) for t in self.tasks)
+        self.states = []
+        for state, states_name in STATES:
+            running = [t for t, on in zip(self.tasks, task_states(self.defines, states_name)) if on]
+            periods = dict((t, period_ms(self.defines, t, state)) for t in running)
+            self.states.append((state, running, periods))
+
+    def bound(self, task, periods):
+        if task in RESPONSE_BOUNDS:
+            return value(self.defines, RESPONSE_BOUNDS[task])
+        return periods[task]
+
+    def step_ms(self, step, period, elapsed):
+        locks, ms, kind = step
+        return max(0, period - ms - elapsed) if kind == RX else ms
+
+    def windows(self, task, period):
+        # (mutex, start, end) for each stretch of a run holding a mutex, uncontended
+        held, windows, t = {}, [], 0
+        for step in self.usage[task] + [((), 0, IO)]:
+            for lock in list(held):
+                if lock not in step[0]:
+                    windows.append((lock, held.pop(lock), t))
+            for lock in step[0]:
+                held.setdefault(lock, t)
+            t += self.step_ms(step, period, t)
+        return windows
+
+
+def gcd(a, b):
+    while b:
+        a, b = b, a % b
+    return a
+
+
+def circular_overlap(circle, a_start, a_len, b_start, b_len):
+    # overlap of [a_start, a_start + a_len) with [b_start, b_start + b_len) repeating every circle
+    a_start %= circle
+    b_start %= circle
+    total = 0
+    n = (a_start - b_start - b_len) // circle
+    while b_start + n * circle < a_start + a_len:
+        lo = max(a_start, b_start + n * circle)
+        hi = min(a_start + a_len, b_start + n * circle + b_len)
+        total += max(0, hi - lo)
+        n += 1
+    return total
+
+
+def pair_cost(model, a, b, offsets, periods, windows):
+    # ms a day the two tasks' (padded) holds on the same mutexes overlap; the
+    # runs only line up differently every gcd of the periods
+    pa, pb = periods[a], periods[b]
+    g = gcd(pa, pb)
+    lcm = pa // g * pb
+    cost = 0
+    for lock, a_s, a_e in windows[a]:
+        for lock_b, b_s, b_e in windows[b]:
+            if lock != lock_b:
+                continue
+            cost += circular_overlap(g, offsets[a] + a_s - GUARD_MS, a_e - a_s + 2 * GUARD_MS,
+                                     offsets[b] + b_s - GUARD_MS, b_e - b_s + 2 * GUARD_MS)
+    return cost * DAY_MS // lcm
+
+
+def task_cost(model, task, offsets, state_windows):
+    cost = 0
+    for (state, running, periods), windows in zip(model.states, state_windows):
+        if task not in running:
+            continue
+        for other in running:
+            if other != task:
+                cost += pair_cost(model, task, other, offsets, periods, windows)
+    return cost
+
+
+def total_cost(model, offsets, state_windows):
+    return sum(task_cost(model, t, offsets, state_windows) for t in model.tasks) // 2
+
+
+def optimize(model):
+    state_windows = [dict((t, model.windows(t, periods[t])) for t in running)
+                     for state, running, periods in model.states]
+    offsets = dict(model.offsets)
+    movable = [t for t in model.tasks if t not in FIXED]
+    improved = True
+    while improved:
+        improved = False
+        for task in movable:
+            period = min(p[task] for s, r, p in model.states if task in r)
+            best = task_cost(model, task, offsets, state_windows)
+            for offset in range(OFFSET_MIN_MS, min(period, OFFSET_MAX_MS + 1), OFFSET_STEP_MS):
+                trial = dict(offsets)
+                trial[task] = offset
+                cost = task_cost(model, task, trial, state_windows)
+                if cost < best:
+                    best, offsets[task], improved = cost, offset, True
+    # (leaving the offsets that moving didn't help where they were)
+    for task in movable:
+        trial = dict(offsets)
+        trial[task] = model.offsets[task]
+        if task_cost(model, task, trial, state_windows) <= task_cost(model, task, offsets, state_windows):
+            offsets = trial
+    return offsets, total_cost(model, model.offsets, state_windows), total_cost(model, offsets, state_windows)
+
+
+class Job:
+    def __init__(self, task, release):
+        self.task = task
+        self.release = release
+        self.step = -1
+        self.left = 0
+        self.needs = []
+        self.held = []
+        self.waiting_since = None
+
+
+def simulate(model, running, periods, offsets, duration_ms=DAY_MS):
+    next_release = dict((t, offsets[t]) for t in running)
+    jobs = {}
+    owner = {}
+    stats = {
+        "collisions": {}, "max_wait": {}, "total_wait": {},
+        "response": dict((t, 0) for t in running), "runs": dict((t, 0) for t in running),
+    }
+
+    def start_step(job, t):
+        job.step += 1
+        steps = model.usage[job.task]
+        locks = steps[job.step][0] if job.step < len(steps) else ()
+        for lock in [l for l in job.held if l not in locks]:
+            job.held.remove(lock)
+            del owner[lock]
+        if job.step == len(steps):
+            stats["response"][job.task] = max(stats["response"][job.task], t - job.release)
+            stats["runs"][job.task] += 1
+            del jobs[job.task]
+            return
+        job.needs = [l for l in locks if l not in job.held]
+        job.left = model.step_ms(steps[job.step], periods[job.task], t - job.release)
+
+    def acquire(t):
+        # (FreeRTOS hands a freed mutex to the highest priority task waiting on it)
+        for job in sorted(jobs.values(), key=lambda j: -model.priority[j.task]):
+            while job.needs:
+                lock = job.needs[0]
+                if lock in owner:
+                    if job.waiting_since is None:
+                        job.waiting_since = t
+                        stats["collisions"][lock] = stats["collisions"].get(lock, 0) + 1
+                    break
+                if job.waiting_since is not None:
+                    waited = t - job.waiting_since
+                    stats["max_wait"][lock] = max(stats["max_wait"].get(lock, 0), waited)
+                    stats["total_wait"][lock] = stats["total_wait"].get(lock, 0) + waited
+                    job.waiting_since = None
+                owner[lock] = job.task
+                job.held.append(lock)
+                job.needs.pop(0)
+
+    def on_cpu():
+        # the highest priority ready cpu step, with priority inheritance
+        priority = dict((t, model.priority[t]) for t in jobs)
+        for _ in range(2):
+            for job in jobs.values():
+                if job.needs:
+                    holder = owner[job.needs[0]]
+                    priority[holder] = max(priority[holder], priority[job.task])
+        ready = [j for j in jobs.values()
+                 if not j.needs and model.usage[j.task][j.step][2] == CPU]
+        if not ready:
+            return None
+        return max(ready, key=lambda j: (priority[j.task], -j.release))
+
+    t = 0
+    while t < duration_ms:
+        for task in running:
+            if task not in jobs and next_release[task] <= t:
+                job = jobs[task] = Job(task, next_release[task])
+                next_release[task] += periods[task]
+                start_step(job, t)
+        settled = False
+        while not settled:
+            settled = True
+            acquire(t)
+            for job in list(jobs.values()):
+                if not job.needs and job.left == 0:
+                    start_step(job, t)
+                    settled = False
+        cpu = on_cpu()
+
+        dt = duration_ms - t
+        for task in running:
+            if task not in jobs:
+                dt = min(dt, next_release[task] - t)
+        for job in jobs.values():
+            if not job.needs and (job is cpu or model.usage[job.task][job.step][2] != CPU):
+                dt = min(dt, job.left)
+        for job in jobs.values():
+            if not job.needs and (job is cpu or model.usage[job.task][job.step][2] != CPU):
+                job.left -= dt
+        t += dt
+    return stats
+
+
+def report(model, offsets):
+    ok = True
+    for state, running, periods in model.states:
+        stats = simulate(model, running, periods, offsets)
+        print("\n%s (a day)" % state)
+        print("  %-28s %8s %10s %8s" % ("task", "runs", "worst ms", "bound"))
+        for task in running:
+            bound = model.bound(task, periods)
+            over = stats["response"][task] > bound
+            ok = ok and not over
+            print("  %-28s %8d %10d %8d%s" % (task, stats["runs"][task], stats["response"][task],
+                                             bound, "  OVER" if over else ""))
+        print("  %-28s %8s %10s %8s %10s" % ("mutex", "collide", "worst wait", "timeout", "total ms"))
+        for lock in sorted(LOCK_TIMEOUTS):
+            if lock not in stats["collisions"]:
+                continue
+            timeout = value(model.defines, LOCK_TIMEOUTS[lock])
+            over = stats["max_wait"].get(lock, 0) >= timeout
+            ok = ok and not over
+            print("  %-28s %8d %10d %8d %10d%s" % (lock, stats["collisions"][lock],
+                                                   stats["max_wait"].get(lock, 0), timeout,
+                                                   stats["total_wait"].get(lock, 0),
+                                                   "  OVER" if over else ""))
+    return ok
+
+
+def write_offsets(model, offsets):
+    path = os.path.join(model.src, OFFSETS_HEADER)
+    lines = [
+        "/*",
+        " * rtos_tasks_offsets.h",
+        " *",
+        " * How long after starting each task waits before its first run, so the",
+        " * periodic tasks' holds on the shared mutexes don't line up.",
+        " * Generated by schedule_model.py --optimize; rerun it (rather than editing",
+        " * these) when the task periods or what the tasks hold change.",
+        " */",
+        "",
+        "#ifndef RTOS_TASKS_OFFSETS_H",
+        "#define RTOS_TASKS_OFFSETS_H",
+        "",
+    ]
+    for task in model.tasks:
+        name = task + "_FREQ_OFFSET"
+        line = "#define " + name + "\t" * max(1, (48 - len("#define " + name) + 3) // 4) + str(offsets[task])
+        if task in NOTES:
+            line += " // " + NOTES[task]
+        lines.append(line)
+    lines += ["", "#endif", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+    print("\nwrote %s" % path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="task phasing and mutex contention")
+    parser.add_argument("--usage", help="what each task holds per run (see top of file)")
+    parser.add_argument("--optimize", action="store_true", help="search for offsets and write them")
+    parser.add_argument("--check", action="store_true", help="fail if a bound is broken")
+    parser.add_argument("src", nargs="?", default="./src")
+    args = parser.parse_args()
+
+    model = Model(args.src, read_usage(args.usage) if args.usage else {})
+    offsets = model.offsets
+    if args.optimize:
+        offsets, before, after = optimize(model)
+        print("hold overlap (padded by %d ms) a day, over the states: %d ms -> %d ms"
+              % (GUARD_MS, before, after))
+        print("  %-28s %8s %8s" % ("offset", "now", "new"))
+        for task in model.tasks:
+            print("  %-28s %8d %8d" % (task, model.offsets[task], offsets[task]))
+        if after >= before:
+            print("no better offsets found")
+            offsets = model.offsets
+
+    ok = report(model, offsets)
+    if args.optimize and offsets != model.offsets:
+        if ok:
+            write_offsets(model, offsets)
+        else:
+            print("\nnot writing offsets that break a bound")
+    if args.check and not ok:
+        print("\nresponse time or mutex wait over its bound")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
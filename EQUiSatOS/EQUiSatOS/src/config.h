@@ -69,11 +69,25 @@
 //#define EQUISIM_SIMULATE_DIRECT_STATE_CHANGES // must disable OVERRIDE_STATE_HOLD_INIT!
 //#define EQUISIM_IN_STATE_TIME_MS			(60*1000)
 //#define EQUISIM_WATCHDOG_RESET_TEST
+//#define EQUISIM_SIMULATE_RADIO // virtual radio + ground station on the radio USART; see equisim_radio.h
+
+/** Power **/
+// stop the tick and sleep on the RTC while all tasks are blocked (see tickless_idle.h)
+//#define TICKLESS_IDLE
 
 /** Debug **/
 // whether to include Tracelyzer tracing library
 #define USE_TRACELYZER				0
 
+// without Tracelyzer, whether to keep a ring of the last task switches, blocks and
+// trace_prints, written to MRAM on a watchdog early warning or stack overflow
+// (see trace_ring.h; ~400 bytes of RAM and a couple of us per event)
+//#define TRACE_RING
+
+// whether to time takes and holds of the shared mutexes and downlink the results
+// (see mutex_stats.h; ~1KB of RAM and a few us per take / give)
+//#define MUTEX_PROFILING
+
 // whether to configASSERTs (and other asserts) should hang
 //#define USE_ASSERTIONS
 
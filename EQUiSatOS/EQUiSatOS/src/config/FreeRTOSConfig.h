@@ -15,7 +15,7 @@ void assert_triggered( const char * file, uint32_t line );
 
 #define configUSE_PREEMPTION                    1
 #define configUSE_IDLE_HOOK                     0
-#define configUSE_TICK_HOOK                     0
+#define configUSE_TICK_HOOK                     1
 #define configPRIO_BITS                         2
 #define configCPU_CLOCK_HZ                      ( 8000000 ) // (system_gclk_gen_get_hz(GCLK_GENERATOR_0))
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 ) // so portTICK_PERIOD_MS = 1
@@ -37,8 +37,14 @@ void assert_triggered( const char * file, uint32_t line );
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_COUNTING_SEMAPHORES           1
 #define configUSE_QUEUE_SETS                    0
-#define configUSE_TICKLESS_IDLE					0
-#define configGENERATE_RUN_TIME_STATS           0
+#ifdef TICKLESS_IDLE
+	#define configUSE_TICKLESS_IDLE				2 // our own, on the RTC (the CM0 port has none)
+	#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP	20
+#else
+	#define configUSE_TICKLESS_IDLE				0
+#endif
+#define configGENERATE_RUN_TIME_STATS           0 // (we keep our own; see traceTASK_SWITCHED_IN below)
+#define configUSE_APPLICATION_TASK_TAG			1 // holds each task's run time stats slot
 #define configENABLE_BACKWARD_COMPATIBILITY     0 // for Tracelyzer streaming mode
 
 /* Co-routine definitions. */
@@ -63,6 +69,7 @@ to exclude the API function. */
 #define INCLUDE_xTaskAbortDelay					1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_xSemaphoreGetMutexHolder        1 // (for mutex profiling)
 #define INCLUDE_uxTaskGetStackHighWaterMark     1
 #define INCLUDE_xTaskGetIdleTaskHandle          0
 #define INCLUDE_xTimerGetTimerDaemonTaskHandle  0
@@ -93,6 +100,35 @@ standard names - or at least those used in the unmodified vector table. */
 // To reassure yourself, look at ASF\thirdparty\freertos\freertos-9.0.0\Source\portable\GCC\ARM_CM0\port.c
 // (lines 88-89; note how the interrupt priority is NOT user-configurable but is rather a property of the port)
 
+/* Charges CPU time to each task as it's switched in (see runtime_stats.h);
+Tracelyzer uses the same trace macro, so this is off when it's on */
+#if ( configUSE_TRACE_FACILITY == 0 ) && ( defined (__GNUC__) || defined (__ICCARM__) )
+	void runtime_stats_switched_in( void* tcb, void* tag );
+	#define traceTASK_SWITCHED_IN()		runtime_stats_switched_in( ( void* ) pxCurrentTCB, ( void* ) pxCurrentTCB->pxTaskTag )
+#endif
+
+/* Records the kernel's events to the trace ring (see trace_ring.h; the switches
+come through runtime_stats_switched_in); again, not with Tracelyzer */
+#if ( configUSE_TRACE_FACILITY == 0 ) && defined( TRACE_RING ) && ( defined (__GNUC__) || defined (__ICCARM__) )
+	#include "data_handling/trace_ring.h"
+	void trace_ring_event( uint8_t event, uint32_t arg );
+	void trace_ring_task_event( uint8_t event, void* tcb, void* tag );
+	#define traceTASK_DELAY_UNTIL( xTimeToWake )			trace_ring_event( TRACE_EV_DELAY, ( xTimeToWake ) )
+	#define traceTASK_DELAY()								trace_ring_event( TRACE_EV_DELAY_FOR, xTicksToDelay )
+	#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )		trace_ring_event( TRACE_EV_BLOCK_RECEIVE, ( uint32_t ) ( pxQueue ) )
+	#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )			trace_ring_event( TRACE_EV_BLOCK_SEND, ( uint32_t ) ( pxQueue ) )
+	#define traceTASK_NOTIFY_WAIT_BLOCK()					trace_ring_event( TRACE_EV_NOTIFY_WAIT, 0 )
+	#define traceTASK_NOTIFY_TAKE_BLOCK()					trace_ring_event( TRACE_EV_NOTIFY_WAIT, 0 )
+	#define traceTASK_SUSPEND( pxTask )						trace_ring_task_event( TRACE_EV_SUSPEND, ( void* ) ( pxTask ), ( void* ) ( pxTask )->pxTaskTag )
+	#define traceTASK_RESUME( pxTask )						trace_ring_task_event( TRACE_EV_RESUME, ( void* ) ( pxTask ), ( void* ) ( pxTask )->pxTaskTag )
+#endif
+
+/* Sleeps on the RTC when all tasks are blocked (see tickless_idle.h) */
+#if ( configUSE_TICKLESS_IDLE == 2 ) && ( defined (__GNUC__) || defined (__ICCARM__) )
+	void vApplicationSleep( uint32_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )	vApplicationSleep( xExpectedIdleTime )
+#endif
+
 /* Integrates the Tracealyzer recorder with FreeRTOS */
 #if ( configUSE_TRACE_FACILITY == 1 )
 	#include "trcRecorder.h"
@@ -10,6 +10,8 @@
 
 #include <global.h>
 #include "Sensor_Structs.h"
+#include "runtime_stats.h"
+#include "mutex_stats.h"
 
 
 // for idle data package
@@ -26,7 +28,7 @@ typedef struct idle_data_t
 	ir_ambient_temps_batch ir_amb_temps_data;
 
 	uint32_t timestamp;
-	bool transmitted; // for determining which data to transmit
+	uint32_t reading_id; // for determining which data to transmit (see downlink_ledger.h)
 	
 } idle_data_t;
 
@@ -46,7 +48,7 @@ typedef struct attitude_data_t
 	magnetometer_batch magnetometer_data					[2];
 
 	uint32_t timestamp;
-	bool transmitted;
+	uint32_t reading_id;
 
 } attitude_data_t;
 
@@ -61,7 +63,7 @@ typedef struct flash_data_t
 	gyro_batch gyro_data								[FLASH_DATA_ARR_LEN];
 
 	uint32_t timestamp;
-	bool transmitted;
+	uint32_t reading_id;
 
 } flash_data_t;
 
@@ -77,7 +79,7 @@ typedef struct flash_cmp_data_t
 	magnetometer_batch mag_before_data;
 
 	uint32_t timestamp;
-	bool transmitted;
+	uint32_t reading_id;
 
 } flash_cmp_data_t;
 
@@ -94,8 +96,29 @@ typedef struct low_power_data_t
 	gyro_batch gyro_data;
 
 	uint32_t timestamp;
-	bool transmitted;
+	uint32_t reading_id;
 	
 } low_power_data_t;
 
+// for run time stats package (one per period; see runtime_stats.h)
+typedef struct runtime_stats_data_t
+{
+	runtime_report_t report;
+	uint16_t stack_min_free[RUNTIME_STATS_SLOTS]; // bytes (see get_stack_min_free)
+
+	uint32_t timestamp;
+	uint32_t reading_id;
+
+} runtime_stats_data_t;
+
+// for mutex stats package (one per period; see mutex_stats.h)
+typedef struct mutex_stats_data_t
+{
+	mutex_stats_report_t report;
+
+	uint32_t timestamp;
+	uint32_t reading_id;
+
+} mutex_stats_data_t;
+
 #endif
@@ -50,7 +50,7 @@ equistack* equistack_Init(equistack* S, void* data, size_t data_size, uint16_t m
 void* equistack_Get(equistack* S, int16_t n)
 {
 	bool got_mutex = true;
-	if (!xSemaphoreTake(S->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS)) {
+	if (!mutex_take(S->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS)) {
 		// log error, but continue on because we're just reading
 		log_error(ELOC_EQUISTACK_GET, ECODE_EQUISTACK_MUTEX_TIMEOUT, false);
 		got_mutex = false;
@@ -58,7 +58,7 @@ void* equistack_Get(equistack* S, int16_t n)
 
 	void* retval = equistack_Get_Unsafe(S, n);
 
-	if (got_mutex) xSemaphoreGive(S->mutex);
+	if (got_mutex) mutex_give(S->mutex);
 	return retval;
 }
 
@@ -142,7 +142,7 @@ static void* equistack_Stage_helper(equistack* S, bool from_isr) {
 	if (from_isr) {
 		got_mutex = xSemaphoreTakeFromISR(S->mutex, NULL);
 	} else {
-		got_mutex = xSemaphoreTake(S->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
+		got_mutex = mutex_take(S->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
 	}
 	
 	if (got_mutex) {
@@ -153,7 +153,7 @@ static void* equistack_Stage_helper(equistack* S, bool from_isr) {
 		if (from_isr) {
 			xSemaphoreGiveFromISR(S->mutex, NULL);
 		} else {
-			xSemaphoreGive(S->mutex);
+			mutex_give(S->mutex);
 		}
 	}
 	else
@@ -207,7 +207,7 @@ static void* equistack_Push_helper(equistack* S, void* data, bool from_isr)
 	if (from_isr) {
 		got_mutex = xSemaphoreTakeFromISR(S->mutex, NULL);
 	} else {
-		got_mutex = xSemaphoreTake(S->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
+		got_mutex = mutex_take(S->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
 	}
 	
 	if (got_mutex) {
@@ -218,7 +218,7 @@ static void* equistack_Push_helper(equistack* S, void* data, bool from_isr)
 		if (from_isr) {
 			xSemaphoreGiveFromISR(S->mutex, NULL);
 		} else {
-			xSemaphoreGive(S->mutex);
+			mutex_give(S->mutex);
 		}
 	}
 	else
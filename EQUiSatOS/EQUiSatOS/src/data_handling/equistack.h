@@ -14,6 +14,7 @@
 #include <asf.h> // don't #include global, there are circular dependencies!
 #include "task.h"
 #include "semphr.h"
+#include "../rtos_tasks/mutex_profiling.h"
 
 typedef struct equistack
 {
@@ -0,0 +1,118 @@
+/*
+ * msg_format.h
+ *
+ * Layout of the messages write_packet puts together, on its own (no includes) so the ground decoder (telemetry_decoder/) builds against the
+ * same constants the satellite does.
+ *
+ * Created: 10/19/2026 5:02:37 AM
+ *  Author: BSE
+ */
+
+
+#ifndef MSG_FORMAT_H_
+#define MSG_FORMAT_H_
+
+/************************************************************************/
+/* MESSAGE FORMAT CONSTANTS												*/
+/* See https://docs.google.com/spreadsheets/d/1sHQNTC5f5sg6j5DD4OKjuQykpIM3z16uetWT9YuB9PQ	*/
+/* for all details and these values										*/
+/************************************************************************/
+// various section sizes in bytes
+#define MSG_PREAMBLE_LENGTH			13
+#define MSG_CUR_DATA_LEN			16
+#define MSG_DATA_AND_ERRORS_LEN		194 // sum of possible data, error, and padding sections (make sure up to date)
+#define MSG_PARITY_LENGTH			32
+#define MSG_SIZE					255
+#define MSG_BUFFER_SIZE				MSG_SIZE // = sum of all sections (largest)
+
+// start points for sections
+#define START_PREAMBLE				0
+#define START_CUR_DATA				13
+#define START_DATA					29
+#define START_PARITY				223
+
+// set number of packets for each packet type
+#define IDLE_DATA_PACKETS			7
+#define ATTITUDE_DATA_PACKETS		5
+#define FLASH_DATA_PACKETS			1
+#define FLASH_CMP_DATA_PACKETS		6
+#define LOW_POWER_DATA_PACKETS		5
+#define RUNTIME_STATS_DATA_PACKETS	1
+#define MUTEX_STATS_DATA_PACKETS	1
+
+// size of each packet
+#define CALLSIGN_SIZE				6
+#define ERROR_PACKET_SIZE			3
+#define IDLE_DATA_PACKET_SIZE		23
+#define ATTITUDE_DATA_PACKET_SIZE	33
+#define FLASH_DATA_PACKET_SIZE		151
+#define FLASH_CMP_DATA_PACKET_SIZE	25
+#define LOW_POWER_DATA_PACKET_SIZE	30
+#define RUNTIME_STATS_DATA_PACKET_SIZE	130
+#define MUTEX_STATS_DATA_PACKET_SIZE	172
+
+// number of errors in each packet type (truncating is INTENTIONAL)
+#define IDLE_DATA_NUM_ERRORS			((MSG_DATA_AND_ERRORS_LEN - IDLE_DATA_PACKETS * IDLE_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+#define ATTITUDE_DATA_NUM_ERRORS		((MSG_DATA_AND_ERRORS_LEN - ATTITUDE_DATA_PACKETS * ATTITUDE_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+#define FLASH_DATA_NUM_ERRORS			((MSG_DATA_AND_ERRORS_LEN - FLASH_DATA_PACKETS * FLASH_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+#define FLASH_CMP_DATA_NUM_ERRORS		((MSG_DATA_AND_ERRORS_LEN - FLASH_CMP_DATA_PACKETS * FLASH_CMP_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+#define LOW_POWER_DATA_NUM_ERRORS		((MSG_DATA_AND_ERRORS_LEN - LOW_POWER_DATA_PACKETS * LOW_POWER_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+#define RUNTIME_STATS_DATA_NUM_ERRORS	((MSG_DATA_AND_ERRORS_LEN - RUNTIME_STATS_DATA_PACKETS * RUNTIME_STATS_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+#define MUTEX_STATS_DATA_NUM_ERRORS		((MSG_DATA_AND_ERRORS_LEN - MUTEX_STATS_DATA_PACKETS * MUTEX_STATS_DATA_PACKET_SIZE) / ERROR_PACKET_SIZE)
+	
+// size of padding after each packet (just get it off the spreadsheet, too hard to calc)
+#define IDLE_DATA_PADDING_SIZE			0
+#define ATTITUDE_DATA_PADDING_SIZE		2
+#define FLASH_DATA_PADDING_SIZE			1
+#define FLASH_CMP_DATA_PADDING_SIZE		2
+#define LOW_POWER_DATA_PADDING_SIZE		2
+#define RUNTIME_STATS_DATA_PADDING_SIZE	1
+#define MUTEX_STATS_DATA_PADDING_SIZE	1
+
+// run time stats packet (see runtime_stats.h): the period length in ms (4 bytes),
+// then for each slot (the tasks in task_type_t order, then the idle task, then
+// anything else) its total ms since boot (4), share of the period in thousandths (2)
+// and longest run this period in RUNTIME_STATS_SLICE_US units (2); then the idle
+// share again (2); then for each slot the least free stack it's been seen with
+// since launch, in bytes (2; STACK_MIN_FREE_NONE if it hasn't been), where the
+// "other" slot's stack is the timer daemon's; and the timestamp (4)
+#define RUNTIME_STATS_SLOTS				12 // == NUM_TASKS + 2
+#define RUNTIME_STATS_SLOT_SIZE			8
+#define RUNTIME_STATS_SLICE_US			100
+#define STACK_MIN_FREE_SIZE				2
+#define STACK_MIN_FREE_NONE				0xFFFF
+
+// mutex stats packet (see mutex_stats.h): for each profiled mutex (in mutex_stats_id_t
+// order) the takes this period (2), the takes that timed out (1), the takes that had to
+// wait, by how long (one byte per MUTEX_STATS_WAIT_BUCKETS bucket), the longest wait
+// and the longest hold in ms (2 each), and the run time stats slot of the task holding
+// it at the last timeout (1; MUTEX_STATS_NO_OWNER if none); then the timestamp (4).
+// Counts saturate.
+#define MUTEX_STATS_NUM					14
+#define MUTEX_STATS_ENTRY_SIZE			12
+#define MUTEX_STATS_WAIT_BUCKETS		4
+#define MUTEX_STATS_WAIT_MIN_US			100	// (shorter is uncontended; buckets go up x10 from here)
+#define MUTEX_STATS_NO_OWNER			0xFF
+
+// the time resolution to store error time deltas in;
+// we have chosen 300s = 5min because it gives approximately a
+// day of errors (1280 mins = 21.33 hours = 13.8 orbits)
+#define ERROR_TIME_BUCKET_SIZE		300 // s
+
+// callsign starting every message (not RS-encoded)
+#define MSG_CALLSIGN				"WL9XZE"
+
+// preamble: callsign, then these (little-endian)
+#define PREAMBLE_TIMESTAMP_OFFSET	6	// 4 bytes
+#define PREAMBLE_STATES_OFFSET		10	// 1 byte state string
+#define PREAMBLE_DATA_LEN_OFFSET	11	// 1 byte data section length
+#define PREAMBLE_NUM_ERRORS_OFFSET	12	// 1 byte errors in the error stack
+
+// state string bits
+#define MSG_STATE_TYPE_SHIFT		0	// msg_data_type_t (3 bits)
+#define MSG_STATE_SAT_STATE_SHIFT	3	// satellite state (3 bits)
+#define MSG_STATE_FLASH_KILLED_BIT	6
+#define MSG_STATE_PROG_MEM_BIT		7	// program memory rewritten on last reboot
+#define MSG_STATE_FIELD_MASK		0b111
+
+#endif /* MSG_FORMAT_H_ */
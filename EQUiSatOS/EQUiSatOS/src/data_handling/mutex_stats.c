@@ -0,0 +1,122 @@
+/*
+ * mutex_stats.c
+ *
+ * Created: 10/19/2026 11:20:37 AM
+ *  Author: BSE
+ */
+
+#include "mutex_stats.h"
+#include <string.h>
+
+/************************************************************************/
+/* ACCOUNTING                                                           */
+/************************************************************************/
+void mutex_stats_clear(mutex_stats_t* s) {
+	memset(s, 0, sizeof(mutex_stats_t));
+	s->timeout_owner = MUTEX_STATS_NO_OWNER;
+}
+
+/* the histogram bucket for a take that waited wait_us (MUTEX_STATS_WAIT_BUCKETS
+   if it didn't really wait) */
+uint8_t mutex_stats_wait_bucket(uint32_t wait_us) {
+	if (wait_us < MUTEX_STATS_WAIT_MIN_US) {
+		return MUTEX_STATS_WAIT_BUCKETS;
+	}
+	uint8_t bucket = 0;
+	uint32_t limit = MUTEX_STATS_WAIT_MIN_US * 10;
+	while (bucket < MUTEX_STATS_WAIT_BUCKETS - 1 && wait_us >= limit) {
+		bucket++;
+		limit *= 10;
+	}
+	return bucket;
+}
+
+/* a take that waited wait_us and got the mutex or not (timed out, with
+   owner's task holding it) */
+void mutex_stats_note_take(mutex_stats_t* s, uint32_t wait_us, bool got, uint8_t owner) {
+	s->takes++;
+	if (wait_us > s->max_wait_us) {
+		s->max_wait_us = wait_us;
+	}
+	if (!got) {
+		s->timeouts++;
+		s->timeout_owner = owner;
+		return;
+	}
+	uint8_t bucket = mutex_stats_wait_bucket(wait_us);
+	if (bucket < MUTEX_STATS_WAIT_BUCKETS) {
+		s->waits[bucket]++;
+	}
+}
+
+void mutex_stats_note_hold(mutex_stats_t* s, uint32_t hold_us) {
+	if (hold_us > s->max_hold_us) {
+		s->max_hold_us = hold_us;
+	}
+}
+
+/************************************************************************/
+/* REPORTS                                                              */
+/************************************************************************/
+static uint32_t saturate(uint32_t value, uint32_t max) {
+	return value > max ? max : value;
+}
+
+void mutex_stats_summarize(const mutex_stats_t* stats, mutex_stats_report_t* r) {
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		const mutex_stats_t* s = &stats[i];
+		mutex_stats_entry_t* e = &r->mutexes[i];
+		e->takes = saturate(s->takes, 0xFFFF);
+		e->timeouts = saturate(s->timeouts, 0xFF);
+		for (int b = 0; b < MUTEX_STATS_WAIT_BUCKETS; b++) {
+			e->waits[b] = saturate(s->waits[b], 0xFF);
+		}
+		e->max_wait_ms = saturate(s->max_wait_us / 1000, 0xFFFF);
+		e->max_hold_ms = saturate(s->max_hold_us / 1000, 0xFFFF);
+		e->timeout_owner = s->timeout_owner;
+	}
+}
+
+// (little-endian, like the rest of the message)
+static void put_le(uint8_t** buf, uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; i++) {
+		*(*buf)++ = value >> (8 * i);
+	}
+}
+
+static uint32_t get_le(const uint8_t** buf, int bytes) {
+	uint32_t value = 0;
+	for (int i = 0; i < bytes; i++) {
+		value |= (uint32_t) *(*buf)++ << (8 * i);
+	}
+	return value;
+}
+
+/* writes r as laid out in msg_format.h (MUTEX_STATS_REPORT_SIZE bytes) */
+void mutex_stats_pack(const mutex_stats_report_t* r, uint8_t* buf) {
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		const mutex_stats_entry_t* e = &r->mutexes[i];
+		put_le(&buf, e->takes, 2);
+		put_le(&buf, e->timeouts, 1);
+		for (int b = 0; b < MUTEX_STATS_WAIT_BUCKETS; b++) {
+			put_le(&buf, e->waits[b], 1);
+		}
+		put_le(&buf, e->max_wait_ms, 2);
+		put_le(&buf, e->max_hold_ms, 2);
+		put_le(&buf, e->timeout_owner, 1);
+	}
+}
+
+void mutex_stats_unpack(const uint8_t* buf, mutex_stats_report_t* r) {
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		mutex_stats_entry_t* e = &r->mutexes[i];
+		e->takes = get_le(&buf, 2);
+		e->timeouts = get_le(&buf, 1);
+		for (int b = 0; b < MUTEX_STATS_WAIT_BUCKETS; b++) {
+			e->waits[b] = get_le(&buf, 1);
+		}
+		e->max_wait_ms = get_le(&buf, 2);
+		e->max_hold_ms = get_le(&buf, 2);
+		e->timeout_owner = get_le(&buf, 1);
+	}
+}
@@ -0,0 +1,80 @@
+/*
+ * mutex_stats.h
+ *
+ * Contention accounting for the shared mutexes. With MUTEX_PROFILING defined
+ * (config.h), mutex_take / mutex_give (see mutex_profiling.h) time every take
+ * and hold of the mutexes in mutex_stats_id_t off the run time stats counter,
+ * and each mutex keeps, per period:
+ *	- how many times it was taken, and how many takes timed out
+ *	- a histogram of how long takes waited (those that waited at all)
+ *	- the longest wait and the longest it was held
+ *	- which task held it the last time a take timed out
+ * This has no RTOS or ASF includes (times are passed in), so the ground tools
+ * build it too (see telemetry_decoder/).
+ *
+ * Created: 10/19/2026 11:20:14 AM
+ *  Author: BSE
+ */
+
+
+#ifndef MUTEX_STATS_H_
+#define MUTEX_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msg_format.h"
+
+// the profiled mutexes, in the order they're reported
+// (the irpow semaphore isn't a mutex, and the print mutex is only for debugging)
+typedef enum {
+	MUTEX_STATS_CRITICAL_ACTION,
+	MUTEX_STATS_I2C_IRPOW,
+	MUTEX_STATS_PROCESSOR_ADC,
+	MUTEX_STATS_HARDWARE_STATE,
+	MUTEX_STATS_WATCHDOG,
+	MUTEX_STATS_MRAM_SPI_CACHE,
+	MUTEX_STATS_IDLE_EQUISTACK,
+	MUTEX_STATS_ATTITUDE_EQUISTACK,
+	MUTEX_STATS_FLASH_EQUISTACK,
+	MUTEX_STATS_FLASH_CMP_EQUISTACK,
+	MUTEX_STATS_LOW_POWER_EQUISTACK,
+	MUTEX_STATS_RUNTIME_STATS_EQUISTACK,
+	MUTEX_STATS_MUTEX_STATS_EQUISTACK,
+	MUTEX_STATS_ERROR_EQUISTACK,
+	NUM_MUTEX_STATS // == MUTEX_STATS_NUM
+} mutex_stats_id_t;
+
+// bytes mutex_stats_pack writes (the packet, less its timestamp)
+#define MUTEX_STATS_REPORT_SIZE		(MUTEX_STATS_NUM * MUTEX_STATS_ENTRY_SIZE)
+
+typedef struct mutex_stats {
+	uint32_t takes;
+	uint32_t timeouts;
+	uint32_t waits[MUTEX_STATS_WAIT_BUCKETS];
+	uint32_t max_wait_us;
+	uint32_t max_hold_us;
+	uint8_t timeout_owner;
+} mutex_stats_t;
+
+typedef struct mutex_stats_entry {
+	uint16_t takes;
+	uint8_t timeouts;
+	uint8_t waits[MUTEX_STATS_WAIT_BUCKETS];
+	uint16_t max_wait_ms;
+	uint16_t max_hold_ms;
+	uint8_t timeout_owner;
+} mutex_stats_entry_t;
+
+typedef struct mutex_stats_report {
+	mutex_stats_entry_t mutexes[MUTEX_STATS_NUM];
+} mutex_stats_report_t;
+
+void mutex_stats_clear(mutex_stats_t* s);
+void mutex_stats_note_take(mutex_stats_t* s, uint32_t wait_us, bool got, uint8_t owner);
+void mutex_stats_note_hold(mutex_stats_t* s, uint32_t hold_us);
+uint8_t mutex_stats_wait_bucket(uint32_t wait_us);
+void mutex_stats_summarize(const mutex_stats_t* stats, mutex_stats_report_t* r);
+void mutex_stats_pack(const mutex_stats_report_t* r, uint8_t* buf);
+void mutex_stats_unpack(const uint8_t* buf, mutex_stats_report_t* r);
+
+#endif /* MUTEX_STATS_H_ */
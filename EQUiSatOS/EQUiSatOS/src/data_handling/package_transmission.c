@@ -5,6 +5,7 @@
 * Author: mckenna
 */
 #include "package_transmission.h"
+#include "../telemetry/downlink_ledger.h"
 
 void assert_transmission_constants(void) {
 	// NOTE: if these are correct, they may be optimized out (which is fine)
@@ -12,6 +13,8 @@ void assert_transmission_constants(void) {
 	// check that starts line up with data sizes
 	configASSERT(MSG_PREAMBLE_LENGTH == START_CUR_DATA);
 	configASSERT(MSG_PREAMBLE_LENGTH + MSG_CUR_DATA_LEN == START_DATA);
+	configASSERT(PREAMBLE_TIMESTAMP_OFFSET == CALLSIGN_SIZE && sizeof(MSG_CALLSIGN) - 1 == CALLSIGN_SIZE);
+	configASSERT(PREAMBLE_NUM_ERRORS_OFFSET + 1 == MSG_PREAMBLE_LENGTH);
 
 	configASSERT(MSG_PREAMBLE_LENGTH + MSG_CUR_DATA_LEN + IDLE_DATA_PACKETS * IDLE_DATA_PACKET_SIZE +
 		IDLE_DATA_NUM_ERRORS * ERROR_PACKET_SIZE + IDLE_DATA_PADDING_SIZE == START_PARITY);
@@ -28,6 +31,14 @@ void assert_transmission_constants(void) {
 	configASSERT(MSG_PREAMBLE_LENGTH + MSG_CUR_DATA_LEN + LOW_POWER_DATA_PACKETS * LOW_POWER_DATA_PACKET_SIZE +
 		LOW_POWER_DATA_NUM_ERRORS * ERROR_PACKET_SIZE + LOW_POWER_DATA_PADDING_SIZE == START_PARITY);
 
+	configASSERT(MSG_PREAMBLE_LENGTH + MSG_CUR_DATA_LEN + RUNTIME_STATS_DATA_PACKETS * RUNTIME_STATS_DATA_PACKET_SIZE +
+		RUNTIME_STATS_DATA_NUM_ERRORS * ERROR_PACKET_SIZE + RUNTIME_STATS_DATA_PADDING_SIZE == START_PARITY);
+	configASSERT(RUNTIME_STATS_REPORT_SIZE + RUNTIME_STATS_SLOTS * STACK_MIN_FREE_SIZE + 4 == RUNTIME_STATS_DATA_PACKET_SIZE);
+
+	configASSERT(MSG_PREAMBLE_LENGTH + MSG_CUR_DATA_LEN + MUTEX_STATS_DATA_PACKETS * MUTEX_STATS_DATA_PACKET_SIZE +
+		MUTEX_STATS_DATA_NUM_ERRORS * ERROR_PACKET_SIZE + MUTEX_STATS_DATA_PADDING_SIZE == START_PARITY);
+	configASSERT(MUTEX_STATS_REPORT_SIZE + 4 == MUTEX_STATS_DATA_PACKET_SIZE);
+
 	// check things will fit in buffer (one space for \0)
 	configASSERT(START_PARITY + MSG_PARITY_LENGTH <= MSG_BUFFER_SIZE - 1);
 }
@@ -86,7 +97,7 @@ void write_packet(uint8_t* msg_buffer, msg_data_type_t msg_type, uint32_t curren
 
 	uint8_t num_data, size_data, num_packet_errors, padding_size;
 
-	bool got_error_stack_mutex = xSemaphoreTake(error_equistack.mutex, EQUISTACK_MUTEX_WAIT_TIME_TICKS);
+	bool got_error_stack_mutex = mutex_take(error_equistack.mutex, EQUISTACK_MUTEX_WAIT_TIME_TICKS);
 	if (!got_error_stack_mutex) {
 		log_error(ELOC_RADIO, ECODE_EQUISTACK_MUTEX_TIMEOUT, false);
 	}
@@ -129,6 +140,20 @@ void write_packet(uint8_t* msg_buffer, msg_data_type_t msg_type, uint32_t curren
 			padding_size =		LOW_POWER_DATA_PADDING_SIZE;
 			break;
 
+		case RUNTIME_STATS_DATA:
+			num_data =			RUNTIME_STATS_DATA_PACKETS;
+			size_data =			RUNTIME_STATS_DATA_PACKET_SIZE;
+			num_packet_errors = RUNTIME_STATS_DATA_NUM_ERRORS;
+			padding_size =		RUNTIME_STATS_DATA_PADDING_SIZE;
+			break;
+
+		case MUTEX_STATS_DATA:
+			num_data =			MUTEX_STATS_DATA_PACKETS;
+			size_data =			MUTEX_STATS_DATA_PACKET_SIZE;
+			num_packet_errors = MUTEX_STATS_DATA_NUM_ERRORS;
+			padding_size =		MUTEX_STATS_DATA_PADDING_SIZE;
+			break;
+
 		default:
 			// this is a problem
 			configASSERT(false);
@@ -141,10 +166,10 @@ void write_packet(uint8_t* msg_buffer, msg_data_type_t msg_type, uint32_t curren
 
 	// configure state string
 	uint8_t state_string = 0;
-	state_string |=  msg_type			& 0b111;			// 3 LSB of msg_type (5 types)
-	state_string |= (get_sat_state()	& 0b111)	<< 3;	// three LSB of satellite state
-	state_string |= (flash_killed & 0x1)			<< 6;	// whether flash is currently killed
-	state_string |= (cache_get_prog_mem_rewritten() & 0x1) << 7;	// whether program mem rewritten on last reboot
+	state_string |= (msg_type			& MSG_STATE_FIELD_MASK)	<< MSG_STATE_TYPE_SHIFT;		// 3 LSB of msg_type (7 types)
+	state_string |= (get_sat_state()	& MSG_STATE_FIELD_MASK)	<< MSG_STATE_SAT_STATE_SHIFT;	// three LSB of satellite state
+	state_string |= (flash_killed & 0x1)			<< MSG_STATE_FLASH_KILLED_BIT;	// whether flash is currently killed
+	state_string |= (cache_get_prog_mem_rewritten() & 0x1) << MSG_STATE_PROG_MEM_BIT;	// whether program mem rewritten on last reboot
 	
 	// incremented index in buffer
 	uint8_t buf_index = 0;
@@ -167,7 +192,7 @@ void write_packet(uint8_t* msg_buffer, msg_data_type_t msg_type, uint32_t curren
 	configASSERT(buf_index == START_DATA + size_data*num_data + num_packet_errors*ERROR_PACKET_SIZE);
 	configASSERT (buf_index <= START_PARITY);
 	
-	if (got_error_stack_mutex) xSemaphoreGive(error_equistack.mutex);
+	if (got_error_stack_mutex) mutex_give(error_equistack.mutex);
 
 	write_value_and_shift(msg_buffer, &buf_index, 0, padding_size);
 	configASSERT(buf_index == START_PARITY);
@@ -187,12 +212,7 @@ void write_preamble(uint8_t* buffer, uint8_t* buf_index, uint32_t timestamp, uin
 	*buf_index = START_PREAMBLE; // to be sure
 
 	// write callsign
-	buffer[(*buf_index)++] = 'W';
-	buffer[(*buf_index)++] = 'L';
-	buffer[(*buf_index)++] = '9';
-	buffer[(*buf_index)++] = 'X';
-	buffer[(*buf_index)++] = 'Z';
-	buffer[(*buf_index)++] = 'E';
+	write_bytes_and_shift(buffer, buf_index,	MSG_CALLSIGN,		CALLSIGN_SIZE);
 
 	write_bytes_and_shift(buffer, buf_index,	&timestamp,			sizeof(timestamp)); // 4 byte timestamp
 	write_bytes_and_shift(buffer, buf_index,	&states,			sizeof(states)); // 1 byte state string
@@ -252,6 +272,26 @@ void write_attitude_data_packet(uint8_t* buffer, uint8_t* buf_index, attitude_da
 void write_flash_data_packet(uint8_t* buffer, uint8_t* buf_index, flash_data_t* flash_data);
 void write_flash_cmp_data_packet(uint8_t* buffer, uint8_t* buf_index, flash_cmp_data_t* flash_cmp_data);
 void write_low_power_data_packet(uint8_t* buffer, uint8_t* buf_index, low_power_data_t* low_power_data);
+void write_runtime_stats_data_packet(uint8_t* buffer, uint8_t* buf_index, runtime_stats_data_t* runtime_stats_data);
+void write_mutex_stats_data_packet(uint8_t* buffer, uint8_t* buf_index, mutex_stats_data_t* mutex_stats_data);
+
+/* index in the equistack for msg_type to start retransmitting from: the newest reading
+   older than the last one retransmitted (so successive retransmissions go through the
+   whole equistack rather than repeating the newest readings), or the newest if none */
+static int retransmit_start_index(msg_data_type_t msg_type) {
+	equistack* stack = get_msg_type_equistack(msg_type);
+	if (stack == NULL) {
+		return 0;
+	}
+	for (int i = 0; i < stack->cur_size; i++) {
+		void* reading = equistack_Get(stack, i);
+		uint32_t timestamp;
+		if (reading != NULL && reading_retransmit_before(msg_type, get_reading_id(msg_type, reading, &timestamp))) {
+			return i;
+		}
+	}
+	return 0;
+}
 
 /* writes the data section corresponding to msg_type, and returns the end of this (the start of the error section).
    The packet equistack associated with msg_type should not be empty. 
@@ -268,20 +308,21 @@ void write_data_section(uint8_t* buffer, uint8_t* buf_index, msg_data_type_t msg
 		// write a packet according to message type, noting whether the particular packet
 		// was transmittable and its size
 		bool transmittable = false;
+		uint32_t reading_id = READING_ID_NONE;
 		int equistack_size;
 		size_t equistack_data_size;
 
 		// for each type, grab the current index (note that msg_type is constant),
-		// and write a packet and note it "transmitted" if we're either retransmitting right now,
-		// or the current packet is not transmitted otherwise.
+		// and write a packet if we're either retransmitting right now,
+		// or the current packet has never been sent (according to the reading ledger).
 		// Also, skip any NULL packets (empty check is below)
 		// Also note the above variables
 		switch (msg_type) {
 			case IDLE_DATA: ;
 				idle_data_t* idle_data = (idle_data_t*) equistack_Get(&idle_readings_equistack, equi_i);
-				if (idle_data != NULL && (retransmit || !idle_data->transmitted)) {
+				if (idle_data != NULL && (retransmit || !reading_was_sent(IDLE_DATA, idle_data->reading_id))) {
 					write_idle_data_packet(buffer, buf_index, idle_data);
-					idle_data->transmitted = true;
+					reading_id = idle_data->reading_id;
 					transmittable = true;
 				}
 				equistack_size = idle_readings_equistack.cur_size;
@@ -290,9 +331,9 @@ void write_data_section(uint8_t* buffer, uint8_t* buf_index, msg_data_type_t msg
 
 			case ATTITUDE_DATA: ;
 				attitude_data_t* attitude_data = (attitude_data_t*) equistack_Get(&attitude_readings_equistack, equi_i);
-				if (attitude_data != NULL && (retransmit || !attitude_data->transmitted)) {
+				if (attitude_data != NULL && (retransmit || !reading_was_sent(ATTITUDE_DATA, attitude_data->reading_id))) {
 					write_attitude_data_packet(buffer, buf_index, attitude_data);
-					attitude_data->transmitted = true;
+					reading_id = attitude_data->reading_id;
 					transmittable = true;
 				}
 				equistack_size = attitude_readings_equistack.cur_size;
@@ -301,9 +342,9 @@ void write_data_section(uint8_t* buffer, uint8_t* buf_index, msg_data_type_t msg
 
 			case FLASH_DATA: ;
 				flash_data_t* flash_data = (flash_data_t*) equistack_Get(&flash_readings_equistack, equi_i);
-				if (flash_data != NULL && (retransmit || !flash_data->transmitted)) {
+				if (flash_data != NULL && (retransmit || !reading_was_sent(FLASH_DATA, flash_data->reading_id))) {
 					write_flash_data_packet(buffer, buf_index, flash_data);
-					flash_data->transmitted = true;
+					reading_id = flash_data->reading_id;
 					transmittable = true;
 				}
 				equistack_size = flash_readings_equistack.cur_size;
@@ -312,9 +353,9 @@ void write_data_section(uint8_t* buffer, uint8_t* buf_index, msg_data_type_t msg
 
 			case FLASH_CMP_DATA: ;
 				flash_cmp_data_t* flash_cmp_data = (flash_cmp_data_t*) equistack_Get(&flash_cmp_readings_equistack, equi_i);
-				if (flash_cmp_data != NULL && (retransmit || !flash_cmp_data->transmitted)) {
+				if (flash_cmp_data != NULL && (retransmit || !reading_was_sent(FLASH_CMP_DATA, flash_cmp_data->reading_id))) {
 					write_flash_cmp_data_packet(buffer, buf_index, flash_cmp_data);
-					flash_cmp_data->transmitted = true;
+					reading_id = flash_cmp_data->reading_id;
 					transmittable = true;
 				}
 				equistack_size = flash_cmp_readings_equistack.cur_size;
@@ -323,15 +364,37 @@ void write_data_section(uint8_t* buffer, uint8_t* buf_index, msg_data_type_t msg
 
 			case LOW_POWER_DATA: ;
 				low_power_data_t* low_power_data = (low_power_data_t*) equistack_Get(&low_power_readings_equistack, equi_i);
-				if (low_power_data != NULL && (retransmit || !low_power_data->transmitted)) {
+				if (low_power_data != NULL && (retransmit || !reading_was_sent(LOW_POWER_DATA, low_power_data->reading_id))) {
 					write_low_power_data_packet(buffer, buf_index, low_power_data);
-					low_power_data->transmitted = true;
+					reading_id = low_power_data->reading_id;
 					transmittable = true;
 				}
 				equistack_size = low_power_readings_equistack.cur_size;
 				equistack_data_size = LOW_POWER_DATA_PACKET_SIZE;
 				break;
 
+			case RUNTIME_STATS_DATA: ;
+				runtime_stats_data_t* runtime_stats_data = (runtime_stats_data_t*) equistack_Get(&runtime_stats_equistack, equi_i);
+				if (runtime_stats_data != NULL && (retransmit || !reading_was_sent(RUNTIME_STATS_DATA, runtime_stats_data->reading_id))) {
+					write_runtime_stats_data_packet(buffer, buf_index, runtime_stats_data);
+					reading_id = runtime_stats_data->reading_id;
+					transmittable = true;
+				}
+				equistack_size = runtime_stats_equistack.cur_size;
+				equistack_data_size = RUNTIME_STATS_DATA_PACKET_SIZE;
+				break;
+
+			case MUTEX_STATS_DATA: ;
+				mutex_stats_data_t* mutex_stats_data = (mutex_stats_data_t*) equistack_Get(&mutex_stats_equistack, equi_i);
+				if (mutex_stats_data != NULL && (retransmit || !reading_was_sent(MUTEX_STATS_DATA, mutex_stats_data->reading_id))) {
+					write_mutex_stats_data_packet(buffer, buf_index, mutex_stats_data);
+					reading_id = mutex_stats_data->reading_id;
+					transmittable = true;
+				}
+				equistack_size = mutex_stats_equistack.cur_size;
+				equistack_data_size = MUTEX_STATS_DATA_PACKET_SIZE;
+				break;
+
 			default:
 				configASSERT(false);
 		}
@@ -345,23 +408,25 @@ void write_data_section(uint8_t* buffer, uint8_t* buf_index, msg_data_type_t msg
 		}
 
 		if (!retransmit && !transmittable) {
-			// if we're not retransmitting and it was already transmitted,
+			// if we're not retransmitting and it was already sent,
 			// skip it (don't note a write)
 			equi_i++;
 		} else {
-			// move along the equistack, noting (above) that this packet will be transmitted
+			// move along the equistack, noting that this packet will be transmitted
+			note_reading_sent(msg_type, reading_id, retransmit);
 			packets_written++;
 			equi_i++;
 		}
 
 		if (equi_i >= equistack_size) {
 			// if we reach the end of the list, it means there are either not enough
-			// packets in the equistack to fill a message, or there were too many already-transmitted packets (for the first time).
-			// In this case, stop caring about whether they were transmitted, and wrap back around to try again
-			equi_i = 0;
+			// packets in the equistack to fill a message, or there were too many already-sent packets (for the first time).
+			// In this case, stop caring about whether they were sent, and go back to retransmit
+			// (the first time, from where the last retransmission left off)
+			equi_i = retransmit ? 0 : retransmit_start_index(msg_type);
 			retransmit = true;
 
-			// if this has happened twice or more (we went through not skipping transmitted packets),
+			// if this has happened twice or more (we went through not skipping sent packets),
 			// then keep looping around the equistack and re-writing until we write all we need
 		}
 	}
@@ -425,6 +490,23 @@ void write_low_power_data_packet(uint8_t* buffer, uint8_t* buf_index, low_power_
 	write_bytes_and_shift(buffer, buf_index,	&(low_power_data->timestamp),					4 /* uint32_t */);
 }
 
+void write_runtime_stats_data_packet(uint8_t* buffer, uint8_t* buf_index, runtime_stats_data_t* runtime_stats_data) {
+	// (the report's laid out by runtime_stats_pack, which the ground tools share)
+	runtime_stats_pack(&(runtime_stats_data->report), buffer + *buf_index);
+	*buf_index += RUNTIME_STATS_REPORT_SIZE;
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		write_bytes_and_shift(buffer, buf_index,	&(runtime_stats_data->stack_min_free[i]),	STACK_MIN_FREE_SIZE);
+	}
+	write_bytes_and_shift(buffer, buf_index,	&(runtime_stats_data->timestamp),				4 /* uint32_t */);
+}
+
+void write_mutex_stats_data_packet(uint8_t* buffer, uint8_t* buf_index, mutex_stats_data_t* mutex_stats_data) {
+	// (laid out by mutex_stats_pack, like the run time stats)
+	mutex_stats_pack(&(mutex_stats_data->report), buffer + *buf_index);
+	*buf_index += MUTEX_STATS_REPORT_SIZE;
+	write_bytes_and_shift(buffer, buf_index,	&(mutex_stats_data->timestamp),					4 /* uint32_t */);
+}
+
 /* writes error correction bytes. Must be called after full message before it was written, obviously. */
 void write_parity(uint8_t* buffer, uint8_t* buf_index) {
 	// encode using Reed-Solomon (START_PARITY is the number of bytes in buffer before parity section)
@@ -436,8 +518,8 @@ void write_parity(uint8_t* buffer, uint8_t* buf_index) {
 }
 
 /* Writes num_bytes from input to data, and shifts the value at buf_index up by num_bytes */
-void write_bytes_and_shift(uint8_t *data, uint8_t* buf_index, void *input, size_t num_bytes) {
-	memcpy(data + *buf_index, (char*) input, num_bytes);
+void write_bytes_and_shift(uint8_t *data, uint8_t* buf_index, const void *input, size_t num_bytes) {
+	memcpy(data + *buf_index, input, num_bytes);
 	*buf_index += num_bytes;
 }
 
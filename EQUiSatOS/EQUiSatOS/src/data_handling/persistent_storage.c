@@ -12,12 +12,8 @@ struct spi_module spi_master_instance;
 struct spi_slave_inst mram1_slave;
 struct spi_slave_inst mram2_slave;
 
-/* log of last known tick count to detect overflows */
-TickType_t prev_get_timestamp_ticks = 0;
-
 void write_state_to_storage_safety(bool safe);
 void cached_state_sync_redundancy(void);
-static uint32_t check_and_correct_tick_wraparound(void);
 bool compare_sat_event_history(satellite_history_batch* history1, satellite_history_batch* history2);
 bool compare_persistent_charging_data(persistent_charging_data_t* data1, persistent_charging_data_t* data2);
 
@@ -41,6 +37,9 @@ void init_persistent_storage(void) {
 	RAD_SAFE_FIELD_SET(storage_radio_revive_timestamp_addr, STORAGE_RADIO_REVIVE_TIMESTAMP_ADDR);
 	RAD_SAFE_FIELD_SET(storage_err_num_addr, STORAGE_ERR_NUM_ADDR);
 	RAD_SAFE_FIELD_SET(storage_err_list_addr, STORAGE_ERR_LIST_ADDR);
+	RAD_SAFE_FIELD_SET(storage_downlink_ledger_addr, STORAGE_DOWNLINK_LEDGER_ADDR);
+	RAD_SAFE_FIELD_SET(storage_stack_min_free_addr, STORAGE_STACK_MIN_FREE_ADDR);
+	RAD_SAFE_FIELD_SET(storage_trace_snapshot_addr, STORAGE_TRACE_SNAPSHOT_ADDR);
 	// field sizes
 	RAD_SAFE_FIELD_SET(storage_secs_since_lauch_size, STORAGE_SECS_SINCE_LAUNCH_SIZE);
 	RAD_SAFE_FIELD_SET(storage_reboot_cnt_size, STORAGE_REBOOT_CNT_SIZE);
@@ -50,6 +49,9 @@ void init_persistent_storage(void) {
 	RAD_SAFE_FIELD_SET(storage_persistent_charging_data_size, STORAGE_PERSISTENT_CHARGING_DATA_SIZE);
 	RAD_SAFE_FIELD_SET(storage_radio_revive_timestamp_size, STORAGE_RADIO_REVIVE_TIMESTAMP_SIZE);
 	RAD_SAFE_FIELD_SET(storage_err_num_size, STORAGE_ERR_NUM_SIZE);
+	RAD_SAFE_FIELD_SET(storage_downlink_ledger_size, STORAGE_DOWNLINK_LEDGER_SIZE);
+	RAD_SAFE_FIELD_SET(storage_stack_min_free_size, STORAGE_STACK_MIN_FREE_SIZE);
+	RAD_SAFE_FIELD_SET(storage_trace_snapshot_size, STORAGE_TRACE_SNAPSHOT_SIZE);
 
 	mram_spi_cache_mutex = xSemaphoreCreateMutexStatic(&_mram_spi_cache_mutex_d);
 
@@ -235,10 +237,27 @@ static bool storage_write_field_unsafe(uint8_t *data, int num_bytes, uint32_t ad
 			address + num_bytes), true); // priority
 }
 
+/* zeroes a field (both copies, in both MRAMs) a few bytes at a time,
+   for ones too big to zero out in RAM first */
+static bool storage_zero_field_unsafe(int num_bytes, uint32_t address) {
+	uint8_t zeros[16];
+	memset(zeros, 0, sizeof(zeros));
+	bool success = true;
+	// (the second copy is right after the first)
+	for (int i = 0; i < 2 * num_bytes; i += sizeof(zeros)) {
+		int chunk = min(2 * num_bytes - i, (int) sizeof(zeros));
+		success = !log_if_error(ELOC_MRAM1_WRITE,
+			mram_write_bytes(&spi_master_instance, &mram1_slave, zeros, chunk, address + i), true) && success;
+		success = !log_if_error(ELOC_MRAM2_WRITE,
+			mram_write_bytes(&spi_master_instance, &mram2_slave, zeros, chunk, address + i), true) && success;
+	}
+	return success;
+}
+
 /* read state from storage into cache - should really only be called on boot,
    otherwise the information in the time since the last write would be lost. */
 void read_state_from_storage(void) {
-	if (xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
 	{
 		#ifdef XPLAINED
 			// defaults when no MRAM available
@@ -260,13 +279,13 @@ void read_state_from_storage(void) {
 		#endif
 		
 		// set initial _secs_since_launch_at_boot based on the last stored timestamp in the MRAM
-		// from here on out this will be used to judge our current _accurate_ timestamp (using xTaskGetTickCount rel. to this)
+		// from here on out this will be used to judge our current _accurate_ timestamp (using the RTC rel. to this)
 		// and secs_since_launch will just be periodically updated in case of reboot
-		// (note that xTaskGetTickCount/1000 is very likely 0 when we first read the state on boot)
+		// (note that the RTC has very likely counted less than a second when we first read the state on boot)
 		cached_state._secs_since_launch_at_boot = cached_state.secs_since_launch
-					- check_and_correct_tick_wraparound();
+					- rtc_time_counts_to_s(rtc_read_counts_64());
 		
-		xSemaphoreGive(mram_spi_cache_mutex);
+		mutex_give(mram_spi_cache_mutex);
 	} else {
 		log_error(ELOC_MRAM_READ, ECODE_SPI_MUTEX_TIMEOUT, true);
 	}
@@ -291,7 +310,7 @@ static bool storage_write_check_errors_unsafe(equistack* stack, bool confirm) {
 	}
 	
 	bool got_mutex = true;
-	if (!xSemaphoreTake(stack->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS)) {
+	if (!mutex_take(stack->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS)) {
 		// log error, but continue on because we're just reading
 		log_error(ELOC_MRAM_WRITE, ECODE_EQUISTACK_MUTEX_TIMEOUT, false);
 		got_mutex = false;
@@ -303,7 +322,7 @@ static bool storage_write_check_errors_unsafe(equistack* stack, bool confirm) {
 			error_buf[i] = *err;
 		}
 	}
-	if (got_mutex) xSemaphoreGive(stack->mutex);
+	if (got_mutex) mutex_give(stack->mutex);
 	
 	// write size and error data to storage
 	storage_write_field_unsafe(&num_errors,	RAD_SAFE_FIELD_GET(storage_err_num_size), RAD_SAFE_FIELD_GET(storage_err_num_addr));
@@ -338,6 +357,33 @@ static bool storage_write_check_errors_unsafe(equistack* stack, bool confirm) {
 	return true;
 }
 
+// writes the reading ledger to mram (like the error list, it isn't crucial
+// enough to confirm or make rad-safe)
+static void storage_write_ledger_unsafe(void) {
+	static downlink_ledger_t ledger;
+	get_reading_ledger(&ledger);
+	storage_write_field_unsafe((uint8_t*) &ledger, RAD_SAFE_FIELD_GET(storage_downlink_ledger_size), RAD_SAFE_FIELD_GET(storage_downlink_ledger_addr));
+}
+
+// writes the stack watermark minimums to mram (same deal as the ledger)
+static void storage_write_stack_min_free_unsafe(void) {
+	static uint16_t stack_min_free[RUNTIME_STATS_SLOTS];
+	get_stack_min_free(stack_min_free);
+	storage_write_field_unsafe((uint8_t*) stack_min_free, RAD_SAFE_FIELD_GET(storage_stack_min_free_size), RAD_SAFE_FIELD_GET(storage_stack_min_free_addr));
+}
+
+#ifdef TRACE_RING
+// writes the trace ring to mram if it's been frozen (only from the emergency
+// write, so only a watchdog early warning or stack overflow replaces the last one)
+static void storage_write_trace_snapshot_unsafe(void) {
+	// (straight from the ring; it's too big to copy out)
+	const trace_snapshot_t* snapshot = get_trace_snapshot();
+	if (snapshot != NULL) {
+		storage_write_field_unsafe((uint8_t*) snapshot, RAD_SAFE_FIELD_GET(storage_trace_snapshot_size), RAD_SAFE_FIELD_GET(storage_trace_snapshot_addr));
+	}
+}
+#endif
+
 // Updates all cache fields that should be updated on each write
 // NOTE: must be called with the SPI mutex to protect the changes
 // in the cached state
@@ -345,7 +391,7 @@ static void update_cache_fields(void) {
 	// make sure all the cached states are in sync
 	cached_state_correct_errors();
 	
-	// grab current timestamp (catching and correcting a tick count overflow if there was one)
+	// grab current timestamp
 	cached_state.secs_since_launch = get_current_timestamp();
 	
 	// grab current sat state
@@ -369,6 +415,8 @@ static bool write_cache_fields_to_storage(bool confirm_errors) {
 	storage_write_field_unsafe(&cached_state.prog_mem_rewritten,				RAD_SAFE_FIELD_GET(storage_prog_mem_rewritten_size),		RAD_SAFE_FIELD_GET(storage_prog_mem_rewritten_addr));
 	storage_write_field_unsafe((uint8_t*) &cached_state.persistent_charging_data,RAD_SAFE_FIELD_GET(storage_persistent_charging_data_size),	RAD_SAFE_FIELD_GET(storage_persistent_charging_data_addr));
 	storage_write_field_unsafe((uint8_t*) &cached_state.radio_revive_timestamp,	RAD_SAFE_FIELD_GET(storage_radio_revive_timestamp_size),	RAD_SAFE_FIELD_GET(storage_radio_revive_timestamp_addr));
+	storage_write_ledger_unsafe();
+	storage_write_stack_min_free_unsafe();
 	return storage_write_check_errors_unsafe(&error_equistack, confirm_errors);
 }
 
@@ -378,7 +426,7 @@ static bool write_cache_fields_to_storage(bool confirm_errors) {
 	Also serves to correct any errors in stack space for cached state
 */
 void write_state_to_storage_safety(bool safe) {
-	if (!safe || xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
+	if (!safe || mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
 	{
 		// always do this (every PERSISTENT_DATA_BACKUP_TASK_FREQ ms),
 		// plus we need to do it before every cached_state update
@@ -422,7 +470,7 @@ void write_state_to_storage_safety(bool safe) {
 			configASSERT(false);
 		}
 		
-		if (safe) xSemaphoreGive(mram_spi_cache_mutex); // we got the mutex if safe is true
+		if (safe) mutex_give(mram_spi_cache_mutex); // we got the mutex if safe is true
 		
 	} else if (safe) {
 		log_error(ELOC_MRAM_WRITE, ECODE_SPI_MUTEX_TIMEOUT, true);
@@ -441,7 +489,7 @@ void write_state_to_storage_emergency(bool from_isr) {
 	if (from_isr) {
 		got_mutex = xSemaphoreTakeFromISR(mram_spi_cache_mutex, NULL);
 	} else {
-		got_mutex = xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS);
+		got_mutex = mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS);
 	}
 	
 	if (got_mutex)
@@ -451,11 +499,14 @@ void write_state_to_storage_emergency(bool from_isr) {
 		
 		// actually perform writes (DON'T check that errors wrote)
 		write_cache_fields_to_storage(false);
+		#ifdef TRACE_RING
+			storage_write_trace_snapshot_unsafe();
+		#endif
 		
 		if (from_isr) {
 			xSemaphoreGiveFromISR(mram_spi_cache_mutex, NULL);
 		} else {
-			xSemaphoreGive(mram_spi_cache_mutex);
+			mutex_give(mram_spi_cache_mutex);
 		}
 	} else {
 		if (from_isr) {
@@ -515,13 +566,13 @@ void cached_state_sync_redundancy(void) {
 /************************************************************************/
 
 bool increment_reboot_count(void) {
-	if (xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
 		cached_state_correct_errors();
 		cached_state.reboot_count++;
 		cached_state_sync_redundancy();
 		write_state_to_storage_safety(false);
 		
-		xSemaphoreGive(mram_spi_cache_mutex);
+		mutex_give(mram_spi_cache_mutex);
 		return true;
 		
 	} else {
@@ -533,13 +584,13 @@ bool increment_reboot_count(void) {
 }
 
 bool set_radio_revive_timestamp(uint32_t radio_revive_timestamp) {
-	if (xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
 		cached_state_correct_errors();
 		cached_state.radio_revive_timestamp = radio_revive_timestamp;
 		cached_state_sync_redundancy();
 		write_state_to_storage_safety(false);
 		
-		xSemaphoreGive(mram_spi_cache_mutex);
+		mutex_give(mram_spi_cache_mutex);
 		return true;
 		
 	} else {
@@ -575,7 +626,7 @@ bool update_sat_event_history(uint8_t antenna_deployed,
 								uint8_t first_flash,
 								uint8_t prog_mem_rewritten) {
 
-	if (xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
 		cached_state_correct_errors();
 	
 		bool hist_changed = false;
@@ -613,7 +664,7 @@ bool update_sat_event_history(uint8_t antenna_deployed,
 			write_state_to_storage_safety(false);
 		}
 		
-		xSemaphoreGive(mram_spi_cache_mutex);
+		mutex_give(mram_spi_cache_mutex);
 		return true;
 		
 	} else {
@@ -665,7 +716,7 @@ void populate_error_stacks(equistack* error_stack) {
 	// take big buffers off stack
 	static sat_error_t error_buf[ERROR_STACK_MAX];
 	
-	if (xSemaphoreTake(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
 	{
 		// read in errors from MRAM
 		uint8_t num_stored_errors;
@@ -698,12 +749,58 @@ void populate_error_stacks(equistack* error_stack) {
 			log_error(ELOC_MRAM_READ, ECODE_OUT_OF_BOUNDS, true);
 		}
 		
-		xSemaphoreGive(mram_spi_cache_mutex);
+		mutex_give(mram_spi_cache_mutex);
+	} else {
+		log_error(ELOC_CACHED_PERSISTENT_STATE, ECODE_SPI_MUTEX_TIMEOUT, true);
+	}
+}
+
+
+/* sets up the reading ledger from the one stored before the last reboot
+   (or from scratch if it can't be read) */
+void populate_reading_ledger(void) {
+	static downlink_ledger_t stored_ledger;
+	
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
+	{
+		storage_read_field_unsafe((uint8_t*) &stored_ledger, RAD_SAFE_FIELD_GET(storage_downlink_ledger_size), RAD_SAFE_FIELD_GET(storage_downlink_ledger_addr));
+		restore_reading_ledger(&stored_ledger);
+		mutex_give(mram_spi_cache_mutex);
+	} else {
+		init_reading_ledger();
+		log_error(ELOC_CACHED_PERSISTENT_STATE, ECODE_SPI_MUTEX_TIMEOUT, true);
+	}
+}
+
+/* folds in the stack watermark minimums stored before the last reboot
+   (they start out unknown, so there's nothing to do if they can't be read) */
+void populate_stack_min_free(void) {
+	static uint16_t stored_stack_min_free[RUNTIME_STATS_SLOTS];
+	
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
+	{
+		storage_read_field_unsafe((uint8_t*) stored_stack_min_free, RAD_SAFE_FIELD_GET(storage_stack_min_free_size), RAD_SAFE_FIELD_GET(storage_stack_min_free_addr));
+		restore_stack_min_free(stored_stack_min_free);
+		mutex_give(mram_spi_cache_mutex);
 	} else {
 		log_error(ELOC_CACHED_PERSISTENT_STATE, ECODE_SPI_MUTEX_TIMEOUT, true);
 	}
 }
 
+/* reads the last trace snapshot written (see trace_ring.h), returning
+   whether there was one (it's only for the ground, via trace_convert.py) */
+bool read_trace_snapshot(trace_snapshot_t* snapshot) {
+	bool success = false;
+	if (mutex_take(mram_spi_cache_mutex, MRAM_SPI_MUTEX_WAIT_TIME_TICKS))
+	{
+		success = storage_read_field_unsafe((uint8_t*) snapshot, RAD_SAFE_FIELD_GET(storage_trace_snapshot_size), RAD_SAFE_FIELD_GET(storage_trace_snapshot_addr));
+		mutex_give(mram_spi_cache_mutex);
+	} else {
+		log_error(ELOC_CACHED_PERSISTENT_STATE, ECODE_SPI_MUTEX_TIMEOUT, true);
+	}
+	return success && snapshot->magic == TRACE_SNAPSHOT_MAGIC;
+}
+
 
 /************************************************************************/
 /* Struct compare functions                                              */
@@ -729,50 +826,21 @@ bool compare_persistent_charging_data(persistent_charging_data_t* data1, persist
 /* helper functions using cached state		                            */
 /************************************************************************/
 
-/* 
-	Checks whether the RTOS tick count overflows (it does after 50 days)
-	and if so, adds an offset to it so that the timestamp in seconds will
-	be stable.
-	Returns the tick value in seconds after correction 
-	(can be used in place of xTaskGetTickCount() / portTICK_PERIOD_MS / 1000)
-*/
-uint32_t check_and_correct_tick_wraparound(void) {
-	// before writing timestamp, check if the tick count overflowed.
-	// If it did, reset the processor to reset the timestamp (it's
-	// the only way), AFTER finishing this write to MRAM
-	// (we wouldn't write the timestamp in this case (it'll be wrong)
-	TickType_t cur_ticks = xTaskGetTickCount();
-	if (cur_ticks < prev_get_timestamp_ticks) { // strictly <
-		configASSERT(false); // we generally don't run for 50 days...
-
-		// increase the offset by the max value of the tick count (which just overflowed), 
-		// minus the time since it overflowed (converted to seconds)
-		// (this may not be the first time we overflowed)
-		cached_state_correct_errors();
-		cached_state._tick_count_overflow_offset_s += ((TICK_COUNT_MAX_VALUE - cur_ticks) / portTICK_PERIOD_MS) / 1000;
-		cached_state_sync_redundancy();
-		
-		log_error(ELOC_RTOS, ECODE_TIMESTAMP_WRAPAROUND, true);
-	}
-	prev_get_timestamp_ticks = cur_ticks;
-	return ((xTaskGetTickCount() / portTICK_PERIOD_MS) / 1000) + cached_state._tick_count_overflow_offset_s;
-}
-
 /*
  * Current timestamp in seconds since boot, with an accuracy of +/- the
  * data write task frequency (a reboot could happen at any point in that period
  * due to a watchdog reset). Segment since reboot is accurate to ms.
- * Also handles an RTOS tick count wraparound.
+ * Off the RTC's extended count (see rtc_time.h), so it doesn't wrap around,
+ * and doesn't lock or divide.
  */
 uint32_t get_current_timestamp(void) {
-	return check_and_correct_tick_wraparound() + cached_state._secs_since_launch_at_boot;
+	return rtc_time_counts_to_s(rtc_read_counts_64()) + cached_state._secs_since_launch_at_boot;
 }
 
 /* Current timestamp in ms since boot, with the above described (low) accuracy */
 uint64_t get_current_timestamp_ms(void) {
-	check_and_correct_tick_wraparound(); // update _tick_count_overflow_offset_s if necessary
-	return ((xTaskGetTickCount() / portTICK_PERIOD_MS) / 1000) + cached_state._tick_count_overflow_offset_s
-		+ (1000 * cached_state._secs_since_launch_at_boot);
+	return rtc_time_counts_to_ms(rtc_read_counts_64())
+		+ (1000 * (uint64_t) cached_state._secs_since_launch_at_boot);
 }
 
 /* returns truncated number or orbits since first boot */
@@ -819,6 +887,17 @@ void write_custom_state(void) {
 	storage_write_field_unsafe((uint8_t*) &persistent_charging_data,RAD_SAFE_FIELD_GET(storage_persistent_charging_data_size),	RAD_SAFE_FIELD_GET(storage_persistent_charging_data_addr));
 	storage_write_field_unsafe((uint8_t*) &radio_revive_timestamp,	RAD_SAFE_FIELD_GET(storage_radio_revive_timestamp_size),	RAD_SAFE_FIELD_GET(storage_radio_revive_timestamp_addr));
 
+	// (a zeroed ledger restores to a fresh one)
+	downlink_ledger_t ledger;
+	memset(&ledger, 0, sizeof(downlink_ledger_t));
+	storage_write_field_unsafe((uint8_t*) &ledger,			sizeof(downlink_ledger_t), STORAGE_DOWNLINK_LEDGER_ADDR);
+	// (none seen yet)
+	uint16_t stack_min_free[RUNTIME_STATS_SLOTS];
+	memset(stack_min_free, 0xFF, sizeof(stack_min_free));
+	storage_write_field_unsafe((uint8_t*) stack_min_free,	sizeof(stack_min_free), STORAGE_STACK_MIN_FREE_ADDR);
+	// (no trace snapshot; the same as trace_ring_init)
+	storage_zero_field_unsafe(sizeof(trace_snapshot_t), STORAGE_TRACE_SNAPSHOT_ADDR);
+
 	// write errors
 	storage_write_field_unsafe((uint8_t*) &num_errs,		1, STORAGE_ERR_NUM_ADDR);
 	if (num_errs > 0)
@@ -12,6 +12,8 @@
 #include "Sensor_Structs.h"
 #include "equistack.h"
 #include "../processor_drivers/MRAM_Commands.h"
+#include "../telemetry/downlink_ledger.h"
+#include "trace_ring.h"
 
 /* addressing constants */
 #define STORAGE_SECS_SINCE_LAUNCH_ADDR			20
@@ -24,6 +26,12 @@
 // prog memory address not used here
 #define STORAGE_ERR_NUM_ADDR					60
 #define STORAGE_ERR_LIST_ADDR					64
+// (after the error list: 64 + 2 * MAX_STORED_ERRORS * SAT_ERROR_T_SIZE = 676)
+#define STORAGE_DOWNLINK_LEDGER_ADDR			700
+// (after the ledger, which has room for all 8 message types: 700 + 2 * 8 * 12 = 892)
+#define STORAGE_STACK_MIN_FREE_ADDR				900
+// (after the stack minimums: 900 + 2 * RUNTIME_STATS_SLOTS * 2 = 948)
+#define STORAGE_TRACE_SNAPSHOT_ADDR				960
 
 /* cached state (known) field sizes */
 #define STORAGE_SECS_SINCE_LAUNCH_SIZE			 4
@@ -34,6 +42,9 @@
 #define STORAGE_PERSISTENT_CHARGING_DATA_SIZE	 1
 #define STORAGE_RADIO_REVIVE_TIMESTAMP_SIZE		 4
 #define STORAGE_ERR_NUM_SIZE					 1
+#define STORAGE_DOWNLINK_LEDGER_SIZE			sizeof(downlink_ledger_t)
+#define STORAGE_STACK_MIN_FREE_SIZE				(RUNTIME_STATS_SLOTS * sizeof(uint16_t))
+#define STORAGE_TRACE_SNAPSHOT_SIZE				sizeof(trace_snapshot_t) // (STORAGE_MAX_FIELD_SIZE)
 
 // maximum size of a single MRAM "field," used for global buffers
 #define STORAGE_MAX_FIELD_SIZE				400 // error list
@@ -42,7 +53,6 @@
 // note: not made rad-safe bcs. the probability of being corrupted + being needed is VERY small
 #define MAX_STORED_ERRORS					ERROR_STACK_MAX 
 #define MRAM_SPI_MUTEX_WAIT_TIME_TICKS		((TickType_t) 1500 / portTICK_PERIOD_MS) // ms
-#define TICK_COUNT_MAX_VALUE				(portMAX_DELAY)
 
 /* rad-safe triple-redundant variables used to weather bit flips in crucial fields */
 // addresses
@@ -55,6 +65,9 @@ RAD_SAFE_FIELD_DEFINE(uint32_t, storage_persistent_charging_data_addr);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_radio_revive_timestamp_addr);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_err_num_addr);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_err_list_addr);
+RAD_SAFE_FIELD_DEFINE(uint32_t, storage_downlink_ledger_addr);
+RAD_SAFE_FIELD_DEFINE(uint32_t, storage_stack_min_free_addr);
+RAD_SAFE_FIELD_DEFINE(uint32_t, storage_trace_snapshot_addr);
 // field sizes
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_secs_since_lauch_size);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_reboot_cnt_size);
@@ -64,6 +77,9 @@ RAD_SAFE_FIELD_DEFINE(uint32_t, storage_prog_mem_rewritten_size);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_persistent_charging_data_size);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_radio_revive_timestamp_size);
 RAD_SAFE_FIELD_DEFINE(uint32_t, storage_err_num_size);
+RAD_SAFE_FIELD_DEFINE(uint32_t, storage_downlink_ledger_size);
+RAD_SAFE_FIELD_DEFINE(uint32_t, storage_stack_min_free_size);
+RAD_SAFE_FIELD_DEFINE(uint32_t, storage_trace_snapshot_size);
 
 /* battery-specific state cache (put here for #include reasons) */
 typedef struct persistent_charging_data_t {
@@ -108,15 +124,11 @@ struct persistent_data {
 	persistent_charging_data_t persistent_charging_data;
 	
 	/* fields NOT written to MRAM;  just here for rad redundancy */
-	// the seconds since launch when we booted; add xTaskGetTickCount()/1000 to get current timestamp
+	// the seconds since launch when we booted; add the RTC's seconds to get current timestamp
 	// note: not actually written to MRAM, just used as a basis for the timestamp during
 	// this boot of the OS (updated on every reboot and then kept constant)
 	uint32_t _secs_since_launch_at_boot;
 	
-	// a value to use to shift the tick count component of the current timestamp
-	// in seconds up whenever the tick counter overflows
-	uint32_t _tick_count_overflow_offset_s;
-	
 } cached_state;
 struct persistent_data cached_state_2;
 struct persistent_data cached_state_3;
@@ -159,6 +171,9 @@ persistent_charging_data_t	cache_get_persistent_charging_data(void);
 
 /* functions which require reading from MRAM (bypass cache) */
 void populate_error_stacks(equistack* error_stack);
+void populate_reading_ledger(void);
+void populate_stack_min_free(void);
+bool read_trace_snapshot(trace_snapshot_t* snapshot);
 
 /* helper functions using cached state */
 uint32_t get_current_timestamp(void);
@@ -0,0 +1,117 @@
+/*
+ * runtime_stats.c
+ *
+ * Created: 10/19/2026 9:13:05 AM
+ *  Author: BSE
+ */
+
+#include "runtime_stats.h"
+#include <string.h>
+
+/************************************************************************/
+/* ACCOUNTING                                                           */
+/************************************************************************/
+/* starts with slot running as of now */
+void runtime_stats_init(runtime_stats_t* s, uint8_t slot, uint32_t now) {
+	memset(s, 0, sizeof(runtime_stats_t));
+	s->last_switch = now;
+	s->slice_start = now;
+	s->cur_slot = slot;
+}
+
+/* slot has just been switched in (possibly the same one as before);
+   this runs on every context switch, so keep it short */
+void runtime_stats_switch(runtime_stats_t* s, uint8_t slot, uint32_t now) {
+	s->period_us[s->cur_slot] += now - s->last_switch;
+	s->last_switch = now;
+	if (slot != s->cur_slot) {
+		uint32_t slice = now - s->slice_start;
+		if (slice > s->max_slice_us[s->cur_slot]) {
+			s->max_slice_us[s->cur_slot] = slice;
+		}
+		s->cur_slot = slot;
+		s->slice_start = now;
+	}
+}
+
+/* ends the period as of now (copying it to p) and starts the next one
+   (the running slot's slice so far counts for this period, and starts over for the next) */
+void runtime_stats_close_period(runtime_stats_t* s, uint32_t now, runtime_period_t* p) {
+	s->period_us[s->cur_slot] += now - s->last_switch;
+	uint32_t slice = now - s->slice_start;
+	if (slice > s->max_slice_us[s->cur_slot]) {
+		s->max_slice_us[s->cur_slot] = slice;
+	}
+	s->last_switch = now;
+	s->slice_start = now;
+
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		s->total_us[i] += s->period_us[i];
+		p->total_us[i] = s->total_us[i];
+		p->period_us[i] = s->period_us[i];
+		p->max_slice_us[i] = s->max_slice_us[i];
+		s->period_us[i] = 0;
+		s->max_slice_us[i] = 0;
+	}
+}
+
+/************************************************************************/
+/* REPORTS                                                              */
+/************************************************************************/
+// share of total in thousandths (0 if total is)
+static uint16_t permille(uint64_t part, uint64_t total) {
+	return total == 0 ? 0 : (uint16_t) ((part * 1000 + total / 2) / total);
+}
+
+void runtime_stats_summarize(const runtime_period_t* p, runtime_report_t* r) {
+	uint64_t period_us = 0;
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		period_us += p->period_us[i];
+	}
+	r->period_ms = (uint32_t) (period_us / 1000);
+
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		runtime_slot_report_t* slot = &r->slots[i];
+		slot->total_ms = (uint32_t) (p->total_us[i] / 1000);
+		slot->period_permille = permille(p->period_us[i], period_us);
+		uint32_t max_slice = p->max_slice_us[i] / RUNTIME_STATS_SLICE_US;
+		slot->max_slice = max_slice > 0xFFFF ? 0xFFFF : max_slice;
+	}
+	r->idle_permille = r->slots[RUNTIME_STATS_IDLE_SLOT].period_permille;
+}
+
+// (little-endian, like the rest of the message)
+static void put_le(uint8_t** buf, uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; i++) {
+		*(*buf)++ = value >> (8 * i);
+	}
+}
+
+static uint32_t get_le(const uint8_t** buf, int bytes) {
+	uint32_t value = 0;
+	for (int i = 0; i < bytes; i++) {
+		value |= (uint32_t) *(*buf)++ << (8 * i);
+	}
+	return value;
+}
+
+/* writes r as laid out in msg_format.h (RUNTIME_STATS_REPORT_SIZE bytes) */
+void runtime_stats_pack(const runtime_report_t* r, uint8_t* buf) {
+	put_le(&buf, r->period_ms, 4);
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		put_le(&buf, r->slots[i].total_ms, 4);
+		put_le(&buf, r->slots[i].period_permille, 2);
+		put_le(&buf, r->slots[i].max_slice, 2);
+	}
+	put_le(&buf, r->idle_permille, 2);
+}
+
+void runtime_stats_unpack(const uint8_t* buf, runtime_report_t* r) {
+	r->period_ms = get_le(&buf, 4);
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		r->slots[i].total_ms = get_le(&buf, 4);
+		r->slots[i].period_permille = get_le(&buf, 2);
+		r->slots[i].max_slice = get_le(&buf, 2);
+	}
+	r->idle_permille = get_le(&buf, 2);
+}
@@ -0,0 +1,72 @@
+/*
+ * runtime_stats.h
+ *
+ * Per-task CPU time accounting. The scheduler reports every task switch (see
+ * traceTASK_SWITCHED_IN in FreeRTOSConfig.h) with the time off a free-running
+ * microsecond counter (TC4/TC5, see TC_Commands.h), and each slot keeps:
+ *	- its total time run since boot
+ *	- its time run this period, and so its share of the period
+ *	- the longest it ran this period without being switched out
+ * where the slots are the tasks (by task_type_t), the idle task, and everything
+ * else (the timer daemon and startup tasks). All time is charged to whichever
+ * slot is switched in, so the period's length is the sum of the slots' times
+ * (and counter wraparound doesn't matter so long as there's a switch at least
+ * every ~71 minutes). Closing a period is cheap, so it can be done with the
+ * scheduler locked out; working out the report from it is left for after.
+ * This has no RTOS or ASF includes (the counter value is passed in), so the
+ * ground tools build it too (see telemetry_decoder/).
+ *
+ * Created: 10/19/2026 9:12:40 AM
+ *  Author: BSE
+ */
+
+
+#ifndef RUNTIME_STATS_H_
+#define RUNTIME_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msg_format.h"
+
+// (after the task_type_t slots)
+#define RUNTIME_STATS_IDLE_SLOT			(RUNTIME_STATS_SLOTS - 2)
+#define RUNTIME_STATS_OTHER_SLOT		(RUNTIME_STATS_SLOTS - 1)
+// bytes runtime_stats_pack writes (the start of the packet; see msg_format.h)
+#define RUNTIME_STATS_REPORT_SIZE		(6 + RUNTIME_STATS_SLOTS * RUNTIME_STATS_SLOT_SIZE)
+
+typedef struct runtime_stats {
+	uint64_t total_us[RUNTIME_STATS_SLOTS];		// up to the start of this period
+	uint64_t period_us[RUNTIME_STATS_SLOTS];
+	uint32_t max_slice_us[RUNTIME_STATS_SLOTS];
+	uint32_t last_switch;						// counter at the last switch
+	uint32_t slice_start;						// counter when cur_slot was switched in
+	uint8_t cur_slot;
+} runtime_stats_t;
+
+// what a period closed with
+typedef struct runtime_period {
+	uint64_t total_us[RUNTIME_STATS_SLOTS];		// including the period
+	uint64_t period_us[RUNTIME_STATS_SLOTS];
+	uint32_t max_slice_us[RUNTIME_STATS_SLOTS];
+} runtime_period_t;
+
+typedef struct runtime_slot_report {
+	uint32_t total_ms;				// (wraps after ~49 days)
+	uint16_t period_permille;
+	uint16_t max_slice;				// RUNTIME_STATS_SLICE_US units (saturating)
+} runtime_slot_report_t;
+
+typedef struct runtime_report {
+	uint32_t period_ms;
+	runtime_slot_report_t slots[RUNTIME_STATS_SLOTS];
+	uint16_t idle_permille;
+} runtime_report_t;
+
+void runtime_stats_init(runtime_stats_t* s, uint8_t slot, uint32_t now);
+void runtime_stats_switch(runtime_stats_t* s, uint8_t slot, uint32_t now);
+void runtime_stats_close_period(runtime_stats_t* s, uint32_t now, runtime_period_t* p);
+void runtime_stats_summarize(const runtime_period_t* p, runtime_report_t* r);
+void runtime_stats_pack(const runtime_report_t* r, uint8_t* buf);
+void runtime_stats_unpack(const uint8_t* buf, runtime_report_t* r);
+
+#endif /* RUNTIME_STATS_H_ */
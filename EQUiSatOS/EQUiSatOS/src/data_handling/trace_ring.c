@@ -0,0 +1,63 @@
+/*
+ * trace_ring.c
+ *
+ * Created: 10/19/2026 9:20:58 PM
+ *  Author: BSE
+ */
+
+#include "trace_ring.h"
+#include <string.h>
+
+void trace_ring_init(trace_snapshot_t* ring) {
+	memset(ring, 0, sizeof(trace_snapshot_t));
+}
+
+/* adds a record (over the oldest, once full) unless the ring's frozen;
+   this runs on every context switch, so keep it short */
+void trace_ring_record(trace_snapshot_t* ring, uint32_t time_us, uint8_t task, uint8_t event, uint16_t arg) {
+	if (ring->reason != TRACE_NOT_FROZEN) {
+		return;
+	}
+	trace_record_t* r = &ring->records[ring->next];
+	r->time_us = time_us;
+	r->task = task;
+	r->event = event;
+	r->arg = arg;
+	ring->next = ring->next == TRACE_RING_LEN - 1 ? 0 : ring->next + 1;
+	if (ring->count < TRACE_RING_LEN) {
+		ring->count++;
+	}
+}
+
+/* records the freeze and stops recording; returns whether this froze it
+   (the first reason is kept) */
+bool trace_ring_freeze(trace_snapshot_t* ring, uint32_t time_us, uint8_t task,
+	trace_freeze_reason_t reason, uint32_t timestamp, uint8_t reboot_count)
+{
+	if (ring->reason != TRACE_NOT_FROZEN) {
+		return false;
+	}
+	trace_ring_record(ring, time_us, task, TRACE_EV_FROZEN, reason);
+	ring->magic = TRACE_SNAPSHOT_MAGIC;
+	ring->timestamp = timestamp;
+	ring->reboot_count = reboot_count;
+	ring->reason = reason;
+	return true;
+}
+
+/* the i'th oldest record kept (i < count) */
+const trace_record_t* trace_ring_get(const trace_snapshot_t* ring, uint16_t i) {
+	uint16_t oldest = ring->count < TRACE_RING_LEN ? 0 : ring->next;
+	uint16_t at = oldest + i;
+	return &ring->records[at >= TRACE_RING_LEN ? at - TRACE_RING_LEN : at];
+}
+
+/* 16-bit FNV-1a (folded) of a trace_print format; trace_convert.py does the same */
+uint16_t trace_ring_hash(const char* str) {
+	uint32_t hash = 2166136261UL;
+	while (*str) {
+		hash ^= (uint8_t) *str++;
+		hash *= 16777619UL;
+	}
+	return (uint16_t) ((hash >> 16) ^ hash);
+}
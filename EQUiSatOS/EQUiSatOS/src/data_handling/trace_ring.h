@@ -0,0 +1,79 @@
+/*
+ * trace_ring.h
+ *
+ * A lightweight binary event trace for builds without Tracelyzer (with
+ * TRACE_RING defined in config.h): the last TRACE_RING_LEN events, each the
+ * time off the microsecond counter (see TC_Commands.h), the run time stats
+ * slot of the task running (see runtime_stats.h), an event and an argument.
+ * The events come from the kernel's trace hooks (task switches, blocking and
+ * suspensions; see FreeRTOSConfig.h) and trace_print, which keeps a hash of
+ * its format (not its arguments; trace_convert.py matches the hashes back up
+ * with the trace_print calls in the source).
+ * On a watchdog early warning or a stack overflow the ring is frozen, so it
+ * keeps what led up to it, and written to MRAM by write_state_to_storage_emergency
+ * (it's only written once frozen; the last one stays there until another freeze).
+ * trace_convert.py turns a snapshot into a timeline for chrome://tracing or Perfetto.
+ * This has no RTOS or ASF includes (times are passed in), so it runs on a host
+ * too (see trace_ring_tests.c); the ring itself is in rtos_tasks.c.
+ *
+ * Created: 10/19/2026 9:20:14 PM
+ *  Author: BSE
+ */
+
+
+#ifndef TRACE_RING_H_
+#define TRACE_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// (so a snapshot is exactly STORAGE_MAX_FIELD_SIZE)
+#define TRACE_RING_LEN				48
+#define TRACE_SNAPSHOT_MAGIC		0x31435254	// "TRC1"
+
+/* events (trace_convert.py reads these and the reasons below from here) */
+#define TRACE_EV_NONE				0
+#define TRACE_EV_SWITCHED_IN		1	// (the task is the one switched in)
+#define TRACE_EV_DELAY				2	// blocked until a tick; arg: it (low 16 bits)
+#define TRACE_EV_DELAY_FOR			3	// blocked for ticks; arg: them
+#define TRACE_EV_BLOCK_RECEIVE		4	// blocked taking a mutex / on a queue; arg: it (low 16 bits of its address)
+#define TRACE_EV_BLOCK_SEND			5	// blocked giving to a queue; arg: it
+#define TRACE_EV_NOTIFY_WAIT		6	// blocked waiting on a notification
+#define TRACE_EV_SUSPEND			7	// arg: slot of the task suspended
+#define TRACE_EV_RESUME				8	// arg: slot of the task resumed
+#define TRACE_EV_PRINT				9	// trace_print; arg: trace_ring_hash of its format
+#define TRACE_EV_FROZEN				10	// (always the last); arg: trace_freeze_reason_t
+
+typedef enum {
+	TRACE_NOT_FROZEN = 0,
+	TRACE_FROZEN_WATCHDOG,			// watchdog early warning
+	TRACE_FROZEN_STACK_OVERFLOW
+} trace_freeze_reason_t;
+
+typedef struct {
+	uint32_t time_us;
+	uint8_t task;
+	uint8_t event;
+	uint16_t arg;
+} trace_record_t;
+
+// the ring, which is also the snapshot written to MRAM
+typedef struct {
+	uint32_t magic;					// (set once frozen)
+	uint32_t timestamp;				// secs since launch when frozen
+	uint16_t next;					// where the next record goes (the oldest, once full)
+	uint16_t count;					// records kept (up to TRACE_RING_LEN)
+	uint8_t reason;					// trace_freeze_reason_t
+	uint8_t reboot_count;			// (when frozen)
+	uint8_t _reserved[2];
+	trace_record_t records[TRACE_RING_LEN];
+} trace_snapshot_t;
+
+void trace_ring_init(trace_snapshot_t* ring);
+void trace_ring_record(trace_snapshot_t* ring, uint32_t time_us, uint8_t task, uint8_t event, uint16_t arg);
+bool trace_ring_freeze(trace_snapshot_t* ring, uint32_t time_us, uint8_t task,
+	trace_freeze_reason_t reason, uint32_t timestamp, uint8_t reboot_count);
+const trace_record_t* trace_ring_get(const trace_snapshot_t* ring, uint16_t i);
+uint16_t trace_ring_hash(const char* str);
+
+#endif /* TRACE_RING_H_ */
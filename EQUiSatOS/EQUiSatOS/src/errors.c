@@ -180,7 +180,7 @@ void add_error_to_equistack(equistack* stack, sat_error_t* new_error) {
 	// is in a consistent state, and ensures that the mutex grabs in
 	// the "safe" equistack functions don't result in infinite recursion 
 	// by logging an error if they can't get a mutex
-	bool got_mutex = xSemaphoreTake(stack->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
+	bool got_mutex = mutex_take(stack->mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
 	// would log error if we didn't get it, but we can't!
 	{
 		sat_error_t* newest_same_error = NULL;
@@ -243,7 +243,7 @@ void add_error_to_equistack(equistack* stack, sat_error_t* new_error) {
 			#endif
 		}
 	}
-	if (got_mutex) xSemaphoreGive(stack->mutex);
+	if (got_mutex) mutex_give(stack->mutex);
 }
 
 // removes priority bit from error code
@@ -6,6 +6,9 @@
  */ 
 
 #include "global.h"
+#ifdef EQUISIM_SIMULATE_RADIO
+	#include "testing_functions/equisim_radio.h"
+#endif
 
 #if PRINT_DEBUG > 0 // if using debug print
 	#define DEBUG_BUF_SIZE		128
@@ -104,6 +107,9 @@ void global_init(void) {
 	#ifdef EQUISIM_SIMULATE_BATTERIES
 		equisim_init();
 	#endif
+	#ifdef EQUISIM_SIMULATE_RADIO
+		equisim_radio_init(NULL); // default config (after the RS tables are set up)
+	#endif
 }
 
 // initialization that can only be done with RTOS started
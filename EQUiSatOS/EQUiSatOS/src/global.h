@@ -64,6 +64,10 @@ void print(const char *format, ...);
 #if configUSE_TRACE_FACILITY == 1
 	// http://www.delorie.com/gnu/docs/gcc/gcc_44.html
 	#define trace_print(format, ...) vTracePrintF(global_trace_channel, format, ##__VA_ARGS__);
+#elif defined(TRACE_RING)
+	// (just which print it was; see trace_ring.h)
+	void trace_ring_print(const char* format);
+	#define trace_print(format, ...) trace_ring_print(format);
 #else
 	#define trace_print(...) ((void)0);
 #endif
@@ -15,6 +15,34 @@ void run_tests(void) {
 	//assert_transmission_constants();
 	//pointer_typecast_test();
 	//longest_same_seq_len_test();
+	//test_fixed_point_conversions();
+	//benchmark_fixed_point_conversions();
+	//imu_window_reduce_test();
+	//rx_matcher_fuzz_test();
+	//benchmark_rx_matcher();
+	//uplink_reply_replay_test();
+	//radio_link_command_mode_test();
+	//radio_link_goodput_test();
+	//downlink_sched_replay_test();
+	//radio_hk_virtual_radio_test();
+	//radio_hk_busy_benchmark();
+	//usart_rx_ring_stress_test();
+	//usart_baud_table_test();
+	//downlink_ledger_replay_test();
+	//runtime_stats_test();
+	//mutex_stats_test();
+	//heartbeat_test();
+	//heartbeat_report_timing_test();
+	//tickless_test();
+	//task_transition_test();
+	//task_transition_latency_test();
+	//battery_snapshot_test();
+	//battery_snapshot_load_test();
+	//rtc_time_test();
+	//benchmark_rtc_time();
+	//trace_ring_test();
+	//benchmark_trace_ring();
+	//dump_trace_snapshot();
 	//radioTest();
 
 	//system_test();
@@ -31,6 +59,11 @@ void run_tests(void) {
 //		- OVERRIDE_STATE_HOLD_INIT to define whether to NOT change states automatically
 //  - (make sure RTOS is started)
 void run_rtos_tests(void) {
+	//sensor_transaction_test();
+	//imu_window_i2c_benchmark();
+	//regulator_cache_scenario_test();
+	//mux_scan_latency_test();
+	//usart_tx_suspension_test();
 	vTaskDelay(2000); // don't be a CPU hog
 }
 
@@ -14,6 +14,28 @@
 #include "runnable_configurations/scratch_testing.h"
 #include "testing_functions/test_stacks.h"
 #include "testing_functions/system_test.h"
+#include "testing_functions/fixed_point_tests.h"
+#include "testing_functions/sensor_transaction_tests.h"
+#include "testing_functions/imu_window_tests.h"
+#include "testing_functions/regulator_cache_tests.h"
+#include "testing_functions/mux_scan_tests.h"
+#include "testing_functions/usart_tx_tests.h"
+#include "testing_functions/rx_matcher_tests.h"
+#include "testing_functions/uplink_reply_tests.h"
+#include "testing_functions/radio_link_tests.h"
+#include "testing_functions/downlink_sched_tests.h"
+#include "testing_functions/radio_hk_tests.h"
+#include "testing_functions/usart_rx_ring_tests.h"
+#include "testing_functions/usart_baud_tests.h"
+#include "testing_functions/downlink_ledger_tests.h"
+#include "testing_functions/runtime_stats_tests.h"
+#include "testing_functions/mutex_stats_tests.h"
+#include "testing_functions/heartbeat_tests.h"
+#include "testing_functions/tickless_tests.h"
+#include "testing_functions/task_transition_tests.h"
+#include "testing_functions/battery_snapshot_tests.h"
+#include "testing_functions/rtc_time_tests.h"
+#include "testing_functions/trace_ring_tests.h"
 
 void run_tests(void);
 void run_rtos_tests(void);
@@ -7,6 +7,9 @@
 
 #include "I2C_Commands.h"
 
+// number of packets (i.e. start conditions) sent on the bus, to profile bus usage
+static uint32_t i2c_transaction_count = 0;
+
 /*
 	Configures I2C connection with standard settings and custom functions
 */
@@ -59,6 +62,7 @@ void i2c_send_stop(void) {
 */
 enum status_code i2c_read_command(struct i2c_master_packet* packet_address)
 {
+	i2c_transaction_count++;
 	return i2c_master_read_packet_wait(&i2c_master_instance, packet_address);
 	//i2c_master_read_packet_wait_no_nack(&i2c_master_instance, packet_address);
 }
@@ -69,6 +73,7 @@ enum status_code i2c_read_command(struct i2c_master_packet* packet_address)
 */
 enum status_code i2c_read_command_nostop(struct i2c_master_packet* packet_address)
 {
+	i2c_transaction_count++;
 	return i2c_master_read_packet_wait_no_stop(&i2c_master_instance, packet_address);
 }
 
@@ -77,6 +82,7 @@ enum status_code i2c_read_command_nostop(struct i2c_master_packet* packet_addres
 */
 enum status_code i2c_write_command(struct i2c_master_packet* packet_address)
 {
+	i2c_transaction_count++;
 	return i2c_master_write_packet_wait(&i2c_master_instance, packet_address);
 }
 
@@ -85,9 +91,18 @@ enum status_code i2c_write_command(struct i2c_master_packet* packet_address)
 */
 enum status_code i2c_write_command_nostop(struct i2c_master_packet* packet_address)
 {
+	i2c_transaction_count++;
 	return i2c_master_write_packet_wait_no_stop(&i2c_master_instance, packet_address);
 }
 
+/*
+	Number of I2C packets sent since boot (all devices)
+*/
+uint32_t get_i2c_transaction_count(void)
+{
+	return i2c_transaction_count;
+}
+
 /*
 	Write data of length len to address address on the i2c bus
 */
@@ -22,6 +22,7 @@ enum status_code i2c_read_command(struct i2c_master_packet* packet_address);
 enum status_code i2c_read_command_nostop(struct i2c_master_packet* packet_address);
 enum status_code i2c_write_command(struct i2c_master_packet* packet_address);
 enum status_code i2c_write_command_nostop(struct i2c_master_packet* packet_address);
+uint32_t get_i2c_transaction_count(void);
 
 enum status_code writeDataToAddress(uint8_t* data, uint8_t len, uint8_t address, bool should_stop);
 enum status_code writeDataToAddressSub(uint8_t* data, uint8_t len, uint8_t address, uint8_t* subAddress, bool should_stop);
@@ -9,16 +9,21 @@
 
 #include "RTC_Commands.h"
 
+// times the 32-bit count has overflowed since init_rtc (see rtc_time.h)
+static volatile uint32_t rtc_overflows = 0;
+
 void init_rtc(void)
 {
 	struct rtc_count_config config_rtc_count;
 	rtc_count_get_config_defaults(&config_rtc_count);
 
-	// These are all defaults but will set them explicitly anyway
-	config_rtc_count.prescaler = RTC_COUNT_PRESCALER_DIV_1024;
+	// GCLK2 runs at 1024 Hz (it's the watchdog's clock too, so it can't change);
+	// count that undivided so the RTC can time tickless idle sleeps (see tickless_idle.h)
+	config_rtc_count.prescaler = RTC_COUNT_PRESCALER_DIV_1;
 	config_rtc_count.mode = RTC_COUNT_MODE_32BIT;
 	config_rtc_count.clear_on_match = false;
-	config_rtc_count.continuously_update = false;
+	// (reading the count otherwise waits on a sync with the slow clock each time)
+	config_rtc_count.continuously_update = true;
 
 	int status_code = 0;
 	int retries = 0;
@@ -33,11 +38,69 @@ void init_rtc(void)
 	{
 		system_reset();
 	} else {
+		rtc_overflows = 0;
 		rtc_count_enable(&rtc_instance);
+		// the compare match only wakes the processor from sleep
+		RTC->MODE0.INTENCLR.reg = RTC_MODE0_INTENCLR_CMP0;
+		RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0 | RTC_MODE0_INTFLAG_OVF;
+		RTC->MODE0.INTENSET.reg = RTC_MODE0_INTENSET_OVF;
+		NVIC_EnableIRQ(RTC_IRQn);
 	}
 }
 
+/* seconds since init_rtc */
 int get_rtc_count(void)
 {
-	return rtc_count_get_count(&rtc_instance);
+	return rtc_count_get_count(&rtc_instance) / RTC_COUNTS_PER_S;
+}
+
+/* raw count since init_rtc (RTC_COUNTS_PER_S per second) */
+uint32_t rtc_read_counts(void)
+{
+	return RTC->MODE0.COUNT.reg;
+}
+
+/* count since init_rtc, extended past 32 bits (so it never overflows);
+   lock-free, so it's fine from any task or interrupt */
+uint64_t rtc_read_counts_64(void)
+{
+	uint32_t overflows, count;
+	bool overflow_pending;
+	do {
+		overflows = rtc_overflows;
+		count = RTC->MODE0.COUNT.reg;
+		overflow_pending = RTC->MODE0.INTFLAG.reg & RTC_MODE0_INTFLAG_OVF;
+	} while (overflows != rtc_overflows);
+	return rtc_time_extend(overflows, count, overflow_pending);
+}
+
+/* sets the RTC to interrupt (waking the processor) when it reaches count at;
+   NOTE the compare takes a few counts to sync, so at must be a few counts away */
+void rtc_set_wake(uint32_t at)
+{
+	while (RTC->MODE0.STATUS.reg & RTC_STATUS_SYNCBUSY);
+	RTC->MODE0.COMP[0].reg = at;
+	RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+	RTC->MODE0.INTENSET.reg = RTC_MODE0_INTENSET_CMP0;
+}
+
+void rtc_clear_wake(void)
+{
+	RTC->MODE0.INTENCLR.reg = RTC_MODE0_INTENCLR_CMP0;
+	RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+}
+
+// (the wake compare's only for waking; the overflow extends the count)
+void RTC_Handler(void)
+{
+	if (RTC->MODE0.INTFLAG.reg & RTC_MODE0_INTFLAG_OVF)
+	{
+		// the count read back lags the RTC's by a sync; wait until it shows the
+		// overflow, so no read sees the new overflow count with the old count
+		// (a millisecond or two, once every ~48 days)
+		while (RTC->MODE0.COUNT.reg >= RTC_TIME_COUNT_HALF);
+		RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_OVF;
+		rtc_overflows++;
+	}
+	RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
 }
\ No newline at end of file
@@ -8,12 +8,19 @@
 #define _RTC_COMMANDS_H
 
 #include <global.h>
+#include "rtc_time.h"
 
 /* NOTE: The conf_clocks.h file must have set CONF_CLOCK_OSC32K_ENABLE and CONF_CLOCK_GCLK_2_ENABLE to true */
 
+#define RTC_COUNTS_PER_S	1024
+
 struct rtc_module rtc_instance;
 
 void init_rtc(void);
 int get_rtc_count(void);
+uint32_t rtc_read_counts(void);
+uint64_t rtc_read_counts_64(void);
+void rtc_set_wake(uint32_t at);
+void rtc_clear_wake(void);
 
 #endif
\ No newline at end of file
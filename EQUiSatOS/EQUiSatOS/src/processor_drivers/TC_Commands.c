@@ -0,0 +1,39 @@
+/*
+ * TC_Commands.c
+ *
+ * Created: 10/19/2026 9:03:20 AM
+ *  Author: BSE
+ */
+
+#include "TC_Commands.h"
+
+static void wait_for_sync(void) {
+	while (RUNTIME_COUNTER_TC->COUNT32.STATUS.reg & TC_STATUS_SYNCBUSY);
+}
+
+void configure_runtime_counter(void) {
+	/* Turn on both modules in PM (TC5 is the upper half of the count) */
+	system_apb_clock_set_mask(SYSTEM_CLOCK_APB_APBC, PM_APBCMASK_TC4 | PM_APBCMASK_TC5);
+	/* Generic clock for the pair, from generator 0 (the default) */
+	struct system_gclk_chan_config gclk_chan_conf;
+	system_gclk_chan_get_config_defaults(&gclk_chan_conf);
+	system_gclk_chan_set_config(RUNTIME_COUNTER_GCLK_ID, &gclk_chan_conf);
+	system_gclk_chan_enable(RUNTIME_COUNTER_GCLK_ID);
+
+	RUNTIME_COUNTER_TC->COUNT32.CTRLA.reg = TC_CTRLA_SWRST;
+	while (RUNTIME_COUNTER_TC->COUNT32.CTRLA.reg & TC_CTRLA_SWRST);
+	wait_for_sync();
+
+	/* 32-bit count up from 0 to 0xFFFFFFFF and around (no compare, no interrupts),
+	at 8 MHz (configCPU_CLOCK_HZ) / 8 = RUNTIME_COUNTER_HZ */
+	RUNTIME_COUNTER_TC->COUNT32.CTRLA.reg = TC_CTRLA_MODE_COUNT32 |
+		TC_CTRLA_WAVEGEN_NFRQ |
+		TC_CTRLA_PRESCALER_DIV8 |
+		TC_CTRLA_PRESCSYNC_PRESC;
+	wait_for_sync();
+	/* keep COUNT synchronized, so it can be read straight off */
+	RUNTIME_COUNTER_TC->COUNT32.READREQ.reg = TC_READREQ_RCONT | TC_READREQ_ADDR(TC_COUNT32_COUNT_OFFSET);
+
+	RUNTIME_COUNTER_TC->COUNT32.CTRLA.reg |= TC_CTRLA_ENABLE;
+	wait_for_sync();
+}
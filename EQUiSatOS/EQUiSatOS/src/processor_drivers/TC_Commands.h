@@ -0,0 +1,31 @@
+/*
+ * TC_Commands.h
+ *
+ * Free-running microsecond counter for timing task run times (see runtime_stats.h),
+ * on TC4 and TC5 chained into one 32-bit counter. It's clocked off GCLK0 (the
+ * 8 MHz CPU clock) divided by 8, so wraps every ~71 minutes; users only ever take
+ * differences. There's no ASF TC driver in the project, so the registers are set
+ * directly (TCC0 is the PWM; TC3 is left free).
+ *
+ * Created: 10/19/2026 9:02:51 AM
+ *  Author: BSE
+ */
+
+
+#ifndef TC_COMMANDS_H_
+#define TC_COMMANDS_H_
+
+#include <system.h>
+
+#define RUNTIME_COUNTER_TC			TC4
+#define RUNTIME_COUNTER_GCLK_ID		TC4_GCLK_ID
+#define RUNTIME_COUNTER_HZ			1000000
+
+void configure_runtime_counter(void);
+
+/* counter value in microseconds (continuously synchronized, so reading doesn't wait) */
+static inline uint32_t runtime_counter_read(void) {
+	return RUNTIME_COUNTER_TC->COUNT32.COUNT.reg;
+}
+
+#endif /* TC_COMMANDS_H_ */
@@ -6,13 +6,18 @@
  */
 
 #include "USART_Commands.h"
+#ifdef EQUISIM_SIMULATE_RADIO
+	#include "../testing_functions/equisim_radio.h"
+#endif
 
 uint8_t edbg_rx_data,ext_rx_data;
+static uint32_t ext_usart_clock_hz;
 
 void USART_init() {	
 	ext_usart_clock_init();
 	ext_usart_pin_init();
 	ext_usart_init();
+	usart_tx_dma_init();
 
 	#if PRINT_DEBUG != 0
 		// if printing, make sure the USART is not sent to the radio
@@ -21,22 +26,110 @@ void USART_init() {
 	#endif
 }
 
+// received bytes for the task capturing them (if any); see usart_rx_ring.h
+static usart_rx_ring_t usart_rx_ring;
+static TaskHandle_t volatile usart_rx_consumer = NULL;
+
 //Receive handler
 void SERCOM3_Handler(void)
 {
+	if (SERCOM3->USART.STATUS.bit.BUFOVF) {
+		// (bytes came in faster than we read them out of the SERCOM)
+		usart_rx_ring.hw_overruns++;
+		SERCOM3->USART.STATUS.reg = SERCOM_USART_STATUS_BUFOVF;
+	}
 	if (SERCOM3->USART.INTFLAG.bit.RXC) {
-		radio_receive_buffer[receiveIndex] = SERCOM3->USART.DATA.reg;
-		receiveIndex++;
-		check_rx_received();
-		if (receiveIndex >= LEN_RECEIVEBUFFER - 1) {
-			receiveIndex = 0;
-		}
+		usart_receive_byte(SERCOM3->USART.DATA.reg);
+	}
+}
+
+// handles a byte from the radio (from the receive interrupt, or the simulated radio)
+void usart_receive_byte(uint8_t rx_byte) {
+	radio_receive_buffer[receiveIndex] = rx_byte;
+	receiveIndex++;
+	check_rx_received(rx_byte);
+	if (receiveIndex >= LEN_RECEIVEBUFFER - 1) {
+		receiveIndex = 0;
+	}
+	
+	// only wake the capturing task once enough bytes are waiting (or the line's idle; see usart_rx_tick)
+	TaskHandle_t consumer = usart_rx_consumer;
+	if (consumer != NULL && usart_rx_ring_put(&usart_rx_ring, rx_byte)) {
+		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+		xTaskNotifyFromISR(consumer, USART_RX_NOTIFY_BIT, eSetBits, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 	}
 }
 
 void clear_USART_rx_buffer(void) {
 	memset(radio_receive_buffer, 0, LEN_RECEIVEBUFFER);
 	receiveIndex = 0;
+	reset_uplink_matcher();
+	if (usart_rx_consumer != NULL && usart_rx_consumer == xTaskGetCurrentTaskHandle()) {
+		// drop what the capturing task hasn't read, and any event for it
+		usart_rx_ring_flush(&usart_rx_ring);
+		xTaskNotifyWait(0, USART_RX_NOTIFY_BIT, NULL, 0);
+	}
+}
+
+/* starts keeping received bytes for the calling task to read (dropping any before) */
+void usart_rx_capture_start(void) {
+	taskENTER_CRITICAL();
+	usart_rx_ring_flush(&usart_rx_ring);
+	usart_rx_ring.reported_head = usart_rx_ring.head;
+	usart_rx_ring.tick_head = usart_rx_ring.head;
+	usart_rx_ring.idle_ticks = 0;
+	usart_rx_consumer = xTaskGetCurrentTaskHandle();
+	taskEXIT_CRITICAL();
+	xTaskNotifyWait(0, USART_RX_NOTIFY_BIT, NULL, 0);
+}
+
+void usart_rx_capture_stop(void) {
+	usart_rx_consumer = NULL;
+	usart_rx_ring_flush(&usart_rx_ring);
+}
+
+/* reads up to max captured bytes (oldest first); returns how many */
+uint16_t usart_rx_read(uint8_t* buf, uint16_t max) {
+	return usart_rx_ring_read(&usart_rx_ring, buf, max);
+}
+
+/* blocks the capturing task until USART_RX_NOTIFY_THRESHOLD bytes have arrived
+   or received bytes are followed by the line going idle, or timeout;
+   returns whether that happened */
+bool usart_rx_wait(TickType_t timeout_ticks) {
+	TickType_t deadline = xTaskGetTickCount() + timeout_ticks;
+	for (;;) {
+		TickType_t now = xTaskGetTickCount();
+		TickType_t wait = (int32_t) (deadline - now) > 0 ? deadline - now : 0;
+		uint32_t bits = 0;
+		// (other notification bits may wake us; keep waiting for ours)
+		if (xTaskNotifyWait(0, USART_RX_NOTIFY_BIT, &bits, wait) && (bits & USART_RX_NOTIFY_BIT)) {
+			return true;
+		}
+		if (wait == 0) {
+			return false;
+		}
+	}
+}
+
+/* from the tick hook; notifies the capturing task once bytes are waiting and the line's idle */
+void usart_rx_tick(void) {
+	TaskHandle_t consumer = usart_rx_consumer;
+	if (consumer != NULL && usart_rx_ring_tick(&usart_rx_ring)) {
+		// (the tick switches to it itself if it's higher priority)
+		xTaskNotifyFromISR(consumer, USART_RX_NOTIFY_BIT, eSetBits, NULL);
+	}
+}
+
+/* whether usart_rx_tick is waiting out the line going idle (so the tick can't stop) */
+bool usart_rx_tick_needed(void) {
+	return usart_rx_consumer != NULL && usart_rx_ring.head != usart_rx_ring.reported_head;
+}
+
+/* for the counters */
+const usart_rx_ring_t* get_usart_rx_ring(void) {
+	return &usart_rx_ring;
 }
 
 /*Assigning pin to the alternate peripheral function*/
@@ -73,6 +166,7 @@ static uint64_t long_division(uint64_t n, uint64_t d)
 }
 /*
 * internal Calculate asynchronous baudrate value (UART)
+* (the reference for usart_baud.h; too slow to use on the M0+)
 */
 uint16_t calculate_baud_value(const uint32_t baudrate, const uint32_t peripheral_clock, uint8_t sample_num)
 {
@@ -95,6 +189,7 @@ uint16_t calculate_baud_value(const uint32_t baudrate, const uint32_t peripheral
 #ifdef XPLAINED_PRO
 
 	#define EXT_USART_SERCOM			SERCOM2
+	#define EXT_USART_DMAC_ID_TX		SERCOM2_DMAC_ID_TX
 	#define EXT_USART_TX_PIN			PINMUX_PA08D_SERCOM2_PAD0
 	#define EXT_USART_RX_PIN			PINMUX_PA09D_SERCOM2_PAD1
 	
@@ -115,9 +210,9 @@ uint16_t calculate_baud_value(const uint32_t baudrate, const uint32_t peripheral
 	/* External connector(SERCOM2) UART initialization */
 	void ext_usart_init(void)
 	{
-	uint16_t baud_value;
-	baud_value = calculate_baud_value(USART_BAUD_RATE,system_gclk_chan_get_hz(SERCOM2_GCLK_ID_CORE), // CHANGED FROM SERCOM3
-	USART_SAMPLE_NUM);
+	// (the clock's fixed once set up, so baud changes don't have to ask again)
+	ext_usart_clock_hz = system_gclk_chan_get_hz(SERCOM2_GCLK_ID_CORE);
+	uint16_t baud_value = usart_baud_value(USART_BAUD_RATE, ext_usart_clock_hz, USART_SAMPLE_NUM);
 	/* By setting the DORD bit LSB is transmitted first and setting the RXPO bit as
 	1 corresponding SERCOM PAD[1] will be used for data reception RXD, PAD[0] will be used as TxD
 	pin by setting TXPO bit as 0, 16x over-sampling is selected by setting the SAMPR bit as 0,
@@ -156,6 +251,7 @@ uint16_t calculate_baud_value(const uint32_t baudrate, const uint32_t peripheral
 #ifdef CTRL_BRD_V3
 
 	#define EXT_USART_SERCOM			SERCOM3
+	#define EXT_USART_DMAC_ID_TX		SERCOM3_DMAC_ID_TX
 	#define EXT_USART_RX_PIN			PINMUX_PA25C_SERCOM3_PAD3
 	#define EXT_USART_TX_PIN			PINMUX_PA24C_SERCOM3_PAD2
 	
@@ -176,9 +272,9 @@ uint16_t calculate_baud_value(const uint32_t baudrate, const uint32_t peripheral
 	/* External connector(SERCOM3) UART initialization */
 	void ext_usart_init(void)
 	{
-	uint16_t baud_value;
-	baud_value = calculate_baud_value(USART_BAUD_RATE,system_gclk_chan_get_hz(SERCOM3_GCLK_ID_CORE),
-	USART_SAMPLE_NUM);
+	// (the clock's fixed once set up, so baud changes don't have to ask again)
+	ext_usart_clock_hz = system_gclk_chan_get_hz(SERCOM3_GCLK_ID_CORE);
+	uint16_t baud_value = usart_baud_value(USART_BAUD_RATE, ext_usart_clock_hz, USART_SAMPLE_NUM);
 	/* By setting the DORD bit LSB is transmitted first and setting the RXPO bit as
 	1 corresponding SERCOM PAD[1] will be used for data reception RXD, PAD[0] will be used as TxD
 	pin by setting TXPO bit as 0, 16x over-sampling is selected by setting the SAMPR bit as 0,
@@ -220,8 +316,136 @@ void ext_usart_pin_init(void)
 	pin_set_peripheral_function(EXT_USART_TX_PIN);
 }
 
+/* switches the radio USART's baud rate (BAUD can only be written with the SERCOM
+   disabled); anything in flight is cut off. Returns false if the rate can't be
+   done off the SERCOM clock */
+bool usart_set_baud_rate(uint32_t baudrate) {
+	uint16_t baud_value = usart_baud_value(baudrate, ext_usart_clock_hz, USART_SAMPLE_NUM);
+	if (baud_value == 0) {
+		return false;
+	}
+	EXT_USART_SERCOM->USART.CTRLA.reg &= ~SERCOM_USART_CTRLA_ENABLE;
+	while(EXT_USART_SERCOM->USART.SYNCBUSY.reg & SERCOM_USART_SYNCBUSY_ENABLE);
+	EXT_USART_SERCOM->USART.BAUD.reg = baud_value;
+	EXT_USART_SERCOM->USART.CTRLA.reg |= SERCOM_USART_CTRLA_ENABLE;
+	while(EXT_USART_SERCOM->USART.SYNCBUSY.reg & SERCOM_USART_SYNCBUSY_ENABLE);
+	return true;
+}
+
+/************************************************************************/
+/* DMA TRANSMIT                                                         */
+/************************************************************************/
+// The DMAC feeds DATA a byte at a time on the SERCOM's DRE trigger, so the
+// buffer goes out back-to-back regardless of what the CPU is doing (tasks
+// keep running; there's no scheduler suspension needed to keep it contiguous).
+// Only one channel is used, so the descriptor "arrays" are a single entry.
+COMPILER_ALIGNED(16) static DmacDescriptor usart_tx_dma_descriptor;
+COMPILER_ALIGNED(16) static DmacDescriptor usart_tx_dma_writeback;
+
+static volatile bool usart_tx_dma_busy = false;
+static volatile bool usart_tx_dma_error = false;
+
+static StaticSemaphore_t _usart_tx_done_sem_d;
+static SemaphoreHandle_t usart_tx_done_sem;
+
+void usart_tx_dma_init(void) {
+	usart_tx_done_sem = xSemaphoreCreateBinaryStatic(&_usart_tx_done_sem_d);
+
+	system_ahb_clock_set_mask(PM_AHBMASK_DMAC);
+	system_apb_clock_set_mask(SYSTEM_CLOCK_APB_APBB, PM_APBBMASK_DMAC);
+
+	DMAC->CTRL.reg &= ~DMAC_CTRL_DMAENABLE;
+	DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+	while (DMAC->CTRL.reg & DMAC_CTRL_SWRST);
+	DMAC->BASEADDR.reg = (uint32_t) &usart_tx_dma_descriptor;
+	DMAC->WRBADDR.reg = (uint32_t) &usart_tx_dma_writeback;
+	DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN0;
+
+	/* one byte per DRE trigger, from the buffer into the USART DATA register */
+	DMAC->CHID.reg = DMAC_CHID_ID(USART_TX_DMA_CHANNEL);
+	DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+	DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+	while (DMAC->CHCTRLA.reg & DMAC_CHCTRLA_SWRST);
+	DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) |
+		DMAC_CHCTRLB_TRIGSRC(EXT_USART_DMAC_ID_TX) |
+		DMAC_CHCTRLB_TRIGACT_BEAT;
+	DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL | DMAC_CHINTENSET_TERR;
+	system_interrupt_enable(DMAC_IRQn);
+}
+
+// transfer done (or bus error); wakes the task waiting in usart_tx_dma_wait
+void DMAC_Handler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	DMAC->CHID.reg = DMAC_CHID_ID(USART_TX_DMA_CHANNEL);
+	uint8_t flags = DMAC->CHINTFLAG.reg;
+	DMAC->CHINTFLAG.reg = flags; // clear
+	if (flags & (DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR)) {
+		usart_tx_dma_error = (flags & DMAC_CHINTFLAG_TERR) != 0;
+		usart_tx_dma_busy = false;
+		xSemaphoreGiveFromISR(usart_tx_done_sem, &xHigherPriorityTaskWoken);
+	}
+	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+}
+
+/* starts sending len bytes of buf; buf must stay valid until usart_tx_dma_wait returns */
+bool usart_tx_dma_start(const uint8_t *buf, int len) {
+	if (len <= 0 || usart_tx_dma_busy) {
+		return false;
+	}
+	xSemaphoreTake(usart_tx_done_sem, 0); // drop any completion left from an aborted transfer
+	#ifdef EQUISIM_SIMULATE_RADIO
+		if (equisim_radio_usart_tx(buf, len)) {
+			usart_tx_dma_error = false;
+			xSemaphoreGive(usart_tx_done_sem);
+			return true;
+		}
+	#endif
+
+	// (SRCADDR is the address just past the last beat when incrementing)
+	usart_tx_dma_descriptor.BTCTRL.reg = DMAC_BTCTRL_VALID |
+		DMAC_BTCTRL_BEATSIZE_BYTE |
+		DMAC_BTCTRL_SRCINC |
+		DMAC_BTCTRL_BLOCKACT_NOACT;
+	usart_tx_dma_descriptor.BTCNT.reg = len;
+	usart_tx_dma_descriptor.SRCADDR.reg = (uint32_t) (buf + len);
+	usart_tx_dma_descriptor.DSTADDR.reg = (uint32_t) &EXT_USART_SERCOM->USART.DATA.reg;
+	usart_tx_dma_descriptor.DESCADDR.reg = 0;
+
+	usart_tx_dma_error = false;
+	usart_tx_dma_busy = true;
+	DMAC->CHID.reg = DMAC_CHID_ID(USART_TX_DMA_CHANNEL);
+	DMAC->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+	return true;
+}
+
+/* blocks the calling task (only) until the transfer started by usart_tx_dma_start
+   has been handed to the USART; aborts it and returns false on timeout or error */
+bool usart_tx_dma_wait(TickType_t timeout_ticks) {
+	if (xSemaphoreTake(usart_tx_done_sem, timeout_ticks)) {
+		return !usart_tx_dma_error;
+	}
+	DMAC->CHID.reg = DMAC_CHID_ID(USART_TX_DMA_CHANNEL);
+	DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+	while (DMAC->CHCTRLA.reg & DMAC_CHCTRLA_ENABLE);
+	usart_tx_dma_busy = false;
+	return false;
+}
+
+bool usart_tx_dma_in_progress(void) {
+	return usart_tx_dma_busy;
+}
+
+/************************************************************************/
+/* BLOCKING TRANSMIT                                                    */
+/************************************************************************/
+// (both wait out any DMA transfer first so bytes can't be interleaved into it)
 void usart_send_buf(const uint8_t *str_buf, int len)
 {
+	while (usart_tx_dma_busy) {}
+	#ifdef EQUISIM_SIMULATE_RADIO
+		if (equisim_radio_usart_tx(str_buf, len)) return;
+	#endif
 	for (int i = 0; i < len; i++)
 	{
 		while(!(EXT_USART_SERCOM->USART.INTFLAG.bit.DRE));
@@ -232,6 +456,10 @@ void usart_send_buf(const uint8_t *str_buf, int len)
 
 void usart_send_string(const uint8_t *str_buf)
 {
+	while (usart_tx_dma_busy) {}
+	#ifdef EQUISIM_SIMULATE_RADIO
+		if (equisim_radio_usart_tx(str_buf, strlen((const char*) str_buf))) return;
+	#endif
 	while (*str_buf != '\0')
 	{
 		while(!(EXT_USART_SERCOM->USART.INTFLAG.bit.DRE));
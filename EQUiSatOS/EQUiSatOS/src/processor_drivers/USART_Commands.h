@@ -10,10 +10,21 @@
 #define USART_COMMANDS_H_
 
 #include <global.h>
+#include "usart_rx_ring.h"
+#include "usart_baud.h"
 
 #define USART_BAUD_RATE 38400
 #define USART_SAMPLE_NUM 16
-#define SHIFT 32
+#define SHIFT 32 // (calculate_baud_value's Q32 ratio; init uses usart_baud.h)
+
+// DMAC channel feeding the radio USART
+#define USART_TX_DMA_CHANNEL		0
+// time for len bytes to go out (10 bits / byte), plus slack
+#define USART_TX_DMA_TIMEOUT_MS(len)	((len) * 10 * 1000 / USART_BAUD_RATE + 10)
+
+// notification bit set on the task capturing received bytes, for ring events
+// (see usart_rx_ring.h; set with eSetBits so other bits are left for other uses)
+#define USART_RX_NOTIFY_BIT			(1UL << 0)
 
 #define LEN_RECEIVEBUFFER 16
 #define LEN_SENDBUFFER 16
@@ -32,8 +43,21 @@ void ext_usart_pin_init(void);
 void ext_usart_init(void);
 void usart_send_buf(const uint8_t *str_buf, int len);
 void usart_send_string(const uint8_t *str_buf);
+void usart_tx_dma_init(void);
+bool usart_tx_dma_start(const uint8_t *buf, int len);
+bool usart_tx_dma_wait(TickType_t timeout_ticks);
+bool usart_tx_dma_in_progress(void);
 uint16_t calculate_baud_value(const uint32_t baudrate, const uint32_t peripheral_clock, uint8_t sample_num);
+bool usart_set_baud_rate(uint32_t baudrate);
 
+void usart_receive_byte(uint8_t rx_byte);
 void clear_USART_rx_buffer(void);
+void usart_rx_capture_start(void);
+void usart_rx_capture_stop(void);
+uint16_t usart_rx_read(uint8_t* buf, uint16_t max);
+bool usart_rx_wait(TickType_t timeout_ticks);
+void usart_rx_tick(void);
+bool usart_rx_tick_needed(void);
+const usart_rx_ring_t* get_usart_rx_ring(void);
 
 #endif /* USART_COMMANDS_H_ */
@@ -0,0 +1,51 @@
+/*
+ * rtc_time.h
+ *
+ * Time since boot off the RTC, for the mission timestamps (see
+ * get_current_timestamp). The RTC's 32-bit count (RTC_COUNTS_PER_S) overflows
+ * after ~48.5 days, so RTC_Handler counts the overflows and rtc_read_counts_64
+ * puts the two together into a count that never does. That takes no locks
+ * (it rereads if the overflow interrupt ran partway through), so it's fine
+ * from any task or interrupt. As the count is in 1/1024ths of a second, seconds
+ * are a shift and ms an exact multiply and shift - no divides, which the M0+
+ * does in software (and 64-bit ones slowly).
+ * This has no ASF includes, so it runs on a host too (see rtc_time_tests.c).
+ *
+ * Created: 10/19/2026 8:12:25 PM
+ *  Author: BSE
+ */
+
+
+#ifndef RTC_TIME_H_
+#define RTC_TIME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RTC_TIME_COUNTS_PER_S_LOG2		10	// RTC_COUNTS_PER_S = 1024
+// ms = counts * 1000 / 1024 = counts * 125 / 128
+#define RTC_TIME_MS_PER_128_COUNTS		125
+// (half the 32-bit count; see rtc_time_extend)
+#define RTC_TIME_COUNT_HALF				0x80000000UL
+
+/* the 64-bit count from the times the 32-bit one has overflowed (read before
+   and after count, unchanged) and whether an overflow was pending then (its
+   interrupt held off, e.g. by a critical section); a pending overflow is only
+   missing from overflows once the count read has wrapped past it */
+static inline uint64_t rtc_time_extend(uint32_t overflows, uint32_t count, bool overflow_pending) {
+	if (overflow_pending && count < RTC_TIME_COUNT_HALF) {
+		overflows++;
+	}
+	return ((uint64_t) overflows << 32) | count;
+}
+
+static inline uint32_t rtc_time_counts_to_s(uint64_t counts) {
+	return (uint32_t) (counts >> RTC_TIME_COUNTS_PER_S_LOG2);
+}
+
+// (exact; rounds down, like dividing would)
+static inline uint64_t rtc_time_counts_to_ms(uint64_t counts) {
+	return (counts * RTC_TIME_MS_PER_128_COUNTS) >> 7;
+}
+
+#endif /* RTC_TIME_H_ */
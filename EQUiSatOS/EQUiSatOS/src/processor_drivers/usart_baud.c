@@ -0,0 +1,71 @@
+/*
+ * usart_baud.c
+ *
+ * Created: 10/19/2026 4:05:43 AM
+ *  Author: BSE
+ */
+
+#include "usart_baud.h"
+
+// (all worked out at compile time)
+static const usart_baud_entry_t usart_baud_table[] = {
+	USART_BAUD_ROWS_FOR_CLOCK(USART_BAUD_CLK_OSC8M),
+	USART_BAUD_ROWS_FOR_CLOCK(USART_BAUD_CLK_OSC8M_DIV2),
+	USART_BAUD_ROWS_FOR_CLOCK(USART_BAUD_CLK_OSC8M_DIV4),
+	USART_BAUD_ROWS_FOR_CLOCK(USART_BAUD_CLK_DFLL),
+};
+#define USART_BAUD_TABLE_LEN	(sizeof(usart_baud_table) / sizeof(usart_baud_table[0]))
+
+const usart_baud_entry_t* get_usart_baud_table(uint8_t* num_entries) {
+	*num_entries = USART_BAUD_TABLE_LEN;
+	return usart_baud_table;
+}
+
+const usart_baud_entry_t* usart_baud_lookup(uint32_t baudrate, uint32_t clock_hz) {
+	for (uint8_t i = 0; i < USART_BAUD_TABLE_LEN; i++) {
+		if (usart_baud_table[i].baudrate == baudrate && usart_baud_table[i].clock_hz == clock_hz) {
+			return &usart_baud_table[i];
+		}
+	}
+	return NULL;
+}
+
+/* calculate_baud_value without the 64-bit division; baudrate * samples must be
+   below clock_hz (and clock_hz at most 2^31), otherwise returns 0.
+   With n = samples * baudrate, calculate_baud_value's Q32 ratio R = n * 2^32 / clock
+   (truncated) and its result is 65536 - ceil(R / 2^16). The top 16 bits of R are
+   q = n * 2^16 / clock, which a 16-step divide gets in 32 bits (n < clock, so the
+   remainder never needs more), and the rest of R is nonzero exactly when the
+   remainder r left over satisfies r * 2^16 >= clock. */
+uint16_t usart_baud_value_fast(uint32_t baudrate, uint32_t clock_hz, uint8_t samples) {
+	uint32_t n = samples * baudrate;
+	if (n >= clock_hz || clock_hz > 0x80000000) {
+		return 0;
+	}
+	uint32_t q = 0, r = n;
+	for (int i = 0; i < 16; i++) {
+		r <<= 1;
+		q <<= 1;
+		if (r >= clock_hz) {
+			r -= clock_hz;
+			q |= 1;
+		}
+	}
+	// (r * 2^16 >= clock, i.e. r >= clock / 2^16 rounded up)
+	if (r >= (clock_hz >> 16) + ((clock_hz & 0xFFFF) != 0)) {
+		q++;
+	}
+	return (uint16_t) (65536 - q);
+}
+
+/* BAUD register value for baudrate off a clock_hz SERCOM clock, from the table if
+   we have it there */
+uint16_t usart_baud_value(uint32_t baudrate, uint32_t clock_hz, uint8_t samples) {
+	if (samples == USART_BAUD_TABLE_SAMPLES) {
+		const usart_baud_entry_t* entry = usart_baud_lookup(baudrate, clock_hz);
+		if (entry != NULL) {
+			return entry->baud_reg;
+		}
+	}
+	return usart_baud_value_fast(baudrate, clock_hz, samples);
+}
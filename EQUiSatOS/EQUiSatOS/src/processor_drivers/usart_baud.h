@@ -0,0 +1,65 @@
+/*
+ * usart_baud.h
+ *
+ * SERCOM USART (arithmetic mode) BAUD register values, without the 64-bit
+ * software division calculate_baud_value does:
+ *   BAUD = 65536 * (1 - samples * baudrate / clock)
+ * Values for the baud rates and clocks we use are worked out by the
+ * compiler (USART_BAUD_REG) into a table in flash; anything else goes through
+ * usart_baud_value_fast, which only needs 32-bit shifts and subtracts.
+ * Both give exactly what calculate_baud_value does (see usart_baud_tests.c).
+ *
+ * Created: 10/19/2026 4:05:21 AM
+ *  Author: BSE
+ */
+
+
+#ifndef USART_BAUD_H_
+#define USART_BAUD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// oversampling the table is built for (SAMPR = 0)
+#define USART_BAUD_TABLE_SAMPLES	16
+
+/* calculate_baud_value, as a constant expression: ratio is samples * baudrate / clock
+   in Q32 (truncated), and the BAUD value is 65536 * (1 - ratio), truncated */
+#define USART_BAUD_RATIO_Q32(baud, clk, samples) \
+	((((uint64_t) (samples) * (baud)) << 32) / (clk))
+#define USART_BAUD_REG(baud, clk, samples) \
+	((uint16_t) ((65536 * ((((uint64_t) 1) << 32) - USART_BAUD_RATIO_Q32(baud, clk, samples))) >> 32))
+
+/* table generator: one row per supported baud rate for a given clock */
+#define USART_BAUD_ROW(baud, clk) \
+	{(baud), (clk), USART_BAUD_REG(baud, clk, USART_BAUD_TABLE_SAMPLES)}
+#define USART_BAUD_ROWS_FOR_CLOCK(clk) \
+	USART_BAUD_ROW(1200, clk), \
+	USART_BAUD_ROW(2400, clk), \
+	USART_BAUD_ROW(4800, clk), \
+	USART_BAUD_ROW(9600, clk), \
+	USART_BAUD_ROW(19200, clk), \
+	USART_BAUD_ROW(38400, clk), \
+	USART_BAUD_ROW(57600, clk), \
+	USART_BAUD_ROW(115200, clk)
+
+// GCLK generator 0 is OSC8M (see conf_clocks.h); the rest are the other
+// OSC8M prescalers and the DFLL, in case the SERCOM clock is ever moved
+#define USART_BAUD_CLK_OSC8M		8000000
+#define USART_BAUD_CLK_OSC8M_DIV2	4000000
+#define USART_BAUD_CLK_OSC8M_DIV4	2000000
+#define USART_BAUD_CLK_DFLL			48000000
+
+typedef struct usart_baud_entry {
+	uint32_t baudrate;
+	uint32_t clock_hz;
+	uint16_t baud_reg;
+} usart_baud_entry_t;
+
+uint16_t usart_baud_value(uint32_t baudrate, uint32_t clock_hz, uint8_t samples);
+uint16_t usart_baud_value_fast(uint32_t baudrate, uint32_t clock_hz, uint8_t samples);
+const usart_baud_entry_t* usart_baud_lookup(uint32_t baudrate, uint32_t clock_hz);
+const usart_baud_entry_t* get_usart_baud_table(uint8_t* num_entries);
+
+#endif /* USART_BAUD_H_ */
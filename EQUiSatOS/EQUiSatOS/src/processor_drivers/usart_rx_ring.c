@@ -0,0 +1,79 @@
+/*
+ * usart_rx_ring.c
+ *
+ * Created: 10/19/2026 3:02:40 AM
+ *  Author: BSE
+ */
+
+#include "usart_rx_ring.h"
+#include <string.h>
+
+void usart_rx_ring_init(usart_rx_ring_t* r) {
+	memset((void*) r, 0, sizeof(usart_rx_ring_t));
+}
+
+/************************************************************************/
+/* PRODUCER (RX INTERRUPT / TICK)                                       */
+/************************************************************************/
+/* puts a received byte in the ring; returns whether enough have
+   arrived since the last event to notify the consumer */
+bool usart_rx_ring_put(usart_rx_ring_t* r, uint8_t b) {
+	uint16_t head = r->head;
+	r->received++;
+	if ((uint16_t) (head - r->tail) >= USART_RX_RING_SIZE) {
+		r->overruns++;
+		return false;
+	}
+	r->buf[head & USART_RX_RING_MASK] = b;
+	r->head = head + 1;
+	if ((uint16_t) (r->head - r->reported_head) >= USART_RX_NOTIFY_THRESHOLD) {
+		r->reported_head = r->head;
+		r->events++;
+		return true;
+	}
+	return false;
+}
+
+/* called every tick; returns whether bytes are waiting that haven't been reported
+   and the line's gone idle. NOTE the RX interrupt may preempt this (it's higher priority),
+   which at worst makes for an extra event */
+bool usart_rx_ring_tick(usart_rx_ring_t* r) {
+	uint16_t head = r->head;
+	if (head != r->tick_head) {
+		r->tick_head = head;
+		r->idle_ticks = 0;
+		return false;
+	}
+	if (head == r->reported_head || ++r->idle_ticks < USART_RX_IDLE_TICKS) {
+		return false;
+	}
+	r->reported_head = head;
+	r->events++;
+	return true;
+}
+
+/************************************************************************/
+/* CONSUMER (TASK)                                                      */
+/************************************************************************/
+uint16_t usart_rx_ring_count(const usart_rx_ring_t* r) {
+	return (uint16_t) (r->head - r->tail);
+}
+
+/* reads up to max bytes out of the ring (oldest first); returns how many */
+uint16_t usart_rx_ring_read(usart_rx_ring_t* r, uint8_t* buf, uint16_t max) {
+	uint16_t tail = r->tail;
+	uint16_t n = (uint16_t) (r->head - tail);
+	if (n > max) {
+		n = max;
+	}
+	for (uint16_t i = 0; i < n; i++) {
+		buf[i] = r->buf[(tail + i) & USART_RX_RING_MASK];
+	}
+	r->tail = tail + n;
+	return n;
+}
+
+/* drops everything waiting */
+void usart_rx_ring_flush(usart_rx_ring_t* r) {
+	r->tail = r->head;
+}
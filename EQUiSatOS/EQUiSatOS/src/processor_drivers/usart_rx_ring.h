@@ -0,0 +1,68 @@
+/*
+ * usart_rx_ring.h
+ *
+ * Single-producer / single-consumer receive ring for the radio USART.
+ * The receive interrupt puts bytes in and publishes head; the consumer task
+ * reads them out and publishes tail (each index is only written by its side,
+ * and both are free-running, so head - tail is the count without locking).
+ * Rather than waking the consumer on every byte, the producer side reports an
+ * event once USART_RX_NOTIFY_THRESHOLD bytes have arrived since the last one,
+ * or (from the tick) once bytes are waiting and the line has been idle for
+ * USART_RX_IDLE_TICKS. Bytes that arrive with the ring full are dropped and
+ * counted as overruns (and the SERCOM's own buffer overflows are counted too).
+ *
+ * Created: 10/19/2026 3:02:17 AM
+ *  Author: BSE
+ */
+
+
+#ifndef USART_RX_RING_H_
+#define USART_RX_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// must be a power of two (indices wrap with a mask), and at most 2^15
+#define USART_RX_RING_SIZE			128
+// bytes waiting to report an event...
+#define USART_RX_NOTIFY_THRESHOLD	32
+// ...or ticks (1 ms; ~4 bytes at 38400 baud) of silence with any waiting
+#define USART_RX_IDLE_TICKS			2
+
+#if (USART_RX_RING_SIZE & (USART_RX_RING_SIZE - 1)) != 0 || USART_RX_RING_SIZE > 32768
+	#error USART_RX_RING_SIZE must be a power of two, at most 32768
+#endif
+#if USART_RX_NOTIFY_THRESHOLD > USART_RX_RING_SIZE
+	#error USART_RX_NOTIFY_THRESHOLD must fit in the ring
+#endif
+
+#define USART_RX_RING_MASK			(USART_RX_RING_SIZE - 1)
+
+typedef struct usart_rx_ring {
+	// (all volatile so the producer's writes are ordered before it publishes head)
+	volatile uint8_t buf[USART_RX_RING_SIZE];
+	volatile uint16_t head;				// next to write (producer only)
+	volatile uint16_t tail;				// next to read (consumer only)
+	// producer side event state
+	volatile uint16_t reported_head;	// head at the last event
+	volatile uint16_t tick_head;		// head at the last tick
+	volatile uint8_t idle_ticks;
+	// stats
+	volatile uint32_t received;
+	volatile uint32_t overruns;			// dropped because the ring was full
+	volatile uint32_t hw_overruns;		// dropped by the SERCOM before we read them
+	volatile uint32_t events;
+} usart_rx_ring_t;
+
+void usart_rx_ring_init(usart_rx_ring_t* r);
+
+/* producer side (interrupts); return whether to notify the consumer */
+bool usart_rx_ring_put(usart_rx_ring_t* r, uint8_t b);
+bool usart_rx_ring_tick(usart_rx_ring_t* r);
+
+/* consumer side */
+uint16_t usart_rx_ring_count(const usart_rx_ring_t* r);
+uint16_t usart_rx_ring_read(usart_rx_ring_t* r, uint8_t* buf, uint16_t max);
+void usart_rx_ring_flush(usart_rx_ring_t* r);
+
+#endif /* USART_RX_RING_H_ */
@@ -35,9 +35,9 @@ void antenna_deploy_task(void *pvParameters) {
 		
 		// only try quickly in ANTENNA_DEPLOY state, otherwise try more periodically
 		if (get_sat_state() == ANTENNA_DEPLOY) {
-			vTaskDelayUntil(&prev_wake_time, ANTENNA_DEPLOY_TASK_FREQ / portTICK_PERIOD_MS);
+			task_delay_until_safe(ANTENNA_DEPLOY_TASK, &prev_wake_time, ANTENNA_DEPLOY_TASK_FREQ / portTICK_PERIOD_MS);
 		} else {
-			vTaskDelayUntil(&prev_wake_time, ANTENNA_DEPLOY_TASK_LESS_FREQ / portTICK_PERIOD_MS);
+			task_delay_until_safe(ANTENNA_DEPLOY_TASK, &prev_wake_time, ANTENNA_DEPLOY_TASK_LESS_FREQ / portTICK_PERIOD_MS);
 		}
 		
 		// report to watchdog (again)
@@ -51,7 +51,7 @@ void antenna_deploy_task(void *pvParameters) {
 			// (delay until the state handling task suspends us)
 			print("Deployed!\n");			
 			update_sat_event_history(1, 0, 0, 0, 0, 0, 0);
-			vTaskDelayUntil(&prev_wake_time, ANTENNA_DEPLOY_TASK_LESS_FREQ / portTICK_PERIOD_MS);
+			task_delay_until_safe(ANTENNA_DEPLOY_TASK, &prev_wake_time, ANTENNA_DEPLOY_TASK_LESS_FREQ / portTICK_PERIOD_MS);
 			// report to watchdog (again)
 			report_task_running(ANTENNA_DEPLOY_TASK);
 			continue;
@@ -65,12 +65,12 @@ void antenna_deploy_task(void *pvParameters) {
 			if ((lid == LI1_DISG && li1 > PWM_LION_MIN_V)
 					|| (lid == LI2_DISG && li2 > PWM_LION_MIN_V)
 					|| (lid == BOTH_DISG && li1 + li2 > PWM_LION_MIN_V)) {
-				if (xSemaphoreTake(critical_action_mutex, CRITICAL_MUTEX_WAIT_TIME_TICKS)) {
+				if (mutex_take(critical_action_mutex, CRITICAL_MUTEX_WAIT_TIME_TICKS)) {
 					if (try_pwm_deploy(P_ANT_DRV1, P_ANT_DRV1_MUX, PWM_LENGTH_MS, 1)) {
 						num_tries++;
 					}
 					
-					xSemaphoreGive(critical_action_mutex);
+					mutex_give(critical_action_mutex);
 				} else {
 					log_error(ELOC_ANTENNA_DEPLOY, ECODE_CRIT_ACTION_MUTEX_TIMEOUT, false);
 				}
@@ -78,13 +78,13 @@ void antenna_deploy_task(void *pvParameters) {
 				// report to watchdog (again)
 				report_task_running(ANTENNA_DEPLOY_TASK);
 			} else {
-				vTaskDelay(ANTENNA_DEPLOY_LI_NOT_CHARGED_WAIT / portTICK_PERIOD_MS);
+				task_delay_safe(ANTENNA_DEPLOY_TASK, ANTENNA_DEPLOY_LI_NOT_CHARGED_WAIT / portTICK_PERIOD_MS);
 			}
 		} else {
 			uint16_t lf1, lf2, lf3, lf4;
 			read_lifepo_volts_precise(&lf1, &lf2, &lf3, &lf4, true);
 			if (lf1 + lf2 > PWM_LIFEPO_MIN_V) {
-				if (xSemaphoreTake(critical_action_mutex, CRITICAL_MUTEX_WAIT_TIME_TICKS)) {
+				if (mutex_take(critical_action_mutex, CRITICAL_MUTEX_WAIT_TIME_TICKS)) {
 					int pin = current_pwm_pin == 2 ? P_ANT_DRV2 : P_ANT_DRV3;
 					int mux = current_pwm_pin == 2 ? P_ANT_DRV2_MUX : P_ANT_DRV3_MUX;
 					set_output(true, P_LF_B1_OUTEN);
@@ -99,7 +99,7 @@ void antenna_deploy_task(void *pvParameters) {
 					set_output(false, P_LF_B1_OUTEN);
 					set_output(is_chgn, P_LF_B1_CHGN);
 					
-					xSemaphoreGive(critical_action_mutex);
+					mutex_give(critical_action_mutex);
 					
 					// report to watchdog (again)
 					report_task_running(ANTENNA_DEPLOY_TASK);
@@ -108,7 +108,7 @@ void antenna_deploy_task(void *pvParameters) {
 					log_error(ELOC_ANTENNA_DEPLOY, ECODE_CRIT_ACTION_MUTEX_TIMEOUT, false);
 				}
 			} else {
-				vTaskDelay(ANTENNA_DEPLOY_LF_NOT_CHARGED_WAIT / portTICK_PERIOD_MS);
+				task_delay_safe(ANTENNA_DEPLOY_TASK, ANTENNA_DEPLOY_LF_NOT_CHARGED_WAIT / portTICK_PERIOD_MS);
 			}
 		}
 	}
@@ -6,6 +6,10 @@
  */ 
 
 #include "rtos_tasks.h"
+#include "../telemetry/downlink_ledger.h"
+
+// list of reads done each sample (static to keep it off the task stack)
+static sensor_transaction_t attitude_data_txn;
 
 void attitude_data_task(void *pvParameters)
 {
@@ -25,7 +29,7 @@ void attitude_data_task(void *pvParameters)
 	
 	for ( ;; )
 	{
-		vTaskDelayUntil( &prev_wake_time, ATTITUDE_DATA_TASK_FREQ / portTICK_PERIOD_MS);
+		task_delay_until_safe(ATTITUDE_DATA_TASK, &prev_wake_time, ATTITUDE_DATA_TASK_FREQ / portTICK_PERIOD_MS);
 		
 		// report to watchdog
 		report_task_running(ATTITUDE_DATA_TASK);
@@ -36,22 +40,34 @@ void attitude_data_task(void *pvParameters)
 		// time the data reading to make sure it doesn't exceed a maximum
 		time_before_data_read = xTaskGetTickCount() / portTICK_PERIOD_MS;
 		
-		// the next couple readings use IR power on, so turn it on for them
-		// to speed up the readings (otherwise they have to wait for it to come on each time)
+		// the second sample of readings also uses IR power, so keep it on between
+		// the two transactions (otherwise it has to wait for it to come on again,
+		// and the IMU would lose its FIFO window)
 		bool got_semaphore = enable_ir_pow_if_necessary();
 		{
-			// read all sensors first
-			read_ir_object_temps_batch(	current_struct->ir_obj_temps_data);
-			read_pdiode_batch(			&(current_struct->pdiode_data));
-			read_gyro_batch(			current_struct->gyro_data);
-			read_accel_batch(			current_struct->accelerometer_data	[0]);
-			read_magnetometer_batch(	current_struct->magnetometer_data	[0]);
-		
-			// delay a bit and take a second batch of readings to allow rate measurements
+			imu_window_batches_t imu_batches = {
+				.accel = current_struct->accelerometer_data,
+				.gyro = &(current_struct->gyro_data),
+				.mag = current_struct->magnetometer_data
+			};
+			
+			// read all sensors first, under a single lock of the hardware mutexes,
+			// and start the IMU sampling accel/gyro into its FIFO (with a magnetometer reading)
+			sensor_txn_begin(&attitude_data_txn);
+			sensor_txn_add(&attitude_data_txn, SR_IR_OBJECT_TEMPS,	current_struct->ir_obj_temps_data, NULL);
+			sensor_txn_add(&attitude_data_txn, SR_PDIODE,			&(current_struct->pdiode_data), NULL);
+			sensor_txn_add(&attitude_data_txn, SR_IMU_WINDOW_START, &imu_batches, NULL);
+			sensor_txn_run(&attitude_data_txn, ELOC_ATTITUDE_DATA);
+
+			// delay a bit (without holding the hardware) while the IMU window fills,
+			// then burst-read and reduce it (the two accel readings are the means of
+			// each half of the window, so they still allow rate measurements), along
+			// with the magnetometer reading at the end of the window
 			// TODO: may want to error if this is off (by a tighter bound than ATTITUDE_DATA_MAX_READ_TIME)
 			vTaskDelay(ATTITUDE_DATA_SECOND_SAMPLE_DELAY / portTICK_PERIOD_MS);
-			read_accel_batch(			current_struct->accelerometer_data	[1]);
-			read_magnetometer_batch(	current_struct->magnetometer_data	[1]);
+			sensor_txn_begin(&attitude_data_txn);
+			sensor_txn_add(&attitude_data_txn, SR_IMU_WINDOW,		&imu_batches, NULL);
+			sensor_txn_run(&attitude_data_txn, ELOC_ATTITUDE_DATA);
 		}
 		// try to disable IR power because we're done, but only if we get the mutex (we expect it to be on so no errors)
 		disable_ir_pow_if_necessary(got_semaphore);
@@ -63,6 +79,7 @@ void attitude_data_task(void *pvParameters)
 			uint32_t time_since_last_log_s = get_current_timestamp() - time_of_last_log_s;
 			if (time_since_last_log_s >= ATTITUDE_DATA_LOG_FREQ_S) {
 				// validate previous stored value in stack, getting back the next staged address we can start adding to
+				current_struct->reading_id = new_reading_id(ATTITUDE_DATA);
 				current_struct = (attitude_data_t*) equistack_Stage(&attitude_readings_equistack);
 				time_of_last_log_s = get_current_timestamp();
 			}
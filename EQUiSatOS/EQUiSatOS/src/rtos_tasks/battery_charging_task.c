@@ -174,6 +174,74 @@ bool st_pin_active(int8_t bat, bat_charge_dig_sigs_batch batch)
 	return (batch>>st_position)&0x01;
 }
 
+/************************************************************************/
+/* SHARED BATTERY READINGS (see battery_snapshot.h)                     */
+/************************************************************************/
+static battery_snapshot_t shared_readings; // (all unread to start)
+static const battery_levels_t state_levels = {
+	LI_LOW_POWER_MV, LF_FLASH_MIN_MV, LF_FULL_SUM_MV, LF_FULL_MAX_MV
+};
+
+static void notify_state_handling(void)
+{
+	if (state_handling_task_handle != NULL)
+		xTaskNotify(state_handling_task_handle, BATTERY_LEVELS_NOTIFY_BIT, eSetBits);
+}
+
+// shares a group of readings just taken, waking the state handling task if they
+// crossed a level it decides on (unless it took them, to decide on)
+static void share_battery_readings(battery_snapshot_group_t group, const battery_snapshot_t* readings)
+{
+	taskENTER_CRITICAL();
+	uint32_t crossed = battery_snapshot_update(&shared_readings, readings, group,
+		xTaskGetTickCount(), &state_levels);
+	taskEXIT_CRITICAL();
+
+	if (crossed && xTaskGetCurrentTaskHandle() != state_handling_task_handle)
+		notify_state_handling();
+}
+
+void get_shared_battery_readings(battery_snapshot_t* readings)
+{
+	taskENTER_CRITICAL();
+	*readings = shared_readings;
+	taskEXIT_CRITICAL();
+}
+
+static bool read_lion_volts_with_retry(uint16_t* li1_mv, uint16_t* li2_mv)
+{
+	bool success = false;
+	for (int8_t i = 0; i < RETRIES_AFTER_MUTEX_TIMEOUT && !success; i++)
+		success = read_lion_volts_precise(li1_mv, li2_mv, true);
+
+	if (success)
+	{
+		battery_snapshot_t readings;
+		readings.li_mv[0] = *li1_mv;
+		readings.li_mv[1] = *li2_mv;
+		share_battery_readings(BATTERY_SNAPSHOT_LI, &readings);
+	}
+	return success;
+}
+
+static bool read_lifepo_volts_with_retry(uint16_t* lf1_mv, uint16_t* lf2_mv, uint16_t* lf3_mv, uint16_t* lf4_mv)
+{
+	bool success = false;
+	for (int8_t i = 0; i < RETRIES_AFTER_MUTEX_TIMEOUT && !success; i++)
+		success = read_lifepo_volts_precise(lf1_mv, lf2_mv, lf3_mv, lf4_mv, true);
+
+	if (success)
+	{
+		battery_snapshot_t readings;
+		readings.lf_mv[0] = *lf1_mv;
+		readings.lf_mv[1] = *lf2_mv;
+		readings.lf_mv[2] = *lf3_mv;
+		readings.lf_mv[3] = *lf4_mv;
+		share_battery_readings(BATTERY_SNAPSHOT_LF, &readings);
+	}
+	return success;
+}
+
 static uint16_t get_panel_ref_val_with_retry(void)
 {
 	uint16_t four_buf[4];
@@ -184,6 +252,9 @@ static uint16_t get_panel_ref_val_with_retry(void)
 	if (!success)
 		return ((uint16_t) -1);
 
+	battery_snapshot_t readings;
+	readings.panel_ref = four_buf[2];
+	share_battery_readings(BATTERY_SNAPSHOT_PANEL, &readings);
 	return ((uint16_t)four_buf[2]);
 }
 
@@ -206,9 +277,36 @@ bool read_bat_charge_dig_sigs_batch_with_retry(bat_charge_dig_sigs_batch *batch)
 	for (int8_t i = 0; i < RETRIES_AFTER_MUTEX_TIMEOUT && !success; i++)
 		success = read_bat_charge_dig_sigs_batch(batch);
 
+	if (success)
+	{
+		battery_snapshot_t readings;
+		readings.dig_sigs = *batch;
+		share_battery_readings(BATTERY_SNAPSHOT_SIGS, &readings);
+	}
 	return success;
 }
 
+// the battery readings, reading (and sharing) any group more than max_age_ms old;
+// groups that can't be read are left as last read (or zero, if they never were)
+void get_battery_readings(battery_snapshot_t* readings, uint32_t max_age_ms)
+{
+	get_shared_battery_readings(readings);
+	TickType_t now = xTaskGetTickCount();
+	TickType_t max_age = max_age_ms / portTICK_PERIOD_MS;
+
+	battery_snapshot_t fresh;
+	if (!battery_snapshot_fresh(readings, BATTERY_SNAPSHOT_LI, now, max_age))
+		read_lion_volts_with_retry(&fresh.li_mv[0], &fresh.li_mv[1]);
+	if (!battery_snapshot_fresh(readings, BATTERY_SNAPSHOT_LF, now, max_age))
+		read_lifepo_volts_with_retry(&fresh.lf_mv[0], &fresh.lf_mv[1], &fresh.lf_mv[2], &fresh.lf_mv[3]);
+	if (!battery_snapshot_fresh(readings, BATTERY_SNAPSHOT_SIGS, now, max_age))
+		read_bat_charge_dig_sigs_batch_with_retry(&fresh.dig_sigs);
+	if (!battery_snapshot_fresh(readings, BATTERY_SNAPSHOT_PANEL, now, max_age))
+		get_panel_ref_val_with_retry();
+
+	get_shared_battery_readings(readings);
+}
+
 bool is_lion(int8_t bat)
 {
 	return (bat == LI1 || bat == LI2);
@@ -630,8 +728,20 @@ void update_should_deploy_antenna(bool has_li_data)
 	uint16_t li2_mv = 0;
 	if (!has_li_data)
 	{
-		for (int8_t i = 0; i < RETRIES_AFTER_MUTEX_TIMEOUT && !li_success; i++)
-			li_success = read_lion_volts_precise((uint16_t *) &li1_mv, (uint16_t *) &li2_mv, true);
+		// (the state handling task reads them more often than this runs)
+		battery_snapshot_t readings;
+		get_shared_battery_readings(&readings);
+		if (battery_snapshot_fresh(&readings, BATTERY_SNAPSHOT_LI, xTaskGetTickCount(),
+			BATTERY_READINGS_MAX_AGE_MS / portTICK_PERIOD_MS))
+		{
+			li1_mv = readings.li_mv[0];
+			li2_mv = readings.li_mv[1];
+			li_success = true;
+		}
+		else
+		{
+			li_success = read_lion_volts_with_retry(&li1_mv, &li2_mv);
+		}
 	}
 	else
 	{
@@ -697,6 +807,10 @@ void battery_charging_task(void *pvParameters)
 		report_task_running(BATTERY_CHARGING_TASK);
 		
 		print("entering battery task!\n");
+		// (the state decisions go by these too)
+		meta_charge_state_t prev_meta_charge_state = charging_data.curr_meta_charge_state;
+		bool prev_should_move_to_antenna_deploy = charging_data.should_move_to_antenna_deploy;
+
 		if (iter_count % BAT_CHARGING_ITERS_UNTIL_FULL == 0 || get_sat_state_wrapped() == LOW_POWER)
 		{
 			// the core battery logic -- a separate function to make it easier to
@@ -710,6 +824,10 @@ void battery_charging_task(void *pvParameters)
 			print("not running the full logic yet: iter at %d\n", iter_count);
 			update_should_deploy_antenna(false);
 		}
+
+		if (charging_data.curr_meta_charge_state != prev_meta_charge_state
+			|| charging_data.should_move_to_antenna_deploy != prev_should_move_to_antenna_deploy)
+			notify_state_handling();
 		
 		iter_count++;
 		vTaskDelayUntil(&prev_wake_time, BATTERY_CHARGING_TASK_FREQ / portTICK_PERIOD_MS);
@@ -726,7 +844,19 @@ bool get_lf_full(
 	bat_charge_dig_sigs_batch batch, 
 	bool got_batch)
 {	
-	uint16_t panel_ref_val = get_panel_ref_val_with_retry();
+	return get_lf_full_with_panel_ref(sum_cell_mv, max_cell_mv, lf, batch, got_batch,
+		get_panel_ref_val_with_retry());
+}
+
+// (panel_ref_val is -1 if it couldn't be read)
+bool get_lf_full_with_panel_ref(
+	uint16_t sum_cell_mv,
+	uint16_t max_cell_mv,
+	int8_t lf,
+	bat_charge_dig_sigs_batch batch,
+	bool got_batch,
+	uint16_t panel_ref_val)
+{
 	bool got_panel_ref = panel_ref_val != ((uint16_t) -1);
 
 	return sum_cell_mv > LF_FULL_SUM_MV ||
@@ -771,11 +901,9 @@ void battery_logic()
 	#endif
 
 	#ifndef BAT_UNIT_TESTING
-	bool li_success = false;
-	for (int8_t i = 0; i < RETRIES_AFTER_MUTEX_TIMEOUT && !li_success; i++)
-		li_success = read_lion_volts_precise(
-			(uint16_t *) &(charging_data.bat_voltages[LI1]),
-			(uint16_t *) &(charging_data.bat_voltages[LI2]), true);
+	bool li_success = read_lion_volts_with_retry(
+		(uint16_t *) &(charging_data.bat_voltages[LI1]),
+		(uint16_t *) &(charging_data.bat_voltages[LI2]));
 
 	// we're going to move to TWO_LI_DOWN -- but not decommission anyone
 	if (!li_success)
@@ -789,9 +917,7 @@ void battery_logic()
 	uint16_t lf2_mv;
 	uint16_t lf3_mv;
 	uint16_t lf4_mv;
-	bool lf_success = false;
-	for (int8_t i = 0; i < RETRIES_AFTER_MUTEX_TIMEOUT && !lf_success; i++)
-		lf_success = read_lifepo_volts_precise(&lf1_mv, &lf2_mv, &lf3_mv, &lf4_mv, true);
+	bool lf_success = read_lifepo_volts_with_retry(&lf1_mv, &lf2_mv, &lf3_mv, &lf4_mv);
 
 	if (!lf_success)
 	{
@@ -1283,7 +1409,7 @@ void battery_logic()
 
 	#ifndef BAT_UNIT_TESTING
 	bool got_mutex = true;
-	if (!xSemaphoreTake(critical_action_mutex, (TickType_t) CRITICAL_MUTEX_WAIT_TIME_TICKS)) {
+	if (!mutex_take(critical_action_mutex, (TickType_t) CRITICAL_MUTEX_WAIT_TIME_TICKS)) {
 		// if for some reason we can't get the bat charging mutex (it times out),
 		// ignore it and move on (the only things this mutex prevents is flashing while
 		// lifepos are charging, which is less worrisome than not running charging logic)
@@ -1317,7 +1443,7 @@ void battery_logic()
 		// elsewhere. We increase the timeout hear to be more confident we get it.
 		// (if it fails, continue on, and don't write to the MRAM)
 		bool got_mutex_spi = false;
-		if (xSemaphoreTake(mram_spi_cache_mutex, 2 * MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
+		if (mutex_take(mram_spi_cache_mutex, 2 * MRAM_SPI_MUTEX_WAIT_TIME_TICKS)) {
 			got_mutex_spi = true;
 		} else {
 			log_error(ELOC_BAT_CHARGING, ECODE_SPI_MUTEX_TIMEOUT, true);
@@ -1339,7 +1465,7 @@ void battery_logic()
 		if (got_mutex_spi) set_persistent_charging_data_unsafe(persist_data);
 
 		// resume normal operation
-		if (got_mutex_spi) xSemaphoreGive(mram_spi_cache_mutex);
+		if (got_mutex_spi) mutex_give(mram_spi_cache_mutex);
 		
 		// it's okay to check discharging even with bad voltages -- there aren't
 		// any voltage based checks
@@ -1350,7 +1476,7 @@ void battery_logic()
 		print("no change to discharging li's\n");
 	}
 
-	if (got_mutex) xSemaphoreGive(critical_action_mutex);
+	if (got_mutex) mutex_give(critical_action_mutex);
 
 	///
 	// phase 3b: set the battery that should be charging to charge and
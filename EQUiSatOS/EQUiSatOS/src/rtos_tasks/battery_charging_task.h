@@ -12,6 +12,7 @@
 #include <asf.h>
 #include "../data_handling/persistent_storage.h"
 #include "rtos_tasks.h"
+#include "battery_snapshot.h"
 #include "testing_functions/equisim_simulated_data.h"
 
 // #define BAT_UNIT_TESTING
@@ -53,6 +54,14 @@
 
 #define PANEL_REF_SUN_MV                1474	// 7500 mv
 
+// the state handling task decides on battery readings up to this old (as old
+// as they could be when it read its own every check), taking its own when the
+// shared ones (see battery_snapshot.h) are older
+#define BATTERY_READINGS_MAX_AGE_MS		STATE_HANDLING_TASK_FREQ
+// notifies the state handling task that the battery readings crossed a level it
+// decides on (or the charging state changed), so it decides right away
+#define BATTERY_LEVELS_NOTIFY_BIT		(1UL << 2)
+
 // NOTE: the order of elements of this enum is very important -- do not change!
 // defines each battery and/or bank
 typedef enum
@@ -151,6 +160,8 @@ typedef struct charging_data
 charging_data_t charging_data;
 
 bool read_bat_charge_dig_sigs_batch_with_retry(bat_charge_dig_sigs_batch *batch);
+void get_shared_battery_readings(battery_snapshot_t* readings);
+void get_battery_readings(battery_snapshot_t* readings, uint32_t max_age_ms);
 li_discharging_t get_li_discharging(void);
 uint8_t get_error_loc(int8_t bat);
 uint32_t get_current_timestamp_wrapped(void);
@@ -176,6 +187,7 @@ bool check_chg_should_decommission(int8_t bat, bool should_be_charging, bat_char
 void check_chg_with_retry(int8_t bat, bool should_be_charging, bat_charge_dig_sigs_batch batch);
 void check_fault_with_retry(int8_t bat, bat_charge_dig_sigs_batch batch);
 bool get_lf_full(uint16_t sum_cell_mv, uint16_t max_cell_mv, int8_t lf, bat_charge_dig_sigs_batch batch, bool got_batch);
+bool get_lf_full_with_panel_ref(uint16_t sum_cell_mv, uint16_t max_cell_mv, int8_t lf, bat_charge_dig_sigs_batch batch, bool got_batch, uint16_t panel_ref_val);
 bool get_lfs_both_full(uint8_t num_lf_down, int8_t good_lf, uint16_t lfb1_max_cell_mv, uint16_t lfb2_max_cell_mv);
 void check_after_discharging(int8_t bat_discharging, int8_t bat_not_discharging);
 void check_discharging_with_retry(int8_t bat_discharging, bat_charge_dig_sigs_batch batch);
@@ -0,0 +1,76 @@
+/*
+ * battery_snapshot.c
+ *
+ * Created: 10/19/2026 7:02:40 PM
+ *  Author: BSE
+ */
+
+#include "battery_snapshot.h"
+#include <string.h>
+
+void battery_snapshot_init(battery_snapshot_t* snap) {
+	memset(snap, 0, sizeof(battery_snapshot_t));
+}
+
+// whether the group has been read, no more than max_age ticks before now
+bool battery_snapshot_fresh(const battery_snapshot_t* snap, battery_snapshot_group_t group,
+	uint32_t now, uint32_t max_age)
+{
+	return snap->valid[group] && now - snap->read_at[group] <= max_age;
+}
+
+// which of the levels the readings are past (those of groups never read aren't)
+uint32_t battery_snapshot_levels(const battery_snapshot_t* snap, const battery_levels_t* levels) {
+	uint32_t past = 0;
+	if (snap->valid[BATTERY_SNAPSHOT_LI]) {
+		for (int li = 0; li < 2; li++) {
+			if (snap->li_mv[li] <= levels->li_low_power_mv) {
+				past |= BATTERY_LEVEL_LI_LOW_POWER(li);
+			}
+		}
+	}
+	if (snap->valid[BATTERY_SNAPSHOT_LF]) {
+		for (int bank = 0; bank < 2; bank++) {
+			uint16_t cell_1 = snap->lf_mv[2 * bank], cell_2 = snap->lf_mv[2 * bank + 1];
+			uint32_t sum = cell_1 + cell_2;
+			if (sum < levels->lf_flash_min_mv) {
+				past |= BATTERY_LEVEL_LF_BELOW_FLASH(bank);
+			}
+			if (sum > levels->lf_full_sum_mv) {
+				past |= BATTERY_LEVEL_LF_FULL_SUM(bank);
+			}
+			if ((cell_1 > cell_2 ? cell_1 : cell_2) > levels->lf_full_max_mv) {
+				past |= BATTERY_LEVEL_LF_FULL_MAX(bank);
+			}
+		}
+	}
+	return past;
+}
+
+/* copies the group from readings into the snapshot, read at now, and returns the
+   levels it moved across (none the first time the group's read) */
+uint32_t battery_snapshot_update(battery_snapshot_t* snap, const battery_snapshot_t* readings,
+	battery_snapshot_group_t group, uint32_t now, const battery_levels_t* levels)
+{
+	bool had_group = snap->valid[group];
+	uint32_t before = battery_snapshot_levels(snap, levels);
+
+	switch (group) {
+		case BATTERY_SNAPSHOT_LI:
+			memcpy(snap->li_mv, readings->li_mv, sizeof(snap->li_mv));
+			break;
+		case BATTERY_SNAPSHOT_LF:
+			memcpy(snap->lf_mv, readings->lf_mv, sizeof(snap->lf_mv));
+			break;
+		case BATTERY_SNAPSHOT_SIGS:
+			snap->dig_sigs = readings->dig_sigs;
+			break;
+		default:
+			snap->panel_ref = readings->panel_ref;
+			break;
+	}
+	snap->valid[group] = true;
+	snap->read_at[group] = now;
+
+	return had_group ? before ^ battery_snapshot_levels(snap, levels) : 0;
+}
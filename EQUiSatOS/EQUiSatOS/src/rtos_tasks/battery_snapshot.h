@@ -0,0 +1,64 @@
+/*
+ * battery_snapshot.h
+ *
+ * The latest battery readings, shared between the tasks that take them (the
+ * battery charging and state handling tasks). Each group of readings is
+ * stamped with the tick it was read at; a task that needs a group uses the
+ * shared one if it's recent enough, and otherwise reads (and shares) its own.
+ * Updating a group also works out which of the levels the state decisions go
+ * by it moved across, so the state handling task can be woken to decide then
+ * rather than at its next check.
+ * This has no RTOS or ASF includes (ticks are passed in), so it runs on a host
+ * too (see battery_snapshot_tests.c); the shared copy, its locking and the
+ * reads are in battery_charging_task.c.
+ *
+ * Created: 10/19/2026 7:02:14 PM
+ *  Author: BSE
+ */
+
+
+#ifndef BATTERY_SNAPSHOT_H_
+#define BATTERY_SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+	BATTERY_SNAPSHOT_LI,		// LiOn volts (precise ADC reads)
+	BATTERY_SNAPSHOT_LF,		// LiFePO cell volts (precise ADC reads)
+	BATTERY_SNAPSHOT_SIGS,		// charging signals (I2C GPIO expander)
+	BATTERY_SNAPSHOT_PANEL,		// panel reference (I2C ADC)
+	BATTERY_SNAPSHOT_GROUPS
+} battery_snapshot_group_t;
+
+typedef struct {
+	bool valid[BATTERY_SNAPSHOT_GROUPS];
+	uint32_t read_at[BATTERY_SNAPSHOT_GROUPS];	// tick
+	uint16_t li_mv[2];
+	uint16_t lf_mv[4];		// cells; the banks are 0 + 1 and 2 + 3
+	uint16_t dig_sigs;		// (bat_charge_dig_sigs_batch)
+	uint16_t panel_ref;
+} battery_snapshot_t;
+
+// the levels the state decisions go by (see decide_next_state)
+typedef struct {
+	uint16_t li_low_power_mv;	// LiOn at or below
+	uint16_t lf_flash_min_mv;	// bank (sum of cells) below
+	uint16_t lf_full_sum_mv;	// bank above
+	uint16_t lf_full_max_mv;	// highest cell in a bank above
+} battery_levels_t;
+
+// bits of battery_snapshot_levels (by battery: LI1, LI2 / LFB1, LFB2)
+#define BATTERY_LEVEL_LI_LOW_POWER(li)		(1UL << (li))
+#define BATTERY_LEVEL_LF_BELOW_FLASH(bank)	(1UL << (2 + (bank)))
+#define BATTERY_LEVEL_LF_FULL_SUM(bank)		(1UL << (4 + (bank)))
+#define BATTERY_LEVEL_LF_FULL_MAX(bank)		(1UL << (6 + (bank)))
+
+void battery_snapshot_init(battery_snapshot_t* snap);
+bool battery_snapshot_fresh(const battery_snapshot_t* snap, battery_snapshot_group_t group,
+	uint32_t now, uint32_t max_age);
+uint32_t battery_snapshot_levels(const battery_snapshot_t* snap, const battery_levels_t* levels);
+uint32_t battery_snapshot_update(battery_snapshot_t* snap, const battery_snapshot_t* readings,
+	battery_snapshot_group_t group, uint32_t now, const battery_levels_t* levels);
+
+#endif /* BATTERY_SNAPSHOT_H_ */
@@ -7,6 +7,7 @@
 
 #include "../processor_drivers/Flash_Commands.h"
 #include "rtos_tasks.h"
+#include "../telemetry/downlink_ledger.h"
 
 #define NUM_FLASHES				3
 #define TIME_BTWN_FLASHES		1000 // ms
@@ -133,7 +134,7 @@ void flash_activate_task(void *pvParameters)
 		// note that we're in the long wait between flashes so that the flash_now 
 		// command won't release the task from one of the other vTaskDelays
 		waiting_between_flashes = true;
-		vTaskDelayUntil( &prev_wake_time, FLASH_ACTIVATE_TASK_FREQ / portTICK_PERIOD_MS);
+		task_delay_until_safe(FLASH_ACTIVATE_TASK, &prev_wake_time, FLASH_ACTIVATE_TASK_FREQ / portTICK_PERIOD_MS);
 		waiting_between_flashes = false;
 		prev_wake_time_s = get_current_timestamp();
 		
@@ -149,7 +150,7 @@ void flash_activate_task(void *pvParameters)
 		print("Starting FLASH sequence");
 		
 		// actually flash leds (make sure we're not transmitting or deploying antenna while this is going on)
-		if (xSemaphoreTake(critical_action_mutex, CRITICAL_MUTEX_WAIT_TIME_TICKS))
+		if (mutex_take(critical_action_mutex, CRITICAL_MUTEX_WAIT_TIME_TICKS))
 		{
 			// turn on IR power before we start to use it during flash
 			bool got_semaphore = enable_ir_pow_if_necessary();
@@ -163,9 +164,9 @@ void flash_activate_task(void *pvParameters)
 				// and enable 5V regulator throughout as well
 				// NOTE: order is intentional!
 				bool actually_flashed = false;
-				if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+				if (i2c_irpow_mutex_take())
 				{
-					if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+					if (processor_adc_mutex_take())
 					{
 						_set_5v_enable_unsafe(true);
 				
@@ -201,11 +202,11 @@ void flash_activate_task(void *pvParameters)
 				
 						// disable sensor regulators and free up mutexes
 						_set_5v_enable_unsafe(false);
-						xSemaphoreGive(processor_adc_mutex);
+						mutex_give(processor_adc_mutex);
 					} else {
 						log_error(ELOC_FLASH, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
 					}
-					xSemaphoreGive(i2c_irpow_mutex);
+					mutex_give(i2c_irpow_mutex);
 				} else {
 					log_error(ELOC_FLASH, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 				}
@@ -226,6 +227,7 @@ void flash_activate_task(void *pvParameters)
 				validate_LEDSNS_readings(current_burst_struct)							;
 			
 				// store burst data in equistack
+				current_burst_struct->reading_id = new_reading_id(FLASH_DATA);
 				current_burst_struct = (flash_data_t*) equistack_Stage(&flash_readings_equistack);
 				// reset data array tails so we're writing at the start
 				data_arrays_tail = 0;
@@ -234,7 +236,7 @@ void flash_activate_task(void *pvParameters)
 				vTaskDelay(TIME_BTWN_FLASHES / portTICK_PERIOD_MS); // delay on last iteration as well is OK
 			}
 			disable_ir_pow_if_necessary(got_semaphore);
-			xSemaphoreGive(critical_action_mutex);
+			mutex_give(critical_action_mutex);
 		} else {
 			log_error(ELOC_FLASH, ECODE_CRIT_ACTION_MUTEX_TIMEOUT, false);
 			// skip logging flash cmp on failure
@@ -256,6 +258,7 @@ void flash_activate_task(void *pvParameters)
 		// store cmp data in flash equistack, but distribute over orbit
 		uint32_t time_since_last_log_s = get_current_timestamp() - time_of_last_log_s;
 		if (time_since_last_log_s >= FLASH_CMP_DATA_LOG_FREQ_S) {
+			current_cmp_struct->reading_id = new_reading_id(FLASH_CMP_DATA);
 			current_cmp_struct = (flash_cmp_data_t*) equistack_Stage(&flash_cmp_readings_equistack);
 			time_of_last_log_s = get_current_timestamp();
 		}
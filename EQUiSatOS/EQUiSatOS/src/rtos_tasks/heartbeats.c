@@ -0,0 +1,73 @@
+/*
+ * heartbeats.c
+ *
+ * Created: 10/19/2026 2:10:31 PM
+ *  Author: BSE
+ */
+
+#include "heartbeats.h"
+#include <string.h>
+
+void heartbeats_init(heartbeats_t* hb) {
+	memset((void*) hb, 0, sizeof(heartbeats_t));
+}
+
+// tasks check in when resuming from suspension or launching
+// (the check in acts as the first report; the task may not run before the watchdog does)
+void heartbeat_check_in(heartbeats_t* hb, int task, uint32_t now) {
+	hb->transitions++;
+	hb->checked_in[task] = true;
+	hb->checked_in_at[task] = now;
+	hb->beats[task] = now;
+	hb->transitions++;
+}
+
+// tasks check out when suspending; a report after this is an error
+void heartbeat_check_out(heartbeats_t* hb, int task) {
+	hb->transitions++;
+	hb->checked_in[task] = false;
+	hb->beats[task] = 0;
+	hb->transitions++;
+}
+
+/* checks tasks first_task to num_tasks - 1 have all reported within allowed_ms
+   of now (and that none checked out have reported); if not, missed_task is the
+   first that hasn't */
+heartbeats_result_t heartbeats_check(const heartbeats_t* hb, int first_task, int num_tasks,
+	const uint32_t* allowed_ms, uint32_t now, int* missed_task)
+{
+	uint32_t transitions = hb->transitions;
+	if (transitions & 1) {
+		return HEARTBEATS_CHANGING;
+	}
+
+	heartbeats_result_t result = HEARTBEATS_OK;
+	for (int i = first_task; i < num_tasks; i++) {
+		uint32_t beat = hb->beats[i];
+		if (!hb->checked_in[i]) {
+			if (beat != 0) {
+				result = HEARTBEATS_MISSED;
+			}
+		} else {
+			// (a task preempted between reading the tick and storing it can store
+			// a tick from before it was suspended and checked back in; go by the check in then)
+			uint32_t checked_in_at = hb->checked_in_at[i];
+			if ((int32_t) (checked_in_at - beat) > 0) {
+				beat = checked_in_at;
+			}
+			if (beat == 0 || now - beat > allowed_ms[i]) {
+				result = HEARTBEATS_MISSED;
+			}
+		}
+		if (result == HEARTBEATS_MISSED) {
+			*missed_task = i;
+			break;
+		}
+	}
+
+	// (anything seen may be half of a check in / out)
+	if (hb->transitions != transitions) {
+		return HEARTBEATS_CHANGING;
+	}
+	return result;
+}
@@ -0,0 +1,51 @@
+/*
+ * heartbeats.h
+ *
+ * The watchdog's view of the tasks. Each task has a heartbeat word: the tick
+ * it last reported running at, written with one aligned 32-bit store (atomic on
+ * the M0+), so reporting never takes a lock or blocks. Checking a task in or
+ * out (on state changes) changes more than one word, so those bump a
+ * transition count before and after (odd while one is underway); a check
+ * that sees the count change under it retries rather than trusting a half-
+ * changed view. This has no RTOS or ASF includes (ticks are passed in), so it
+ * runs on a host too (see heartbeat_tests.c).
+ *
+ * Created: 10/19/2026 2:10:05 PM
+ *  Author: BSE
+ */
+
+
+#ifndef HEARTBEATS_H_
+#define HEARTBEATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HEARTBEATS_MAX_TASKS		10 // == NUM_TASKS
+
+typedef enum {
+	HEARTBEATS_OK,
+	HEARTBEATS_MISSED,		// a task is late, or reported while checked out
+	HEARTBEATS_CHANGING		// a check in / out happened during the check; try again
+} heartbeats_result_t;
+
+typedef struct heartbeats {
+	volatile uint32_t beats[HEARTBEATS_MAX_TASKS];			// tick of the last report (0 if checked out)
+	volatile uint32_t checked_in_at[HEARTBEATS_MAX_TASKS];	// tick of the last check in
+	volatile bool checked_in[HEARTBEATS_MAX_TASKS];
+	volatile uint32_t transitions;
+} heartbeats_t;
+
+void heartbeats_init(heartbeats_t* hb);
+void heartbeat_check_in(heartbeats_t* hb, int task, uint32_t now);
+void heartbeat_check_out(heartbeats_t* hb, int task);
+
+/* a task reporting it's running (lock-free) */
+static inline void heartbeat_beat(heartbeats_t* hb, int task, uint32_t now) {
+	hb->beats[task] = now;
+}
+
+heartbeats_result_t heartbeats_check(const heartbeats_t* hb, int first_task, int num_tasks,
+	const uint32_t* allowed_ms, uint32_t now, int* missed_task);
+
+#endif /* HEARTBEATS_H_ */
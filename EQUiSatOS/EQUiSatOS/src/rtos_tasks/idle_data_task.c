@@ -6,6 +6,10 @@
  */
 
 #include "rtos_tasks.h"
+#include "../telemetry/downlink_ledger.h"
+
+// list of reads done each iteration (static to keep it off the task stack)
+static sensor_transaction_t idle_data_txn;
 
 void idle_data_task(void *pvParameters)
 {
@@ -27,7 +31,7 @@ void idle_data_task(void *pvParameters)
 
 	for( ;; )
 	{
-		vTaskDelayUntil( &prev_wake_time, IDLE_DATA_TASK_FREQ / portTICK_PERIOD_MS);
+		task_delay_until_safe(IDLE_DATA_TASK, &prev_wake_time, IDLE_DATA_TASK_FREQ / portTICK_PERIOD_MS);
 
 		// report to watchdog
 		report_task_running(IDLE_DATA_TASK);
@@ -40,24 +44,22 @@ void idle_data_task(void *pvParameters)
 
 		// add all sensors to batch
 		current_struct->satellite_history = cache_get_sat_event_history();
-		read_lion_volts_batch(			current_struct->lion_volts_data);
-		// the next couple readings use IR power on, so turn it on for them
-		// to speed up the readings (otherwise they have to wait for it to come on each time)
-		bool got_semaphore = enable_ir_pow_if_necessary();
-		{
-			en_and_read_lion_temps_batch(	current_struct->lion_temps_data);
-			read_ad7991_batbrd(				current_struct->lion_current_data, current_struct->panelref_lref_data);
-			read_bat_charge_dig_sigs_batch(	&(current_struct->bat_charge_dig_sigs_data));
-			read_imu_temp_batch(			&(current_struct->imu_temp_data));
-			read_radio_temp_batch(			&(current_struct->radio_temp_data));
-			read_ir_ambient_temps_batch(	current_struct->ir_amb_temps_data);
-		
-			// verify readings (without storing) at regular intervals in this task
-			verify_regulators();
-			verify_flash_readings(false); // not flashing (function is thread-safe)
-		}
-		// try to disable IR power because we're done, but only if we get the mutex (we expect it to be on so no errors)
-		disable_ir_pow_if_necessary(got_semaphore);
+		// all reads are done in one transaction, which locks the hardware mutexes
+		// and turns on IR power only once for the whole set
+		sensor_txn_begin(&idle_data_txn);
+		sensor_txn_add(&idle_data_txn, SR_LION_VOLTS,			current_struct->lion_volts_data, NULL);
+		sensor_txn_add(&idle_data_txn, SR_LION_TEMPS,			current_struct->lion_temps_data, NULL);
+		sensor_txn_add(&idle_data_txn, SR_AD7991_BATBRD,		current_struct->lion_current_data, current_struct->panelref_lref_data);
+		sensor_txn_add(&idle_data_txn, SR_BAT_CHARGE_DIG_SIGS,	&(current_struct->bat_charge_dig_sigs_data), NULL);
+		sensor_txn_add(&idle_data_txn, SR_IMU_TEMP,			&(current_struct->imu_temp_data), NULL);
+		sensor_txn_add(&idle_data_txn, SR_RADIO_TEMP,			&(current_struct->radio_temp_data), NULL);
+		sensor_txn_add(&idle_data_txn, SR_IR_AMBIENT_TEMPS,	current_struct->ir_amb_temps_data, NULL);
+		// verify readings (without storing) at regular intervals in this task
+		sensor_txn_add(&idle_data_txn, SR_VERIFY_FLASH_READINGS, NULL, NULL); // not flashing
+		sensor_txn_run(&idle_data_txn, ELOC_IDLE_DATA);
+		// not part of the transaction because it may wait for the regulators to settle,
+		// which must only be done while holding the I2C mutex (see sensor_transaction.h)
+		verify_regulators();
 		
 		// in this task only, manually disable IR power if it's on and on one's using it
 		ensure_ir_power_disabled(false);
@@ -71,6 +73,7 @@ void idle_data_task(void *pvParameters)
 			uint32_t time_since_last_log_s = get_current_timestamp() - time_of_last_log_s;
 			if (time_since_last_log_s >= IDLE_DATA_LOG_FREQ_S) {
 				// validate previous stored value in stack, getting back the next staged address we can start adding to
+				current_struct->reading_id = new_reading_id(IDLE_DATA);
 				current_struct = (idle_data_t*) equistack_Stage(&idle_readings_equistack);
 				time_of_last_log_s = get_current_timestamp();
 			}
@@ -6,6 +6,7 @@
  */ 
 
 #include "rtos_tasks.h"
+#include "../telemetry/downlink_ledger.h"
 
 void low_power_data_task(void *pvParameters)
 {
@@ -24,7 +25,7 @@ void low_power_data_task(void *pvParameters)
 	
 	for( ;; )
 	{	
-		vTaskDelayUntil( &prev_wake_time, LOW_POWER_DATA_TASK_FREQ / portTICK_PERIOD_MS);
+		task_delay_until_safe(LOW_POWER_DATA_TASK, &prev_wake_time, LOW_POWER_DATA_TASK_FREQ / portTICK_PERIOD_MS);
 		
 		// report to watchdog
 		report_task_running(LOW_POWER_DATA_TASK);
@@ -64,6 +65,7 @@ void low_power_data_task(void *pvParameters)
 		TickType_t data_read_time = (xTaskGetTickCount() / portTICK_PERIOD_MS) - time_before_data_read;
 		if (data_read_time <= LOW_POWER_DATA_MAX_READ_TIME) {
 			// validate previous stored value in stack, getting back the next staged address we can start adding to
+			current_struct->reading_id = new_reading_id(LOW_POWER_DATA);
 			current_struct = (low_power_data_t*) equistack_Stage(&low_power_readings_equistack);
 		} else {
 			// log error if the data read took too long
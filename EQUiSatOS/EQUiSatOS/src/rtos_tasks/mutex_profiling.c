@@ -0,0 +1,101 @@
+/*
+ * mutex_profiling.c
+ *
+ * Created: 10/19/2026 11:42:20 AM
+ *  Author: BSE
+ */
+
+#include "mutex_profiling.h"
+#include "rtos_tasks.h"
+#include "../processor_drivers/TC_Commands.h"
+
+// in mutex_stats_id_t order
+static SemaphoreHandle_t* profiled_mutexes[MUTEX_STATS_NUM] = {
+	&critical_action_mutex,
+	&i2c_irpow_mutex,
+	&processor_adc_mutex,
+	&hardware_state_mutex,
+	&watchdog_mutex,
+	&mram_spi_cache_mutex,
+	&_idle_equistack_mutex,
+	&_attitude_equistack_mutex,
+	&_flash_equistack_mutex,
+	&_flash_cmp_equistack_mutex,
+	&_low_power_equistack_mutex,
+	&_runtime_stats_equistack_mutex,
+	&_mutex_stats_equistack_mutex,
+	&_error_equistack_mutex
+};
+
+// this period's stats (changed in critical sections, as takes can time out together)
+static mutex_stats_t mutex_stats[MUTEX_STATS_NUM];
+// run time stats counter when each was last taken (only touched by its holder)
+static uint32_t taken_at[MUTEX_STATS_NUM];
+
+void init_mutex_profiling(void) {
+	configASSERT(NUM_MUTEX_STATS == MUTEX_STATS_NUM);
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		mutex_stats_clear(&mutex_stats[i]);
+	}
+}
+
+// the profiled mutex (-1 if it isn't one)
+static int profiled_mutex_id(SemaphoreHandle_t mutex) {
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		if (*profiled_mutexes[i] == mutex) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+BaseType_t profiled_mutex_take(SemaphoreHandle_t mutex, TickType_t wait_ticks) {
+	int id = profiled_mutex_id(mutex);
+	if (id < 0) {
+		return xSemaphoreTake(mutex, wait_ticks);
+	}
+
+	uint32_t start = runtime_counter_read();
+	BaseType_t got = xSemaphoreTake(mutex, wait_ticks);
+	uint32_t now = runtime_counter_read();
+	uint8_t owner = MUTEX_STATS_NO_OWNER;
+	if (got) {
+		taken_at[id] = now;
+	} else {
+		// (whoever had it may have given it up since)
+		TaskHandle_t holder = xSemaphoreGetMutexHolder(mutex);
+		if (holder != NULL) {
+			owner = get_runtime_stats_slot(holder);
+		}
+	}
+
+	taskENTER_CRITICAL();
+	mutex_stats_note_take(&mutex_stats[id], now - start, got, owner);
+	taskEXIT_CRITICAL();
+	return got;
+}
+
+BaseType_t profiled_mutex_give(SemaphoreHandle_t mutex) {
+	int id = profiled_mutex_id(mutex);
+	// (only holds we timed; it may have been taken from an ISR, or not at all)
+	if (id >= 0 && xSemaphoreGetMutexHolder(mutex) == xTaskGetCurrentTaskHandle()) {
+		uint32_t hold_us = runtime_counter_read() - taken_at[id];
+		taskENTER_CRITICAL();
+		mutex_stats_note_hold(&mutex_stats[id], hold_us);
+		taskEXIT_CRITICAL();
+	}
+	return xSemaphoreGive(mutex);
+}
+
+/* ends the current stats period, summarizing it into report */
+void close_mutex_stats_period(mutex_stats_report_t* report) {
+	// (summarizing divides, so copy the stats out quickly and do that after)
+	static mutex_stats_t period[MUTEX_STATS_NUM];
+	taskENTER_CRITICAL();
+	memcpy(period, mutex_stats, sizeof(mutex_stats));
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		mutex_stats_clear(&mutex_stats[i]);
+	}
+	taskEXIT_CRITICAL();
+	mutex_stats_summarize(period, report);
+}
@@ -0,0 +1,36 @@
+/*
+ * mutex_profiling.h
+ *
+ * Take / give for the shared mutexes. With MUTEX_PROFILING defined (config.h)
+ * these time the mutexes in mutex_stats_id_t (see mutex_stats.h) and are just
+ * xSemaphoreTake / xSemaphoreGive otherwise (and for any other mutex).
+ * Only for use from tasks; ISRs keep using the FromISR calls.
+ * (This doesn't include global.h, so equistacks can use it.)
+ *
+ * Created: 10/19/2026 11:41:52 AM
+ *  Author: BSE
+ */
+
+
+#ifndef MUTEX_PROFILING_H_
+#define MUTEX_PROFILING_H_
+
+#include <config.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "../data_handling/mutex_stats.h"
+
+#ifdef MUTEX_PROFILING
+	#define mutex_take(mutex, wait_ticks)	profiled_mutex_take(mutex, wait_ticks)
+	#define mutex_give(mutex)				profiled_mutex_give(mutex)
+#else
+	#define mutex_take(mutex, wait_ticks)	xSemaphoreTake(mutex, wait_ticks)
+	#define mutex_give(mutex)				xSemaphoreGive(mutex)
+#endif
+
+BaseType_t profiled_mutex_take(SemaphoreHandle_t mutex, TickType_t wait_ticks);
+BaseType_t profiled_mutex_give(SemaphoreHandle_t mutex);
+void init_mutex_profiling(void);
+void close_mutex_stats_period(mutex_stats_report_t* report);
+
+#endif /* MUTEX_PROFILING_H_ */
@@ -3,27 +3,62 @@
  *
  * Created: 12/8/2017 01:40:22
  *  Author: mcken
- */ 
+ */
 
 #include "rtos_tasks.h"
+#include "../telemetry/downlink_ledger.h"
+
+// the period being reported on (static to keep it off the task stack)
+static runtime_period_t runtime_period;
 
 // super simple task that periodically writes satellite state to non-volatile memory
+// (and reports on CPU, stack and mutex use every so often)
 void persistent_data_backup_task(void *pvParameters) {
 	// delay to offset task relative to others, then start
 	vTaskDelay(PERSISTENT_DATA_BACKUP_TASK_FREQ_OFFSET);
 	TickType_t prev_wake_time = xTaskGetTickCount();
 
+	// initialize first struct
+	runtime_stats_data_t *current_struct = (runtime_stats_data_t*) equistack_Initial_Stage(&runtime_stats_equistack);
+	#ifdef MUTEX_PROFILING
+		mutex_stats_data_t *mutex_struct = (mutex_stats_data_t*) equistack_Initial_Stage(&mutex_stats_equistack);
+	#endif
+
 	init_task_state(PERSISTENT_DATA_BACKUP_TASK);
 
+	// (the first period runs from boot)
+	uint32_t time_of_last_log_s = get_current_timestamp();
+
 	for( ;; )
 	{
 		vTaskDelayUntil( &prev_wake_time, PERSISTENT_DATA_BACKUP_TASK_FREQ / portTICK_PERIOD_MS);
-		
+
 		report_task_running(PERSISTENT_DATA_BACKUP_TASK);
-		
+
+		// (so the watermarks go out with the state)
+		sample_stack_min_free();
 		write_state_to_storage();
+
+		uint32_t time_since_last_log_s = get_current_timestamp() - time_of_last_log_s;
+		if (time_since_last_log_s >= RUNTIME_STATS_LOG_FREQ_S) {
+			// close the period quickly, then work out the report (which divides a lot) outside that
+			close_runtime_stats_period(&runtime_period);
+			runtime_stats_summarize(&runtime_period, &current_struct->report);
+			get_stack_min_free(current_struct->stack_min_free);
+			current_struct->timestamp = get_current_timestamp();
+			current_struct->reading_id = new_reading_id(RUNTIME_STATS_DATA);
+			current_struct = (runtime_stats_data_t*) equistack_Stage(&runtime_stats_equistack);
+			#ifdef MUTEX_PROFILING
+				// (same period, give or take)
+				close_mutex_stats_period(&mutex_struct->report);
+				mutex_struct->timestamp = get_current_timestamp();
+				mutex_struct->reading_id = new_reading_id(MUTEX_STATS_DATA);
+				mutex_struct = (mutex_stats_data_t*) equistack_Stage(&mutex_stats_equistack);
+			#endif
+			time_of_last_log_s = get_current_timestamp();
+		}
 	}
-	
+
 	// delete this task if it ever breaks out
 	vTaskDelete( NULL );
-}
\ No newline at end of file
+}
@@ -10,6 +10,7 @@
 #include "data_handling/Sensor_Structs.h"
 #include "data_handling/equistack.h"
 #include "sensor_drivers/sensor_read_commands.h"
+#include "processor_drivers/TC_Commands.h"
 
 /************************************************************************/
 /* TASK CONTROL FUNCTIONS                                               */
@@ -30,6 +31,7 @@ static void init_task_handles(void) {
 
 void pre_init_rtos_tasks(void) {
 	init_task_handles();
+	init_stack_min_free();
 }
 
 /************************************************************************/
@@ -49,11 +51,174 @@ equistack* get_msg_type_equistack(msg_data_type_t msg_type) {
 			return &flash_cmp_readings_equistack;
 		case LOW_POWER_DATA:
 			return &low_power_readings_equistack;
+		case RUNTIME_STATS_DATA:
+			return &runtime_stats_equistack;
+		case MUTEX_STATS_DATA:
+			return &mutex_stats_equistack;
 		default:
 			return NULL;
 	}
 }
 
+/************************************************************************/
+/* RUN TIME STATS (see runtime_stats.h)									*/
+/************************************************************************/
+static runtime_stats_t runtime_stats;
+// (the idle task has no handle of ours to tag, so it's told apart by its TCB)
+static StaticTask_t idle_task_tcb;
+#ifdef TRACE_RING
+	static trace_snapshot_t trace_ring; // (see TRACE RING below)
+	// slot of the task running, for events that don't say
+	static uint8_t trace_task = RUNTIME_STATS_OTHER_SLOT;
+#endif
+
+/* starts the counter, charging everything to RUNTIME_STATS_OTHER_SLOT
+   until tasks start being switched in (before the scheduler is started) */
+void init_runtime_stats(void) {
+	configure_runtime_counter();
+	runtime_stats_init(&runtime_stats, RUNTIME_STATS_OTHER_SLOT, runtime_counter_read());
+}
+
+/* tags each created task with its slot (+ 1, so untagged tasks are NULL) */
+void tag_runtime_stats_tasks(void) {
+	configASSERT(NUM_TASKS + 2 == RUNTIME_STATS_SLOTS);
+	for (int t = 0; t < NUM_TASKS; t++) {
+		if (*task_handles[t] != NULL) {
+			vTaskSetApplicationTaskTag(*task_handles[t], (TaskHookFunction_t) (uintptr_t) (t + 1));
+		}
+	}
+}
+
+static inline uint8_t task_slot(void* tcb, void* tag) {
+	if (tag != NULL) {
+		return (uint8_t) ((uintptr_t) tag - 1);
+	} else if (tcb == &idle_task_tcb) {
+		return RUNTIME_STATS_IDLE_SLOT;
+	} else {
+		return RUNTIME_STATS_OTHER_SLOT;
+	}
+}
+
+/* called by the scheduler (from PendSV, with interrupts off) as it switches in the task with tcb */
+void runtime_stats_switched_in(void* tcb, void* tag) {
+	uint8_t slot = task_slot(tcb, tag);
+	uint32_t now = runtime_counter_read();
+	runtime_stats_switch(&runtime_stats, slot, now);
+	#ifdef TRACE_RING
+		trace_task = slot;
+		trace_ring_record(&trace_ring, now, slot, TRACE_EV_SWITCHED_IN, 0);
+	#endif
+}
+
+/* the run time stats slot task is charged to */
+uint8_t get_runtime_stats_slot(TaskHandle_t task) {
+	return task_slot((void*) task, (void*) xTaskGetApplicationTaskTag(task));
+}
+
+/* ends the current stats period, copying it out to period */
+void close_runtime_stats_period(runtime_period_t* period) {
+	taskENTER_CRITICAL();
+	runtime_stats_close_period(&runtime_stats, runtime_counter_read(), period);
+	taskEXIT_CRITICAL();
+}
+
+#ifdef TRACE_RING
+/************************************************************************/
+/* TRACE RING (see trace_ring.h)										*/
+/************************************************************************/
+/* records an event of the running task's; from the kernel's trace hooks (some
+   of which run with just the scheduler suspended), tasks or interrupts */
+void trace_ring_event(uint8_t event, uint32_t arg) {
+	UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	trace_ring_record(&trace_ring, runtime_counter_read(), trace_task, event, (uint16_t) arg);
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+/* records an event on another task (by the running one); the arg is its slot */
+void trace_ring_task_event(uint8_t event, void* tcb, void* tag) {
+	trace_ring_event(event, task_slot(tcb, tag));
+}
+
+/* trace_print */
+void trace_ring_print(const char* format) {
+	trace_ring_event(TRACE_EV_PRINT, trace_ring_hash(format));
+}
+
+/* stops recording, keeping what led up to now to write to MRAM (see
+   write_state_to_storage_emergency); returns whether this froze it */
+bool freeze_trace_ring(trace_freeze_reason_t reason) {
+	// (both lock-free)
+	uint32_t timestamp = get_current_timestamp();
+	uint8_t reboot_count = cache_get_reboot_count();
+
+	UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	bool froze = trace_ring_freeze(&trace_ring, runtime_counter_read(), trace_task,
+		reason, timestamp, reboot_count);
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+	return froze;
+}
+
+/* the ring if it's been frozen (it doesn't change after), otherwise NULL */
+const trace_snapshot_t* get_trace_snapshot(void) {
+	if (trace_ring.reason == TRACE_NOT_FROZEN) {
+		return NULL;
+	}
+	return &trace_ring;
+}
+#endif
+
+/************************************************************************/
+/* STACK WATERMARKS														*/
+/************************************************************************/
+// the least free stack (bytes) seen for each run time stats slot's task since launch
+// (the "other" slot's being the timer daemon's); kept in MRAM with the reading ledger
+static uint16_t stack_min_free[RUNTIME_STATS_SLOTS];
+// (the timer daemon has no handle of ours either)
+static StaticTask_t timer_task_tcb;
+
+void init_stack_min_free(void) {
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		stack_min_free[i] = STACK_MIN_FREE_NONE;
+	}
+}
+
+/* folds in the minimums stored before the last reboot */
+void restore_stack_min_free(const uint16_t* stored) {
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		if (stored[i] < stack_min_free[i]) {
+			stack_min_free[i] = stored[i];
+		}
+	}
+}
+
+/* takes each task's stack high watermark into the minimums; the watermark is
+   the least free stack the task has ever had, so this only has to run often
+   enough to get the worst into MRAM before a reset */
+void sample_stack_min_free(void) {
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		TaskHandle_t task;
+		if (i < NUM_TASKS) {
+			task = *task_handles[i];
+		} else {
+			task = (TaskHandle_t) (i == RUNTIME_STATS_IDLE_SLOT ? &idle_task_tcb : &timer_task_tcb);
+		}
+		// (NULL would be the calling task)
+		if (task == NULL) {
+			continue;
+		}
+		uint32_t free_bytes = uxTaskGetStackHighWaterMark(task) * sizeof(StackType_t);
+		if (free_bytes < stack_min_free[i]) {
+			stack_min_free[i] = free_bytes;
+		}
+	}
+}
+
+/* copies out the minimums (only the backup task changes them, so a copy
+   racing a sample at worst mixes two samples' worth) */
+void get_stack_min_free(uint16_t* copy) {
+	memcpy(copy, stack_min_free, sizeof(stack_min_free));
+}
+
 /************************************************************************/
 /* RTOS HOOKS															*/
 /************************************************************************/
@@ -62,6 +227,9 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, signed char *pcTaskName)
 	configASSERT(false); // MIGHT hang here on stack overflow
 	// if this happens for real, log error, write persistent state, and reset processor
 	log_error(ELOC_RTOS, ECODE_STACK_OVERFLOW, true);
+	#ifdef TRACE_RING
+		freeze_trace_ring(TRACE_FROZEN_STACK_OVERFLOW); // (written with the state)
+	#endif
 	write_state_to_storage_emergency(false); // NOT from ISR; do this to minimize stack usage
 	print("STACK OVERFLOW RESET -- RESETTING SATELLITE");
 	#ifdef WATCHDOG_RESET_ACTIVE
@@ -79,6 +247,14 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, signed char *pcTaskName)
 	// FOR TESTING
 //}
 
+/**
+ * The tick hook for FreeRTOS - run from the tick interrupt every tick, so it
+ * must be short and only use FromISR functions.
+ */
+void vApplicationTickHook(void) {
+	usart_rx_tick(); // notices the radio USART going idle
+}
+
 /************************************************************************/
 /* Required functions for FreeRTOS 9 static allocation					*/
 /* Copied from http://www.freertos.org/a00110.html						*/
@@ -94,12 +270,11 @@ void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer,
 	/* If the buffers to be provided to the Idle task are declared inside this
 	function then they must be declared static - otherwise they will be allocated on
 	the stack and so not exists after this function exits. */
-	static StaticTask_t xIdleTaskTCB;
 	static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
 
     /* Pass out a pointer to the StaticTask_t structure in which the Idle task's
     state will be stored. */
-    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskTCBBuffer = &idle_task_tcb; // (file scope; see runtime_stats_switched_in)
 
     /* Pass out the array that will be used as the Idle task's stack. */
     *ppxIdleTaskStackBuffer = uxIdleTaskStack;
@@ -121,12 +296,11 @@ void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer,
 	/* If the buffers to be provided to the Timer task are declared inside this
 	function then they must be declared static - otherwise they will be allocated on
 	the stack and so not exists after this function exits. */
-	static StaticTask_t xTimerTaskTCB;
 	static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
 
     /* Pass out a pointer to the StaticTask_t structure in which the Timer
     task's state will be stored. */
-    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskTCBBuffer = &timer_task_tcb; // (file scope; see sample_stack_min_free)
 
     /* Pass out the array that will be used as the Timer task's stack. */
     *ppxTimerTaskStackBuffer = uxTimerTaskStack;
@@ -18,7 +18,10 @@
 
 #include "rtos_tasks_config.h"
 #include "data_handling/State_Structs.h"
+#include "sensor_drivers/sensor_transaction.h"
 #include "watchdog_task.h"
+#include "mutex_profiling.h"
+#include "data_handling/trace_ring.h"
 
 /************************************************************************/
 /* TASK HEADERS                                                         */
@@ -81,6 +84,8 @@ equistack attitude_readings_equistack; // of attitude_data_t
 equistack flash_readings_equistack; // of flash_data_t
 equistack flash_cmp_readings_equistack; // of flash_cmp_t
 equistack low_power_readings_equistack; // of low_power_data_t
+equistack runtime_stats_equistack; // of runtime_stats_data_t
+equistack mutex_stats_equistack; // of mutex_stats_data_t
 
 /* Global (but don't use them!) arrays used in equistack (put here as an alternative to mallocing) */
 idle_data_t _idle_equistack_arr			[IDLE_STACK_MAX];
@@ -88,13 +93,15 @@ attitude_data_t _attitude_equistack_arr	[ATTITUDE_STACK_MAX];
 flash_data_t _flash_equistack_arr		[FLASH_STACK_MAX];
 flash_cmp_data_t _flash_cmp_equistack_arr	[FLASH_CMP_STACK_MAX];
 idle_data_t _low_power_equistack_arr	[LOW_POWER_STACK_MAX];
+runtime_stats_data_t _runtime_stats_equistack_arr	[RUNTIME_STATS_STACK_MAX];
+mutex_stats_data_t _mutex_stats_equistack_arr	[MUTEX_STATS_STACK_MAX];
 
 /* # of mutexes (for sat state handling) */
 #if (PRINT_DEBUG == 1 || PRINT_DEBUG == 3) && defined(SAFE_PRINT)
 	// to be technically correct with prints
-	#define NUM_MUTEXES			14
+	#define NUM_MUTEXES			16
 #else 
-	#define NUM_MUTEXES			13
+	#define NUM_MUTEXES			15
 #endif
 
 /* Global (but don't use them!) mutex data and mutex handles used inside equistacks (alt. to malloc) */
@@ -108,6 +115,10 @@ StaticSemaphore_t _flash_cmp_equistack_mutex_d;
 SemaphoreHandle_t _flash_cmp_equistack_mutex;
 StaticSemaphore_t _low_power_equistack_mutex_d;
 SemaphoreHandle_t _low_power_equistack_mutex;
+StaticSemaphore_t _runtime_stats_equistack_mutex_d;
+SemaphoreHandle_t _runtime_stats_equistack_mutex;
+StaticSemaphore_t _mutex_stats_equistack_mutex_d;
+SemaphoreHandle_t _mutex_stats_equistack_mutex;
 
 /************************************************************************/
 /* TASK STATE MANAGEMENT                                               */
@@ -140,6 +151,18 @@ uint32_t get_time_of_next_flash(void);	// implemented in flash_activate_task
 bool flash_now(void);					// implemented in flash_activate_task
 bool would_flash_now(void);				// implemented in flash_activate_task
 equistack* get_msg_type_equistack(msg_data_type_t msg_type);
+void init_runtime_stats(void);
+void tag_runtime_stats_tasks(void);
+void close_runtime_stats_period(runtime_period_t* period);
+uint8_t get_runtime_stats_slot(TaskHandle_t task);
+void init_stack_min_free(void);
+void restore_stack_min_free(const uint16_t* stored);
+void sample_stack_min_free(void);
+void get_stack_min_free(uint16_t* copy);
+#ifdef TRACE_RING
+	bool freeze_trace_ring(trace_freeze_reason_t reason);
+	const trace_snapshot_t* get_trace_snapshot(void);
+#endif
 bool should_exit_antenna_deploy(void);
 
 /************************************************************************/
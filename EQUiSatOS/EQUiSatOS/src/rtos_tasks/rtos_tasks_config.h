@@ -140,6 +140,8 @@ enum {
 #define ATTITUDE_STACK_MAX				6 // == (ATTITUDE_DATA_PACKETS + 1)
 #define FLASH_STACK_MAX					4 // such that we transmit all we store every minute
 #define FLASH_CMP_STACK_MAX				7 // == (FLASH_CMP_DATA_PACKETS + 1)
+#define RUNTIME_STATS_STACK_MAX			2 // == (RUNTIME_STATS_DATA_PACKETS + 1)
+#define MUTEX_STATS_STACK_MAX			2 // == (MUTEX_STATS_DATA_PACKETS + 1)
 
 /************************************************************************/
 /* Enum for states that represent changes in which tasks are running	*/
@@ -165,8 +167,10 @@ typedef enum
 	ATTITUDE_DATA,
 	FLASH_DATA,
 	FLASH_CMP_DATA,
-	LOW_POWER_DATA, // must be the largest value, because we wrap around this list and ignore it
-	NUM_MSG_TYPE // = LOW_POWER_DATA + 1
+	LOW_POWER_DATA,
+	RUNTIME_STATS_DATA,
+	MUTEX_STATS_DATA, // (the state string has room for up to 8 types)
+	NUM_MSG_TYPE // = MUTEX_STATS_DATA + 1
 } msg_data_type_t;
 
 /************************************************************************/
@@ -194,17 +198,8 @@ typedef enum
 /************************************************************************/
 
 // these are offsets are added to "start time" to avoid periodic contention of tasks
-// offsets should be different especially for tasks that have similar (high) frequencies/priorities
-#define WATCHDOG_TASK_FREQ_OFFSET				100 // high-freq; should be small
-#define STATE_HANDLING_TASK_FREQ_OFFSET			200
-#define ANTENNA_DEPLOY_TASK_FREQ_OFFSET			300 // high-freq
-#define BATTERY_CHARGING_TASK_FREQ_OFFSET		30000 // should be small
-#define TRANSMIT_TASK_FREQ_OFFSET				1500
-#define FLASH_ACTIVATE_TASK_FREQ_OFFSET			600
-#define IDLE_DATA_TASK_FREQ_OFFSET				10000 // separate from attitude
-#define LOW_POWER_DATA_TASK_FREQ_OFFSET			800
-#define ATTITUDE_DATA_TASK_FREQ_OFFSET			900
-#define PERSISTENT_DATA_BACKUP_TASK_FREQ_OFFSET	500	// high-freq
+// (generated, along with a report on the contention they leave, by schedule_model.py)
+#include "rtos_tasks_offsets.h"
 
 /* action frequency periods in MS (some that actually have data collection are below) */
 #ifndef TESTING_SPEEDUP
@@ -247,6 +242,10 @@ typedef enum
 #ifndef TESTING_SPEEDUP
 #define PERSISTENT_DATA_BACKUP_TASK_FREQ		(1*60*1000)
 #endif
+	// (the backup task also closes out the run time stats period; see runtime_stats.h)
+	#ifndef TESTING_SPEEDUP
+	#define RUNTIME_STATS_LOG_FREQ_S				ORBITAL_PERIOD_S
+	#endif
 
 #ifndef TESTING_SPEEDUP
 #define ATTITUDE_DATA_TASK_FREQ					(4*60*1000)
@@ -297,6 +296,7 @@ typedef enum
 	#define LOW_POWER_DATA_TASK_FREQ			20000
 	#define BATTERY_CHARGING_TASK_FREQ			(1*60*1000)
 	#define PERSISTENT_DATA_BACKUP_TASK_FREQ	(30*1000)
+		#define RUNTIME_STATS_LOG_FREQ_S			(5*60)
 #endif
 
 #endif
@@ -0,0 +1,24 @@
+/*
+ * rtos_tasks_offsets.h
+ *
+ * How long after starting each task waits before its first run, so the
+ * periodic tasks' holds on the shared mutexes don't line up.
+ * Generated by schedule_model.py --optimize; rerun it (rather than editing
+ * these) when the task periods or what the tasks hold change.
+ */
+
+#ifndef RTOS_TASKS_OFFSETS_H
+#define RTOS_TASKS_OFFSETS_H
+
+#define WATCHDOG_TASK_FREQ_OFFSET				100 // high-freq; should be small
+#define STATE_HANDLING_TASK_FREQ_OFFSET			200
+#define ANTENNA_DEPLOY_TASK_FREQ_OFFSET			300 // high-freq
+#define BATTERY_CHARGING_TASK_FREQ_OFFSET		30000
+#define TRANSMIT_TASK_FREQ_OFFSET				1500
+#define FLASH_ACTIVATE_TASK_FREQ_OFFSET			11000
+#define IDLE_DATA_TASK_FREQ_OFFSET				10000
+#define LOW_POWER_DATA_TASK_FREQ_OFFSET			800
+#define ATTITUDE_DATA_TASK_FREQ_OFFSET			900
+#define PERSISTENT_DATA_BACKUP_TASK_FREQ_OFFSET	500
+
+#endif
@@ -9,6 +9,27 @@ void emergency_resume_antenna_deploy(void);
 void decide_next_state(sat_state_t current_state);
 void check_for_error_issues(void);
 
+/* waits until the next periodic check is due, or the battery readings cross a level
+   we decide on (see BATTERY_LEVELS_NOTIFY_BIT) */
+static void wait_for_next_check(TickType_t* prev_wake_time)
+{
+	TickType_t period = STATE_HANDLING_TASK_FREQ / portTICK_PERIOD_MS;
+	for ( ;; )
+	{
+		TickType_t left = *prev_wake_time + period - xTaskGetTickCount();
+		if ((int32_t) left <= 0) {
+			*prev_wake_time += period;
+			return;
+		}
+		// (other notifications, like state change acknowledgments, come through here too)
+		uint32_t bits = 0;
+		xTaskNotifyWait(0, BATTERY_LEVELS_NOTIFY_BIT, &bits, left);
+		if (bits & BATTERY_LEVELS_NOTIFY_BIT) {
+			return;
+		}
+	}
+}
+
 void state_handling_task(void *pvParameters)
 {
 	// delay to offset task relative to others, then start
@@ -36,7 +57,7 @@ void state_handling_task(void *pvParameters)
 			#endif
 		#endif
 		
-		vTaskDelayUntil(&prev_wake_time, STATE_HANDLING_TASK_FREQ / portTICK_PERIOD_MS);
+		wait_for_next_check(&prev_wake_time);
 		
 		// report to watchdog
 		report_task_running(STATE_HANDLING_TASK);
@@ -60,19 +81,21 @@ void decide_next_state(sat_state_t current_state) {
 	
 	///
 	// the state decision will be predicated on the current battery levels and
-	// the timestamp -- we'll grab them here
+	// the timestamp -- we'll grab them here (the battery charging task's, if
+	// they're recent enough)
 	///
 
-	uint16_t li1_mv;
-	uint16_t li2_mv;
-	read_lion_volts_precise(&li1_mv, &li2_mv, true);
+	battery_snapshot_t readings;
+	get_battery_readings(&readings, BATTERY_READINGS_MAX_AGE_MS);
+
+	uint16_t li1_mv = readings.li_mv[0];
+	uint16_t li2_mv = readings.li_mv[1];
 
 	// individual batteries within the life po banks
-	uint16_t lf1_mv;
-	uint16_t lf2_mv;
-	uint16_t lf3_mv;
-	uint16_t lf4_mv;
-	read_lifepo_volts_precise(&lf1_mv, &lf2_mv, &lf3_mv, &lf4_mv, true);
+	uint16_t lf1_mv = readings.lf_mv[0];
+	uint16_t lf2_mv = readings.lf_mv[1];
+	uint16_t lf3_mv = readings.lf_mv[2];
+	uint16_t lf4_mv = readings.lf_mv[3];
 
 	// average voltage for the batteries within each LF bank
 	int lfb1_sum = lf1_mv + lf2_mv;
@@ -87,11 +110,12 @@ void decide_next_state(sat_state_t current_state) {
 	// now it's time to check for all of the standard state changes
 	///
 
-	bat_charge_dig_sigs_batch batch;
-	bool got_batch = !read_bat_charge_dig_sigs_batch_with_retry(&batch);
+	bat_charge_dig_sigs_batch batch = readings.dig_sigs;
+	bool got_batch = readings.valid[BATTERY_SNAPSHOT_SIGS];
+	uint16_t panel_ref_val = readings.valid[BATTERY_SNAPSHOT_PANEL] ? readings.panel_ref : ((uint16_t) -1);
 
-	bool one_lf_full_one_above_flash = (get_lf_full(lfb1_sum, max(lf1_mv, lf2_mv), LFB1, batch, got_batch) && (lfb2_sum >= LF_FLASH_MIN_MV || charging_data.decommissioned[LFB2])) 
-									|| (get_lf_full(lfb2_sum, max(lf3_mv, lf4_mv), LFB2, batch, got_batch) && (lfb1_sum >= LF_FLASH_MIN_MV || charging_data.decommissioned[LFB1]));
+	bool one_lf_full_one_above_flash = (get_lf_full_with_panel_ref(lfb1_sum, max(lf1_mv, lf2_mv), LFB1, batch, got_batch, panel_ref_val) && (lfb2_sum >= LF_FLASH_MIN_MV || charging_data.decommissioned[LFB2])) 
+									|| (get_lf_full_with_panel_ref(lfb2_sum, max(lf3_mv, lf4_mv), LFB2, batch, got_batch, panel_ref_val) && (lfb1_sum >= LF_FLASH_MIN_MV || charging_data.decommissioned[LFB1]));
 	bool one_lf_below_flash = (lfb1_sum < LF_FLASH_MIN_MV) || (lfb2_sum < LF_FLASH_MIN_MV);
 
 	bool one_li_below_low_power = li1_mv <= LI_LOW_POWER_MV || li2_mv <= LI_LOW_POWER_MV;
@@ -131,7 +155,7 @@ void decide_next_state(sat_state_t current_state) {
 			else if (get_current_timestamp() > MIN_TIME_IN_BOOT_S)
 				set_sat_state(IDLE_NO_FLASH);
 			else if (should_exit_antenna_deploy())
-				task_suspend(ANTENNA_DEPLOY_TASK);
+				task_suspend_safe(ANTENNA_DEPLOY_TASK);
 			break;
 
 		case IDLE_NO_FLASH:
@@ -178,7 +202,7 @@ void check_for_error_issues(void) {
 	}
 	
 	// take error equistack mutex to have a consistent state; if we can't get it it's not crucial though
-	bool got_mutex = xSemaphoreTake(error_equistack.mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
+	bool got_mutex = mutex_take(error_equistack.mutex, (TickType_t) EQUISTACK_MUTEX_WAIT_TIME_TICKS);
 	if (!got_mutex) {
 		log_error(ELOC_STATE_HANDLING, ECODE_EQUISTACK_MUTEX_TIMEOUT, false);
 	}
@@ -196,7 +220,7 @@ void check_for_error_issues(void) {
 			}
 		}
 	}
-	if (got_mutex) xSemaphoreGive(error_equistack.mutex);
+	if (got_mutex) mutex_give(error_equistack.mutex);
 	
 	/*
 		if i2c-related devices are all failing, there may be an issue with the i2c bus, so 
@@ -0,0 +1,76 @@
+/*
+ * tickless_idle.c
+ *
+ * Created: 10/19/2026 4:06:40 PM
+ *  Author: BSE
+ */
+
+#include "tickless_idle.h"
+#include "rtos_tasks.h"
+#include "../processor_drivers/RTC_Commands.h"
+
+#ifdef TICKLESS_IDLE
+
+/* portSUPPRESS_TICKS_AND_SLEEP; called from the idle task with the scheduler
+   suspended, when no task is due for expected_idle_ticks */
+void vApplicationSleep(TickType_t expected_idle_ticks) {
+	uint32_t sleep_counts = tickless_sleep_counts(expected_idle_ticks);
+	if (sleep_counts < TICKLESS_MIN_SLEEP_COUNTS) {
+		return;
+	}
+
+	// (from here until the tick's corrected, an interrupt can wake us but not run)
+	__disable_irq();
+
+	// abort if a task was readied or a tick came due since the idle task checked,
+	// or the tick hook is waiting on the radio line going idle
+	if (eTaskConfirmSleepModeStatus() == eAbortSleep
+		|| (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+		|| usart_rx_tick_needed())
+	{
+		__enable_irq();
+		return;
+	}
+
+	// start on an RTC count edge, so the counts slept measure the sleep to
+	// the cycle rather than losing up to a count (~1ms) every time
+	uint32_t start = rtc_read_counts();
+	while (rtc_read_counts() == start);
+	start++;
+	sleep_counts--; // (the one we waited out)
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	uint32_t in_tick_cycles = SysTick->LOAD - SysTick->VAL;
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+		// (a tick came due while we waited; count it with the ones slept)
+		SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+		in_tick_cycles += TICKLESS_CYCLES_PER_TICK;
+	}
+	rtc_set_wake(start + sleep_counts);
+
+	// (the compare may not have synced in time to match; don't sleep through it)
+	if ((int32_t) (start + sleep_counts - rtc_read_counts()) > TICKLESS_COMPARE_SYNC_COUNTS) {
+		system_set_sleepmode(SYSTEM_SLEEPMODE_IDLE_0);
+		__DSB();
+		__WFI();
+		__ISB();
+	}
+
+	// awake (from the RTC or anything else); see how long for
+	uint32_t slept_counts = rtc_read_counts() - start;
+	rtc_clear_wake();
+	uint32_t rest_cycles;
+	uint32_t ticks = tickless_ticks_slept(in_tick_cycles, slept_counts,
+		expected_idle_ticks - 1, &rest_cycles);
+
+	// finish this tick period where it would have, then go back to whole ones
+	SysTick->LOAD = TICKLESS_CYCLES_PER_TICK - rest_cycles - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	vTaskStepTick(ticks);
+	SysTick->LOAD = TICKLESS_CYCLES_PER_TICK - 1;
+
+	// (whatever woke us runs now)
+	__enable_irq();
+}
+
+#endif
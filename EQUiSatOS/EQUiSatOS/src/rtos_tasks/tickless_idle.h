@@ -0,0 +1,72 @@
+/*
+ * tickless_idle.h
+ *
+ * Tickless idle (with TICKLESS_IDLE defined in config.h). When every task is
+ * blocked for a while, the idle task stops the 1 kHz SysTick, sets the RTC
+ * (counting RTC_COUNTS_PER_S) to wake the processor just before the next task
+ * is due, and sleeps in IDLE0 (so the DMA and the SERCOMs keep running). Any
+ * interrupt (a radio byte, the watchdog early warning) ends the sleep early;
+ * either way the RTC says how long it lasted, and the tick count is stepped
+ * forward by that and the SysTick restarted mid-period to stay in phase.
+ * It doesn't sleep while the tick hook is waiting on the radio line going
+ * idle (see usart_rx_tick), or for more than a watchdog period.
+ * The tick correction here has no RTOS or ASF includes, so it runs on a host
+ * too (see tickless_tests.c); tickless_model.py estimates what this saves.
+ *
+ * Created: 10/19/2026 4:05:12 PM
+ *  Author: BSE
+ */
+
+
+#ifndef TICKLESS_IDLE_H_
+#define TICKLESS_IDLE_H_
+
+#include <stdint.h>
+
+#define TICKLESS_CYCLES_PER_TICK		8000	// configCPU_CLOCK_HZ / configTICK_RATE_HZ
+// processor cycles per RTC count is 8000000 / 1024 = 7812.5
+#define TICKLESS_CYCLES_PER_2_COUNTS	15625
+#define TICKLESS_COUNTS_PER_S			1024	// RTC_COUNTS_PER_S
+// writing the RTC compare takes up to this long to sync (~6 slow clock cycles)
+#define TICKLESS_COMPARE_SYNC_COUNTS	8
+// not worth sleeping for less
+#define TICKLESS_MIN_SLEEP_COUNTS		(2*TICKLESS_COMPARE_SYNC_COUNTS)
+// the longest sleep (the watchdog task should wake well before this anyway)
+#define TICKLESS_MAX_SLEEP_TICKS		1500	// WATCHDOG_TASK_FREQ
+
+/* RTC counts to sleep for when the next task is due in idle_ticks (leaving
+   the last tick to the SysTick, so the tick count never passes it) */
+static inline uint32_t tickless_sleep_counts(uint32_t idle_ticks) {
+	if (idle_ticks > TICKLESS_MAX_SLEEP_TICKS) {
+		idle_ticks = TICKLESS_MAX_SLEEP_TICKS;
+	}
+	// (rounding down; a little short is fine, a little long isn't)
+	return (idle_ticks - 1) * TICKLESS_COUNTS_PER_S / 1000;
+}
+
+/* whole ticks passed, given the cycles into the tick period when the SysTick
+   stopped and the RTC counts slept since (at most max_ticks); rest_cycles
+   is how far into the next period that leaves us (short of its end, as the
+   SysTick can't be loaded with 0) */
+static inline uint32_t tickless_ticks_slept(uint32_t in_tick_cycles, uint32_t slept_counts,
+	uint32_t max_ticks, uint32_t* rest_cycles)
+{
+	// (anything past the longest sleep is late anyway; this keeps the math in 32 bits)
+	if (slept_counts > 2 * TICKLESS_MAX_SLEEP_TICKS) {
+		slept_counts = 2 * TICKLESS_MAX_SLEEP_TICKS;
+	}
+	uint32_t cycles = in_tick_cycles + slept_counts * TICKLESS_CYCLES_PER_2_COUNTS / 2;
+	uint32_t ticks = cycles / TICKLESS_CYCLES_PER_TICK;
+	uint32_t rest = cycles - ticks * TICKLESS_CYCLES_PER_TICK;
+	if (ticks > max_ticks) {
+		// (woke late; catch the tick up and let the SysTick take the next right away)
+		ticks = max_ticks;
+		rest = TICKLESS_CYCLES_PER_TICK - 2;
+	} else if (rest > TICKLESS_CYCLES_PER_TICK - 2) {
+		rest = TICKLESS_CYCLES_PER_TICK - 2;
+	}
+	*rest_cycles = rest;
+	return ticks;
+}
+
+#endif /* TICKLESS_IDLE_H_ */
@@ -22,20 +22,22 @@
 #define PRE_REPLY_DELAY_MS			700
 #define FLASH_CMD_PREFLASH_DELAY_MS 1500
 #define REBOOT_CMD_DELAY_MS			2000
+// time left at the end of a cycle after sending uplink replies (a reply in progress,
+// plus a radio housekeeping session in cycles that have one)
+#define UPLINK_REPLY_HOLD_MARGIN_NO_HK_MS	TOTAL_TRANSMIT_TIME_MS(CMD_RESPONSE_SIZE)
+#define UPLINK_REPLY_HOLD_MARGIN_MS			(RADIO_HK_MAX_SESSION_MS + UPLINK_REPLY_HOLD_MARGIN_NO_HK_MS)
 
 #define RADIO_KILL_DUR_3DAYS_S		259200		// 3 days
 #define RADIO_KILL_DUR_WEEK_S		604800		// 7 days
 
-// packet sequencing
-// TODO: is there an optimal order?
-#define DEFAULT_MSG_TYPE_SLOT_1		IDLE_DATA
-#define DEFAULT_MSG_TYPE_SLOT_2		ATTITUDE_DATA
-#define DEFAULT_MSG_TYPE_SLOT_3		FLASH_DATA
-#define DEFAULT_MSG_TYPE_SLOT_4		FLASH_CMP_DATA
+// packet sequencing: see telemetry/downlink_sched.h
 
 // timing constants
 #define MAX_CMD_MODE_RECOVERY_TIME_MS		(100 + WARM_RESET_WAIT_AFTER_MS + WARM_RESET_REBOOT_TIME + MAX_RADIO_CMD_TIME)
 #define TEMP_RESPONSE_TIME_MS				400
+// longest radio housekeeping session (see telemetry/radio_housekeeping.h):
+// entering command mode, reading the temperature and warm resetting
+#define RADIO_HK_MAX_SESSION_MS				(SET_CMD_MODE_WAIT_BEFORE_MS + SET_CMD_MODE_WAIT_AFTER_MS + TEMP_RESPONSE_TIME_MS + MAX_CMD_MODE_RECOVERY_TIME_MS)
 #define STATE_CHANGE_MONITOR_DELAY_TICKS	15
 
 // queue on which to receive rx_cmd_type_t's from UART interrupt to be processed
@@ -44,7 +46,7 @@
 QueueHandle_t rx_command_queue;
 
 void radio_control_init(void);
-uint16_t get_radio_temp_cached(void);
+uint16_t get_radio_temp_cached(void); // (see telemetry/radio_housekeeping.c)
 uint8_t* _get_cur_data_buf(void);
 
 #endif /* TRANSMIT_TASK_H_ */
\ No newline at end of file
@@ -21,8 +21,8 @@ uint32_t WATCHDOG_ALLOWED_TIMES_MS[NUM_TASKS] = {
 	PERSISTENT_DATA_BACKUP_TASK_FREQ + WATCHDOG_TASK_TIMEOUT_BUFFER
 };
 
-static bool check_ins[NUM_TASKS];
-static uint32_t running_times[NUM_TASKS];
+// (reports are lock-free; see heartbeats.h)
+static heartbeats_t heartbeats;
 static TickType_t prev_time;
 
 void init_watchdog_clock(void) {
@@ -34,16 +34,15 @@ void init_watchdog_clock(void) {
 // initializes our watchdog-monitoring task
 void init_watchdog_task(void) {
 	configASSERT(WATCHDOG_TASK == 0);
-	memset(&check_ins, 0, sizeof(bool) * NUM_TASKS);
-	memset(&running_times, 0, sizeof(uint32_t) * NUM_TASKS);
+	configASSERT(NUM_TASKS == HEARTBEATS_MAX_TASKS);
+	heartbeats_init(&heartbeats);
 	watchdog_mutex = xSemaphoreCreateMutexStatic(&_watchdog_task_mutex_d);
 	prev_time = xTaskGetTickCount();
 }
 
-static void task_pet_watchdog(bool got_mutex) {
+static void task_pet_watchdog(void) {
 	pet_watchdog();
 	print("Pet watchdog");
-	if (got_mutex) xSemaphoreGive(watchdog_mutex);
 }
 
 void watchdog_task(void *pvParameters) {
@@ -61,45 +60,33 @@ void watchdog_task(void *pvParameters) {
 	vTaskDelete( NULL );
 }
 
+// checks every task has reported recently enough (without the watchdog mutex;
+// a state change while checking just means checking again)
 bool watchdog_as_function(void) {
-	bool got_mutex = true;
-	if (!xSemaphoreTake(watchdog_mutex, WATCHDOG_MUTEX_WAIT_TIME_TICKS)) {
-		// this is an error but the watchdog is so critical we'll keep running
-		log_error(ELOC_WATCHDOG, ECODE_WATCHDOG_MUTEX_TIMEOUT, true);
-		got_mutex = false;
-	}
-	
 	bool watch_block = false;
 	// we only care about ticks since boot, not total timestamp
 	TickType_t curr_time = xTaskGetTickCount();
 	// if the time has wrapped around it will be less than the previous, so just say it's fine
 	// and wait for the next call of the task
 	if (curr_time < prev_time) {
-		task_pet_watchdog(got_mutex);
-		if (got_mutex) xSemaphoreGive(watchdog_mutex);
+		task_pet_watchdog();
 		return true;
 	}
 	prev_time = curr_time;
 	
 	// NOTE: WATCHDOG_TASK == 0
-	for (task_type_t i = WATCHDOG_TASK + 1; i < NUM_TASKS; i++) { 
-		if (!check_ins[i]) {
-			if (running_times[i]) {
-				watch_block = true;
-				break;
-			}
-		} else {
-			if (!running_times[i] || curr_time - running_times[i] > WATCHDOG_ALLOWED_TIMES_MS[i]) {
-				watch_block = true;
-				break;
-			}
-		}
+	int missed_task;
+	heartbeats_result_t result = HEARTBEATS_CHANGING;
+	for (int i = 0; i < WATCHDOG_CHECK_ATTEMPTS && result == HEARTBEATS_CHANGING; i++) {
+		result = heartbeats_check(&heartbeats, WATCHDOG_TASK + 1, NUM_TASKS,
+			WATCHDOG_ALLOWED_TIMES_MS, curr_time, &missed_task);
 	}
+	// (if tasks are still changing state, they've all just been checked in or out; wait for next time)
+	watch_block = result == HEARTBEATS_MISSED;
 
 	if (watch_block) {
 		// "kick" watchdog; RESTART SATELLITE
-		print("Watchdog kicked - RESTARTING Satellite");
-		if (got_mutex) xSemaphoreGive(watchdog_mutex);
+		print("Watchdog kicked - RESTARTING Satellite (task %d)", missed_task);
 
 		log_error(ELOC_WATCHDOG, ECODE_WATCHDOG_RESET, true);
 		write_state_to_storage();
@@ -113,7 +100,7 @@ bool watchdog_as_function(void) {
 		
 	} else {
 		// pet watchdog - pass this watchdog test, move onto next
-		task_pet_watchdog(got_mutex);
+		task_pet_watchdog();
 		return true;
 	}
 }
@@ -127,37 +114,33 @@ bool watchdog_as_function(void) {
 // be called when the watchdog mutex has been locked (even if the		
 // scheduler is suspended, a blocked task may still come in after that and
 // overwrite what was done)
+// Reports (report_task_running) don't need the mutex; they're one store.
 /************************************************************************/
 
 // tasks must check in when resuming from suspension or launching
 // NOTE: not safe to call without having gotten mutex
 void check_in_task_unsafe(task_type_t task_ind) {
-	check_ins[task_ind] = true; // set this task bit to true
-	// set a tasks running time to the current one 
 	// (this acts as its first "check in"; it may not run before watchdog does right after changing state)
-	running_times[task_ind] = xTaskGetTickCount();
+	taskENTER_CRITICAL();
+	heartbeat_check_in(&heartbeats, task_ind, xTaskGetTickCount());
+	taskEXIT_CRITICAL();
 }
 
 // tasks must check in while running to avoid the watchdog
 // (we'll set 'im loose on that task if it doesn't!)
+// (never blocks; see heartbeats.h)
 void report_task_running(task_type_t task_ind) {
-	bool got_mutex = true;
-	if (!xSemaphoreTake(watchdog_mutex, WATCHDOG_MUTEX_WAIT_TIME_TICKS)) {
-		// log error, but continue becasue this is crucial
-		log_error(ELOC_WATCHDOG, ECODE_WATCHDOG_MUTEX_TIMEOUT, true);
-		got_mutex = false;
-	}
-	running_times[task_ind] = xTaskGetTickCount();
-	if (got_mutex) xSemaphoreGive(watchdog_mutex);
+	heartbeat_beat(&heartbeats, task_ind, xTaskGetTickCount());
 }
 
 // tasks must check out when suspending so they don't trip the watchdog
 // NOTE: not safe to call without having gotten mutex
 void check_out_task_unsafe(task_type_t task_ind) {
-	check_ins[task_ind] = false; // set this task bit to false
-	// set the running time to 0 so when the check task is run, it makes sure
-	// there were no incorrect report_task_running calls
-	running_times[task_ind] = 0;
+	// (this clears its last report so the watchdog can make sure
+	// there were no incorrect report_task_running calls)
+	taskENTER_CRITICAL();
+	heartbeat_check_out(&heartbeats, task_ind);
+	taskEXIT_CRITICAL();
 }
 
 // INTERRUPT; Writes state to storage if the watchdog is about to restart the satellite
@@ -165,6 +148,9 @@ void watchdog_early_warning_callback(void) {
 	// if RTOS is ready we can manually log errors/write to storage
 	if (rtos_ready) {
 		log_error_from_isr(ELOC_WATCHDOG, ECODE_WATCHDOG_EARLY_WARNING, true);
+		#ifdef TRACE_RING
+			freeze_trace_ring(TRACE_FROZEN_WATCHDOG); // (written with the state)
+		#endif
 		write_state_to_storage_emergency(true); // from ISR
 	}
 	// otherwise; defer this operation by telling RTOS to do it once started
@@ -174,9 +160,9 @@ void watchdog_early_warning_callback(void) {
 /* testing functions */
 // testing function to get whether a task is checked in
 bool _get_task_checked_in(task_type_t task) {
-	return check_ins[task];
+	return heartbeats.checked_in[task];
 }
 // testing function to get time a task was checked in
 uint32_t _get_task_checked_in_time(task_type_t task) {
-	return running_times[task];
+	return heartbeats.beats[task];
 }
\ No newline at end of file
@@ -13,8 +13,11 @@
 #include "../rtos_tasks/rtos_tasks_config.h"
 #include "../rtos_tasks/rtos_tasks.h"
 #include "../data_handling/persistent_storage.h"
+#include "heartbeats.h"
 
 #define WATCHDOG_MUTEX_WAIT_TIME_TICKS ((TickType_t) 500)
+// times the watchdog checks the heartbeats when state changes interrupt it
+#define WATCHDOG_CHECK_ATTEMPTS 3
 
 #ifdef TESTING_SPEEDUP
 	#define WATCHDOG_TASK_TIMEOUT_BUFFER 10000
@@ -32,7 +35,7 @@ void init_watchdog_task(void);
 bool watchdog_as_function(void);
 
 void check_in_task_unsafe(task_type_t task_ind);
-void report_task_running(task_type_t task_ind); // always safe; uses mutex
+void report_task_running(task_type_t task_ind); // always safe; lock-free
 void check_out_task_unsafe(task_type_t task_ind);
 void watchdog_early_warning_callback(void);
 
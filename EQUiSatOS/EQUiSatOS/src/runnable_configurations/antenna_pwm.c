@@ -14,7 +14,7 @@ bool antenna_did_deploy(void) {
 	// if we fail to get the mutex, continue on and mess with anything reading sensors
 	// (we don't care about sensors much relative to antenna deployment)
 	bool got_mutex = false;
-	if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS)) {
+	if (processor_adc_mutex_take()) {
 		got_mutex = true;
 	} else {
 		log_error(ELOC_ANTENNA_DEPLOY, ECODE_PROC_ADC_MUTEX_TIMEOUT, true);
@@ -24,7 +24,7 @@ bool antenna_did_deploy(void) {
 	bool did_deploy = get_input(P_DET_RTN);
 	_set_5v_enable_unsafe(false);
 
-	if (got_mutex) xSemaphoreGive(processor_adc_mutex);
+	if (got_mutex) mutex_give(processor_adc_mutex);
 	return did_deploy;
 }
 
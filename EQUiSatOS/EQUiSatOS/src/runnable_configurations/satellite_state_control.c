@@ -18,8 +18,14 @@ task_states current_task_states;
 /************************************************************************/ 
 struct hw_states hardware_states = {false, RADIO_OFF, false, 0, 0, 0};
 
+// bumped whenever the rail, radio, or antenna state changes (as seen by
+// hardware_state_mutex_take/give), so users can cache results that depend on it
+static uint32_t hw_state_generation = 0;
+static struct hw_states hw_states_at_take; // protected by hardware_state_mutex
+
 /************************************************************************/
-/* List of mutexes for massive take of all of them during a task state change */
+/* List of mutexes (in the order they must be taken); a state change takes */
+/* those held by tasks it's suspending that aren't at a safe point      */
 /************************************************************************/
 // note; all are statically defined so have predetermined addresses
 SemaphoreHandle_t* all_mutexes_ordered[NUM_MUTEXES] = {
@@ -42,10 +48,16 @@ SemaphoreHandle_t* all_mutexes_ordered[NUM_MUTEXES] = {
 	&_flash_equistack_mutex,
 	&_flash_cmp_equistack_mutex,
 	&_low_power_equistack_mutex,
+	&_runtime_stats_equistack_mutex,
+	&_mutex_stats_equistack_mutex,
 	// error equistack mutex last just because it follows the calls structure
 	&_error_equistack_mutex
 };
 
+// tasks that are safe to suspend, and the state change waiting on them (see task_transitions.h)
+static task_transitions_t task_transitions;
+static TaskHandle_t volatile transition_waiter = NULL;
+
 void configure_state_from_reboot(void);
 void set_single_task_state(bool running, task_type_t task_id);
 void startup_task(void* pvParameters);
@@ -54,6 +66,15 @@ void startup_task(void* pvParameters);
 void run_rtos()
 {
 	configASSERT(NUM_MUTEXES == sizeof(all_mutexes_ordered) / sizeof(SemaphoreHandle_t*));
+	configASSERT(NUM_TASKS <= TASK_TRANSITIONS_MAX_TASKS);
+	task_transitions_init(&task_transitions);
+	
+	// start timing tasks before any run
+	init_runtime_stats();
+	#ifdef MUTEX_PROFILING
+		// (times off the same counter)
+		init_mutex_profiling();
+	#endif
 	
 	// create first init task to start RTOS and other tasks
 	xTaskCreateStatic(startup_task,
@@ -97,6 +118,8 @@ void startup_task(void* pvParameters) {
 	_flash_equistack_mutex = xSemaphoreCreateMutexStatic(&_flash_equistack_mutex_d);
 	_flash_cmp_equistack_mutex = xSemaphoreCreateMutexStatic(&_flash_cmp_equistack_mutex_d);
 	_low_power_equistack_mutex = xSemaphoreCreateMutexStatic(&_low_power_equistack_mutex_d);
+	_runtime_stats_equistack_mutex = xSemaphoreCreateMutexStatic(&_runtime_stats_equistack_mutex_d);
+	_mutex_stats_equistack_mutex = xSemaphoreCreateMutexStatic(&_mutex_stats_equistack_mutex_d);
 
 	// Initialize EQUiStacks
 	equistack_Init(&idle_readings_equistack, &_idle_equistack_arr,
@@ -109,6 +132,10 @@ void startup_task(void* pvParameters) {
 		sizeof(flash_cmp_data_t), FLASH_CMP_STACK_MAX, _flash_cmp_equistack_mutex);
  	equistack_Init(&low_power_readings_equistack, &_low_power_equistack_arr,
 		sizeof(low_power_data_t), LOW_POWER_STACK_MAX, _low_power_equistack_mutex);
+	equistack_Init(&runtime_stats_equistack, &_runtime_stats_equistack_arr,
+		sizeof(runtime_stats_data_t), RUNTIME_STATS_STACK_MAX, _runtime_stats_equistack_mutex);
+	equistack_Init(&mutex_stats_equistack, &_mutex_stats_equistack_arr,
+		sizeof(mutex_stats_data_t), MUTEX_STATS_STACK_MAX, _mutex_stats_equistack_mutex);
 		
 	/************************************************************************/
 	/* ESSENTIAL INITIALIZATION                                             */
@@ -140,6 +167,8 @@ void startup_task(void* pvParameters) {
 		vTraceSetMutexName(_flash_equistack_mutex , "eqF_BST");
 		vTraceSetMutexName(_flash_cmp_equistack_mutex, "eqF_CMP");
 		vTraceSetMutexName(_low_power_equistack_mutex, "eqLP");
+		vTraceSetMutexName(_runtime_stats_equistack_mutex, "eqRT");
+		vTraceSetMutexName(_mutex_stats_equistack_mutex, "eqMX");
 		vTraceSetMutexName(_error_equistack_mutex, "eqERR");
 	#endif
 	
@@ -255,6 +284,9 @@ void startup_task(void* pvParameters) {
 		&low_power_data_task_buffer);
 	#endif
 
+	// mark tasks for run time stats (before any of them run)
+	tag_runtime_stats_tasks();
+
 	xTaskResumeAll();
 
 	setTXEnable(false);
@@ -308,6 +340,10 @@ void configure_state_from_reboot(void) {
 	// add any errors we can from MRAM cache
 	// (NOTE; no one should've logged any yet, or else they may be overwritten!)
 	populate_error_stacks(&error_equistack);
+	// and pick up reading IDs where they left off (before any readings are logged)
+	populate_reading_ledger();
+	// and the stack watermarks
+	populate_stack_min_free();
 	
 	// if the satellite restarted because of the watchdog, log that as an error so we know
 	enum system_reset_cause cause = system_get_reset_cause();
@@ -458,7 +494,7 @@ bool set_sat_state(sat_state_t state) {
    which operates semi-independently of satellite state 
    (it must run in some, must not run in some, and doesn't 
     matter in others) */
-static void set_antenna_deploy_by_sat_state(sat_state_t prev_sat_state, sat_state_t next_sat_state, bool antenna_deployed) {
+static bool antenna_deploy_task_state(sat_state_t prev_sat_state, sat_state_t next_sat_state, bool antenna_deployed) {
 	bool antenna_task_state = false;
 	switch (prev_sat_state) {
 		// coming from initial, always turn on (we only ever go to antenna deploy)
@@ -505,17 +541,58 @@ static void set_antenna_deploy_by_sat_state(sat_state_t prev_sat_state, sat_stat
 			log_error(ELOC_STATE_HANDLING, ECODE_UNEXPECTED_CASE, false);
 			break;
 	}
-	
-	// actually set designated state
-	set_single_task_state(antenna_task_state, ANTENNA_DEPLOY_TASK);
-	// mainly for debugging; ensures check_task_state_consistenty is valid
-	current_task_states.states[ANTENNA_DEPLOY_TASK] = antenna_task_state;
+	return antenna_task_state;
+}
+
+/************************************************************************/
+/* SAFE POINTS (see task_transitions.h)                                 */
+/************************************************************************/
+static void enter_safe_point(task_type_t task_id) {
+	taskENTER_CRITICAL();
+	bool acknowledge = task_transitions_enter_safe_point(&task_transitions, task_id);
+	TaskHandle_t waiter = transition_waiter;
+	taskEXIT_CRITICAL();
+	if (acknowledge && waiter != NULL) {
+		// (if it's higher priority, it may suspend us right here; that's fine)
+		xTaskNotify(waiter, TASK_TRANSITION_ACK_NOTIFY_BIT, eSetBits);
+	}
+}
+
+static void leave_safe_point(task_type_t task_id) {
+	taskENTER_CRITICAL();
+	task_transitions_leave_safe_point(&task_transitions, task_id);
+	taskEXIT_CRITICAL();
+}
+
+/* vTaskDelayUntil for a task's wait between runs, during which a state change
+   may suspend it; call ONLY holding no mutexes or IR power */
+void task_delay_until_safe(task_type_t task_id, TickType_t* prev_wake_time, TickType_t ticks) {
+	enter_safe_point(task_id);
+	vTaskDelayUntil(prev_wake_time, ticks);
+	leave_safe_point(task_id);
+}
+
+/* vTaskDelay during which a state change may suspend the task; call ONLY
+   holding no mutexes or IR power */
+void task_delay_safe(task_type_t task_id, TickType_t ticks) {
+	enter_safe_point(task_id);
+	vTaskDelay(ticks);
+	leave_safe_point(task_id);
+}
+
+/* xQueueReceive during which a state change may suspend the task (for waits
+   within a run); call ONLY holding no mutexes or IR power */
+BaseType_t task_queue_receive_safe(task_type_t task_id, QueueHandle_t queue, void* buffer, TickType_t ticks) {
+	enter_safe_point(task_id);
+	BaseType_t received = xQueueReceive(queue, buffer, ticks);
+	leave_safe_point(task_id);
+	return received;
 }
 
 /************************************************************************/
 // TASK STATE CONTROL WRAPPERS
 // - task_suspend and task_resume are called while the scheduler
-//   is suspended and the watchdog mutex is locked so don't need to be safe
+//   is suspended so don't need to be safe
 /************************************************************************/
 
 // helper to wait until a semaphore is at zero
@@ -531,118 +608,175 @@ static bool wait_on_semaphore(SemaphoreHandle_t sem, TickType_t wait_time) {
 	return true;
 }
 
-// Takes all mutexes in RTOS, in particular those that a task could hold.
-// This is done because these mutexes would be inaccessible on that task's suspension.
-// Returns whether all were obtained. If they weren't, NO mutexes will be held.
-static bool take_all_mutexes(void) {
-	// starting from the top (first-taken mutex), try to take ALL the mutexes
-	int8_t i = 0;
-	while (i < NUM_MUTEXES) {
-		configASSERT(all_mutexes_ordered[i] != NULL);
-		if (all_mutexes_ordered[i] != NULL) { // avoid null pointer and leave it to watchdog
-			// handle special case for irpow counting semaphore (we can't just take it,
-			// we want to wait until everyone is done using it, so we wait for it to get to 0)
-			// NOTE that there are no guarantees we'll get it, but because all the things that use IR power
-			// take the i2c mutex, which we have, we'll be okay. (The auto-IR-power turn off logic handles this)
-			if (*(all_mutexes_ordered[i]) == irpow_semaphore) {
-				bool semaphore_got_to_zero = wait_on_semaphore(irpow_semaphore, TASK_STATE_CHANGE_MUTEX_WAIT_TIME_TICKS);
-				if (!semaphore_got_to_zero) {
-					// don't unravel mutexes, but log error (this could lead to timing issues in the future)
-					log_error(ELOC_STATE_HANDLING, ECODE_IR_POW_IN_USE_ON_STATE_CHANGE, false);
-				}
-			} else {
-				bool got_mutex = xSemaphoreTake(*(all_mutexes_ordered[i]), TASK_STATE_CHANGE_MUTEX_WAIT_TIME_TICKS);
-				if (!got_mutex) {
-					break; // start unraveling taken mutexes
-				}
-			}
+// the tasks (as a mask) running now that states stops
+static uint32_t tasks_to_suspend(const task_states* states) {
+	uint32_t to_suspend = 0;
+	for (task_type_t task_id = 0; task_id < NUM_TASKS; task_id++) {
+		if (!states->states[task_id] && !task_state_consistent(false, task_id)) {
+			to_suspend |= TASK_TRANSITIONS_BIT(task_id);
 		}
-		i++;
 	}
+	return to_suspend;
+}
 
-	// if we got all, we're good
-	if (i == NUM_MUTEXES) {
-		return true;
-	} else {
-		// don't try and give the mutex we couldn't get
-		i--;
-		
-		// if any cannot be obtained in their timeout, we have to unroll all our
-		// previous takings so we're not holding any mutexes, and THEN try again.
-		while (i >= 0) {
-			// (assume null check above worked for real satellite)
-			if (*(all_mutexes_ordered[i]) != irpow_semaphore) {
-				xSemaphoreGive(*(all_mutexes_ordered[i]));
-			}
-			i--;
-		}
+// whether any of the tasks (as a mask) holds mutex
+static bool mutex_held_by(SemaphoreHandle_t mutex, uint32_t tasks) {
+	TaskHandle_t holder = xSemaphoreGetMutexHolder(mutex);
+	if (holder == NULL) {
 		return false;
 	}
+	for (task_type_t task_id = 0; task_id < NUM_TASKS; task_id++) {
+		if ((tasks & TASK_TRANSITIONS_BIT(task_id)) && holder == *task_handles[task_id]) {
+			return true;
+		}
+	}
+	return false;
 }
 
-// Gives all mutexes that were taken above
-static void give_all_mutexes(void) {
-	for (int8_t i = 0; i < NUM_MUTEXES; i++) {
+// the first mutex (in order) from index first on that any of the tasks holds (NUM_MUTEXES if none)
+static int8_t next_mutex_held_by(uint32_t tasks, int8_t first) {
+	for (int8_t i = first; i < NUM_MUTEXES; i++) {
 		configASSERT(all_mutexes_ordered[i] != NULL);
-		if (all_mutexes_ordered[i] != NULL // avoid null pointer and leave it to watchdog
-			&& *(all_mutexes_ordered[i]) != irpow_semaphore) { // can't give the semaphore
-			xSemaphoreGive(*(all_mutexes_ordered[i]));
+		// (the IR power semaphore has no holder; see below)
+		if (all_mutexes_ordered[i] != NULL && *(all_mutexes_ordered[i]) != irpow_semaphore
+			&& mutex_held_by(*(all_mutexes_ordered[i]), tasks)) {
+			return i;
+		}
+	}
+	return NUM_MUTEXES;
+}
+
+static void give_mutexes(SemaphoreHandle_t* mutexes, int8_t num) {
+	while (num > 0) {
+		mutex_give(mutexes[--num]);
+	}
+}
+
+// Waits up to wait_ticks for the tasks (as a mask) to all be at safe points;
+// if they get there, returns true with the scheduler suspended (so they stay there).
+static bool suspend_scheduler_at_safe_points(uint32_t to_suspend, TickType_t wait_ticks) {
+	// (drop any acknowledgment left from a past change)
+	xTaskNotifyWait(0, TASK_TRANSITION_ACK_NOTIFY_BIT, NULL, 0);
+	vTaskSuspendAll();
+	transition_waiter = xTaskGetCurrentTaskHandle();
+	task_transitions_request(&task_transitions, to_suspend);
+	xTaskResumeAll();
+
+	TickType_t start_ticks = xTaskGetTickCount();
+	for (;;) {
+		vTaskSuspendAll();
+		if (task_transitions_unsafe(&task_transitions, to_suspend) == 0) {
+			return true;
+		}
+		xTaskResumeAll();
+		TickType_t waited = xTaskGetTickCount() - start_ticks;
+		if (waited >= wait_ticks) {
+			return false;
+		}
+		// (other notifications may wake us too; we just check again)
+		xTaskNotifyWait(0, TASK_TRANSITION_ACK_NOTIFY_BIT, NULL, wait_ticks - waited);
+	}
+}
+
+// For tasks that didn't get to a safe point in time: takes (in order, to avoid deadlock)
+// only the mutexes those tasks hold, so they can't be suspended holding one.
+// Returns the number taken (into taken, to give back after) with the scheduler suspended.
+static int8_t suspend_scheduler_unlocked(uint32_t to_suspend, SemaphoreHandle_t* taken) {
+	// IR power has no holder; as all users of it also take the i2c mutex, wait for it to be unused
+	if (!wait_on_semaphore(irpow_semaphore, TASK_STATE_CHANGE_MUTEX_WAIT_TIME_TICKS)) {
+		// don't unravel mutexes, but log error (this could lead to timing issues in the future)
+		log_error(ELOC_STATE_HANDLING, ECODE_IR_POW_IN_USE_ON_STATE_CHANGE, false);
+	}
+
+	for (uint8_t tries = 0; tries < TASK_STATE_CHANGE_MUTEX_TAKE_RETRIES; tries++) {
+		int8_t num_taken = 0;
+		bool got_all = true;
+		uint32_t late = task_transitions_unsafe(&task_transitions, to_suspend);
+		for (int8_t i = next_mutex_held_by(late, 0); i < NUM_MUTEXES; i = next_mutex_held_by(late, i + 1)) {
+			if (!mutex_take(*(all_mutexes_ordered[i]), TASK_STATE_CHANGE_MUTEX_WAIT_TIME_TICKS)) {
+				got_all = false;
+				break;
+			}
+			taken[num_taken++] = *(all_mutexes_ordered[i]);
 		}
+
+		if (got_all) {
+			// (they may have taken earlier ones while we waited, or others may have left safe points)
+			vTaskSuspendAll();
+			if (next_mutex_held_by(task_transitions_unsafe(&task_transitions, to_suspend), 0) == NUM_MUTEXES) {
+				return num_taken;
+			}
+			xTaskResumeAll();
+		}
+		// give back what we got and try again
+		give_mutexes(taken, num_taken);
 	}
+
+	// if we've failed at this point it's probably deadlock, so continue with the state change
+	// (use watchdog to represent this crazy failure)
+	configASSERT(false);
+	log_error(ELOC_STATE_HANDLING, ECODE_ALL_MUTEX_TIMEOUT, true);
+	vTaskSuspendAll();
+	return 0;
+}
+
+/* Suspends the RTOS scheduler once the to_suspend tasks (as a mask) can be
+   suspended without leaving a mutex held (normally when they're all at safe
+   points, between runs; if one doesn't get to one in time, when they hold none).
+   Tasks not being suspended keep running (and taking mutexes) until then.
+   The caller makes its changes and calls finish_task_transition, then resumes
+   the scheduler and gives back the mutexes taken. */
+static int8_t suspend_scheduler_for_transition(uint32_t to_suspend, SemaphoreHandle_t* taken) {
+	if (suspend_scheduler_at_safe_points(to_suspend, TASK_STATE_CHANGE_SAFE_POINT_WAIT_TICKS)) {
+		return 0;
+	}
+	return suspend_scheduler_unlocked(to_suspend, taken);
+}
+
+// (with the scheduler suspended)
+static void finish_task_transition(void) {
+	task_transitions_finish(&task_transitions);
+	transition_waiter = NULL;
 }
 
 /* 
-	Sets all task states atomically by suspending the RTOS scheduler and watchdog,
-	grabbing all mutexes to ensure no task is suspended while holding one, and
+	Sets all task states atomically by suspending the RTOS scheduler once
+	the tasks being suspended are at safe points (see task_transitions.h),
 	resuming or suspending tasks as specified, and setting the current
 	state variable (atomically in here)
 */
 void set_all_task_states(const task_states states, sat_state_t state, sat_state_t prev_sat_state)
 {
-	// determine whether antenna deployed before taking ALL mutexes
-	bool antenna_deployed = antenna_did_deploy();
-	
-	// IMPORTANT: take all mutexes to ensure no task is suspended while holding one.
-	// Note that the ordering here is important to avoid deadlock 
-	// (this is a coarse operation, but we consider it fine because these transitions
-	// should be fairly rare)
-	bool got_all = true;
-	uint8_t num_retries = 0;
-	do {
-		// take all mutexes, but give them back if any fails and try again
-		got_all = take_all_mutexes();
-		configASSERT(got_all);
-		num_retries++;
-		
-	} while (!got_all && num_retries < TASK_STATE_CHANGE_MUTEX_TAKE_RETRIES);
-	
-	configASSERT(got_all);
-	
-	// if we failed to get some mutex, continue on (if we've failed at this point
-	// it's probably deadlock, so continue with the state change) (log error of course)
-	if (!got_all) {
-		// (use watchdog to represent this crazy failure)
-		log_error(ELOC_STATE_HANDLING, ECODE_ALL_MUTEX_TIMEOUT, true);
-	}
+	// the antenna deploy task is independently handled
+	task_states next_states = states;
+	next_states.states[ANTENNA_DEPLOY_TASK] = antenna_deploy_task_state(prev_sat_state, state, antenna_did_deploy());
+
+	// only the tasks being suspended need to be somewhere safe; resuming can't strand a mutex
+	SemaphoreHandle_t taken[NUM_MUTEXES];
+	int8_t num_taken = suspend_scheduler_for_transition(tasks_to_suspend(&next_states), taken);
 	{
-		// NOTE we have the watchdog mutex as required for calling set_single_task_state
-		pet_watchdog(); // in case this takes a bit and we're close
-		vTaskSuspendAll();
 		// values given by external-facing functions
 		current_sat_state = state;
-		current_task_states = states;
+		current_task_states = next_states;
 
 		for (int task_id = 0; task_id < NUM_TASKS; task_id++) {
-			// antenna deploy task is independently handled
-			if (task_id != ANTENNA_DEPLOY_TASK) {
-				set_single_task_state(states.states[task_id], task_id);
-			} else {
-				set_antenna_deploy_by_sat_state(prev_sat_state, state, antenna_deployed);
-			}
+			set_single_task_state(next_states.states[task_id], task_id);
 		}
-		xTaskResumeAll();
+		finish_task_transition();
 	}
-	give_all_mutexes();
+	xTaskResumeAll();
+	give_mutexes(taken, num_taken);
+}
+
+/* Suspends the given task (outside of a state change) once it's somewhere safe
+   NOTE: CURRENTLY SHOULD ONLY BE CALLED ON THE ANTENNA_DEPLOY_TASK */
+void task_suspend_safe(task_type_t task_id) {
+	SemaphoreHandle_t taken[NUM_MUTEXES];
+	int8_t num_taken = suspend_scheduler_for_transition(TASK_TRANSITIONS_BIT(task_id), taken);
+	task_suspend(task_id);
+	finish_task_transition();
+	xTaskResumeAll();
+	give_mutexes(taken, num_taken);
 }
 
 // sets whether this task is running, suspended, or resumes a previous
@@ -704,9 +838,9 @@ void task_resume(task_type_t task_id)
 /* Resumes the given task, safely pausing the watchdog
    NOTE: CURRENTLY SHOULD ONLY BE CALLED ON THE ANTENNA_DEPLOY_TASK */
 void task_resume_safe(task_type_t task_id) {
-	if (xSemaphoreTake(watchdog_mutex, WATCHDOG_MUTEX_WAIT_TIME_TICKS)) {
+	if (mutex_take(watchdog_mutex, WATCHDOG_MUTEX_WAIT_TIME_TICKS)) {
 		task_resume(task_id);
-		xSemaphoreGive(watchdog_mutex);
+		mutex_give(watchdog_mutex);
 	} else {
 		log_error(ELOC_STATE_HANDLING, ECODE_WATCHDOG_MUTEX_TIMEOUT, false);
 	}
@@ -723,13 +857,42 @@ struct hw_states* get_hw_states(void) {
 }
 
 bool hardware_state_mutex_take(uint8_t eloc) {
-	if (!xSemaphoreTake(hardware_state_mutex, HARDWARE_STATE_MUTEX_WAIT_TIME_TICKS)) {
+	if (!mutex_take(hardware_state_mutex, HARDWARE_STATE_MUTEX_WAIT_TIME_TICKS)) {
 		log_error(eloc, ECODE_HW_STATE_MUTEX_TIMEOUT, false);
+		// callers generally go on to change the state anyway, and won't call
+		// give, so assume the worst
+		hw_state_generation++;
 		return false;	
 	};
+	hw_states_at_take = hardware_states;
 	return true;
 }
 
+static bool hw_state_changed_since_take(void) {
+	return hardware_states.rail_5v_enabled != hw_states_at_take.rail_5v_enabled
+		|| hardware_states.radio_state != hw_states_at_take.radio_state
+		|| hardware_states.antenna_deploying != hw_states_at_take.antenna_deploying;
+}
+
 void hardware_state_mutex_give(void) {
-	xSemaphoreGive(hardware_state_mutex);
+	if (hw_state_changed_since_take()) {
+		hw_state_generation++;
+	}
+	mutex_give(hardware_state_mutex);
+}
+
+// REQUIRES hardware_state_mutex
+// counts a state change made while holding the mutex now rather than when
+// it's given, so get_hw_state_generation reflects it before then
+void hardware_state_note_change_unsafe(void) {
+	if (hw_state_changed_since_take()) {
+		hw_state_generation++;
+		hw_states_at_take = hardware_states;
+	}
+}
+
+// see hw_state_generation; hold the hardware state mutex if it needs
+// to match the current state
+uint32_t get_hw_state_generation(void) {
+	return hw_state_generation;
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "testing_functions/sat_data_tests.h"
 #include "../testing_functions/os_system_tests.h"
 #include "antenna_pwm.h"
+#include "task_transitions.h"
 #include "../errors.h"
 
 /************************************************************************/
@@ -44,7 +45,13 @@ uint8_t got_early_warning_callback_in_boot;
 #define LOW_POWER_TASK_STATES 		((task_states){{true,	true,	true,	true,	true,	false,	false,	true,	false, 	true}})
 // **see .c file for ir power states**
 
-// duration to wait to get each of ALL the mutexes in sequence (LONG because we really need this)
+// duration to wait for the tasks being suspended to get to safe points (see task_transitions.h)
+// (a few seconds, longer than most runs; for a task still short of one after this -
+// the transmit task partway through its packets, say - the mutexes it holds are taken instead)
+#define TASK_STATE_CHANGE_SAFE_POINT_WAIT_TICKS		(3000 / portTICK_PERIOD_MS)
+// task notification bit for tasks to acknowledge a state change (see USART_RX_NOTIFY_BIT)
+#define TASK_TRANSITION_ACK_NOTIFY_BIT				(1UL << 1)
+// duration to wait to get each of the mutexes held by tasks that didn't get to safe points in time
 #define TASK_STATE_CHANGE_MUTEX_WAIT_TIME_TICKS		(4000 / portTICK_PERIOD_MS)
 #define TASK_STATE_CHANGE_MUTEX_TAKE_RETRIES		10
 #define SEMAPHORE_EMPTY_POLL_TIME_TICKS				10 // poll a lot
@@ -114,6 +121,10 @@ sat_state_t get_sat_state(void);
 bool set_sat_state(sat_state_t state);
 task_states get_sat_task_states(void);
 void task_resume_safe(task_type_t task_id);
+void task_suspend_safe(task_type_t task_id);
+void task_delay_until_safe(task_type_t task_id, TickType_t* prev_wake_time, TickType_t ticks);
+void task_delay_safe(task_type_t task_id, TickType_t ticks);
+BaseType_t task_queue_receive_safe(task_type_t task_id, QueueHandle_t queue, void* buffer, TickType_t ticks);
 bool check_task_state_consistency(void);
 bool low_power_active(void);
 
@@ -121,6 +132,8 @@ bool low_power_active(void);
 struct hw_states* get_hw_states(void);
 bool hardware_state_mutex_take(uint8_t eloc);
 void hardware_state_mutex_give(void);
+void hardware_state_note_change_unsafe(void);
+uint32_t get_hw_state_generation(void);
 
 void run_rtos(void);
 void init_task_state(task_type_t task);
@@ -12,6 +12,7 @@
 	#include "../telemetry/rscode-1.3/ecc.h"
 #endif
 #include "../processor_drivers/Flash_Commands.h"
+#include "../testing_functions/test_check.h"
 
 void runit(void){	
 	configure_i2c_standard(SERCOM4);
@@ -391,73 +392,76 @@ void pointer_typecast_test(void) {
 	configASSERT((recieve_buf_4 & 0xff) == 0xcd && ((recieve_buf_4 >> 8) & 0xff) == 0xab); // little endian
 }
 
+// feeds the string through the uplink matcher like the RX interrupt would,
+// returning the last command it completed
+static rx_cmd_type_t feed_rx(const char* str) {
+	rx_cmd_type_t cmd = CMD_NONE;
+	while (*str != '\0') {
+		rx_cmd_type_t test = check_rx_received((uint8_t) *str);
+		if (test != CMD_NONE) {
+			cmd = test;
+		}
+		str++;
+	}
+	return cmd;
+}
+
 void rx_pointer_test(void) {
-	char* cmd_test_buf;
-	rx_cmd_type_t test;
-	cmd_test_buf = "K1ADFLGHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_FLASH);
-	
-	cmd_test_buf = "K1ADFJGHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_NONE);
-	
-	cmd_test_buf = "K1ADECGHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_ECHO);
-	
-	cmd_test_buf = "K1ADK1GHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_KILL_3DAYS);
-	
-	cmd_test_buf = "K1ADK2GHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_KILL_WEEK);
-	
-	cmd_test_buf = "K1ADK3GHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_KILL_FOREVER);
-	
-	cmd_test_buf = "K1ADREGHIJKLMNOP";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_REBOOT);
-	
-	cmd_test_buf = "0000000000K1ADEC";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_ECHO);
-	
-	cmd_test_buf = "C0000000000K1ADE";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_ECHO);
-	
-	cmd_test_buf = "1ADEC0000000000K";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_ECHO);
-	
-	cmd_test_buf = "DEC0000000000K1A";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_ECHO);
-	
-	cmd_test_buf = "00000K1ADEC00000";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_ECHO);
-	
-	cmd_test_buf = "00000K1AD0EC0000";
-	memcpy(radio_receive_buffer, cmd_test_buf, LEN_RECEIVEBUFFER);
-	test = check_rx_received();
-	assert(test == CMD_NONE);
+	rx_cmd_type_t cmd;
+
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADFLGHIJKLMNOP");
+	test_check(cmd == CMD_FLASH);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADFJGHIJKLMNOP");
+	test_check(cmd == CMD_NONE);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADECGHIJKLMNOP");
+	test_check(cmd == CMD_ECHO);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADK1GHIJKLMNOP");
+	test_check(cmd == CMD_KILL_3DAYS);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADK2GHIJKLMNOP");
+	test_check(cmd == CMD_KILL_WEEK);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADK3GHIJKLMNOP");
+	test_check(cmd == CMD_KILL_FOREVER);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADREGHIJKLMNOP");
+	test_check(cmd == CMD_REBOOT);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("0000000000K1ADEC");
+	test_check(cmd == CMD_ECHO);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("00000K1ADEC00000");
+	test_check(cmd == CMD_ECHO);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("00000K1AD0EC0000");
+	test_check(cmd == CMD_NONE);
+	
+	// split across separate receives (formerly across the end of the ring buffer)
+	clear_USART_rx_buffer();
+	cmd = feed_rx("0000000000000K1A");
+	test_check(cmd == CMD_NONE);
+	cmd = feed_rx("DEC0000000000000");
+	test_check(cmd == CMD_ECHO);
+	
+	// restarting the callsign partway through a near-match
+	clear_USART_rx_buffer();
+	cmd = feed_rx("KK1ADEC");
+	test_check(cmd == CMD_ECHO);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1ADK1ADRV");
+	test_check(cmd == CMD_REVIVE);
+	
+	// clearing the buffer drops a partial command
+	clear_USART_rx_buffer();
+	cmd = feed_rx("K1AD");
+	test_check(cmd == CMD_NONE);
+	clear_USART_rx_buffer();
+	cmd = feed_rx("EC");
+	test_check(cmd == CMD_NONE);
 }
 
 void lf_full_discharge(void) {
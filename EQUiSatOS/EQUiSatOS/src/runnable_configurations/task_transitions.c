@@ -0,0 +1,52 @@
+/*
+ * task_transitions.c
+ *
+ * Created: 10/19/2026 5:13:10 PM
+ *  Author: BSE
+ */
+
+#include "task_transitions.h"
+#include <string.h>
+
+void task_transitions_init(task_transitions_t* tt) {
+	memset((void*) tt, 0, sizeof(task_transitions_t));
+}
+
+/************************************************************************/
+/* TASK SIDE (IN A CRITICAL SECTION)                                    */
+/************************************************************************/
+/* a task blocking between runs (holding nothing); returns whether a state
+   change is waiting on it (so it should acknowledge) */
+bool task_transitions_enter_safe_point(task_transitions_t* tt, int task) {
+	uint32_t bit = TASK_TRANSITIONS_BIT(task);
+	tt->at_safe_point |= bit;
+	if (tt->pending & bit) {
+		tt->pending &= ~bit;
+		return true;
+	}
+	return false;
+}
+
+/* a task waking to run (before it takes anything) */
+void task_transitions_leave_safe_point(task_transitions_t* tt, int task) {
+	tt->at_safe_point &= ~TASK_TRANSITIONS_BIT(task);
+}
+
+/************************************************************************/
+/* CHANGING SIDE (SCHEDULER SUSPENDED)                                  */
+/************************************************************************/
+/* asks the to_suspend tasks to acknowledge when they next reach a safe point
+   (even those at one now; they may leave it before the change is made) */
+void task_transitions_request(task_transitions_t* tt, uint32_t to_suspend) {
+	tt->pending |= to_suspend;
+}
+
+/* those of to_suspend that can't be suspended safely right now */
+uint32_t task_transitions_unsafe(const task_transitions_t* tt, uint32_t to_suspend) {
+	return to_suspend & ~tt->at_safe_point;
+}
+
+/* the change is made (or given up on); nothing's waiting on acknowledgments */
+void task_transitions_finish(task_transitions_t* tt) {
+	tt->pending = 0;
+}
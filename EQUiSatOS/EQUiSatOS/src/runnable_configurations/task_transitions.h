@@ -0,0 +1,46 @@
+/*
+ * task_transitions.h
+ *
+ * Which tasks can be suspended right now without leaving a lock held. Tasks
+ * that state changes can suspend mark themselves at a safe point while
+ * blocked between runs (when they hold no mutex or IR power), and unmark
+ * themselves on waking. A state change marks the tasks it will suspend
+ * pending; each acknowledges (to the changing task, by task notification)
+ * when it next reaches a safe point, and once all are at one the change
+ * suspends them there. Task-side calls must be in a critical section and
+ * changing-side ones with the scheduler suspended (so a task can't leave its
+ * safe point between being checked and being suspended).
+ * This has no RTOS or ASF includes, so it runs on a host too (see
+ * task_transition_tests.c).
+ *
+ * Created: 10/19/2026 5:12:44 PM
+ *  Author: BSE
+ */
+
+
+#ifndef TASK_TRANSITIONS_H_
+#define TASK_TRANSITIONS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TASK_TRANSITIONS_MAX_TASKS	32
+#define TASK_TRANSITIONS_BIT(task)	(1UL << (task))
+
+typedef struct task_transitions {
+	volatile uint32_t at_safe_point;	// tasks blocked between runs
+	volatile uint32_t pending;			// tasks a state change is waiting on
+} task_transitions_t;
+
+void task_transitions_init(task_transitions_t* tt);
+
+/* task side */
+bool task_transitions_enter_safe_point(task_transitions_t* tt, int task);
+void task_transitions_leave_safe_point(task_transitions_t* tt, int task);
+
+/* changing side */
+void task_transitions_request(task_transitions_t* tt, uint32_t to_suspend);
+uint32_t task_transitions_unsafe(const task_transitions_t* tt, uint32_t to_suspend);
+void task_transitions_finish(task_transitions_t* tt);
+
+#endif /* TASK_TRANSITIONS_H_ */
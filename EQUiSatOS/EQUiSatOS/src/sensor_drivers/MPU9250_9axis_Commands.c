@@ -1,8 +1,28 @@
 #include "MPU9250_9axis_Commands.h"
 
+static enum status_code MPU9250_write_reg(uint8_t reg, uint8_t val) {
+	uint8_t data[] = {reg, val};
+	return writeDataToAddress(data,2,MPU9250_ADDRESS,MPU9250_SHOULD_STOP);
+}
+
+// Also sets the sample rate and filter the FIFO window uses (see MPU9250_fifo_start).
+// These stay set, so the single accel/gyro reads get the same 41 Hz-filtered data,
+// updated every 25 ms (MPU9250_FIFO_SAMPLE_RATE_HZ) rather than the 250 Hz / 8 kHz default.
 enum status_code MPU9250_init(void) {
 	uint8_t address = 0;
-	return readFromAddressAndMemoryLocation(&address,1,MPU9250_ADDRESS,WHOAMI_ADDRESS,MPU9250_SHOULD_STOP);
+	enum status_code statc = readFromAddressAndMemoryLocation(&address,1,MPU9250_ADDRESS,WHOAMI_ADDRESS,MPU9250_SHOULD_STOP);
+	if (is_error(statc)) {
+		return statc;
+	}
+	// SMPLRT_DIV and CONFIG are adjacent, so set both in one write
+	uint8_t rateData[] = {SMPLRT_DIV, MPU9250_FIFO_SMPLRT_DIV,
+		MPU9250_CONFIG_FIFO_MODE_STOP | MPU9250_CONFIG_DLPF_41HZ};
+	statc = writeDataToAddress(rateData,3,MPU9250_ADDRESS,MPU9250_SHOULD_STOP);
+	if (is_error(statc)) {
+		return statc;
+	}
+	// FIFO access stays enabled; whether anything goes into it is up to FIFO_EN
+	return MPU9250_write_reg(USER_CTRL, MPU9250_USER_CTRL_FIFO_EN);
 }
 
 enum status_code gyro_init(void) {
@@ -100,12 +120,67 @@ enum status_code MPU9250_read_gyro_EQUiSat_coords(int16_t toFill[3]) {
 
 // to convert to Celsius: buf / 333.87 + 21.0
 enum status_code MPU9250_read_temp(int16_t* buf) {
-	uint8_t rawData[2];  // each byte of the data
-	enum status_code statc = readFromAddressAndMemoryLocation(rawData,2,MPU9250_ADDRESS,TEMP_READ_ADDRESS,MPU9250_SHOULD_STOP); 
+	uint8_t rawData[2];  // each byte of the data
+	enum status_code statc = readFromAddressAndMemoryLocation(rawData,2,MPU9250_ADDRESS,TEMP_READ_ADDRESS,MPU9250_SHOULD_STOP); 
 	*buf = ((int16_t)rawData[0] << 8) | rawData[1];  // Turn the MSB and LSB into a 16-bit value
 	return statc;
 }
 
+/************************************************************************/
+/* FIFO BURST MODE                                                      */
+/************************************************************************/
+// same axis conventions as MPU9250_read_acc / MPU9250_read_gyro
+static void MPU9250_parse_xyz(uint8_t* data, int16_t toFill[3]) {
+	toFill[0]=-(data[0]<<8 | data[1]);
+	toFill[1]=-(data[2]<<8 | data[3]);
+	toFill[2]=data[4]<<8 | data[5];
+}
+
+// resets the FIFO and starts the MPU filling it with accel + gyro frames at
+// MPU9250_FIFO_SAMPLE_RATE_HZ (as configured by MPU9250_init); read them back with
+// MPU9250_fifo_stop and MPU9250_fifo_read_frames. (The MPU must stay powered in between.)
+// Only FIFO_EN changes, and MPU9250_fifo_stop puts it back, so no other reads are affected.
+enum status_code MPU9250_fifo_start(void) {
+	// reset bit clears itself, leaving FIFO access enabled
+	enum status_code statc = MPU9250_write_reg(USER_CTRL, MPU9250_USER_CTRL_FIFO_EN | MPU9250_USER_CTRL_FIFO_RST);
+	if (is_error(statc)) {
+		return statc;
+	}
+	return MPU9250_write_reg(FIFO_EN, MPU9250_FIFO_EN_ACC_GYRO);
+}
+
+// stops sampling into the FIFO and gives the number of whole frames in it
+enum status_code MPU9250_fifo_stop(uint16_t* num_frames) {
+	uint8_t data[2] = {0, 0};
+	*num_frames = 0;
+	enum status_code statc = MPU9250_write_reg(FIFO_EN, 0x00);
+	if (is_error(statc)) {
+		return statc;
+	}
+	statc = readFromAddressAndMemoryLocation(data,2,MPU9250_ADDRESS,FIFO_COUNTH,MPU9250_SHOULD_STOP);
+	// count is 13 bits
+	*num_frames = ((((uint16_t) data[0] & 0x1F) << 8) | data[1]) / MPU9250_FIFO_FRAME_SIZE;
+	return statc;
+}
+
+// pops num_frames (<= MPU9250_FIFO_MAX_BURST_FRAMES) frames out of the FIFO
+// in a single burst read, oldest first
+enum status_code MPU9250_fifo_read_frames(int16_t acc[][3], int16_t gyro[][3], uint8_t num_frames) {
+	static uint8_t data[MPU9250_FIFO_MAX_BURST_FRAMES * MPU9250_FIFO_FRAME_SIZE];
+	if (num_frames > MPU9250_FIFO_MAX_BURST_FRAMES) {
+		num_frames = MPU9250_FIFO_MAX_BURST_FRAMES;
+	}
+	enum status_code statc = readFromAddressAndMemoryLocation(data,num_frames * MPU9250_FIFO_FRAME_SIZE,
+		MPU9250_ADDRESS,FIFO_R_W,MPU9250_SHOULD_STOP);
+	
+	for (int i = 0; i < num_frames; i++) {
+		uint8_t* frame = data + i * MPU9250_FIFO_FRAME_SIZE;
+		MPU9250_parse_xyz(frame, acc[i]);
+		MPU9250_parse_xyz(frame + 6, gyro[i]);
+	}
+	return statc;
+}
+
 float MPU9250_computeCompassDir(int16_t x, int16_t y, int16_t z) {
 	float heading = atan2(z, x);
 	float declinationAngle = 0.244346;
@@ -125,6 +200,8 @@ float MPU9250_computeCompassDir(int16_t x, int16_t y, int16_t z) {
 
 //Compute the biases from averaging surrounding inputs and loads them to bias registers i.e. "zeros" the IMU.
 // Should be run with the sensor flat and not moving.
+// Resets the MPU and changes its sample rate and filter, so MPU9250_init, gyro_init,
+// accel_init, and mag_init must be run again before the FIFO window is used.
 void MPU9250_computeBias(float* dest1, float* dest2){
 	uint8_t data[12]; // data array to hold accelerometer and gyro x, y, z, data
 	uint16_t ii, packet_count, fifo_count;
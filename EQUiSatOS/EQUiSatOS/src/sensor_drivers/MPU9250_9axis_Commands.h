@@ -64,6 +64,19 @@
 #define		ZA_OFFSET_H      0x0A
 #define		ZA_OFFSET_L_TC   0x0B
 
+//FIFO burst mode (accel + gyro frames sampled by the MPU itself)
+#define		MPU9250_FIFO_SIZE				512
+#define		MPU9250_FIFO_FRAME_SIZE			12 // accel xyz then gyro xyz, big-endian int16s
+// readFromAddressAndMemoryLocation takes a uint8_t length, so this many whole frames fit in one read
+#define		MPU9250_FIFO_MAX_BURST_FRAMES	(255 / MPU9250_FIFO_FRAME_SIZE)
+#define		MPU9250_FIFO_EN_ACC_GYRO		0x78
+#define		MPU9250_USER_CTRL_FIFO_EN		0x40
+#define		MPU9250_USER_CTRL_FIFO_RST		0x04
+#define		MPU9250_CONFIG_FIFO_MODE_STOP	0x40 // don't overwrite old frames when full (keeps frames aligned)
+#define		MPU9250_CONFIG_DLPF_41HZ		0x03 // 41 Hz bandwidth, 1 kHz internal sample rate
+#define		MPU9250_FIFO_SMPLRT_DIV			24	 // 1 kHz / (1 + 24) = 40 Hz into the FIFO
+#define		MPU9250_FIFO_SAMPLE_RATE_HZ		(1000 / (1 + MPU9250_FIFO_SMPLRT_DIV))
+
 enum status_code MPU9250_init(void);
 enum status_code gyro_init(void);
 enum status_code accel_init(void);
@@ -76,6 +89,9 @@ enum status_code MPU9250_read_acc_EQUiSat_coords(int16_t toFill[3]);
 enum status_code MPU9250_read_gyro(int16_t toFill[3]);
 enum status_code MPU9250_read_gyro_EQUiSat_coords(int16_t toFill[3]);
 enum status_code MPU9250_read_temp(int16_t* buf);
+enum status_code MPU9250_fifo_start(void);
+enum status_code MPU9250_fifo_stop(uint16_t* num_frames);
+enum status_code MPU9250_fifo_read_frames(int16_t acc[][3], int16_t gyro[][3], uint8_t num_frames);
 void MPU9250_computeBias(float* dest1, float* dest2);
 float MPU9250_computeCompassDir(int16_t x, int16_t y, int16_t z);
 
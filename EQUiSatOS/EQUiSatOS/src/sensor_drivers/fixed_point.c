@@ -0,0 +1,102 @@
+/*
+ * fixed_point.c
+ *
+ * Created: 10/18/2026 2:14:21 PM
+ *  Author: BSE
+ */
+
+#include "fixed_point.h"
+
+/************************************************************************/
+/* LINEAR TRUNCATION                                                    */
+/************************************************************************/
+// compresses a 16-bit reading to 8 bits along the line (src + b) * m / 256
+// (already pure integer; kept here so both directions live together)
+uint8_t fp_truncate_q8(uint16_t src, uint16_t m, int16_t b) {
+	return (((uint16_t)(src + b)) * m) >> 8;
+}
+
+// inverse of fp_truncate_q8: (val << 8) / m - b, but with the divide replaced
+// by a multiply by the Q24 reciprocal of m (see FP_RECIP_Q24).
+// Since val is only 8 bits, val * m_recip_q24 fits in 32 bits for any m >= 1, and
+// because the reciprocal is rounded up the estimate is at most one too high,
+// so a single multiply-compare makes this bit-exact with the integer divide.
+uint16_t fp_untruncate_q8(uint8_t val, uint16_t m, uint32_t m_recip_q24, int16_t b) {
+	uint32_t scaled = ((uint32_t) val) << 8;
+	uint32_t quot = (val * m_recip_q24) >> (FP_RECIP_SHIFT - 8);
+	if (quot * m > scaled) {
+		quot--;
+	}
+	return quot - b;
+}
+
+/************************************************************************/
+/* TEMPERATURE                                                          */
+/************************************************************************/
+// MLX90614 data (0.02 K / LSB) to hundredths of a degree C; exact
+int32_t fp_mlx_data_to_temp_cdeg(uint16_t data) {
+	return ((int32_t) data) * FP_MLX_CDEG_PER_LSB - FP_KELVIN_OFFSET_CDEG;
+}
+
+/************************************************************************/
+/* ANGLES                                                               */
+/************************************************************************/
+#define ATAN_TABLE_BITS		5
+#define ATAN_TABLE_LEN		((1 << ATAN_TABLE_BITS) + 1)
+#define ATAN_RATIO_SHIFT	16
+#define ATAN_FRAC_BITS		(ATAN_RATIO_SHIFT - ATAN_TABLE_BITS)
+
+// atan(i / 32) in centi-degrees, for i = 0..32 (i.e. 0 to 45 degrees)
+static const uint16_t atan_table_cdeg[ATAN_TABLE_LEN] = {
+	0,		179,	358,	536,	713,	888,	1062,	1234,
+	1404,	1571,	1735,	1897,	2056,	2211,	2363,	2511,
+	2657,	2798,	2936,	3070,	3201,	3327,	3451,	3571,
+	3687,	3800,	3909,	4016,	4119,	4218,	4315,	4409,
+	4500
+};
+
+// atan2(y, x) in centi-degrees, in the range (-18000, 18000].
+// Reduces to the first octant, then linearly interpolates the table above;
+// worst-case error vs. the libm atan2 is a couple of centi-degrees.
+int32_t fp_atan2_cdeg(int16_t y, int16_t x) {
+	if (x == 0 && y == 0) {
+		return 0; // matches atan2(0, 0)
+	}
+	uint32_t ax = x < 0 ? -((int32_t) x) : x;
+	uint32_t ay = y < 0 ? -((int32_t) y) : y;
+	bool swapped = ay > ax;
+	uint32_t num = swapped ? ax : ay;
+	uint32_t den = swapped ? ay : ax;
+
+	// num <= den <= 2^15, so the Q16 ratio cannot overflow
+	uint32_t ratio = (num << ATAN_RATIO_SHIFT) / den;
+	uint32_t idx = ratio >> ATAN_FRAC_BITS;
+	uint32_t frac = ratio & ((1 << ATAN_FRAC_BITS) - 1);
+
+	int32_t angle = atan_table_cdeg[idx];
+	if (idx < ATAN_TABLE_LEN - 1) {
+		int32_t step = atan_table_cdeg[idx + 1] - angle;
+		angle += (step * (int32_t) frac + (1 << (ATAN_FRAC_BITS - 1))) >> ATAN_FRAC_BITS;
+	}
+
+	// unfold octant -> quadrant -> half-plane
+	if (swapped)	angle = FP_CDEG_90 - angle;
+	if (x < 0)		angle = FP_CDEG_180 - angle;
+	if (y < 0)		angle = -angle;
+	return angle;
+}
+
+// fixed-point equivalent of the *_computeCompassDir functions:
+// heading from the x and z axes plus declination, in centi-degrees [0, 36000)
+uint16_t fp_compass_dir_cdeg(int16_t x, int16_t z) {
+	int32_t heading = fp_atan2_cdeg(z, x) + FP_DECLINATION_CDEG;
+	// correct for when signs are reversed
+	if (heading < 0) {
+		heading += FP_CDEG_360;
+	}
+	// check for wrap due to addition of declination
+	if (heading >= FP_CDEG_360) {
+		heading -= FP_CDEG_360;
+	}
+	return heading;
+}
@@ -0,0 +1,57 @@
+/*
+ * fixed_point.h
+ *
+ * Created: 10/18/2026 2:14:05 PM
+ *  Author: BSE
+ *
+ * Integer / Q-format versions of the sensor conversions that used to be done
+ * in (soft) floating point. The M0+ has neither an FPU nor a hardware divider,
+ * so everything here sticks to adds, shifts, and 32-bit multiplies, with at
+ * most one (small) software divide in the atan2.
+ *
+ * Formats used:
+ *   - truncation lines: m is a Q8 scale (result = (src + b) * m >> 8)
+ *   - line reciprocals: Q24 (2^24 / m), used to undo the Q8 scale
+ *   - temperatures: hundredths of a degree C ("centi-degrees"), int32_t
+ *   - angles: hundredths of a degree ("centi-degrees")
+ */
+
+#ifndef FIXED_POINT_H_
+#define FIXED_POINT_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/************************************************************************/
+/* LINEAR TRUNCATION (see truncate_16t / untruncate)                    */
+/************************************************************************/
+#define FP_RECIP_SHIFT				24
+// reciprocal of a line slope m in Q24, rounded up so the estimate it gives
+// is never below the true quotient (corrected down in fp_untruncate_q8)
+#define FP_RECIP_Q24(m)				((((uint32_t) 1) << FP_RECIP_SHIFT) / (m) + 1)
+
+uint8_t fp_truncate_q8(uint16_t src, uint16_t m, int16_t b);
+uint16_t fp_untruncate_q8(uint8_t val, uint16_t m, uint32_t m_recip_q24, int16_t b);
+
+/************************************************************************/
+/* TEMPERATURE                                                          */
+/************************************************************************/
+// MLX90614 temperature registers are in units of 0.02 K
+#define FP_MLX_CDEG_PER_LSB			2
+#define FP_KELVIN_OFFSET_CDEG		27315
+
+int32_t fp_mlx_data_to_temp_cdeg(uint16_t data);
+
+/************************************************************************/
+/* ANGLES                                                               */
+/************************************************************************/
+#define FP_CDEG_90					9000
+#define FP_CDEG_180					18000
+#define FP_CDEG_360					36000
+// 0.244346 rad; the same declination the float compass functions use
+#define FP_DECLINATION_CDEG			1400
+
+int32_t fp_atan2_cdeg(int16_t y, int16_t x);
+uint16_t fp_compass_dir_cdeg(int16_t x, int16_t z);
+
+#endif /* FIXED_POINT_H_ */
@@ -0,0 +1,52 @@
+/*
+ * imu_window.c
+ *
+ * Created: 10/18/2026 6:40:31 PM
+ *  Author: BSE
+ */
+
+#include "imu_window.h"
+
+// rounds to nearest (ties away from zero) without a signed divide
+static int16_t mean_of(int32_t sum, uint8_t count) {
+	if (sum >= 0) {
+		return (sum + count / 2) / count;
+	}
+	return -(int16_t) ((-sum + count / 2) / count);
+}
+
+// reduces count samples of x, y, z to per-axis mean, min, max, and variance.
+// Two passes (mean first) so the squared deviations stay small; the 64-bit
+// sum only matters for very noisy windows. count == 0 gives all zeros.
+void imu_window_reduce(int16_t samples[][3], uint8_t count, imu_axis_stats_t stats[3]) {
+	for (int axis = 0; axis < 3; axis++) {
+		imu_axis_stats_t* s = &stats[axis];
+		if (count == 0) {
+			s->mean = 0;
+			s->min = 0;
+			s->max = 0;
+			s->variance = 0;
+			continue;
+		}
+
+		int32_t sum = 0;
+		s->min = samples[0][axis];
+		s->max = samples[0][axis];
+		for (int i = 0; i < count; i++) {
+			int16_t v = samples[i][axis];
+			sum += v;
+			if (v < s->min) s->min = v;
+			if (v > s->max) s->max = v;
+		}
+		s->mean = mean_of(sum, count);
+
+		uint64_t sq_sum = 0;
+		for (int i = 0; i < count; i++) {
+			int32_t dev = samples[i][axis] - s->mean;
+			uint32_t abs_dev = dev < 0 ? -dev : dev; // (square of up to 2^16 fits unsigned)
+			sq_sum += abs_dev * abs_dev;
+		}
+		uint64_t variance = sq_sum / count;
+		s->variance = variance > UINT32_MAX ? UINT32_MAX : (uint32_t) variance;
+	}
+}
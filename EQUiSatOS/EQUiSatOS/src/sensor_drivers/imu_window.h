@@ -0,0 +1,34 @@
+/*
+ * imu_window.h
+ *
+ * On-board reduction of a window of IMU samples (from the MPU9250 FIFO)
+ * to per-axis statistics, so a whole window fits in the fields of a
+ * single attitude_data_t.
+ *
+ * Created: 10/18/2026 6:40:12 PM
+ *  Author: BSE
+ */
+
+
+#ifndef IMU_WINDOW_H_
+#define IMU_WINDOW_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+typedef struct imu_axis_stats {
+	int16_t mean;			// rounded to nearest
+	int16_t min;
+	int16_t max;
+	uint32_t variance;		// population variance, in LSB^2 (saturates)
+} imu_axis_stats_t;
+
+typedef struct imu_window_stats {
+	imu_axis_stats_t accel[3];
+	imu_axis_stats_t gyro[3];
+	uint8_t num_samples;
+} imu_window_stats_t;
+
+void imu_window_reduce(int16_t samples[][3], uint8_t count, imu_axis_stats_t stats[3]);
+
+#endif /* IMU_WINDOW_H_ */
@@ -0,0 +1,134 @@
+/*
+ * mux_scan.c
+ *
+ * Created: 10/18/2026 8:41:32 PM
+ *  Author: BSE
+ */
+
+#include "mux_scan.h"
+
+typedef enum {
+	MUX_SCAN_IDLE,
+	MUX_SCAN_SELECTING,		// task is switching the mux over I2C
+	MUX_SCAN_CONVERTING,	// ADC running; task is handling the previous result
+	MUX_SCAN_CONVERTED,		// result ready (set by ADC_Handler)
+} mux_scan_state_t;
+
+static volatile mux_scan_state_t scan_state = MUX_SCAN_IDLE;
+static volatile uint16_t scan_result;
+
+static StaticSemaphore_t _mux_scan_converted_sem_d;
+static SemaphoreHandle_t mux_scan_converted_sem;
+
+void mux_scan_init(void) {
+	mux_scan_converted_sem = xSemaphoreCreateBinaryStatic(&_mux_scan_converted_sem_d);
+}
+
+// ADC result ready; only enabled during a scan (configure_adc resets the ADC,
+// which clears it, so polled reads elsewhere are unaffected)
+void ADC_Handler(void)
+{
+	if (ADC->INTFLAG.bit.RESRDY) {
+		scan_result = ADC->RESULT.reg; // (reading clears RESRDY)
+		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+		if (scan_state == MUX_SCAN_CONVERTING) {
+			scan_state = MUX_SCAN_CONVERTED;
+			xSemaphoreGiveFromISR(mux_scan_converted_sem, &xHigherPriorityTaskWoken);
+		}
+		portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
+// selects the channel and starts its conversion (the ISR finishes it)
+static enum status_code start_channel(struct adc_module* adc_instance, uint8_t mux_addr, uint8_t mux_channel) {
+	uint8_t rs;
+	scan_state = MUX_SCAN_SELECTING;
+	enum status_code sc = LTC1380_channel_select(mux_addr, mux_channel, &rs);
+	// drop any result that came in after a previous timeout
+	xSemaphoreTake(mux_scan_converted_sem, 0);
+	scan_state = MUX_SCAN_CONVERTING;
+	adc_start_conversion(adc_instance);
+	return sc;
+}
+
+static enum status_code wait_for_conversion(uint16_t* mV) {
+	if (xSemaphoreTake(mux_scan_converted_sem, MUX_SCAN_CONVERSION_TIMEOUT_MS / portTICK_PERIOD_MS)) {
+		*mV = convert_adc_to_mV(scan_result);
+		return STATUS_OK;
+	}
+	scan_state = MUX_SCAN_SELECTING; // ignore it if it does show up
+	*mV = 0;
+	return STATUS_ERR_TIMEOUT;
+}
+
+// runs the scan described by scan, calling scan->on_result for every channel;
+// returns the first error seen on any channel (each is also passed to on_result)
+enum status_code mux_scan_run(mux_scan_t* scan, struct adc_module* adc_instance) {
+	TickType_t start = xTaskGetTickCount();
+	enum status_code first_error = STATUS_OK;
+
+	// the previous channel's result, handled while the next one converts
+	bool have_prev = false;
+	uint8_t prev_channel = 0;
+	enum status_code prev_sc = STATUS_OK;
+	uint16_t prev_mV = 0;
+
+	enum status_code adc_sc = configure_adc(adc_instance, scan->pin, false);
+	#ifndef XPLAINED
+	if (!is_error(adc_sc)) {
+		adc_instance->hw->INTENSET.reg = ADC_INTENSET_RESRDY;
+		system_interrupt_enable(ADC_IRQn);
+	}
+	#endif
+
+	for (uint8_t i = 0; i < scan->num_channels; i++) {
+		uint8_t mux_channel = scan->first_channel + i;
+		enum status_code sc = adc_sc;
+		uint16_t mV = 0;
+
+		#ifndef XPLAINED
+		if (!is_error(adc_sc)) {
+			enum status_code select_sc = start_channel(adc_instance, scan->mux_addr, mux_channel);
+			if (have_prev) {
+				scan->on_result(prev_channel, prev_sc, prev_mV, scan->arg);
+			}
+			sc = wait_for_conversion(&mV);
+			if (is_error(select_sc)) {
+				sc = select_sc;
+			}
+		} else if (have_prev) {
+			scan->on_result(prev_channel, prev_sc, prev_mV, scan->arg);
+		}
+		#else
+		uint8_t rs;
+		sc = LTC1380_channel_select(scan->mux_addr, mux_channel, &rs);
+		read_adc_mV(*adc_instance, &mV);
+		if (have_prev) {
+			scan->on_result(prev_channel, prev_sc, prev_mV, scan->arg);
+		}
+		#endif
+
+		if (is_error(sc) && !is_error(first_error)) {
+			first_error = sc;
+		}
+		prev_channel = mux_channel;
+		prev_sc = sc;
+		prev_mV = mV;
+		have_prev = true;
+	}
+
+	#ifndef XPLAINED
+	if (!is_error(adc_sc)) {
+		adc_instance->hw->INTENCLR.reg = ADC_INTENCLR_RESRDY;
+		system_interrupt_disable(ADC_IRQn);
+		adc_disable(adc_instance);
+	}
+	#endif
+	scan_state = MUX_SCAN_IDLE;
+	if (have_prev) {
+		scan->on_result(prev_channel, prev_sc, prev_mV, scan->arg);
+	}
+
+	scan->latency_ms = (xTaskGetTickCount() - start) / portTICK_PERIOD_MS;
+	return first_error;
+}
@@ -0,0 +1,46 @@
+/*
+ * mux_scan.h
+ *
+ * Reads a run of LTC1380 multiplexer channels through one processor ADC pin
+ * as a pipeline, instead of a blocking select / configure ADC / poll per channel:
+ *	- the ADC is configured once per scan (the pin is the same for every channel)
+ *	- each conversion is finished by the ADC result-ready interrupt (ADC_Handler),
+ *	  which advances the scan state machine and wakes the scanning task, so the
+ *	  CPU is free while converting
+ *	- while a channel converts, the previous channel's result is handed to the
+ *	  caller's on_result (conversion to mV, bounds checks, error logging)
+ * The next channel's mux select can't overlap the current conversion because
+ * every channel shares the one mux output the ADC is accumulating over.
+ *
+ * REQUIRES i2c_irpow_mutex and processor_adc_mutex to be held around mux_scan_run.
+ *
+ * Created: 10/18/2026 8:41:10 PM
+ *  Author: BSE
+ */
+
+
+#ifndef MUX_SCAN_H_
+#define MUX_SCAN_H_
+
+#include <global.h>
+#include "LTC1380_Multiplexer_Commands.h"
+#include "../processor_drivers/ADC_Commands.h"
+
+#define MUX_SCAN_CONVERSION_TIMEOUT_MS		10 // a conversion takes well under 1ms
+
+typedef void (*mux_scan_result_fn)(uint8_t mux_channel, enum status_code sc, uint16_t mV, void* arg);
+
+typedef struct mux_scan {
+	uint8_t mux_addr;
+	enum adc_positive_input pin;
+	uint8_t first_channel;			// scans first_channel .. first_channel + num_channels - 1
+	uint8_t num_channels;
+	mux_scan_result_fn on_result;	// called (in the scanning task) once per channel, in order
+	void* arg;						// passed to on_result
+	TickType_t latency_ms;			// time the last run took
+} mux_scan_t;
+
+void mux_scan_init(void);
+enum status_code mux_scan_run(mux_scan_t* scan, struct adc_module* adc_instance);
+
+#endif /* MUX_SCAN_H_ */
@@ -188,73 +188,82 @@ uint16_t get_high_bound_from_signal(sig_id_t sig) {
 	}
 }
 
+// (with the reciprocal worked out at compile time, so untruncating needs no divide)
+#define LINE_M(m)		((line_m_t) {(m), FP_RECIP_Q24(m)})
+#define LINE_M_NONE		((line_m_t) {0, 0})
+
 // IF SIG ISN'T IN THE CASES WE'RE CHECKING, THIS WILL RETURN 0
-uint16_t get_line_m_from_signal(sig_id_t sig) {
+line_m_t get_line_m_and_recip_from_signal(sig_id_t sig) {
 	switch (sig) {
 		case S_IR_AMB:
-			return A_IR_AMB_M;
+			return LINE_M(A_IR_AMB_M);
 		case S_LED_TEMP_REG:
-			return A_TEMP_M;
+			return LINE_M(A_TEMP_M);
 		case S_LED_TEMP_FLASH:
-			return A_TEMP_M;
+			return LINE_M(A_TEMP_M);
 		case S_LED_SNS:
-			return A_LED_SNS_M;
+			return LINE_M(A_LED_SNS_M);
 		case S_LED_SNS_REG:
-			return A_LED_SNS_M;
+			return LINE_M(A_LED_SNS_M);
 		case S_LED_SNS_FLASH:
-			return A_LED_SNS_M;
+			return LINE_M(A_LED_SNS_M);
 		case S_LED_SNS_FLASH_BATCH:
-			return A_LED_SNS_M;
+			return LINE_M(A_LED_SNS_M);
 		case S_L_TEMP:
-			return A_TEMP_M;
+			return LINE_M(A_TEMP_M);
 		case S_LF_TEMP:
-			return A_TEMP_M;
+			return LINE_M(A_TEMP_M);
 		case S_LF_SNS_REG:
-			return A_LF_SNS_M;
+			return LINE_M(A_LF_SNS_M);
 		case S_LF_SNS_FLASH:
-			return A_LF_SNS_M;
+			return LINE_M(A_LF_SNS_M);
 		case S_LF_SNS_FLASH_BATCH:
-		return A_LF_SNS_M;
+		return LINE_M(A_LF_SNS_M);
 		case S_L_SNS:
-			return A_L_SNS_M;
+			return LINE_M(A_L_SNS_M);
 		case S_L_SNS_IDLE_RAD_OFF:
-			return A_L_SNS_M;
+			return LINE_M(A_L_SNS_M);
 		case S_L_SNS_IDLE_RAD_ON:
-			return A_L_SNS_M;
+			return LINE_M(A_L_SNS_M);
 		case S_L_SNS_TRANSMIT:
-			return A_L_SNS_M;
+			return LINE_M(A_L_SNS_M);
 		case S_L_SNS_ANT_DEPLOY:
-			return A_L_SNS_M;
+			return LINE_M(A_L_SNS_M);
 		case S_LF_VOLT:
-			return A_LF_VOLT_M;
+			return LINE_M(A_LF_VOLT_M);
 		case S_LF_OSNS_FLASH:
-			return A_LF_OSNS_M;
+			return LINE_M(A_LF_OSNS_M);
 		case S_LF_OSNS_FLASH_BATCH:
-		return A_LF_OSNS_M;
+		return LINE_M(A_LF_OSNS_M);
 		case S_LF_OSNS_REG:
-			return A_LF_OSNS_M;
+			return LINE_M(A_LF_OSNS_M);
 		case S_L_VOLT:
-			return A_L_VOLT_M;
+			return LINE_M(A_L_VOLT_M);
 		case S_LREF:
-			return A_LREF_M;
+			return LINE_M(A_LREF_M);
 		case S_PANELREF:
-			return A_PANELREF_M;
+			return LINE_M(A_PANELREF_M);
 		case S_GYRO:
-			return A_GYRO_M;
+			return LINE_M(A_GYRO_M);
 		case S_ACCEL:
-			return A_ACCEL_M;
+			return LINE_M(A_ACCEL_M);
 		case S_MAG:
-			return A_MAG_M;
+			return LINE_M(A_MAG_M);
 		case S_RAD_TEMP:
-			return A_RAD_TEMP_M;
+			return LINE_M(A_RAD_TEMP_M);
 		case S_IMU_TEMP:
-			return A_IMU_TEMP_M;
+			return LINE_M(A_IMU_TEMP_M);
 		default:
 			log_error(ELOC_SCALING_M, ECODE_UNEXPECTED_CASE, false);
-			return 0; // so if the scaling value isn't found, the reading will ALWAYS BE 0
+			return LINE_M_NONE; // so if the scaling value isn't found, the reading will ALWAYS BE 0
 	}
 }
 
+// IF SIG ISN'T IN THE CASES WE'RE CHECKING, THIS WILL RETURN 0
+uint16_t get_line_m_from_signal(sig_id_t sig) {
+	return get_line_m_and_recip_from_signal(sig).m;
+}
+
 // IF SIG ISN'T IN THE CASES WE'RE CHECKING, THIS WILL RETURN 0
 int16_t get_line_b_from_signal(sig_id_t sig) {
 	switch (sig) {
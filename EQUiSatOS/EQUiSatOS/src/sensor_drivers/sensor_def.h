@@ -10,6 +10,7 @@
 #define SENSOR_DEF_H_
 
 #include <inttypes.h>
+#include "fixed_point.h"
 
 /************************************************************************/
 /* POSSIBLE BOUNDS (for truncation)                                     */
@@ -185,9 +186,16 @@ typedef enum {
 	S_5VREF_TRANSITION
 } sig_id_t;
 
+// a truncation line's slope and its Q24 reciprocal (see fp_untruncate_q8)
+typedef struct {
+	uint16_t m;
+	uint32_t m_recip_q24;
+} line_m_t;
+
 uint16_t get_low_bound_from_signal(sig_id_t sig);
 uint16_t get_high_bound_from_signal(sig_id_t sig);
 uint16_t get_line_m_from_signal(sig_id_t sig);
+line_m_t get_line_m_and_recip_from_signal(sig_id_t sig);
 int16_t get_line_b_from_signal(sig_id_t sig);
 
 #endif /* SENSOR_DEF_H_ */
\ No newline at end of file
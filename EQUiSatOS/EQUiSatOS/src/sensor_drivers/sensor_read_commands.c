@@ -51,6 +51,43 @@ void init_sensor_read_commands(void) {
 	i2c_irpow_mutex = xSemaphoreCreateMutexStatic(&_i2c_irpow_mutex_d);
 	processor_adc_mutex = xSemaphoreCreateMutexStatic(&_processor_adc_mutex_d);
 	irpow_semaphore = xSemaphoreCreateCountingStatic(IR_POW_SEMAPHORE_MAX_COUNT, IR_POW_SEMAPHORE_MAX_COUNT, &_irpow_semaphore_d);
+	mux_scan_init();
+}
+
+/************************************************************************/
+/* HARDWARE MUTEX HELPERS                                               */
+/************************************************************************/
+// number of times each hardware mutex has been requested (whether or not it was
+// obtained), for comparing how many lock acquisitions different read strategies need
+static sensor_lock_counts_t lock_counts;
+
+// last regulator verification that passed in a steady hardware state,
+// and how many were skipped because of it (all protected by hardware_state_mutex)
+static struct {
+	bool valid;
+	uint32_t hw_state_generation;
+	TickType_t time;
+} regulator_verify_cache;
+static regulator_verify_counts_t regulator_verify_counts;
+
+// how long the last temperature mux scan took
+static TickType_t last_temp_scan_latency_ms;
+
+// full statistics of the last IMU window read (only the means make it into attitude data)
+static imu_window_stats_t last_imu_window;
+
+bool i2c_irpow_mutex_take(void) {
+	lock_counts.i2c_irpow++;
+	return mutex_take(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS);
+}
+
+bool processor_adc_mutex_take(void) {
+	lock_counts.processor_adc++;
+	return mutex_take(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS);
+}
+
+void get_sensor_lock_counts(sensor_lock_counts_t* counts) {
+	*counts = lock_counts;
 }
 
 /************************************************************************/
@@ -67,10 +104,11 @@ static void read_ad7991_ctrlbrd_unsafe(ad7991_ctrlbrd_batch batch) {
 uint8_t truncate_16t(uint16_t src, sig_id_t sig) {
 	uint16_t m = get_line_m_from_signal(sig);
 	int16_t b = get_line_b_from_signal(sig);
-	return (((uint16_t)(src + b)) * m) >> 8;
+	return fp_truncate_q8(src, m, b);
 }
 
-void log_if_out_of_bounds(uint16_t reading, sig_id_t sig, uint8_t eloc, bool priority) {
+// returns whether the reading was in bounds
+bool log_if_out_of_bounds(uint16_t reading, sig_id_t sig, uint8_t eloc, bool priority) {
 	uint16_t low = get_low_bound_from_signal(sig);
 	uint16_t high = get_high_bound_from_signal(sig);
 	if (reading < low) {
@@ -91,7 +129,10 @@ void log_if_out_of_bounds(uint16_t reading, sig_id_t sig, uint8_t eloc, bool pri
 			err.eloc = eloc;
 			print("READING OUT OF BOUNDS - HIGH - eloc: %s, reading: %d, high bound: %d\n", get_eloc_str(&err), reading, high);
 		#endif
+	} else {
+		return true;
 	}
+	return false;
 }
 
 // note: processor ADC is locked externally to these methods for speed and for particular edge cases
@@ -109,6 +150,41 @@ static void commands_read_adc_mV_truncate(uint8_t* dest, int pin, uint8_t eloc,
 	*dest = truncate_16t(read, sig);
 }
 
+/* temperature mux scans (see mux_scan.h) */
+typedef struct {
+	uint8_t* batch;			// indexed from the first channel scanned
+	uint8_t first_channel;
+	sig_id_t sig;
+} temp_scan_ctx_t;
+
+// called for each channel of a temperature scan, while the next one converts
+static void temp_scan_result(uint8_t mux_channel, enum status_code sc, uint16_t mV, void* arg) {
+	temp_scan_ctx_t* ctx = (temp_scan_ctx_t*) arg;
+	log_if_error(TEMP_ELOCS[mux_channel], sc, true);
+	log_if_out_of_bounds(mV, ctx->sig, TEMP_ELOCS[mux_channel], true);
+	ctx->batch[mux_channel - ctx->first_channel] = truncate_16t(mV, ctx->sig);
+}
+
+// REQUIRES i2c_irpow_mutex, processor_adc_mutex AND 5V regulator enabled
+// reads num_channels temperature mux channels starting at first_channel into batch
+static void scan_temps_unsafe(uint8_t* batch, uint8_t first_channel, uint8_t num_channels, sig_id_t sig) {
+	temp_scan_ctx_t ctx = {batch, first_channel, sig};
+	mux_scan_t scan = {
+		.mux_addr = TEMP_MULTIPLEXER_I2C,
+		.pin = P_AI_TEMP_OUT,
+		.first_channel = first_channel,
+		.num_channels = num_channels,
+		.on_result = temp_scan_result,
+		.arg = &ctx,
+	};
+	mux_scan_run(&scan, &adc_instance);
+	last_temp_scan_latency_ms = scan.latency_ms;
+}
+
+TickType_t get_last_temp_scan_latency_ms(void) {
+	return last_temp_scan_latency_ms;
+}
+
 // unsafe because need i2c_mutex AND/OR processor_adc_mutex
 void _set_5v_enable_unsafe(bool on) {
 	// note: to avoid chance of deadlock, any locks
@@ -204,10 +280,10 @@ void ensure_ir_power_disabled(bool expected_on) {
 		set_output(false, P_IR_PWR_CMD);
 		trace_print("set ir power off (semaphore unused)");
 
-	} else if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS)) {
+	} else if (i2c_irpow_mutex_take()) {
 		trace_print("set ir power off (had to take mutex)");
 		set_output(false, P_IR_PWR_CMD);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 
 	} else {
 		// we can't turn it off if there are still tasks using it or the i2c mutex
@@ -222,39 +298,93 @@ void ensure_ir_power_disabled(bool expected_on) {
 	}
 }
 
+/************************************************************************/
+/* REGULATOR VERIFICATION CACHE                                         */
+/************************************************************************/
+// REQUIRES hardware_state_mutex
+// finishes off 5V rail and radio transitions whose time is up (we're the one who
+// should do this), as a state change right away; the settled state is steady,
+// so a verification after a transmit can be cached as soon as it's done
+static void finish_hw_transitions(void) {
+	// check 5V regulator state and update hardware states if necessary
+	// if it's transitioning to OFF, check that it's done and set it's
+	// state to off if it is
+	if (get_hw_states()->rail_5v_enabled == HW_TRANSITIONING 
+		&& xTaskGetTickCount() >= get_hw_states()->rail_5v_target_off_time) {
+		get_hw_states()->rail_5v_enabled = HW_OFF;
+	}
+	
+	// check radio power off regulator state and update hardware states if necessary
+	// if it's transitioning to IDLE, check that it's done and set it's
+	// state to off if it is
+	if (get_hw_states()->radio_state == RADIO_IDLE_TRANS_TRANSITION
+		&& xTaskGetTickCount() >= get_hw_states()->radio_trans_done_target_time) {
+		get_hw_states()->radio_state = RADIO_IDLE;
+	}
+	hardware_state_note_change_unsafe();
+}
+
+// REQUIRES hardware_state_mutex
+// whether regulators were verified recently enough, with no hardware state
+// change since, that another check would be redundant (counts a skip if so);
+// finishes off any transitions that are done first, as that's a state change
+static bool regulators_verified_recently(void) {
+	finish_hw_transitions();
+	if (regulator_verify_cache.valid
+		&& regulator_verify_cache.hw_state_generation == get_hw_state_generation()
+		&& xTaskGetTickCount() - regulator_verify_cache.time < VERIFY_REGS_CACHE_FRESH_MS / portTICK_PERIOD_MS) {
+		regulator_verify_counts.skipped++;
+		return true;
+	}
+	return false;
+}
+
+// whether regulator readings in the given state can be reused, i.e. the
+// expected values won't change just by time passing
+static bool hw_state_is_steady(struct hw_states* states) {
+	return states->rail_5v_enabled != HW_TRANSITIONING
+		&& states->radio_state != RADIO_OFF_IDLE_TRANSITION
+		&& states->radio_state != RADIO_IDLE_TRANS_TRANSITION;
+}
+
+void get_regulator_verify_counts(regulator_verify_counts_t* counts) {
+	if (hardware_state_mutex_take(ELOC_VERIFY_REGS)) {
+		*counts = regulator_verify_counts;
+		hardware_state_mutex_give();
+	} else {
+		memset(counts, 0, sizeof(regulator_verify_counts_t));
+	}
+}
+
 void verify_regulators_unsafe(void) {
 	struct hw_states* states;
 	ad7991_ctrlbrd_batch batch = {0,0,0,0};
+	bool cacheable;
+	uint32_t generation;
 
 	// only lock hardware state mutex while needed to act on state,
 	// but long enough to ensure the state doesn't change in the middle of checking it
 	if (hardware_state_mutex_take(ELOC_VERIFY_REGS)) {
-		read_ad7991_ctrlbrd_unsafe(batch);
-		
-		// check 5V regulator state and update hardware states if necessary
-		// if it's transitioning to OFF, check that it's done and set it's
-		// state to off if it is (we're the one who should do this)
-		if (get_hw_states()->rail_5v_enabled == HW_TRANSITIONING 
-			&& xTaskGetTickCount() >= get_hw_states()->rail_5v_target_off_time) {
-			get_hw_states()->rail_5v_enabled = HW_OFF;
+		if (regulators_verified_recently()) {
+			hardware_state_mutex_give();
+			return;
 		}
+		regulator_verify_counts.performed++;
+		read_ad7991_ctrlbrd_unsafe(batch);
 		
-		// check radio power off regulator state and update hardware states if necessary
-		// if it's transitioning to IDLE, check that it's done and set it's
-		// state to off if it is (we're the one who should do this)
-		if (get_hw_states()->radio_state == RADIO_IDLE_TRANS_TRANSITION
-			&& xTaskGetTickCount() >= get_hw_states()->radio_trans_done_target_time) {
-			get_hw_states()->radio_state = RADIO_IDLE;
-		}
+		// (any transitions that are done were finished off above)
+		cacheable = hw_state_is_steady(get_hw_states());
 		
 		states = get_hw_states(); // take at time of state read
+		generation = get_hw_state_generation();
 		hardware_state_mutex_give();
 	} else {
 		return;
 	}
 
+	bool in_bounds = true;
 	// 3V6_REF is index 0
-	log_if_out_of_bounds(batch[0], states->radio_state ? S_3V6_REF_ON : S_3V6_REF_OFF, ELOC_AD7991_CBRD_3V6_REF, true);
+	in_bounds &= log_if_out_of_bounds(batch[0], states->radio_state ? S_3V6_REF_ON : S_3V6_REF_OFF, ELOC_AD7991_CBRD_3V6_REF, true);
 	// 3V6_SNS is index 1
 	sig_id_t state_3v6_sns;
 	switch(states->radio_state) {
@@ -279,7 +409,7 @@ void verify_regulators_unsafe(void) {
 			log_error(ELOC_AD7991_CBRD_3V6_REF, ECODE_UNEXPECTED_CASE, false);
 			break;
 	}
-	log_if_out_of_bounds(batch[1], state_3v6_sns, ELOC_AD7991_CBRD_3V6_SNS, true);
+	in_bounds &= log_if_out_of_bounds(batch[1], state_3v6_sns, ELOC_AD7991_CBRD_3V6_SNS, true);
 	// 5VREF is index 2
 	sig_id_t state_5v_rail;
 	switch (states->rail_5v_enabled) {
@@ -298,13 +428,32 @@ void verify_regulators_unsafe(void) {
 			break;
 	}
 
-	log_if_out_of_bounds(batch[2], state_5v_rail, ELOC_AD7991_CBRD_5V_REF, true);
+	in_bounds &= log_if_out_of_bounds(batch[2], state_5v_rail, ELOC_AD7991_CBRD_5V_REF, true);
 	// 3V3REF current is index 3 (should always be on)
-	log_if_out_of_bounds(batch[3], S_3V3_REF, ELOC_AD7991_CBRD_3V3_REF, true);
+	in_bounds &= log_if_out_of_bounds(batch[3], S_3V3_REF, ELOC_AD7991_CBRD_3V3_REF, true);
+	
+	// remember a good check so redundant ones can be skipped
+	// (never a bad one; we want to keep checking for a fault)
+	if (cacheable && in_bounds && hardware_state_mutex_take(ELOC_VERIFY_REGS)) {
+		// (only valid if nothing's changed since we read)
+		regulator_verify_cache.valid = generation == get_hw_state_generation();
+		regulator_verify_cache.hw_state_generation = generation;
+		regulator_verify_cache.time = xTaskGetTickCount();
+		hardware_state_mutex_give();
+	}
 }
 
 void verify_regulators(void) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	// don't bother with the bus (or IR power) if the last check is still good
+	if (hardware_state_mutex_take(ELOC_VERIFY_REGS)) {
+		bool skip = regulators_verified_recently();
+		hardware_state_mutex_give();
+		if (skip) {
+			return;
+		}
+	}
+	
+	if (i2c_irpow_mutex_take())
 	{
 		// safely turn on IR power
 		bool got_semaphore = enable_ir_pow_if_necessary();
@@ -317,7 +466,7 @@ void verify_regulators(void) {
 		
 		verify_regulators_unsafe();
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_AD7991_CBRD_3V3_REF, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 	}
@@ -327,45 +476,55 @@ void verify_regulators(void) {
 /* SENSOR BATCH READING FUNCTIONS                                       */
 /************************************************************************/
 
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_ir_object_temps_batch_unsafe(ir_object_temps_batch batch) {
+	// send stop because the IR sensors need it before processing commands
+	// after the line has been busy
+	i2c_send_stop();
+	for (int i = 0; i < 6; i ++) {
+		uint16_t obj;
+		status_code_genare_t sc = MLX90614_read_all_obj(IR_ADDS[i], &obj);
+		log_if_error(IR_ELOCS[i], sc, false);
+		log_if_out_of_bounds(obj, S_IR_OBJ, IR_ELOCS[i], false);
+		batch[i] = obj;
+	}
+}
+
 void read_ir_object_temps_batch(ir_object_temps_batch batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		// send stop because the IR sensors need it before processing commands
-		// after the line has been busy
-		i2c_send_stop();
-		for (int i = 0; i < 6; i ++) {
-			uint16_t obj;
-			status_code_genare_t sc = MLX90614_read_all_obj(IR_ADDS[i], &obj);
-			log_if_error(IR_ELOCS[i], sc, false);
-			log_if_out_of_bounds(obj, S_IR_OBJ, IR_ELOCS[i], false);
-			batch[i] = obj;
-		}
+		_read_ir_object_temps_batch_unsafe(batch);
 		disable_ir_pow_if_necessary(got_semaphore);
 
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_IR_POS_Z, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(ir_object_temps_batch));
 	}
 }
 
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_ir_ambient_temps_batch_unsafe(ir_ambient_temps_batch batch) {
+	// send stop because the IR sensors need it before processing commands
+	// after the line has been busy
+	i2c_send_stop();
+	for (int i = 0; i < 6; i++) {
+		uint16_t amb;
+		status_code_genare_t sc = MLX90614_read2ByteValue(IR_ADDS[i], AMBIENT, &amb);
+		log_if_error(IR_ELOCS[i], sc, false);
+		log_if_out_of_bounds(amb, S_IR_AMB, IR_ELOCS[i], false);
+		batch[i] = truncate_16t(amb, S_IR_AMB);
+	}
+}
+
 void read_ir_ambient_temps_batch(ir_ambient_temps_batch batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		// send stop because the IR sensors need it before processing commands
-		// after the line has been busy
-		i2c_send_stop();
-		for (int i = 0; i < 6; i++) {
-			uint16_t amb;
-			status_code_genare_t sc = MLX90614_read2ByteValue(IR_ADDS[i], AMBIENT, &amb);
-			log_if_error(IR_ELOCS[i], sc, false);
-			log_if_out_of_bounds(amb, S_IR_AMB, IR_ELOCS[i], false);
-			batch[i] = truncate_16t(amb, S_IR_AMB);
-		}
+		_read_ir_ambient_temps_batch_unsafe(batch);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_IR_POS_Y, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(ir_ambient_temps_batch));
@@ -382,19 +541,33 @@ void read_lion_volts_batch(lion_volts_batch batch) {
 	batch[1] = truncate_16t(val_2_precise, S_L_VOLT);
 }
 
+// reads precise values; just a helper function
+static void read_lion_volts_precise_unsafe(uint16_t* val_1, uint16_t* val_2, bool precise) {
+	#ifndef EQUISIM_SIMULATE_BATTERIES
+		commands_read_adc_mV(val_1, P_AI_L1_REF, ELOC_L1_REF, S_L_VOLT, true, precise);
+		commands_read_adc_mV(val_2, P_AI_L2_REF, ELOC_L2_REF, S_L_VOLT, true, precise);
+		*val_1 = *val_1 * 25 / 10;
+		*val_2 = *val_2 * 25 / 10;
+	#else
+		equisim_read_lion_volts_precise(val_1, val_2);
+	#endif
+}
+
+// REQUIRES processor_adc_mutex
+void _read_lion_volts_batch_unsafe(lion_volts_batch batch) {
+	uint16_t val_1_precise;
+	uint16_t val_2_precise;
+
+	read_lion_volts_precise_unsafe(&val_1_precise, &val_2_precise, false);
+	batch[0] = truncate_16t(val_1_precise, S_L_VOLT);
+	batch[1] = truncate_16t(val_2_precise, S_L_VOLT);
+}
+
 bool read_lion_volts_precise(uint16_t* val_1, uint16_t* val_2, bool precise) {
-	if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (processor_adc_mutex_take())
 	{
-		#ifndef EQUISIM_SIMULATE_BATTERIES
-			commands_read_adc_mV(val_1, P_AI_L1_REF, ELOC_L1_REF, S_L_VOLT, true, precise);
-			commands_read_adc_mV(val_2, P_AI_L2_REF, ELOC_L2_REF, S_L_VOLT, true, precise);
-			*val_1 = *val_1 * 25 / 10;
-			*val_2 = *val_2 * 25 / 10;
-		#else
-			equisim_read_lion_volts_precise(val_1, val_2);
-		#endif
-
-		xSemaphoreGive(processor_adc_mutex);
+		read_lion_volts_precise_unsafe(val_1, val_2, precise);
+		mutex_give(processor_adc_mutex);
 		return true;
 	} else {
 		log_error(ELOC_L1_REF, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
@@ -404,50 +577,41 @@ bool read_lion_volts_precise(uint16_t* val_1, uint16_t* val_2, bool precise) {
 	}
 }
 
-//results must be length 4
-bool read_ad7991_batbrd_precise(uint16_t* results) {
+// REQUIRES i2c_irpow_mutex and IR power on
+// results must be length 4
+static void read_ad7991_batbrd_precise_unsafe(uint16_t* results) {
 	status_code_genare_t sc;
 	sig_id_t l1_sig;
 	sig_id_t l2_sig;
 	sig_id_t sig;
 
-	// (we need to lock i2c_irpow_mutex before hardware_state_mutex to avoid deadlock)
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS)) {
-		bool got_semaphore = enable_ir_pow_if_necessary();
-		// only lock hardware state mutex while needed to act on state,
-		// but long enough to ensure the state doesn't change in the middle of checking it
-		bool got_hw_state_mutex = hardware_state_mutex_take(ELOC_AD7991_BBRD);
-		{
-			sc = AD7991_read_all_mV(results, AD7991_BATBRD);
-			log_if_error(ELOC_AD7991_BBRD, sc, true);
-
-			struct hw_states* states = get_hw_states();
-			int8_t disg_state = charging_data.lion_discharging;
-			if (states->antenna_deploying) {
-				sig = S_L_SNS_ANT_DEPLOY;
-			} else if (states->radio_state == RADIO_TRANSMITTING) {
-				sig = S_L_SNS_TRANSMIT;
-			} else if (states->radio_state == RADIO_IDLE_TRANS_TRANSITION) {
-				sig = S_L_SNS_IDLE_TRANS_TRANSITION;
-			} else if (states->radio_state == RADIO_OFF_IDLE_TRANSITION) {
-				sig = S_L_SNS_OFF_IDLE_TRANSITION;
-			} else if (states->radio_state == RADIO_IDLE) {
-				sig = S_L_SNS_IDLE_RAD_ON;
-			} else {
-				// default; most likely
-				sig = S_L_SNS_IDLE_RAD_OFF;
-			}
-			l1_sig = (disg_state == LI1 || disg_state == -1) ? sig : S_L_SNS_OFF;
-			l2_sig = (disg_state == LI2 || disg_state == -1) ? sig : S_L_SNS_OFF;
+	// only lock hardware state mutex while needed to act on state,
+	// but long enough to ensure the state doesn't change in the middle of checking it
+	bool got_hw_state_mutex = hardware_state_mutex_take(ELOC_AD7991_BBRD);
+	{
+		sc = AD7991_read_all_mV(results, AD7991_BATBRD);
+		log_if_error(ELOC_AD7991_BBRD, sc, true);
+
+		struct hw_states* states = get_hw_states();
+		int8_t disg_state = charging_data.lion_discharging;
+		if (states->antenna_deploying) {
+			sig = S_L_SNS_ANT_DEPLOY;
+		} else if (states->radio_state == RADIO_TRANSMITTING) {
+			sig = S_L_SNS_TRANSMIT;
+		} else if (states->radio_state == RADIO_IDLE_TRANS_TRANSITION) {
+			sig = S_L_SNS_IDLE_TRANS_TRANSITION;
+		} else if (states->radio_state == RADIO_OFF_IDLE_TRANSITION) {
+			sig = S_L_SNS_OFF_IDLE_TRANSITION;
+		} else if (states->radio_state == RADIO_IDLE) {
+			sig = S_L_SNS_IDLE_RAD_ON;
+		} else {
+			// default; most likely
+			sig = S_L_SNS_IDLE_RAD_OFF;
 		}
-		if (got_hw_state_mutex) hardware_state_mutex_give();
-		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
-	} else {
-		log_error(ELOC_AD7991_BBRD, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
-		memset(results, 0, sizeof(uint16_t)*4);
-		return false;
+		l1_sig = (disg_state == LI1 || disg_state == -1) ? sig : S_L_SNS_OFF;
+		l2_sig = (disg_state == LI2 || disg_state == -1) ? sig : S_L_SNS_OFF;
 	}
+	if (got_hw_state_mutex) hardware_state_mutex_give();
 
 	// results[0] = L2_SNS
 	log_if_out_of_bounds(results[0], l2_sig, ELOC_AD7991_BBRD_L2_SNS, true);
@@ -460,13 +624,25 @@ bool read_ad7991_batbrd_precise(uint16_t* results) {
 	results[3] = equisim_read_panelref();
 	#endif
 	log_if_out_of_bounds(results[3], S_PANELREF, ELOC_AD7991_BBRD_PANEL_REF, true);
+}
 
-	return true;
+//results must be length 4
+bool read_ad7991_batbrd_precise(uint16_t* results) {
+	// (we need to lock i2c_irpow_mutex before hardware_state_mutex to avoid deadlock)
+	if (i2c_irpow_mutex_take()) {
+		bool got_semaphore = enable_ir_pow_if_necessary();
+		read_ad7991_batbrd_precise_unsafe(results);
+		disable_ir_pow_if_necessary(got_semaphore);
+		mutex_give(i2c_irpow_mutex);
+		return true;
+	} else {
+		log_error(ELOC_AD7991_BBRD, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
+		memset(results, 0, sizeof(uint16_t)*4);
+		return false;
+	}
 }
 
-bool read_ad7991_batbrd(lion_current_batch batch1, panelref_lref_batch batch2) {
-	uint16_t results[4];
-	bool gotMutex = read_ad7991_batbrd_precise(results);
+static void truncate_ad7991_batbrd(uint16_t* results, lion_current_batch batch1, panelref_lref_batch batch2) {
 	// results[0] = L2_SNS
 	batch1[1] = truncate_16t(results[0], S_L_SNS);
 	// results[1] = L1_SNS
@@ -475,16 +651,29 @@ bool read_ad7991_batbrd(lion_current_batch batch1, panelref_lref_batch batch2) {
 	batch2[1] = truncate_16t(results[2], S_LREF);
 	// results[3] = PANELREF
 	batch2[0] = truncate_16t(results[3], S_PANELREF);
+}
+
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_ad7991_batbrd_unsafe(lion_current_batch batch1, panelref_lref_batch batch2) {
+	uint16_t results[4];
+	read_ad7991_batbrd_precise_unsafe(results);
+	truncate_ad7991_batbrd(results, batch1, batch2);
+}
+
+bool read_ad7991_batbrd(lion_current_batch batch1, panelref_lref_batch batch2) {
+	uint16_t results[4];
+	bool gotMutex = read_ad7991_batbrd_precise(results);
+	truncate_ad7991_batbrd(results, batch1, batch2);
 	return gotMutex;
 }
 
 void read_ad7991_ctrlbrd(ad7991_ctrlbrd_batch batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
 		read_ad7991_ctrlbrd_unsafe(batch);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_AD7991_CBRD, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(ad7991_ctrlbrd_batch));
@@ -497,24 +686,12 @@ void read_ad7991_ctrlbrd(ad7991_ctrlbrd_batch batch) {
 // note: only called from flash_task, and with i2c_irpow_mutex held
 // REQUIRES i2c_irpow_mutex, processor_adc_mutex AND 5V regulator enabled
 void _read_led_temps_batch_unsafe(led_temps_batch batch, bool flashing_now) {
-	for (int i = 4; i < 8; i++) {
-		uint8_t rs8;
-		status_code_genare_t sc = LTC1380_channel_select(TEMP_MULTIPLEXER_I2C, i, &rs8);
-		log_if_error(TEMP_ELOCS[i], sc, true);
-		commands_read_adc_mV_truncate(&rs8, P_AI_TEMP_OUT, TEMP_ELOCS[i], flashing_now ? S_LED_TEMP_FLASH : S_LED_TEMP_REG, true);
-		batch[i - 4] = rs8;
-	}
+	scan_temps_unsafe(batch, 4, 4, flashing_now ? S_LED_TEMP_FLASH : S_LED_TEMP_REG);
 }
 
 // REQUIRES i2c_irpow_mutex, processor_adc_mutex AND 5V regulator enabled
 void _read_lifepo_temps_batch_unsafe(lifepo_bank_temps_batch batch) {
-	for (int i = 0; i < 2; i++) {
-		uint8_t rs8;
-		status_code_genare_t sc = LTC1380_channel_select(TEMP_MULTIPLEXER_I2C, i, &rs8);
-		log_if_error(TEMP_ELOCS[i], sc, true);
-		commands_read_adc_mV_truncate(&rs8, P_AI_TEMP_OUT, TEMP_ELOCS[i], S_L_TEMP, true);
-		batch[i] = rs8;
-	}
+	scan_temps_unsafe(batch, 0, 2, S_L_TEMP);
 }
 
 void _read_lifepo_current_batch_unsafe(lifepo_current_batch batch, bool flashing_now) {
@@ -528,10 +705,10 @@ void _read_lifepo_current_batch_unsafe(lifepo_current_batch batch, bool flashing
 
 // only used in antenna deploy task
 void read_lifepo_current_precise(uint16_t* val_1, uint16_t* val_2, uint16_t* val_3, uint16_t* val_4) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+		if (processor_adc_mutex_take())
 		{
 			#ifndef EQUISIM_SIMULATE_BATTERIES
 				commands_read_adc_mV(val_1, P_AI_LFB1SNS, ELOC_LFB1SNS, S_LF_SNS_REG, true, false);
@@ -542,7 +719,7 @@ void read_lifepo_current_precise(uint16_t* val_1, uint16_t* val_2, uint16_t* val
 				equisim_read_lifepo_current_precise(val_1, val_2, val_3, val_4);
 			#endif
 
-			xSemaphoreGive(processor_adc_mutex);
+			mutex_give(processor_adc_mutex);
 		} else {
 			log_error(ELOC_LFB1SNS, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
 			memset(val_1, 0, sizeof(uint16_t));
@@ -551,7 +728,7 @@ void read_lifepo_current_precise(uint16_t* val_1, uint16_t* val_2, uint16_t* val
 			memset(val_4, 0, sizeof(uint16_t));
 		}
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_LFB1SNS, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(val_1, 0, sizeof(uint16_t));
@@ -581,10 +758,10 @@ static void read_lifepo_volts_precise_unsafe(uint16_t* val_1, uint16_t* val_2, u
 
 // reads precise values; mutex safe
 bool read_lifepo_volts_precise(uint16_t* val_1, uint16_t* val_2, uint16_t* val_3, uint16_t* val_4, bool precise) {
-	if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (processor_adc_mutex_take())
 	{
 		read_lifepo_volts_precise_unsafe(val_1, val_2, val_3, val_4, precise);
-		xSemaphoreGive(processor_adc_mutex);
+		mutex_give(processor_adc_mutex);
 		return true;
 	} else {
 		log_error(ELOC_LF1REF, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
@@ -613,10 +790,10 @@ void _read_lifepo_volts_batch_unsafe(lifepo_volts_batch batch) {
 
 // reads truncated batch; mutex safe
 void read_lifepo_volts_batch(lifepo_volts_batch batch) {
-	if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (processor_adc_mutex_take())
 	{
 		_read_lifepo_volts_batch_unsafe(batch);
-		xSemaphoreGive(processor_adc_mutex);
+		mutex_give(processor_adc_mutex);
 	} else {
 		log_error(ELOC_LF1REF, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(lifepo_volts_batch));
@@ -631,34 +808,38 @@ void _read_led_current_batch_unsafe(led_current_batch batch, bool flashing_now)
 	commands_read_adc_mV_truncate(&batch[3], P_AI_LED4SNS, ELOC_LED4SNS, sig, true);
 }
 
+// REQUIRES i2c_irpow_mutex, processor_adc_mutex AND IR power on
+void _verify_flash_readings_unsafe(bool flashing_now) {
+	uint8_t buffer[4]; // size of largest data type
+
+	// read values to nowhere, making them check bounds for errors
+	_set_5v_enable_unsafe(true); // required only for these three
+	_read_led_temps_batch_unsafe(buffer, flashing_now);
+	_read_lifepo_temps_batch_unsafe(buffer);
+	_set_5v_enable_unsafe(false);
+	_read_lifepo_current_batch_unsafe(buffer, flashing_now);
+	_read_lifepo_volts_batch_unsafe(buffer);
+	_read_led_current_batch_unsafe(buffer, flashing_now);
+}
+
 void verify_flash_readings(bool flashing_now) {
 	// note: if this function happens to context switch into being flashing
 	// on this line, and then comes back while flashing, the flash
 	// task will have the mutex so we'll wait here until it's done
 	// (the passed flash state will be valid even if a flash happens)
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+		if (processor_adc_mutex_take())
 		{
-			uint8_t buffer[4]; // size of largest data type
-
-			// read values to nowhere, making them check bounds for errors
-			_set_5v_enable_unsafe(true); // required only for these three
-			_read_led_temps_batch_unsafe(buffer, flashing_now);
-			_read_lifepo_temps_batch_unsafe(buffer);
-			_set_5v_enable_unsafe(false);
-			_read_lifepo_current_batch_unsafe(buffer, flashing_now);
-			_read_lifepo_volts_batch_unsafe(buffer);
-			_read_led_current_batch_unsafe(buffer, flashing_now);
-
-			xSemaphoreGive(processor_adc_mutex);
+			_verify_flash_readings_unsafe(flashing_now);
+			mutex_give(processor_adc_mutex);
 		} else {
 			log_error(ELOC_LED1SNS, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
 			// no data passed back that needs to be cleared
 		}
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_LED1SNS, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		// no data passed back that needs to be cleared
@@ -684,82 +865,97 @@ uint8_t get_pdiode_two_bit_range(uint16_t raw) {
 	}
 }
 
+// REQUIRES i2c_irpow_mutex, processor_adc_mutex AND IR power on
+void _read_pdiode_batch_unsafe(pdiode_batch* batch) {
+	uint8_t rs;
+	memset(batch, 0, sizeof(pdiode_batch));
+	for (int i = 0; i < 6; i++) {
+		uint16_t result;
+
+		status_code_genare_t sc = LTC1380_channel_select(PHOTO_MULTIPLEXER_I2C, i, &rs);
+		log_if_error(PD_ELOCS[i], sc, false);
+
+		commands_read_adc_mV(&result, P_AI_PD_OUT, PD_ELOCS[i], S_PD, false, false);
+		uint8_t two_bit_range = get_pdiode_two_bit_range(result);
+		if (two_bit_range == 4) {
+			// PD_ACCESS used as general photo diode indicator
+			log_error(ELOC_PD_NEG_Z, ECODE_UNEXPECTED_CASE, false);
+		} else {
+			*batch |= (two_bit_range << (i*2));
+		}
+	}
+}
+
 void read_pdiode_batch(pdiode_batch* batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+		if (processor_adc_mutex_take())
 		{
-			uint8_t rs;
-			memset(batch, 0, sizeof(pdiode_batch));
-			for (int i = 0; i < 6; i++) {
-				uint16_t result;
-
-				status_code_genare_t sc = LTC1380_channel_select(PHOTO_MULTIPLEXER_I2C, i, &rs);
-				log_if_error(PD_ELOCS[i], sc, false);
-
-				commands_read_adc_mV(&result, P_AI_PD_OUT, PD_ELOCS[i], S_PD, false, false);
-				uint8_t two_bit_range = get_pdiode_two_bit_range(result);
-				if (two_bit_range == 4) {
-					// PD_ACCESS used as general photo diode indicator
-					log_error(ELOC_PD_NEG_Z, ECODE_UNEXPECTED_CASE, false);
-				} else {
-					*batch |= (two_bit_range << (i*2));
-				}
-			}
-			xSemaphoreGive(processor_adc_mutex);
+			_read_pdiode_batch_unsafe(batch);
+			mutex_give(processor_adc_mutex);
 		} else {
 			log_error(ELOC_PD_POS_Y, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
 			memset(batch, 0, sizeof(pdiode_batch));
 		}
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_PD_POS_Y, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(pdiode_batch));
 	}
 }
 
+// REQUIRES i2c_irpow_mutex, processor_adc_mutex AND IR power on
+void _en_and_read_lion_temps_batch_unsafe(lion_temps_batch batch) {
+	_set_5v_enable_unsafe(true);
+	verify_regulators_unsafe();
+
+	scan_temps_unsafe(batch, 2, 2, S_L_TEMP);
+
+	_set_5v_enable_unsafe(false);
+}
+
 void en_and_read_lion_temps_batch(lion_temps_batch batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		if (xSemaphoreTake(processor_adc_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+		if (processor_adc_mutex_take())
 		{
-			_set_5v_enable_unsafe(true);
-			verify_regulators_unsafe();
-
-			for (int i = 2; i < 4; i++) {
-				uint8_t rs8;
-				status_code_genare_t sc = LTC1380_channel_select(TEMP_MULTIPLEXER_I2C, i, &rs8);
-				log_if_error(TEMP_ELOCS[i], sc, true);
-				commands_read_adc_mV_truncate(&rs8, P_AI_TEMP_OUT, TEMP_ELOCS[i], S_L_TEMP, true);
-				batch[i - 2] = rs8;
-			}
-
-			_set_5v_enable_unsafe(false);
-			xSemaphoreGive(processor_adc_mutex);
+			_en_and_read_lion_temps_batch_unsafe(batch);
+			mutex_give(processor_adc_mutex);
 		} else {
 			log_error(ELOC_TEMP_L_1, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
 			memset(batch, 0, sizeof(lion_temps_batch));
 		}
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_TEMP_L_1, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(lion_temps_batch));
 	}
 }
 
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_accel_batch_unsafe(accelerometer_batch accel_batch) {
+	int16_t rs[3];
+	status_code_genare_t sc = MPU9250_read_acc(rs);
+
+	log_if_error(ELOC_IMU_ACC, sc, false);
+	for (int i = 0; i < 3; i++) {
+		accel_batch[i] = truncate_16t(rs[i], S_ACCEL);
+	}
+}
+
 void read_accel_batch(accelerometer_batch accel_batch) {
 	int16_t rs[3];
 	status_code_genare_t sc;
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
 		sc = MPU9250_read_acc(rs);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_IMU_ACC, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(accel_batch, 0, sizeof(accelerometer_batch));
@@ -786,13 +982,13 @@ void _read_gyro_batch_unsafe(gyro_batch gyr_batch) {
 void read_gyro_batch(gyro_batch gyr_batch) {
 	int16_t rs[3];
 	status_code_genare_t sc;
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		// didn't enable it, we won't turn it off
 		bool got_semaphore = enable_ir_pow_if_necessary();
 		sc = MPU9250_read_gyro(rs);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_IMU_GYRO, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(gyr_batch, 0, sizeof(gyro_batch));
@@ -806,16 +1002,99 @@ void read_gyro_batch(gyro_batch gyr_batch) {
 	}
 }
 
+// REQUIRES i2c_irpow_mutex and IR power on, and IR power must stay on
+// until the matching _read_imu_window_batch_unsafe (the FIFO is lost otherwise)
+// Also reads the magnetometer (which isn't on the MPU, so can't go in its FIFO)
+// into batches->mag[0], right as the window starts.
+void _start_imu_window_unsafe(imu_window_batches_t* batches) {
+	status_code_genare_t sc = MPU9250_fifo_start();
+	log_if_error(ELOC_IMU_ACC, sc, false);
+	_read_magnetometer_batch_unsafe(batches->mag[0]);
+}
+
+// REQUIRES i2c_irpow_mutex and IR power on
+// Reads the accel/gyro samples the MPU has put in its FIFO since
+// _start_imu_window_unsafe (in one burst) and reduces them on board:
+// batches->accel[0] and [1] get the mean of the first and second half of the window
+// (so they still work as the two samples used for rate measurements), and batches->gyro
+// gets the mean of the whole window. The window min/max are what get bounds-checked,
+// and the full stats are kept for get_last_imu_window_stats.
+// batches->mag[1] is read right before the window ends.
+// Falls back to single reads if the FIFO has nothing useful in it.
+void _read_imu_window_batch_unsafe(imu_window_batches_t* batches) {
+	static int16_t acc[MPU9250_FIFO_MAX_BURST_FRAMES][3];
+	static int16_t gyro[MPU9250_FIFO_MAX_BURST_FRAMES][3];
+	imu_axis_stats_t half_stats[3];
+	uint16_t num_frames;
+
+	_read_magnetometer_batch_unsafe(batches->mag[1]);
+	status_code_genare_t sc = MPU9250_fifo_stop(&num_frames);
+	log_if_error(ELOC_IMU_ACC, sc, false);
+	if (num_frames * MPU9250_FIFO_FRAME_SIZE > MPU9250_FIFO_SIZE - MPU9250_FIFO_FRAME_SIZE) {
+		// FIFO filled up, so the window is missing its end (still usable)
+		log_error(ELOC_IMU_ACC, ECODE_OVERFLOW, false);
+	}
+	if (num_frames > MPU9250_FIFO_MAX_BURST_FRAMES) {
+		num_frames = MPU9250_FIFO_MAX_BURST_FRAMES; // the rest is cleared on next start
+	}
+	if (num_frames >= 2) {
+		sc = MPU9250_fifo_read_frames(acc, gyro, num_frames);
+		log_if_error(ELOC_IMU_ACC, sc, false);
+	}
+	if (num_frames < 2 || is_error(sc)) {
+		log_error(ELOC_IMU_ACC, ECODE_BAD_DATA, false);
+		memset(&last_imu_window, 0, sizeof(imu_window_stats_t));
+		_read_accel_batch_unsafe(batches->accel[0]);
+		_read_gyro_batch_unsafe(*batches->gyro);
+		_read_accel_batch_unsafe(batches->accel[1]);
+		return;
+	}
+
+	imu_window_reduce(acc, num_frames, last_imu_window.accel);
+	imu_window_reduce(gyro, num_frames, last_imu_window.gyro);
+	last_imu_window.num_samples = num_frames;
+
+	uint8_t half = num_frames / 2;
+	imu_window_reduce(acc, half, half_stats);
+	for (int i = 0; i < 3; i++) {
+		batches->accel[0][i] = truncate_16t(half_stats[i].mean, S_ACCEL);
+	}
+	imu_window_reduce(acc + half, num_frames - half, half_stats);
+	for (int i = 0; i < 3; i++) {
+		batches->accel[1][i] = truncate_16t(half_stats[i].mean, S_ACCEL);
+	}
+	for (int i = 0; i < 3; i++) {
+		log_if_out_of_bounds(last_imu_window.gyro[i].min, S_GYRO, ELOC_IMU_GYRO, false);
+		log_if_out_of_bounds(last_imu_window.gyro[i].max, S_GYRO, ELOC_IMU_GYRO, false);
+		(*batches->gyro)[i] = truncate_16t(last_imu_window.gyro[i].mean, S_GYRO);
+	}
+}
+
+void get_last_imu_window_stats(imu_window_stats_t* stats) {
+	memcpy(stats, &last_imu_window, sizeof(imu_window_stats_t));
+}
+
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_magnetometer_batch_unsafe(magnetometer_batch batch) {
+	int16_t rs[3];
+	status_code_genare_t sc = HMC5883L_readXYZ(rs);
+
+	log_if_error(ELOC_IMU_MAG, sc, false);
+	for (int i = 0; i < 3; i++) {
+		batch[i] = truncate_16t(rs[i], S_MAG);
+	}
+}
+
 void read_magnetometer_batch(magnetometer_batch batch) {
 	int16_t rs[3];
 	status_code_genare_t sc;
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
 		//sc = MPU9250_read_mag(rs);
 		sc = HMC5883L_readXYZ(rs);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_IMU_MAG, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(magnetometer_batch));
@@ -828,29 +1107,33 @@ void read_magnetometer_batch(magnetometer_batch batch) {
 	}
 }
 
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_bat_charge_dig_sigs_batch_unsafe(bat_charge_dig_sigs_batch* batch) {
+	#ifndef EQUISIM_SIMULATE_BATTERIES
+		status_code_genare_t sc = TCA9535_init(batch);
+		log_if_error(ELOC_TCA, sc, true);
+		// zero out the places we're going to overwrite
+		// see order in Message Format spreadsheet
+		*batch &= 0b1111001111110000;
+		// fill in the new values we want
+		*batch |= get_input(P_L1_RUN_CHG);
+		*batch |= (get_input(P_L2_RUN_CHG)<<1);
+		*batch |= (get_input(P_LF_B1_RUNCHG)<<2);
+		*batch |= (get_input(P_LF_B2_RUNCHG)<<3);
+		*batch |= (get_input(P_L1_DISG)<<10);
+		*batch |= (get_input(P_L2_DISG)<<11);
+	#else
+		equisim_read_bat_charge_dig_sigs_batch(batch);
+	#endif
+}
+
 bool read_bat_charge_dig_sigs_batch(bat_charge_dig_sigs_batch* batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS))
+	if (i2c_irpow_mutex_take())
 	{
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		#ifndef EQUISIM_SIMULATE_BATTERIES
-			status_code_genare_t sc = TCA9535_init(batch);
-			log_if_error(ELOC_TCA, sc, true);
-			// zero out the places we're going to overwrite
-			// see order in Message Format spreadsheet
-			*batch &= 0b1111001111110000;
-			// fill in the new values we want
-			*batch |= get_input(P_L1_RUN_CHG);
-			*batch |= (get_input(P_L2_RUN_CHG)<<1);
-			*batch |= (get_input(P_LF_B1_RUNCHG)<<2);
-			*batch |= (get_input(P_LF_B2_RUNCHG)<<3);
-			*batch |= (get_input(P_L1_DISG)<<10);
-			*batch |= (get_input(P_L2_DISG)<<11);
-		#else
-			equisim_read_bat_charge_dig_sigs_batch(batch);
-		#endif
-
+		_read_bat_charge_dig_sigs_batch_unsafe(batch);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 		return true;
 	} else {
 		log_error(ELOC_TCA, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
@@ -859,16 +1142,21 @@ bool read_bat_charge_dig_sigs_batch(bat_charge_dig_sigs_batch* batch) {
 	}
 }
 
+// REQUIRES i2c_irpow_mutex and IR power on
+void _read_imu_temp_batch_unsafe(imu_temp_batch* batch) {
+	int16_t buf;
+	enum status_code sc = MPU9250_read_temp(&buf);
+	log_if_error(ELOC_IMU_TEMP, sc, false);
+	log_if_out_of_bounds(buf, S_IMU_TEMP, ELOC_IMU_TEMP, false);
+	*batch = truncate_16t(buf, S_IMU_TEMP);
+}
+
 void read_imu_temp_batch(imu_temp_batch* batch) {
-	if (xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS)) {
+	if (i2c_irpow_mutex_take()) {
 		bool got_semaphore = enable_ir_pow_if_necessary();
-		int16_t buf;
-		enum status_code sc = MPU9250_read_temp(&buf);
-		log_if_error(ELOC_IMU_TEMP, sc, false);
-		log_if_out_of_bounds(buf, S_IMU_TEMP, ELOC_IMU_TEMP, false);
-		*batch = truncate_16t(buf, S_IMU_TEMP);
+		_read_imu_temp_batch_unsafe(batch);
 		disable_ir_pow_if_necessary(got_semaphore);
-		xSemaphoreGive(i2c_irpow_mutex);
+		mutex_give(i2c_irpow_mutex);
 	} else {
 		log_error(ELOC_IMU_TEMP, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		memset(batch, 0, sizeof(magnetometer_batch));
@@ -883,7 +1171,8 @@ bool read_field_from_bcds(bat_charge_dig_sigs_batch batch, bcds_conversions_t sh
 	return (batch >> shift) & 1;
 }
 
+// no divide; see fp_untruncate_q8
 uint16_t untruncate(uint8_t val, sig_id_t sig) {
-	uint16_t u16 = ((uint16_t)val) << 8;
-	return u16 / get_line_m_from_signal(sig) - get_line_b_from_signal(sig);
+	line_m_t line = get_line_m_and_recip_from_signal(sig);
+	return fp_untruncate_q8(val, line.m, line.m_recip_q24, get_line_b_from_signal(sig));
 }
@@ -15,6 +15,8 @@
 #include "../global.h"
 #include "../testing_functions/equisim_simulated_data.h"
 #include "sensor_def.h"
+#include "imu_window.h"
+#include "mux_scan.h"
 #include "../rtos_tasks/battery_charging_task.h"
 
 /************************************************************************/
@@ -24,6 +26,11 @@
 #define EN_5V_POWER_OFF_DELAY_MS		200  // note we hold a mutex for this time
 #define IR_WAKE_DELAY_MS				300
 
+/* REGULATOR VERIFICATION CACHE */
+// a regulator verification is skipped if one passed less than this long ago
+// with the same hardware state generation (see get_hw_state_generation)
+#define VERIFY_REGS_CACHE_FRESH_MS		10000
+
 /* PDIODE BOUNDS */
 #define PDIODE_00_01					460
 #define PDIODE_01_10					505
@@ -51,6 +58,7 @@ typedef enum {
 /************************************************************************/
 /* HARDWARE MUTEXs - see https://www.draw.io/#G1bt9XDgZvyObssMtjbUi8nUNwu0kcQpVI */
 /* **ONLY** can be used outside this task in the flash_activate_task (for speed purposes) */
+/* and sensor_transaction.c (to batch many reads under one lock)        */
 /************************************************************************/
 #define HARDWARE_MUTEX_WAIT_TIME_TICKS	(2000 / portTICK_PERIOD_MS)
 StaticSemaphore_t _i2c_irpow_mutex_d;
@@ -61,11 +69,36 @@ SemaphoreHandle_t processor_adc_mutex;
 StaticSemaphore_t _irpow_semaphore_d;
 SemaphoreHandle_t irpow_semaphore;
 
+typedef struct sensor_lock_counts {
+	uint32_t i2c_irpow;
+	uint32_t processor_adc;
+} sensor_lock_counts_t;
+
+bool i2c_irpow_mutex_take(void);
+bool processor_adc_mutex_take(void);
+void get_sensor_lock_counts(sensor_lock_counts_t* counts);
+void get_last_imu_window_stats(imu_window_stats_t* stats);
+
+// where the readings from a window of IMU samples go (see _read_imu_window_batch_unsafe)
+typedef struct imu_window_batches {
+	accelerometer_batch* accel;		// two batches: means of the first and second half of the window
+	gyro_batch* gyro;				// one batch: mean of the whole window
+	magnetometer_batch* mag;		// two batches: read at the start and end of the window
+} imu_window_batches_t;
+TickType_t get_last_temp_scan_latency_ms(void);
+
+typedef struct regulator_verify_counts {
+	uint32_t performed;
+	uint32_t skipped;
+} regulator_verify_counts_t;
+
+void get_regulator_verify_counts(regulator_verify_counts_t* counts);
+
 /************************************************************************/
 /* FUNCTIONS                                                            */
 /************************************************************************/
 uint8_t truncate_16t(uint16_t src, sig_id_t sig);
-void log_if_out_of_bounds(uint16_t reading, sig_id_t sig, uint8_t eloc, bool priority);
+bool log_if_out_of_bounds(uint16_t reading, sig_id_t sig, uint8_t eloc, bool priority);
 uint16_t untruncate(uint8_t val, sig_id_t sig);
 void init_sensor_read_commands(void);
 
@@ -95,6 +128,22 @@ void _read_lifepo_volts_batch_unsafe(		lifepo_volts_batch batch);
 void _read_led_current_batch_unsafe(		led_current_batch batch, bool flashing_now);
 void _read_gyro_batch_unsafe(				gyro_batch gyr_batch);
 
+/* non-thread safe functions that should ONLY be called from a sensor transaction
+   (see sensor_transaction.h for which hardware mutexes each one needs) */
+void _read_lion_volts_batch_unsafe(			lion_volts_batch batch);
+void _read_ad7991_batbrd_unsafe(			lion_current_batch batch1, panelref_lref_batch batch2);
+void _en_and_read_lion_temps_batch_unsafe(	lion_temps_batch batch);
+void _read_ir_object_temps_batch_unsafe(	ir_object_temps_batch batch);
+void _read_ir_ambient_temps_batch_unsafe(	ir_ambient_temps_batch batch);
+void _read_imu_temp_batch_unsafe(			imu_temp_batch* batch);
+void _read_pdiode_batch_unsafe(				pdiode_batch* batch);
+void _read_accel_batch_unsafe(				accelerometer_batch accel_batch);
+void _read_magnetometer_batch_unsafe(		magnetometer_batch batch);
+void _start_imu_window_unsafe(				imu_window_batches_t* batches);
+void _read_imu_window_batch_unsafe(			imu_window_batches_t* batches);
+void _read_bat_charge_dig_sigs_batch_unsafe(bat_charge_dig_sigs_batch* batch);
+void _verify_flash_readings_unsafe(bool flashing_now);
+
 /* utility */
 bool read_lion_volts_precise(uint16_t* val_1, uint16_t* val_2, bool precise);
 bool read_lifepo_volts_precise(uint16_t* val_1, uint16_t* val_2, uint16_t* val_3, uint16_t* val_4, bool precise);
@@ -0,0 +1,189 @@
+/*
+ * sensor_transaction.c
+ *
+ * Created: 10/18/2026 4:21:52 PM
+ *  Author: BSE
+ */
+
+#include "sensor_transaction.h"
+
+static uint8_t get_read_needs(sensor_read_t type) {
+	switch (type) {
+		case SR_LION_VOLTS:
+			return SR_NEEDS_ADC;
+		case SR_LION_TEMPS:
+		case SR_PDIODE:
+		case SR_VERIFY_FLASH_READINGS:
+			return SR_NEEDS_I2C | SR_NEEDS_ADC;
+		case SR_RADIO_TEMP:
+			return 0;
+		default:
+			return SR_NEEDS_I2C;
+	}
+}
+
+// size of the batch (or first batch) a read fills, to clear it on failure
+static size_t get_read_size(sensor_read_t type) {
+	switch (type) {
+		case SR_LION_VOLTS:				return sizeof(lion_volts_batch);
+		case SR_LION_TEMPS:				return sizeof(lion_temps_batch);
+		case SR_AD7991_BATBRD:			return sizeof(lion_current_batch);
+		case SR_BAT_CHARGE_DIG_SIGS:	return sizeof(bat_charge_dig_sigs_batch);
+		case SR_IMU_TEMP:				return sizeof(imu_temp_batch);
+		case SR_RADIO_TEMP:				return sizeof(radio_temp_batch);
+		case SR_IR_AMBIENT_TEMPS:		return sizeof(ir_ambient_temps_batch);
+		case SR_IR_OBJECT_TEMPS:		return sizeof(ir_object_temps_batch);
+		case SR_PDIODE:					return sizeof(pdiode_batch);
+		case SR_GYRO:					return sizeof(gyro_batch);
+		case SR_ACCEL:					return sizeof(accelerometer_batch);
+		case SR_MAGNETOMETER:			return sizeof(magnetometer_batch);
+		default:						return 0;
+	}
+}
+
+static void clear_read(sensor_read_op_t* read) {
+	if (read->dest != NULL) {
+		memset(read->dest, 0, get_read_size(read->type));
+	}
+	if (read->type == SR_AD7991_BATBRD && read->dest2 != NULL) {
+		memset(read->dest2, 0, sizeof(panelref_lref_batch));
+	}
+	if (read->type == SR_IMU_WINDOW_START && read->dest != NULL) {
+		imu_window_batches_t* batches = read->dest;
+		memset(batches->mag[0], 0, sizeof(magnetometer_batch));
+	}
+	if (read->type == SR_IMU_WINDOW && read->dest != NULL) {
+		imu_window_batches_t* batches = read->dest;
+		memset(batches->accel, 0, sizeof(accelerometer_batch) * 2);
+		memset(batches->gyro, 0, sizeof(gyro_batch));
+		memset(batches->mag[1], 0, sizeof(magnetometer_batch));
+	}
+}
+
+// performs a single read; hardware mutexes must be held as given by get_read_needs
+static void run_read_unsafe(sensor_read_op_t* read, uint8_t eloc) {
+	switch (read->type) {
+		case SR_LION_VOLTS:
+			_read_lion_volts_batch_unsafe(read->dest);
+			break;
+		case SR_LION_TEMPS:
+			_en_and_read_lion_temps_batch_unsafe(read->dest);
+			break;
+		case SR_AD7991_BATBRD:
+			_read_ad7991_batbrd_unsafe(read->dest, read->dest2);
+			break;
+		case SR_BAT_CHARGE_DIG_SIGS:
+			_read_bat_charge_dig_sigs_batch_unsafe(read->dest);
+			break;
+		case SR_IMU_TEMP:
+			_read_imu_temp_batch_unsafe(read->dest);
+			break;
+		case SR_RADIO_TEMP:
+			read_radio_temp_batch(read->dest);
+			break;
+		case SR_IR_AMBIENT_TEMPS:
+			_read_ir_ambient_temps_batch_unsafe(read->dest);
+			break;
+		case SR_IR_OBJECT_TEMPS:
+			_read_ir_object_temps_batch_unsafe(read->dest);
+			break;
+		case SR_PDIODE:
+			_read_pdiode_batch_unsafe(read->dest);
+			break;
+		case SR_GYRO:
+			_read_gyro_batch_unsafe(read->dest);
+			break;
+		case SR_ACCEL:
+			_read_accel_batch_unsafe(read->dest);
+			break;
+		case SR_MAGNETOMETER:
+			_read_magnetometer_batch_unsafe(read->dest);
+			break;
+		case SR_IMU_WINDOW_START:
+			_start_imu_window_unsafe(read->dest);
+			break;
+		case SR_IMU_WINDOW:
+			_read_imu_window_batch_unsafe(read->dest);
+			break;
+		case SR_VERIFY_FLASH_READINGS:
+			_verify_flash_readings_unsafe(false);
+			break;
+		default:
+			log_error(eloc, ECODE_UNEXPECTED_CASE, false);
+			break;
+	}
+}
+
+void sensor_txn_begin(sensor_transaction_t* txn) {
+	txn->num_reads = 0;
+	txn->needs = 0;
+	txn->lock_wait_ms = 0;
+	txn->total_ms = 0;
+}
+
+// appends a read to the transaction; reads are run in the order they're added
+bool sensor_txn_add(sensor_transaction_t* txn, sensor_read_t type, void* dest, void* dest2) {
+	if (txn->num_reads >= SENSOR_TXN_MAX_READS) {
+		configASSERT(false);
+		return false;
+	}
+	sensor_read_op_t* read = &txn->reads[txn->num_reads++];
+	read->type = type;
+	read->dest = dest;
+	read->dest2 = dest2;
+	read->duration_ms = 0;
+	txn->needs |= get_read_needs(type);
+	return true;
+}
+
+// runs every read in the transaction under a single acquisition of the
+// hardware mutexes it needs, recording how long each read took.
+// If a mutex can't be obtained, an error is logged at eloc, all read
+// destinations are cleared, and false is returned.
+bool sensor_txn_run(sensor_transaction_t* txn, uint8_t eloc) {
+	TickType_t start = xTaskGetTickCount();
+	bool got_i2c = false;
+	bool got_adc = false;
+	bool got_semaphore = false;
+	bool ok = true;
+
+	// (canonical order: i2c_irpow_mutex, processor_adc_mutex, [hardware_state_mutex inside reads])
+	if (txn->needs & SR_NEEDS_I2C) {
+		got_i2c = i2c_irpow_mutex_take();
+		if (got_i2c) {
+			got_semaphore = enable_ir_pow_if_necessary();
+		} else {
+			log_error(eloc, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
+			ok = false;
+		}
+	}
+	if (ok && (txn->needs & SR_NEEDS_ADC)) {
+		got_adc = processor_adc_mutex_take();
+		if (!got_adc) {
+			log_error(eloc, ECODE_PROC_ADC_MUTEX_TIMEOUT, false);
+			ok = false;
+		}
+	}
+	txn->lock_wait_ms = (xTaskGetTickCount() - start) / portTICK_PERIOD_MS;
+
+	for (uint8_t i = 0; i < txn->num_reads; i++) {
+		sensor_read_op_t* read = &txn->reads[i];
+		// (reads that need no hardware always run)
+		if (ok || get_read_needs(read->type) == 0) {
+			TickType_t read_start = xTaskGetTickCount();
+			run_read_unsafe(read, eloc);
+			read->duration_ms = (xTaskGetTickCount() - read_start) / portTICK_PERIOD_MS;
+		} else {
+			clear_read(read);
+			read->duration_ms = 0;
+		}
+	}
+
+	if (got_adc) mutex_give(processor_adc_mutex);
+	if (got_i2c) {
+		disable_ir_pow_if_necessary(got_semaphore);
+		mutex_give(i2c_irpow_mutex);
+	}
+	txn->total_ms = (xTaskGetTickCount() - start) / portTICK_PERIOD_MS;
+	return ok;
+}
@@ -0,0 +1,78 @@
+/*
+ * sensor_transaction.h
+ *
+ * A "sensor transaction" runs an ordered list of batch reads while holding
+ * the hardware mutexes (and IR power) once for the whole list, rather than
+ * having each read_*_batch function take and give them separately.
+ * Locks are taken in the canonical order (i2c_irpow_mutex, then
+ * processor_adc_mutex), and only the ones the listed reads need.
+ *
+ * Usage:
+ *		sensor_transaction_t txn;
+ *		sensor_txn_begin(&txn);
+ *		sensor_txn_add(&txn, SR_LION_VOLTS, cur->lion_volts_data, NULL);
+ *		...
+ *		sensor_txn_run(&txn, ELOC_IDLE_DATA);
+ *
+ * SR_IMU_WINDOW_START and SR_IMU_WINDOW bracket a window of IMU samples; they're
+ * meant to go in two transactions with a delay in between, with IR power kept on,
+ * and both given the same imu_window_batches_t.
+ *
+ * NOTE: don't add reads that are likely to block for long; every other user of
+ * the hardware is locked out until the whole transaction finishes.
+ *
+ * Created: 10/18/2026 4:21:37 PM
+ *  Author: BSE
+ */
+
+
+#ifndef SENSOR_TRANSACTION_H_
+#define SENSOR_TRANSACTION_H_
+
+#include "sensor_read_commands.h"
+
+#define SENSOR_TXN_MAX_READS		12
+
+// hardware required by a read
+#define SR_NEEDS_I2C				0x1 // i2c_irpow_mutex, and IR power on
+#define SR_NEEDS_ADC				0x2 // processor_adc_mutex
+
+typedef enum {
+	SR_LION_VOLTS,				// lion_volts_batch					(ADC)
+	SR_LION_TEMPS,				// lion_temps_batch					(I2C + ADC)
+	SR_AD7991_BATBRD,			// lion_current_batch, panelref_lref_batch (I2C)
+	SR_BAT_CHARGE_DIG_SIGS,		// bat_charge_dig_sigs_batch*		(I2C)
+	SR_IMU_TEMP,				// imu_temp_batch*					(I2C)
+	SR_RADIO_TEMP,				// radio_temp_batch*				(none; cached)
+	SR_IR_AMBIENT_TEMPS,		// ir_ambient_temps_batch			(I2C)
+	SR_IR_OBJECT_TEMPS,			// ir_object_temps_batch			(I2C)
+	SR_PDIODE,					// pdiode_batch*					(I2C + ADC)
+	SR_GYRO,					// gyro_batch						(I2C)
+	SR_ACCEL,					// accelerometer_batch				(I2C)
+	SR_MAGNETOMETER,			// magnetometer_batch				(I2C)
+	SR_IMU_WINDOW_START,		// imu_window_batches_t*; starts MPU FIFO sampling, fills mag[0] (I2C)
+	SR_IMU_WINDOW,				// imu_window_batches_t*; reduces the FIFO window, fills the rest (I2C)
+	SR_VERIFY_FLASH_READINGS,	// no data; not flashing			(I2C + ADC)
+	NUM_SENSOR_READS
+} sensor_read_t;
+
+typedef struct sensor_read_op {
+	sensor_read_t type;
+	void* dest;
+	void* dest2;				// only for reads that fill two batches
+	TickType_t duration_ms;		// filled in when run
+} sensor_read_op_t;
+
+typedef struct sensor_transaction {
+	sensor_read_op_t reads[SENSOR_TXN_MAX_READS];
+	uint8_t num_reads;
+	uint8_t needs;				// SR_NEEDS_* of all reads
+	TickType_t lock_wait_ms;	// time spent getting mutexes and IR power
+	TickType_t total_ms;		// time from start of locking to release
+} sensor_transaction_t;
+
+void sensor_txn_begin(sensor_transaction_t* txn);
+bool sensor_txn_add(sensor_transaction_t* txn, sensor_read_t type, void* dest, void* dest2);
+bool sensor_txn_run(sensor_transaction_t* txn, uint8_t eloc);
+
+#endif /* SENSOR_TRANSACTION_H_ */
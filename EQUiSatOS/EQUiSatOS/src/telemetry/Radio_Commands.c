@@ -1,4 +1,8 @@
 #include "Radio_Commands.h"
+#include "uplink_commands.h"
+#ifdef EQUISIM_SIMULATE_RADIO
+	#include "../testing_functions/equisim_radio.h"
+#endif
 
 char ground_callsign_buf[] = {'K', '1', 'A', 'D'};
 char echo_buf[] = {'E', 'C'};
@@ -11,6 +15,8 @@ char revive_buf[] = {'R', 'V'};
 char flash_kill_buf[] = {'F', 'K'};
 char flash_revive_buf[] = {'F', 'R'};
 	
+static rx_matcher_t uplink_matcher;
+
 bool flash_killed = false;
 	
 char echo_response_buf[] =	{'E', 'C', 'H', 'O', 'C', 'H', 'O', 'C', 'O'};
@@ -35,9 +41,13 @@ void radio_init(void) {
 	setup_pin(true, P_RAD_SHDN); //init shutdown pin
 	setup_pin(true, P_TX_EN); //init send enable pin
 	setup_pin(true, P_RX_EN); //init receive enable pin
+	if (!init_uplink_matcher(&uplink_matcher)) {
+		// the command table is too big for the matcher limits; nothing will match
+		log_error(ELOC_RADIO_UPLINK, ECODE_OUT_OF_BOUNDS, true);
+	}
 }
 
-bool check_checksum(uint8_t* data, uint8_t dataLen, uint8_t actualChecksum) {
+bool check_checksum(const uint8_t* data, uint8_t dataLen, uint8_t actualChecksum) {
 	uint8_t checksum = 0;
 	for (uint8_t i = 0; i<dataLen; i++) {
 		checksum = (checksum + data[i]) & 0xFF;
@@ -46,10 +56,19 @@ bool check_checksum(uint8_t* data, uint8_t dataLen, uint8_t actualChecksum) {
 	return (checksum == actualChecksum);
 }
 
+// blocks instead of spinning once the RTOS is running
+static void radio_cmd_delay_ms(uint32_t ms) {
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		vTaskDelay(ms / portTICK_PERIOD_MS);
+	} else {
+		delay_ms(ms);
+	}
+}
+
 void set_command_mode(bool delay) {
-	if (delay) delay_ms(SET_CMD_MODE_WAIT_BEFORE_MS);	
+	if (delay) radio_cmd_delay_ms(SET_CMD_MODE_WAIT_BEFORE_MS);
 	usart_send_string((uint8_t*) "+++");	
-	if (delay) delay_ms(SET_CMD_MODE_WAIT_AFTER_MS);
+	if (delay) radio_cmd_delay_ms(SET_CMD_MODE_WAIT_AFTER_MS);
 }
 
 void flash_kill(void) {
@@ -60,77 +79,24 @@ void flash_revive(void) {
 	flash_killed = false;
 }
 
-bool check_if_rx_matches(char* buf, uint8_t len, uint8_t rx_buf_index) {
-	for (int i = 0; i < len; i++) {
-		if (buf[i] != radio_receive_buffer[rx_buf_index % LEN_RECEIVEBUFFER]) {
-			return false;
-		}		
-		rx_buf_index++;
-	}
-	return true;
+// forgets any partially-received command (i.e. when the RX buffer is cleared)
+void reset_uplink_matcher(void) {
+	rx_matcher_reset(&uplink_matcher);
 }
 
-// checks if an RX command was received, and signals the transmit
-// task if so. MUST be called from an interrupt while doing so.
-rx_cmd_type_t check_rx_received(void) {
-	//checking for callsign
-	rx_cmd_type_t command = CMD_NONE;
-	uint8_t i = 0;	
-	while (i < LEN_RECEIVEBUFFER) {
-		bool callsign_valid = true;
-		for (int j = 0; j < LEN_GROUND_CALLSIGN; j++) {
-			if (radio_receive_buffer[(i+j) % LEN_RECEIVEBUFFER] != ground_callsign_buf[j]) {
-				callsign_valid = false;
-				break;
-			}
-		}
-		if (callsign_valid) {
-			// required RTOS interrupt context-switching variable; see below
-			BaseType_t xHigherPriorityTaskWoken = false;
-			uint8_t rxbuf_cmd_start_index = (i+4) % LEN_RECEIVEBUFFER;
-			// if valid command, send to transmit task to handle when ready			
-			if (check_if_rx_matches(echo_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//ECHO
-				command = CMD_ECHO;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);							
-			} else if (check_if_rx_matches(flash_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//FLASH
-				command = CMD_FLASH;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);				
-			} else if (check_if_rx_matches(reboot_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//REBOOT
-				command = CMD_REBOOT;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);				
-			}  else if (check_if_rx_matches(kill_3days_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//KILL FOR 3 DAYS
-				command = CMD_KILL_3DAYS;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);					
-			} else if (check_if_rx_matches(kill_week_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//KILL FOR 1 WEEK
-				command = CMD_KILL_WEEK;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);				
-			} else if (check_if_rx_matches(kill_forever_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//KILL FOREVER :'(
-				command = CMD_KILL_FOREVER;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);				
-			} else if (check_if_rx_matches(revive_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//REVIVE! :)
-				command = CMD_REVIVE;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);				
-			} else if (check_if_rx_matches(flash_kill_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//FLASH KILL
-				command = CMD_FLASH_KILL;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);
-			} else if (check_if_rx_matches(flash_revive_buf, LEN_UPLINK_BUF, rxbuf_cmd_start_index)) {
-				//FLASH REVIVE
-				command = CMD_FLASH_REVIVE;
-				xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);
-			}
-			// trigger a context switch if the call from this interrupt
-			// resulting in a lower-priority task being interrupted
-			portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-		}
-		i++;
+// feeds a received byte to the uplink matcher, and signals the transmit task
+// if it completed a command. MUST be called from an interrupt while doing so.
+rx_cmd_type_t check_rx_received(uint8_t rx_byte) {
+	uint8_t matched = rx_matcher_step(&uplink_matcher, rx_byte);
+	rx_cmd_type_t command = matched;
+	if (command != CMD_NONE) {
+		// required RTOS interrupt context-switching variable; see below
+		BaseType_t xHigherPriorityTaskWoken = false;
+		// send to transmit task to handle when ready
+		xQueueSendFromISR(rx_command_queue, &command, &xHigherPriorityTaskWoken);
+		// trigger a context switch if the call from this interrupt
+		// resulting in a lower-priority task being interrupted
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 	}
 	return command;
 }
@@ -155,12 +121,18 @@ void warm_reset(void){
 void setTXEnable(bool enable) {
 	//Invert because active low to open
 	set_output(!enable, P_TX_EN);
+	#ifdef EQUISIM_SIMULATE_RADIO
+		equisim_radio_set_tx_enable(enable);
+	#endif
 }
 
 /*Controls TX buffer between proc TX and radio.*/
 void setRXEnable(bool enable) {
 	//Invert because active low to open
 	set_output(!enable, P_RX_EN);
+	#ifdef EQUISIM_SIMULATE_RADIO
+		equisim_radio_set_rx_enable(enable);
+	#endif
 }
 
 /************************************************************************/
@@ -187,7 +159,7 @@ void transmit_buf_wait(const uint8_t* buf, size_t size) {
 	// reads below will go fast (NOTE okay to break mutex order because shouldn't ever block)
 	bool got_ir_pow_semaphore = enable_ir_pow_if_necessary();
  	bool got_i2c_irpow_mutex = true;
-	if (!xSemaphoreTake(i2c_irpow_mutex, HARDWARE_MUTEX_WAIT_TIME_TICKS)) {
+	if (!i2c_irpow_mutex_take()) {
 		log_error(ELOC_RADIO_TRANSMIT, ECODE_I2C_IRPOW_MUTEX_TIMEOUT, false);
 		got_i2c_irpow_mutex = false;
 	}
@@ -197,27 +169,35 @@ void transmit_buf_wait(const uint8_t* buf, size_t size) {
 		// (don't let it delay transmission)
 		bool got_hw_state_mutex = hardware_state_mutex_take(ELOC_RADIO_TRANSMIT);
 		
-		// suspend the scheduler to make sure the whole buf is sent atomically
-		// (so the radio gets the full buf at once and doesn't cut out in the middle)	
-		pet_watchdog(); // in case this takes a bit and we're close to reset	
-		vTaskSuspendAll();
-		{
-			#if defined(TRANSMIT_ACTIVE)
-				setTXEnable(true);
-			#endif
-			#if defined(TRANSMIT_ACTIVE) || !defined(DONT_PRINT_RAW_TRANSMISSIONS)
-				transmission_start_ticks = xTaskGetTickCount(); // note: doesn't change in this block
+		// the whole buf is sent by DMA so the radio gets it all at once and doesn't
+		// cut out in the middle, without suspending the scheduler (other tasks keep
+		// running while it goes out; only this one blocks)
+		pet_watchdog(); // in case this takes a bit and we're close to reset
+		#if defined(TRANSMIT_ACTIVE)
+			setTXEnable(true);
+		#endif
+		#if defined(TRANSMIT_ACTIVE) || !defined(DONT_PRINT_RAW_TRANSMISSIONS)
+			transmission_start_ticks = xTaskGetTickCount();
+			bool dma_started = usart_tx_dma_start(buf, size);
+			if (!dma_started) {
+				// shouldn't happen; fall back to sending it ourselves
+				log_error(ELOC_RADIO_TRANSMIT, ECODE_UNEXPECTED_CASE, false);
 				usart_send_buf(buf, size);
-				get_hw_states()->radio_state = RADIO_IDLE_TRANS_TRANSITION;
-				trace_print("transmitting...");
-			#endif
-			#if PRINT_DEBUG == 1 || PRINT_DEBUG == 3
-				//delay_ms(10); // TODO
-				setTXEnable(false);
-			#endif
-		}
-		xTaskResumeAll();
+			}
+			get_hw_states()->radio_state = RADIO_IDLE_TRANS_TRANSITION;
+		#endif
 		if (got_hw_state_mutex) hardware_state_mutex_give();
+		
+		#if defined(TRANSMIT_ACTIVE) || !defined(DONT_PRINT_RAW_TRANSMISSIONS)
+			if (dma_started && !usart_tx_dma_wait(USART_TX_DMA_TIMEOUT_MS(size) / portTICK_PERIOD_MS)) {
+				log_error(ELOC_RADIO_TRANSMIT, ECODE_TIMEOUT, false);
+			}
+			trace_print("transmitting...");
+		#endif
+		#if PRINT_DEBUG == 1 || PRINT_DEBUG == 3
+			//delay_ms(10); // TODO
+			setTXEnable(false);
+		#endif
 	
 		// wait duration for transmission to start and current to rise before verifying
 		// NOTE this increments transmission_start_ticks so it equals the time after this returns (for later)
@@ -232,7 +212,7 @@ void transmit_buf_wait(const uint8_t* buf, size_t size) {
 			// if we got the mutex we can safely do a fast call to the unsafe method
 			verify_regulators_unsafe();
 			trace_print("verified regulators");
-			xSemaphoreGive(i2c_irpow_mutex);
+			mutex_give(i2c_irpow_mutex);
 		} else {
 			// if we didn't get the mutex, still try and verify the regulators (the slower way)
 			verify_regulators();
@@ -262,6 +242,9 @@ void setRadioState(bool enable, bool confirm) {
 	// enable / disable 3V6 regulator and radio power at the same time
 	set_output(enable, P_RAD_PWR_RUN);
 	set_output(enable, P_RAD_SHDN);
+	#ifdef EQUISIM_SIMULATE_RADIO
+		equisim_radio_set_power(enable);
+	#endif
 	#if PRINT_DEBUG == 0
 		setTXEnable(enable);
 		setRXEnable(enable);
@@ -11,6 +11,7 @@
 
 #include "../processor_drivers/USART_Commands.h"
 #include "../sensor_drivers/sensor_read_commands.h"
+#include "rx_matcher.h"
 
 // constants
 #define RADIO_BAUD_BYTES				1200
@@ -33,6 +34,9 @@ extern char kill_week_buf[LEN_UPLINK_BUF];
 extern char kill_forever_buf[LEN_UPLINK_BUF];
 extern char flash_buf[LEN_UPLINK_BUF];
 extern char reboot_buf[LEN_UPLINK_BUF];
+extern char revive_buf[LEN_UPLINK_BUF];
+extern char flash_kill_buf[LEN_UPLINK_BUF];
+extern char flash_revive_buf[LEN_UPLINK_BUF];
 #define CMD_RESPONSE_SIZE			9
 extern char echo_response_buf[CMD_RESPONSE_SIZE];
 extern char flash_response_buf[CMD_RESPONSE_SIZE];
@@ -46,7 +50,7 @@ bool flash_killed;
 void flash_kill(void);
 void flash_revive(void);
 	
-bool check_checksum(uint8_t* data, uint8_t dataLen, uint8_t actualChecksum);
+bool check_checksum(const uint8_t* data, uint8_t dataLen, uint8_t actualChecksum);
 
 void set_command_mode(bool delay);
 void XDL_prepare_get_temp(void);
@@ -75,8 +79,8 @@ typedef enum {
 	
 } rx_cmd_type_t;
 
-rx_cmd_type_t check_rx_received(void);
-bool check_if_rx_matches(char* buf, uint8_t len, uint8_t rx_buf_index);
+void reset_uplink_matcher(void);
+rx_cmd_type_t check_rx_received(uint8_t rx_byte);
 
 #endif /* RADIO_COMMANDS_H_ */
 
@@ -0,0 +1,159 @@
+/*
+ * downlink_ledger.c
+ *
+ * Created: 10/19/2026 7:02:40 AM
+ *  Author: BSE
+ */
+
+#include "downlink_ledger.h"
+#include "../rtos_tasks/rtos_tasks.h"
+
+/************************************************************************/
+/* LEDGER                                                               */
+/************************************************************************/
+void downlink_ledger_init(downlink_ledger_t* l) {
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		l->types[t].next_id = READING_ID_NONE + 1;
+		l->types[t].sent_bits = 0;
+		l->types[t].retransmit_id = READING_ID_NONE;
+	}
+}
+
+/* the ID for a reading of type just logged */
+uint32_t downlink_ledger_new_id(downlink_ledger_t* l, msg_data_type_t type) {
+	downlink_ledger_entry_t* e = &l->types[type];
+	uint32_t id = e->next_id++;
+	e->sent_bits <<= 1;
+	return id;
+}
+
+/* whether reading id of type has been sent; readings older than the window
+   are long out of their equistacks, so count as sent */
+bool downlink_ledger_was_sent(const downlink_ledger_t* l, msg_data_type_t type, uint32_t id) {
+	const downlink_ledger_entry_t* e = &l->types[type];
+	if (id == READING_ID_NONE || id >= e->next_id) {
+		return false;
+	}
+	uint32_t age = e->next_id - 1 - id;
+	if (age >= DOWNLINK_LEDGER_WINDOW) {
+		return true;
+	}
+	return (e->sent_bits >> age) & 1;
+}
+
+void downlink_ledger_note_sent(downlink_ledger_t* l, msg_data_type_t type, uint32_t id, bool retransmit) {
+	downlink_ledger_entry_t* e = &l->types[type];
+	if (id == READING_ID_NONE || id >= e->next_id) {
+		return;
+	}
+	uint32_t age = e->next_id - 1 - id;
+	if (age < DOWNLINK_LEDGER_WINDOW) {
+		e->sent_bits |= 1UL << age;
+	}
+	if (retransmit) {
+		e->retransmit_id = id;
+	}
+}
+
+/* whether reading id is older than the last one retransmitted
+   (i.e. retransmissions should pick up from the newest such reading) */
+bool downlink_ledger_retransmit_before(const downlink_ledger_t* l, msg_data_type_t type, uint32_t id) {
+	return id != READING_ID_NONE && id < l->types[type].retransmit_id;
+}
+
+/* sets up l from a ledger stored before a reboot (blank if it doesn't look like one) */
+void downlink_ledger_restore(downlink_ledger_t* l, const downlink_ledger_t* stored) {
+	downlink_ledger_init(l);
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		uint32_t next_id = stored->types[t].next_id;
+		// (a fresh MRAM is all zeros or all ones; and don't wrap around to READING_ID_NONE)
+		if (next_id == READING_ID_NONE || next_id >= 0xFFFFFFFF - DOWNLINK_LEDGER_WINDOW) {
+			continue;
+		}
+		// skip the IDs of any readings logged after the ledger was stored;
+		// none of the readings it covers are around anymore
+		l->types[t].next_id = next_id + DOWNLINK_LEDGER_WINDOW;
+	}
+}
+
+/************************************************************************/
+/* SATELLITE LEDGER                                                     */
+/************************************************************************/
+// (the data tasks log readings and the transmit task sends them, so all access
+// is in a critical section; each is a handful of instructions)
+static downlink_ledger_t reading_ledger;
+
+void init_reading_ledger(void) {
+	downlink_ledger_init(&reading_ledger);
+}
+
+uint32_t new_reading_id(msg_data_type_t type) {
+	taskENTER_CRITICAL();
+	uint32_t id = downlink_ledger_new_id(&reading_ledger, type);
+	taskEXIT_CRITICAL();
+	return id;
+}
+
+bool reading_was_sent(msg_data_type_t type, uint32_t id) {
+	taskENTER_CRITICAL();
+	bool sent = downlink_ledger_was_sent(&reading_ledger, type, id);
+	taskEXIT_CRITICAL();
+	return sent;
+}
+
+void note_reading_sent(msg_data_type_t type, uint32_t id, bool retransmit) {
+	taskENTER_CRITICAL();
+	downlink_ledger_note_sent(&reading_ledger, type, id, retransmit);
+	taskEXIT_CRITICAL();
+}
+
+bool reading_retransmit_before(msg_data_type_t type, uint32_t id) {
+	taskENTER_CRITICAL();
+	bool before = downlink_ledger_retransmit_before(&reading_ledger, type, id);
+	taskEXIT_CRITICAL();
+	return before;
+}
+
+// (for writing to MRAM; that can happen from an ISR, see write_state_to_storage_emergency)
+void get_reading_ledger(downlink_ledger_t* copy) {
+	UBaseType_t saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	*copy = reading_ledger;
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+}
+
+// (on boot, before any readings are logged)
+void restore_reading_ledger(const downlink_ledger_t* stored) {
+	taskENTER_CRITICAL();
+	downlink_ledger_restore(&reading_ledger, stored);
+	taskEXIT_CRITICAL();
+}
+
+// the reading structs all have an ID and timestamp, but in different places
+uint32_t get_reading_id(msg_data_type_t type, const void* reading, uint32_t* timestamp) {
+	switch (type) {
+		case IDLE_DATA:
+			*timestamp = ((const idle_data_t*) reading)->timestamp;
+			return ((const idle_data_t*) reading)->reading_id;
+		case ATTITUDE_DATA:
+			*timestamp = ((const attitude_data_t*) reading)->timestamp;
+			return ((const attitude_data_t*) reading)->reading_id;
+		case FLASH_DATA:
+			*timestamp = ((const flash_data_t*) reading)->timestamp;
+			return ((const flash_data_t*) reading)->reading_id;
+		case FLASH_CMP_DATA:
+			*timestamp = ((const flash_cmp_data_t*) reading)->timestamp;
+			return ((const flash_cmp_data_t*) reading)->reading_id;
+		case LOW_POWER_DATA:
+			*timestamp = ((const low_power_data_t*) reading)->timestamp;
+			return ((const low_power_data_t*) reading)->reading_id;
+		case RUNTIME_STATS_DATA:
+			*timestamp = ((const runtime_stats_data_t*) reading)->timestamp;
+			return ((const runtime_stats_data_t*) reading)->reading_id;
+		case MUTEX_STATS_DATA:
+			*timestamp = ((const mutex_stats_data_t*) reading)->timestamp;
+			return ((const mutex_stats_data_t*) reading)->reading_id;
+		default:
+			*timestamp = 0;
+			return READING_ID_NONE;
+	}
+}
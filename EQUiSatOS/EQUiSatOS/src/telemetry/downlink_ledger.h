@@ -0,0 +1,60 @@
+/*
+ * downlink_ledger.h
+ *
+ * Keeps track of which readings have been sent, per message type, by reading ID
+ * rather than a flag in the reading itself.
+ *	- every reading gets the next ID of its type as it's logged (just before it's
+ *	  staged into its equistack); IDs only increase, including across reboots
+ *	- a bitmap covers the last DOWNLINK_LEDGER_WINDOW IDs of each type (more than
+ *	  any equistack holds): bit i is set once reading next_id - 1 - i has been sent
+ *	- the last reading retransmitted is remembered, so retransmissions work their
+ *	  way down the equistack instead of repeating the newest readings every time
+ * The ledger is written to MRAM with the error list. The readings themselves
+ * don't survive a reboot, so on boot the IDs are moved a whole window ahead
+ * (past any logged since the last backup) and the bitmap starts out clear.
+ *
+ * Created: 10/19/2026 7:02:14 AM
+ *  Author: BSE
+ */
+
+
+#ifndef DOWNLINK_LEDGER_H_
+#define DOWNLINK_LEDGER_H_
+
+#include <global.h>
+
+// IDs the bitmap covers (bits in sent_bits; must be more than any equistack holds)
+#define DOWNLINK_LEDGER_WINDOW		32
+// (the ID of no reading; IDs start at 1)
+#define READING_ID_NONE				0
+
+typedef struct downlink_ledger_entry {
+	uint32_t next_id;			// ID the next reading logged gets
+	uint32_t sent_bits;			// bit i: reading next_id - 1 - i has been sent
+	uint32_t retransmit_id;		// last reading retransmitted (or READING_ID_NONE)
+} downlink_ledger_entry_t;
+
+typedef struct downlink_ledger {
+	downlink_ledger_entry_t types[NUM_MSG_TYPE];
+} downlink_ledger_t;
+
+/* ledger operations (on a given ledger, so these don't depend on the RTOS) */
+void downlink_ledger_init(downlink_ledger_t* l);
+uint32_t downlink_ledger_new_id(downlink_ledger_t* l, msg_data_type_t type);
+bool downlink_ledger_was_sent(const downlink_ledger_t* l, msg_data_type_t type, uint32_t id);
+void downlink_ledger_note_sent(downlink_ledger_t* l, msg_data_type_t type, uint32_t id, bool retransmit);
+bool downlink_ledger_retransmit_before(const downlink_ledger_t* l, msg_data_type_t type, uint32_t id);
+void downlink_ledger_restore(downlink_ledger_t* l, const downlink_ledger_t* stored);
+
+/* the satellite's ledger (thread-safe) */
+void init_reading_ledger(void);
+uint32_t new_reading_id(msg_data_type_t type);
+bool reading_was_sent(msg_data_type_t type, uint32_t id);
+void note_reading_sent(msg_data_type_t type, uint32_t id, bool retransmit);
+bool reading_retransmit_before(msg_data_type_t type, uint32_t id);
+void get_reading_ledger(downlink_ledger_t* copy);
+void restore_reading_ledger(const downlink_ledger_t* stored);
+
+uint32_t get_reading_id(msg_data_type_t type, const void* reading, uint32_t* timestamp);
+
+#endif /* DOWNLINK_LEDGER_H_ */
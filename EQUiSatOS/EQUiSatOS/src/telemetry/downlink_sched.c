@@ -0,0 +1,222 @@
+/*
+ * downlink_sched.c
+ *
+ * Created: 10/19/2026 1:13:05 AM
+ *  Author: BSE
+ */
+
+#include "downlink_sched.h"
+#include "../rtos_tasks/battery_charging_task.h"
+#include "downlink_ledger.h"
+
+typedef struct {
+	msg_data_type_t type;
+	uint8_t readings_per_msg;
+	uint32_t deadline_s;
+	int32_t quantum;		// round-robin credit per round
+} downlink_type_def_t;
+
+// in the order retransmissions rotate through
+static const downlink_type_def_t normal_types[] = {
+	/* type				readings / msg			deadline						quantum */
+	{IDLE_DATA,			IDLE_DATA_PACKETS,		DOWNLINK_DEADLINE_IDLE_S,		DOWNLINK_SLOT_COST},
+	{ATTITUDE_DATA,		ATTITUDE_DATA_PACKETS,	DOWNLINK_DEADLINE_ATTITUDE_S,	DOWNLINK_SLOT_COST},
+	{FLASH_DATA,		FLASH_DATA_PACKETS,		DOWNLINK_DEADLINE_FLASH_S,		DOWNLINK_SLOT_COST},
+	{FLASH_CMP_DATA,	FLASH_CMP_DATA_PACKETS,	DOWNLINK_DEADLINE_FLASH_CMP_S,	DOWNLINK_SLOT_COST},
+	{RUNTIME_STATS_DATA,	RUNTIME_STATS_DATA_PACKETS,	DOWNLINK_DEADLINE_RUNTIME_STATS_S,	DOWNLINK_SLOT_COST},
+	{MUTEX_STATS_DATA,	MUTEX_STATS_DATA_PACKETS,	DOWNLINK_DEADLINE_MUTEX_STATS_S,	DOWNLINK_SLOT_COST},
+};
+#define NUM_NORMAL_TYPES		(sizeof(normal_types) / sizeof(normal_types[0]))
+
+static const downlink_type_def_t low_power_types[] = {
+	{LOW_POWER_DATA,	LOW_POWER_DATA_PACKETS,	DOWNLINK_DEADLINE_LOW_POWER_S,	DOWNLINK_SLOT_COST},
+};
+#define NUM_LOW_POWER_TYPES		(sizeof(low_power_types) / sizeof(low_power_types[0]))
+
+/************************************************************************/
+/* SCHEDULING                                                           */
+/************************************************************************/
+void downlink_sched_init(downlink_sched_t* s) {
+	s->energy = DOWNLINK_ENERGY_CAP;
+	for (int i = 0; i < NUM_MSG_TYPE; i++) {
+		s->deficit[i] = 0;
+	}
+	s->drr_next = 0;
+	s->retransmit_next = 0;
+}
+
+/* slot credit earned this window (li_mv is 0 if it hasn't been read yet) */
+int32_t downlink_energy_refill(uint16_t li_mv, bool low_power) {
+	if (low_power) {
+		return DOWNLINK_REFILL_LOW_POWER;
+	}
+	if (li_mv == 0 || li_mv >= LI_FULL_LOWER_MV) {
+		return DOWNLINK_REFILL_FULL;
+	} else if (li_mv >= LI_DOWN_MV) {
+		return DOWNLINK_REFILL_CHARGED;
+	} else if (li_mv >= LI_LOW_POWER_MV) {
+		return DOWNLINK_REFILL_DOWN;
+	} else {
+		return DOWNLINK_REFILL_LOW;
+	}
+}
+
+// how urgent a type's unsent data is (0 if it isn't): about to be
+// overwritten beats overdue, and fuller / more overdue goes first
+static uint32_t urgency(const downlink_type_def_t* def, const downlink_backlog_t* b, uint8_t unsent) {
+	if (unsent == 0) {
+		return 0;
+	}
+	if (unsent >= b->capacity) {
+		return 0x80000000 | unsent;
+	}
+	if (b->oldest_age_s >= def->deadline_s) {
+		// (percent of the deadline)
+		return min((uint64_t) b->oldest_age_s * 100 / def->deadline_s, 0x7FFFFFFF);
+	}
+	return 0;
+}
+
+static void add_new_data_slot(downlink_sched_t* s, downlink_plan_t* plan,
+		const downlink_type_def_t* def, uint8_t* unsent) {
+	plan->slots[plan->num_slots++] = def->type;
+	unsent[def->type] -= min(unsent[def->type], def->readings_per_msg);
+	// (bounded so an urgent type can't be locked out of the round-robin for long)
+	s->deficit[def->type] = max(s->deficit[def->type] - DOWNLINK_SLOT_COST, -DOWNLINK_ENERGY_CAP);
+}
+
+// next type to retransmit, rotating through those with anything stored
+static msg_data_type_t next_retransmit_type(downlink_sched_t* s, const downlink_type_def_t* types,
+		uint8_t num_types, const downlink_backlog_t* backlog) {
+	for (int k = 0; k < num_types; k++) {
+		uint8_t i = (s->retransmit_next + k) % num_types;
+		if (backlog[types[i].type].stored > 0) {
+			s->retransmit_next = (i + 1) % num_types;
+			return types[i].type;
+		}
+	}
+	// nothing stored at all; send the (empty) next type anyway
+	uint8_t i = s->retransmit_next % num_types;
+	s->retransmit_next = (i + 1) % num_types;
+	return types[i].type;
+}
+
+/* fills in the message types to send this window (possibly none) */
+void downlink_sched_plan(downlink_sched_t* s, const downlink_backlog_t backlog[NUM_MSG_TYPE],
+		bool low_power, uint16_t li_mv, downlink_plan_t* plan) {
+	const downlink_type_def_t* types = low_power ? low_power_types : normal_types;
+	uint8_t num_types = low_power ? NUM_LOW_POWER_TYPES : NUM_NORMAL_TYPES;
+	uint8_t max_slots = low_power ? DOWNLINK_LOW_POWER_MAX_SLOTS : DOWNLINK_MAX_SLOTS;
+
+	int32_t refill = downlink_energy_refill(li_mv, low_power);
+	s->energy = min(s->energy + refill, DOWNLINK_ENERGY_CAP);
+	uint8_t affordable = min(max_slots, s->energy / DOWNLINK_SLOT_COST);
+	plan->num_slots = 0;
+
+	uint8_t unsent[NUM_MSG_TYPE];
+	bool had_urgent_slot[NUM_MSG_TYPE];
+	for (int i = 0; i < NUM_MSG_TYPE; i++) {
+		unsent[i] = backlog[i].unsent;
+		had_urgent_slot[i] = false;
+	}
+
+	// urgent types first (one slot each)
+	while (plan->num_slots < affordable) {
+		const downlink_type_def_t* most_urgent = NULL;
+		uint32_t most_urgency = 0;
+		for (int i = 0; i < num_types; i++) {
+			uint32_t u = urgency(&types[i], &backlog[types[i].type], unsent[types[i].type]);
+			if (!had_urgent_slot[types[i].type] && u > most_urgency) {
+				most_urgent = &types[i];
+				most_urgency = u;
+			}
+		}
+		if (most_urgent == NULL) {
+			break;
+		}
+		had_urgent_slot[most_urgent->type] = true;
+		add_new_data_slot(s, plan, most_urgent, unsent);
+	}
+
+	// then the rest of the unsent data by deficit round-robin
+	bool any_unsent = true;
+	while (plan->num_slots < affordable && any_unsent) {
+		any_unsent = false;
+		for (int k = 0; k < num_types && plan->num_slots < affordable; k++) {
+			const downlink_type_def_t* def = &types[(s->drr_next + k) % num_types];
+			if (unsent[def->type] == 0) {
+				s->deficit[def->type] = 0; // (nothing waiting doesn't earn credit)
+				continue;
+			}
+			any_unsent = true;
+			s->deficit[def->type] += def->quantum;
+			while (s->deficit[def->type] >= DOWNLINK_SLOT_COST && unsent[def->type] > 0
+					&& plan->num_slots < affordable) {
+				add_new_data_slot(s, plan, def, unsent);
+			}
+		}
+		s->drr_next = (s->drr_next + 1) % num_types;
+	}
+
+	// retransmit with credit that would otherwise overflow the bank by next window,
+	// and send at least the minimum
+	int32_t left_over = s->energy - plan->num_slots * DOWNLINK_SLOT_COST;
+	int32_t overflow = left_over + refill - DOWNLINK_ENERGY_CAP;
+	uint8_t num_slots = plan->num_slots;
+	if (overflow > 0) {
+		num_slots += (overflow + DOWNLINK_SLOT_COST - 1) / DOWNLINK_SLOT_COST;
+	}
+	num_slots = min(max(num_slots, DOWNLINK_MIN_SLOTS), affordable);
+	while (plan->num_slots < num_slots) {
+		plan->slots[plan->num_slots++] = next_retransmit_type(s, types, num_types, backlog);
+	}
+
+	s->energy -= plan->num_slots * DOWNLINK_SLOT_COST;
+}
+
+/************************************************************************/
+/* TRANSMIT TASK SIDE                                                   */
+/************************************************************************/
+static downlink_sched_t downlink_sched;
+
+void downlink_sched_task_init(void) {
+	downlink_sched_init(&downlink_sched);
+}
+
+static void get_backlog(msg_data_type_t type, uint32_t now, downlink_backlog_t* b) {
+	memset(b, 0, sizeof(downlink_backlog_t));
+	equistack* stack = get_msg_type_equistack(type);
+	if (stack == NULL) {
+		return;
+	}
+	// hold the stack still while walking it; if we can't, plan as if it's
+	// empty (it just won't get retransmission slots this time)
+	if (!mutex_take(stack->mutex, EQUISTACK_MUTEX_WAIT_TIME_TICKS)) {
+		log_error(ELOC_RADIO, ECODE_EQUISTACK_MUTEX_TIMEOUT, false);
+		return;
+	}
+	// (the oldest is the one being staged / overwritten, so it isn't readable)
+	b->capacity = stack->max_size - 1;
+	b->stored = stack->cur_size;
+	// going from most recent to oldest
+	for (int i = 0; i < stack->cur_size; i++) {
+		void* reading = equistack_Get_Unsafe(stack, i);
+		uint32_t timestamp;
+		if (reading != NULL && !reading_was_sent(type, get_reading_id(type, reading, &timestamp))) {
+			b->unsent++;
+			b->oldest_age_s = now >= timestamp ? now - timestamp : 0;
+		}
+	}
+	mutex_give(stack->mutex);
+}
+
+void plan_downlink(downlink_plan_t* plan) {
+	downlink_backlog_t backlog[NUM_MSG_TYPE];
+	uint32_t now = get_current_timestamp();
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		get_backlog(t, now, &backlog[t]);
+	}
+	// the battery task keeps the last LiOn voltages it read; go by the higher
+	uint16_t li_mv = max(charging_data.bat_voltages[LI1], charging_data.bat_voltages[LI2]);
+	downlink_sched_plan(&downlink_sched, backlog, low_power_active(), li_mv, plan);
+}
@@ -0,0 +1,82 @@
+/*
+ * downlink_sched.h
+ *
+ * Decides how many messages to send each transmission window, and of what
+ * types (replacing the fixed four slots with a priority fallback chain).
+ *	- energy: each window earns slot credit according to the LiOn voltage
+ *	  (a full window's worth when charged), banked up to DOWNLINK_MAX_SLOTS;
+ *	  each message spends one slot
+ *	- urgency: a type whose unsent readings are about to be overwritten (its
+ *	  equistack is full of them), or whose oldest unsent reading is past its
+ *	  freshness deadline, gets a slot first (fullest / most overdue first)
+ *	- fairness: remaining slots with unsent data go by deficit round-robin
+ *	  (each type earns its quantum per round, and spends a slot's worth per message)
+ *	- credit that would otherwise be lost off the top of the bank is spent on
+ *	  retransmissions (rotating through the types), so a charged satellite still
+ *	  sends a full window, and at least DOWNLINK_MIN_SLOTS always go out if affordable
+ * In low power, only LOW_POWER_DATA is sent, and at most DOWNLINK_LOW_POWER_MAX_SLOTS.
+ *
+ * Created: 10/19/2026 1:12:40 AM
+ *  Author: BSE
+ */
+
+
+#ifndef DOWNLINK_SCHED_H_
+#define DOWNLINK_SCHED_H_
+
+#include <global.h>
+
+#define DOWNLINK_MAX_SLOTS				4
+#define DOWNLINK_LOW_POWER_MAX_SLOTS	2
+#define DOWNLINK_MIN_SLOTS				1
+// (credit is in thousandths of a slot)
+#define DOWNLINK_SLOT_COST				1000
+#define DOWNLINK_ENERGY_CAP				(DOWNLINK_MAX_SLOTS * DOWNLINK_SLOT_COST)
+
+// slot credit earned per window at each LiOn voltage (see battery_charging_task.h)
+#define DOWNLINK_REFILL_FULL			(4 * DOWNLINK_SLOT_COST)	// >= LI_FULL_LOWER_MV (or unknown)
+#define DOWNLINK_REFILL_CHARGED			(3 * DOWNLINK_SLOT_COST)	// >= LI_DOWN_MV
+#define DOWNLINK_REFILL_DOWN			(2 * DOWNLINK_SLOT_COST)	// >= LI_LOW_POWER_MV
+#define DOWNLINK_REFILL_LOW				(1 * DOWNLINK_SLOT_COST)
+#define DOWNLINK_REFILL_LOW_POWER		(2 * DOWNLINK_SLOT_COST)	// in low power (per TRANSMIT_TASK_LESS_FREQ)
+
+// freshness deadlines: how old an unsent reading can get before its type is urgent
+#define DOWNLINK_DEADLINE_IDLE_S		(5*60)
+#define DOWNLINK_DEADLINE_ATTITUDE_S	(5*60)
+#define DOWNLINK_DEADLINE_FLASH_S		(2*60)
+#define DOWNLINK_DEADLINE_FLASH_CMP_S	(10*60)
+#define DOWNLINK_DEADLINE_LOW_POWER_S	(5*60)
+#define DOWNLINK_DEADLINE_RUNTIME_STATS_S	(30*60)	// (one report per RUNTIME_STATS_LOG_FREQ_S)
+#define DOWNLINK_DEADLINE_MUTEX_STATS_S		(30*60)	// (same)
+
+// what's waiting in a message type's equistack
+typedef struct downlink_backlog {
+	uint8_t unsent;			// readings not transmitted yet
+	uint8_t stored;			// readings in the equistack
+	uint8_t capacity;		// most it can hold (more overwrite the oldest)
+	uint32_t oldest_age_s;	// age of the oldest unsent reading
+} downlink_backlog_t;
+
+typedef struct downlink_sched {
+	int32_t energy;						// banked slot credit
+	int32_t deficit[NUM_MSG_TYPE];		// round-robin credit
+	uint8_t drr_next;					// type to start the next round at
+	uint8_t retransmit_next;			// next type to retransmit
+} downlink_sched_t;
+
+typedef struct downlink_plan {
+	uint8_t num_slots;
+	msg_data_type_t slots[DOWNLINK_MAX_SLOTS];
+} downlink_plan_t;
+
+/* scheduling (inputs passed in, so these don't depend on the RTOS or equistacks) */
+void downlink_sched_init(downlink_sched_t* s);
+int32_t downlink_energy_refill(uint16_t li_mv, bool low_power);
+void downlink_sched_plan(downlink_sched_t* s, const downlink_backlog_t backlog[NUM_MSG_TYPE],
+	bool low_power, uint16_t li_mv, downlink_plan_t* plan);
+
+/* transmit task side */
+void downlink_sched_task_init(void);
+void plan_downlink(downlink_plan_t* plan);
+
+#endif /* DOWNLINK_SCHED_H_ */
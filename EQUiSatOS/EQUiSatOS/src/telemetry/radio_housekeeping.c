@@ -0,0 +1,222 @@
+/*
+ * radio_housekeeping.c
+ *
+ * Created: 10/19/2026 2:22:14 AM
+ *  Author: BSE
+ */
+
+#include "radio_housekeeping.h"
+
+/************************************************************************/
+/* RESPONSES                                                            */
+/************************************************************************/
+// 0x01, 0xD0, temp (2 bytes, 1/10 degree C), checksum
+static bool read_temp_response(const uint8_t* resp, uint16_t len, uint16_t* value) {
+	if (len < 5 || !check_checksum(resp+1, 3, resp[4])) {
+		return false;
+	}
+	*value = (resp[2] << 8) | resp[3];
+	return true;
+}
+
+static void on_temp_read(uint16_t value) {
+	log_if_out_of_bounds(value, S_RAD_TEMP, ELOC_RADIO_TEMP, true);
+}
+
+// 0x01, 0x9D, checksum (the radio then reboots)
+static bool read_reset_response(const uint8_t* resp, uint16_t len, uint16_t* value) {
+	return len >= 4 && resp[1] == (0x1d | 0x80)
+		&& check_checksum(resp+1, 2, resp[3]);
+}
+
+/************************************************************************/
+/* OPERATION TABLE                                                      */
+/************************************************************************/
+// in the order they're run in a session
+static const radio_hk_op_def_t radio_hk_op_defs[NUM_RADIO_HK_OPS] = {
+	{
+		.op = RADIO_HK_TEMP,
+		.prepare = XDL_prepare_get_temp,
+		.read_response = read_temp_response,
+		.on_read = on_temp_read,
+		.response_wait_ms = TEMP_RESPONSE_TIME_MS,
+		.every_sessions = 1,
+		.reset_on_failures = true,
+		.eloc = ELOC_RADIO_TEMP,
+	},
+	{
+		// (the radio reboots out of command mode, so this goes last)
+		.op = RADIO_HK_WARM_RESET,
+		.prepare = warm_reset,
+		.read_response = read_reset_response,
+		.response_wait_ms = MAX_RADIO_CMD_TIME,
+		.after_ms = RADIO_HK_WARM_RESET_AFTER_MS,
+		.every_sessions = 0,
+		.eloc = ELOC_RADIO,
+	},
+};
+
+const radio_hk_op_def_t* get_radio_hk_op_def(radio_hk_op_t op) {
+	if (op >= NUM_RADIO_HK_OPS) {
+		return NULL;
+	}
+	return &radio_hk_op_defs[op];
+}
+
+/************************************************************************/
+/* SCHEDULING                                                           */
+/************************************************************************/
+void radio_hk_sched_init(radio_hk_sched_t* s) {
+	memset(s, 0, sizeof(radio_hk_sched_t));
+}
+
+void radio_hk_sched_request(radio_hk_sched_t* s, radio_hk_op_t op) {
+	if (op < NUM_RADIO_HK_OPS) {
+		s->requested[op] = true;
+	}
+}
+
+bool radio_hk_sched_due(const radio_hk_sched_t* s, uint32_t now) {
+	for (int i = 0; i < NUM_RADIO_HK_OPS; i++) {
+		if (s->requested[i]) {
+			return true;
+		}
+	}
+	// (also if the clock went backwards, i.e. the timestamp was reset)
+	return !s->had_session || now < s->last_session
+		|| now - s->last_session >= RADIO_HK_INTERVAL_S;
+}
+
+/* starts a session now, filling in the operations to run in it (in order) */
+void radio_hk_sched_plan(radio_hk_sched_t* s, uint32_t now, radio_hk_session_t* session) {
+	session->num_ops = 0;
+	for (int i = 0; i < NUM_RADIO_HK_OPS; i++) {
+		const radio_hk_op_def_t* def = &radio_hk_op_defs[i];
+		if (s->requested[def->op] || (def->every_sessions != 0 && s->sessions % def->every_sessions == 0)) {
+			session->ops[session->num_ops++] = def->op;
+			s->requested[def->op] = false;
+		}
+	}
+	s->sessions++;
+	s->had_session = true;
+	s->last_session = now;
+}
+
+void radio_hk_sched_result(radio_hk_sched_t* s, radio_hk_op_t op, bool ok, uint16_t value, uint32_t now) {
+	const radio_hk_op_def_t* def = get_radio_hk_op_def(op);
+	if (def == NULL) {
+		return;
+	}
+	radio_hk_result_t* result = &s->results[op];
+	if (ok) {
+		result->value = value;
+		result->timestamp = now;
+		result->failures = 0;
+		return;
+	}
+	result->failures++;
+	if (def->reset_on_failures && result->failures >= RADIO_HK_MAX_FAILURES) {
+		// the radio isn't answering; try resetting it next session
+		radio_hk_sched_request(s, RADIO_HK_WARM_RESET);
+		result->failures = 0;
+	}
+}
+
+/* time the radio is busy (on and in command mode) for a session */
+uint32_t radio_hk_session_time_ms(const radio_hk_session_t* session) {
+	if (session->num_ops == 0) {
+		return 0;
+	}
+	uint32_t time_ms = SET_CMD_MODE_WAIT_BEFORE_MS + SET_CMD_MODE_WAIT_AFTER_MS;
+	for (int i = 0; i < session->num_ops; i++) {
+		const radio_hk_op_def_t* def = get_radio_hk_op_def(session->ops[i]);
+		time_ms += def->response_wait_ms + def->after_ms;
+	}
+	return time_ms;
+}
+
+/************************************************************************/
+/* TRANSMIT TASK SIDE                                                   */
+/************************************************************************/
+static radio_hk_sched_t radio_hk;
+
+void radio_housekeeping_init(void) {
+	radio_hk_sched_init(&radio_hk);
+}
+
+/* runs op next session (and makes a session due) */
+void radio_housekeeping_request(radio_hk_op_t op) {
+	radio_hk_sched_request(&radio_hk, op);
+}
+
+bool radio_housekeeping_due(void) {
+	return radio_hk_sched_due(&radio_hk, get_current_timestamp());
+}
+
+/* runs a command-mode session; the radio must be on (it's left on) */
+void run_radio_housekeeping(void) {
+	radio_hk_session_t session;
+	radio_hk_sched_plan(&radio_hk, get_current_timestamp(), &session);
+	if (session.num_ops == 0) {
+		return;
+	}
+
+	// set command mode to allow sending commands
+	// (after the radio's been quiet long enough for it to take the escape)
+	vTaskDelay(SET_CMD_MODE_WAIT_BEFORE_MS / portTICK_PERIOD_MS);
+	setTXEnable(true);
+	setRXEnable(true);
+	set_command_mode(false); // don't delay, we'll take care of it
+	vTaskDelay(SET_CMD_MODE_WAIT_AFTER_MS / portTICK_PERIOD_MS);
+	// (so we're woken when a response comes in, rather than always waiting it out)
+	usart_rx_capture_start();
+
+	for (int i = 0; i < session.num_ops; i++) {
+		const radio_hk_op_def_t* def = get_radio_hk_op_def(session.ops[i]);
+		clear_USART_rx_buffer();
+		def->prepare();
+		usart_send_string(radio_send_buffer);
+
+		// wait for a good response (or until it's too late for one)
+		TickType_t response_deadline = xTaskGetTickCount() + def->response_wait_ms / portTICK_PERIOD_MS;
+		uint8_t response[LEN_RECEIVEBUFFER];
+		uint16_t response_len = 0;
+		uint16_t value = 0;
+		bool ok = false;
+		for (;;) {
+			TickType_t now = xTaskGetTickCount();
+			TickType_t wait = (int32_t) (response_deadline - now) > 0 ? response_deadline - now : 0;
+			bool woken = usart_rx_wait(wait);
+			response_len += usart_rx_read(response + response_len, LEN_RECEIVEBUFFER - response_len);
+			ok = def->read_response(response, response_len, &value);
+			if (ok || !woken) {
+				break;
+			}
+		}
+		radio_hk_sched_result(&radio_hk, def->op, ok, value, get_current_timestamp());
+		if (ok && def->on_read != NULL) {
+			def->on_read(value);
+		} else if (!ok) {
+			log_error(def->eloc, ECODE_TIMEOUT, false);
+		}
+		if (def->after_ms > 0) {
+			vTaskDelay(def->after_ms / portTICK_PERIOD_MS);
+		}
+	}
+	usart_rx_capture_stop();
+	setRXEnable(false);
+	setTXEnable(false);
+}
+
+/* last result of op, with when it was read */
+const radio_hk_result_t* get_radio_hk_result(radio_hk_op_t op) {
+	if (op >= NUM_RADIO_HK_OPS) {
+		return NULL;
+	}
+	return &radio_hk.results[op];
+}
+
+// temporary version of radio temp; set by the last housekeeping session
+uint16_t get_radio_temp_cached(void) {
+	return radio_hk.results[RADIO_HK_TEMP].value;
+}
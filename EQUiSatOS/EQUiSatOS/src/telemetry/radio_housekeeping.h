@@ -0,0 +1,91 @@
+/*
+ * radio_housekeeping.h
+ *
+ * Radio command-mode operations (the temperature query, warm resets, and any
+ * configuration queries), batched into one command-mode session at most every
+ * RADIO_HK_INTERVAL_S instead of entering command mode every few transmit cycles.
+ * Entering command mode costs the escape guard times (SET_CMD_MODE_WAIT_BEFORE_MS
+ * and SET_CMD_MODE_WAIT_AFTER_MS) with the radio on, so sharing them saves most
+ * of the radio's busy time. Results are cached with the time they were read, for
+ * the packet builders (get_radio_temp_cached / get_radio_hk_result).
+ * Other code can request an operation for the next session (radio_housekeeping_request),
+ * which also makes the session due; a warm reset is requested automatically if
+ * the radio stops answering the temperature query.
+ *
+ * Adding an operation: add it to radio_hk_op_t and a row in radio_hk_op_defs
+ * (radio_housekeeping.c); ones after which the radio leaves command mode go last.
+ *
+ * Created: 10/19/2026 2:21:50 AM
+ *  Author: BSE
+ */
+
+
+#ifndef RADIO_HOUSEKEEPING_H_
+#define RADIO_HOUSEKEEPING_H_
+
+#include <global.h>
+#include "Radio_Commands.h"
+
+// a command-mode session at most this often (unless something's requested)
+#define RADIO_HK_INTERVAL_S				(5*60)
+// temperature reads failed in a row before warm resetting the radio
+#define RADIO_HK_MAX_FAILURES			3
+// time after a warm reset before the radio can be used
+#define RADIO_HK_WARM_RESET_AFTER_MS	(100 + WARM_RESET_WAIT_AFTER_MS + WARM_RESET_REBOOT_TIME)
+
+typedef enum {
+	RADIO_HK_TEMP,
+	RADIO_HK_WARM_RESET,
+	NUM_RADIO_HK_OPS
+} radio_hk_op_t;
+
+typedef struct radio_hk_op_def {
+	radio_hk_op_t op;
+	void (*prepare)(void);					// fills in radio_send_buffer
+	bool (*read_response)(const uint8_t* resp, uint16_t len, uint16_t* value);	// checks the bytes received so far (and reads its value)
+	void (*on_read)(uint16_t value);		// run with a good response (NULL for none)
+	uint16_t response_wait_ms;				// after sending
+	uint16_t after_ms;						// before the radio can be used again
+	uint8_t every_sessions;					// how often it's run (0 for only on request)
+	bool reset_on_failures;					// warm reset after RADIO_HK_MAX_FAILURES in a row
+	uint8_t eloc;							// logged with ECODE_TIMEOUT if there's no good response
+} radio_hk_op_def_t;
+
+typedef struct radio_hk_result {
+	uint16_t value;
+	uint32_t timestamp;		// of the last good response (0 if never)
+	uint8_t failures;		// in a row
+} radio_hk_result_t;
+
+typedef struct radio_hk_sched {
+	bool had_session;
+	uint32_t last_session;	// timestamp
+	uint16_t sessions;
+	bool requested[NUM_RADIO_HK_OPS];
+	radio_hk_result_t results[NUM_RADIO_HK_OPS];
+} radio_hk_sched_t;
+
+typedef struct radio_hk_session {
+	uint8_t num_ops;
+	radio_hk_op_t ops[NUM_RADIO_HK_OPS];
+} radio_hk_session_t;
+
+/* operation table */
+const radio_hk_op_def_t* get_radio_hk_op_def(radio_hk_op_t op);
+
+/* scheduling (times passed in, so these don't depend on the RTOS running) */
+void radio_hk_sched_init(radio_hk_sched_t* s);
+void radio_hk_sched_request(radio_hk_sched_t* s, radio_hk_op_t op);
+bool radio_hk_sched_due(const radio_hk_sched_t* s, uint32_t now);
+void radio_hk_sched_plan(radio_hk_sched_t* s, uint32_t now, radio_hk_session_t* session);
+void radio_hk_sched_result(radio_hk_sched_t* s, radio_hk_op_t op, bool ok, uint16_t value, uint32_t now);
+uint32_t radio_hk_session_time_ms(const radio_hk_session_t* session);
+
+/* transmit task side */
+void radio_housekeeping_init(void);
+void radio_housekeeping_request(radio_hk_op_t op);
+bool radio_housekeeping_due(void);
+void run_radio_housekeeping(void);
+const radio_hk_result_t* get_radio_hk_result(radio_hk_op_t op);
+
+#endif /* RADIO_HOUSEKEEPING_H_ */
@@ -0,0 +1,99 @@
+/*
+ * rx_matcher.c
+ *
+ * Created: 10/18/2026 10:14:51 PM
+ *  Author: BSE
+ */
+
+#include "rx_matcher.h"
+#include <string.h>
+
+#define RX_MATCHER_UNSET		0xFF
+
+static uint8_t class_of(rx_matcher_t* m, uint8_t byte) {
+	if (m->class_map[byte] == 0) {
+		if (m->num_classes >= RX_MATCHER_MAX_CLASSES) {
+			return RX_MATCHER_UNSET;
+		}
+		m->class_map[byte] = m->num_classes++;
+	}
+	return m->class_map[byte];
+}
+
+// walks (adding states as needed) one byte down the trie from state
+static uint8_t trie_add(rx_matcher_t* m, uint8_t state, uint8_t byte) {
+	uint8_t c = class_of(m, byte);
+	if (c == RX_MATCHER_UNSET) {
+		return RX_MATCHER_UNSET;
+	}
+	if (m->next[state][c] == RX_MATCHER_UNSET) {
+		if (m->num_states >= RX_MATCHER_MAX_STATES) {
+			return RX_MATCHER_UNSET;
+		}
+		m->next[state][c] = m->num_states++;
+	}
+	return m->next[state][c];
+}
+
+/* builds the matcher for prefix + each pattern body; returns false
+   if the table is too big for the RX_MATCHER_MAX_* limits */
+bool rx_matcher_build(rx_matcher_t* m, const char* prefix, uint8_t prefix_len,
+		const rx_matcher_pattern_t* patterns, uint8_t num_patterns, uint8_t body_len) {
+	memset(m->class_map, 0, sizeof(m->class_map)); // class 0 is every byte not in a pattern
+	memset(m->next, RX_MATCHER_UNSET, sizeof(m->next));
+	memset(m->out, RX_MATCHER_NO_MATCH, sizeof(m->out));
+	m->num_classes = 1;
+	m->num_states = 1; // root
+	m->state = 0;
+
+	/* trie of all the patterns */
+	uint8_t prefix_end = 0;
+	for (int i = 0; i < prefix_len && prefix_end != RX_MATCHER_UNSET; i++) {
+		prefix_end = trie_add(m, prefix_end, prefix[i]);
+	}
+	if (prefix_end == RX_MATCHER_UNSET) {
+		return false;
+	}
+	for (int p = 0; p < num_patterns; p++) {
+		uint8_t s = prefix_end;
+		for (int i = 0; i < body_len && s != RX_MATCHER_UNSET; i++) {
+			s = trie_add(m, s, patterns[p].body[i]);
+		}
+		if (s == RX_MATCHER_UNSET) {
+			return false;
+		}
+		m->out[s] = patterns[p].id;
+	}
+
+	/* breadth-first over the trie, filling in every missing transition
+	   from the state's failure link (longest proper suffix that's a trie prefix),
+	   which has always been completed already because it's shallower */
+	uint8_t fail[RX_MATCHER_MAX_STATES];
+	uint8_t queue[RX_MATCHER_MAX_STATES];
+	uint8_t head = 0, tail = 0;
+	for (int c = 0; c < m->num_classes; c++) {
+		uint8_t child = m->next[0][c];
+		if (child == RX_MATCHER_UNSET) {
+			m->next[0][c] = 0;
+		} else {
+			fail[child] = 0;
+			queue[tail++] = child;
+		}
+	}
+	while (head < tail) {
+		uint8_t s = queue[head++];
+		for (int c = 0; c < m->num_classes; c++) {
+			uint8_t child = m->next[s][c];
+			if (child == RX_MATCHER_UNSET) {
+				m->next[s][c] = m->next[fail[s]][c];
+			} else {
+				fail[child] = m->next[fail[s]][c];
+				if (m->out[child] == RX_MATCHER_NO_MATCH) {
+					m->out[child] = m->out[fail[child]];
+				}
+				queue[tail++] = child;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * rx_matcher.h
+ *
+ * Streaming matcher for uplink commands: a DFA (Aho-Corasick automaton over a
+ * compressed alphabet) built once from a command table, then stepped once per
+ * received byte (from the USART receive interrupt) in constant time, so there's
+ * no rescanning of the receive buffer.
+ * Each pattern is a shared prefix (the ground callsign) followed by a body
+ * (the command) of fixed length.
+ *
+ * Created: 10/18/2026 10:14:27 PM
+ *  Author: BSE
+ */
+
+
+#ifndef RX_MATCHER_H_
+#define RX_MATCHER_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+// limits on the generated automaton (build fails if the table needs more)
+#define RX_MATCHER_MAX_STATES		24
+#define RX_MATCHER_MAX_CLASSES		16 // distinct pattern bytes, plus "anything else"
+#define RX_MATCHER_NO_MATCH			0  // pattern ids must be nonzero
+
+typedef struct rx_matcher_pattern {
+	const char* body;
+	uint8_t id;
+} rx_matcher_pattern_t;
+
+typedef struct rx_matcher {
+	uint8_t class_map[256];		// received byte -> alphabet class
+	uint8_t next[RX_MATCHER_MAX_STATES][RX_MATCHER_MAX_CLASSES];
+	uint8_t out[RX_MATCHER_MAX_STATES]; // id of the pattern ending in each state, or RX_MATCHER_NO_MATCH
+	volatile uint8_t state;
+	uint8_t num_states;
+	uint8_t num_classes;
+} rx_matcher_t;
+
+bool rx_matcher_build(rx_matcher_t* m, const char* prefix, uint8_t prefix_len,
+	const rx_matcher_pattern_t* patterns, uint8_t num_patterns, uint8_t body_len);
+
+static inline void rx_matcher_reset(rx_matcher_t* m) {
+	m->state = 0;
+}
+
+// advances the matcher by one received byte; returns the id of the pattern
+// that byte completed, or RX_MATCHER_NO_MATCH
+static inline uint8_t rx_matcher_step(rx_matcher_t* m, uint8_t byte) {
+	uint8_t s = m->next[m->state][m->class_map[byte]];
+	m->state = s;
+	return m->out[s];
+}
+
+#endif /* RX_MATCHER_H_ */
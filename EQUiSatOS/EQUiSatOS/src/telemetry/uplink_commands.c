@@ -0,0 +1,251 @@
+/*
+ * uplink_commands.c
+ *
+ * Created: 10/18/2026 11:08:42 PM
+ *  Author: BSE
+ */
+
+#include "uplink_commands.h"
+
+/************************************************************************/
+/* HANDLERS                                                             */
+/************************************************************************/
+// returns we've received a kill command and that command is currently active.
+bool is_radio_killed(void) {
+	// note: the cache is the most rad-tolerant area of the memory,
+	// so we always grab the value from there
+	return cache_get_radio_revive_timestamp() >= get_current_timestamp();
+}
+
+//Called on a kill command; sets the duration for which the radio is killed
+static void kill_radio_for_time(rx_cmd_type_t cmd) {
+	if (is_radio_killed()) {
+		return;
+	}
+	uint32_t revive_time = get_current_timestamp();
+	switch(cmd) {
+		case CMD_KILL_3DAYS:
+			revive_time += RADIO_KILL_DUR_3DAYS_S;
+			log_error(ELOC_RADIO_UPLINK, ECODE_UPLINK_KILL3DAYS, false);
+			break;
+		case CMD_KILL_WEEK:
+			revive_time += RADIO_KILL_DUR_WEEK_S;
+			log_error(ELOC_RADIO_UPLINK, ECODE_UPLINK_KILL1WEEK, false);
+			break;
+		case CMD_KILL_FOREVER: // :'(
+			log_error(ELOC_RADIO_UPLINK, ECODE_UPLINK_KILLFOREVER, false);
+			revive_time = 0xFFFFFFFF;
+			break;
+		default:
+			log_error(ELOC_RADIO_UPLINK, ECODE_UNEXPECTED_CASE, false);
+	}
+	set_radio_revive_timestamp(revive_time);
+}
+
+//revives radio from being killed if revive command is received
+static void revive_radio(rx_cmd_type_t cmd) {
+	set_radio_revive_timestamp(0);
+	log_error(ELOC_RADIO_UPLINK, ECODE_UPLINK_REVIVED, false);
+}
+
+static void flash_kill_handler(rx_cmd_type_t cmd) {
+	flash_kill();
+}
+
+static void flash_revive_handler(rx_cmd_type_t cmd) {
+	flash_revive();
+}
+
+// if flash task is currently in period between flashes,
+// wake it up and flash. Otherwise, if we're currently flashing,
+// this command does nothing.
+static void flash_after_replies(void) {
+	flash_now();
+}
+
+static void reboot_after_replies(void) {
+	log_error(ELOC_RADIO_UPLINK, ECODE_UPLINK_REBOOT, false);
+	write_state_to_storage_emergency(false);
+	system_reset();
+}
+
+/************************************************************************/
+/* REPLY BUILDERS                                                       */
+/************************************************************************/
+static const uint8_t* echo_reply(void)			{ return (uint8_t*) echo_response_buf; }
+static const uint8_t* reboot_reply(void)		{ return (uint8_t*) reboot_response_buf; }
+static const uint8_t* revive_reply(void)		{ return (uint8_t*) revive_response_buf; }
+static const uint8_t* flash_kill_reply(void)	{ return (uint8_t*) flash_kill_response_buf; }
+static const uint8_t* flash_revive_reply(void)	{ return (uint8_t*) flash_revive_response_buf; }
+
+static const uint8_t* flash_reply(void) {
+	// write whether we will flash (weren't currently) to last byte
+	flash_response_buf[CMD_RESPONSE_SIZE-1] = would_flash_now();
+	return (uint8_t*) flash_response_buf;
+}
+
+static const uint8_t* kill_reply(void) {
+	uint32_t revive_time = cache_get_radio_revive_timestamp();
+	memcpy(kill_response_buf + 5, &revive_time, 4);
+	return (uint8_t*) kill_response_buf;
+}
+
+/************************************************************************/
+/* COMMAND TABLE                                                        */
+/************************************************************************/
+static const uplink_cmd_def_t uplink_cmd_defs[] = {
+	/* cmd				pattern				handler					reply				#	spacing				killed	after					after delay */
+	{CMD_ECHO,			echo_buf,			NULL,					echo_reply,			3,	PRE_REPLY_DELAY_MS,	false,	NULL,					0},
+	{CMD_FLASH,			flash_buf,			NULL,					flash_reply,		3,	PRE_REPLY_DELAY_MS,	false,	flash_after_replies,	FLASH_CMD_PREFLASH_DELAY_MS},
+	{CMD_REBOOT,		reboot_buf,			NULL,					reboot_reply,		3,	PRE_REPLY_DELAY_MS,	false,	reboot_after_replies,	REBOOT_CMD_DELAY_MS},
+	{CMD_KILL_3DAYS,	kill_3days_buf,		kill_radio_for_time,	kill_reply,			3,	PRE_REPLY_DELAY_MS,	false,	NULL,					0},
+	{CMD_KILL_WEEK,		kill_week_buf,		kill_radio_for_time,	kill_reply,			3,	PRE_REPLY_DELAY_MS,	false,	NULL,					0},
+	{CMD_KILL_FOREVER,	kill_forever_buf,	kill_radio_for_time,	kill_reply,			3,	PRE_REPLY_DELAY_MS,	false,	NULL,					0},
+	{CMD_REVIVE,		revive_buf,			revive_radio,			revive_reply,		3,	PRE_REPLY_DELAY_MS,	true,	NULL,					0},
+	{CMD_FLASH_KILL,	flash_kill_buf,		flash_kill_handler,		flash_kill_reply,	3,	PRE_REPLY_DELAY_MS,	true,	NULL,					0},
+	{CMD_FLASH_REVIVE,	flash_revive_buf,	flash_revive_handler,	flash_revive_reply,	3,	PRE_REPLY_DELAY_MS,	true,	NULL,					0},
+};
+#define NUM_UPLINK_CMDS		(sizeof(uplink_cmd_defs) / sizeof(uplink_cmd_defs[0]))
+
+const uplink_cmd_def_t* get_uplink_cmd_def(rx_cmd_type_t cmd) {
+	for (uint8_t i = 0; i < NUM_UPLINK_CMDS; i++) {
+		if (uplink_cmd_defs[i].cmd == cmd) {
+			return &uplink_cmd_defs[i];
+		}
+	}
+	return NULL;
+}
+
+/* builds a matcher for the ground callsign followed by any uplink command */
+bool init_uplink_matcher(rx_matcher_t* m) {
+	rx_matcher_pattern_t patterns[NUM_UPLINK_CMDS];
+	for (uint8_t i = 0; i < NUM_UPLINK_CMDS; i++) {
+		patterns[i].body = uplink_cmd_defs[i].pattern;
+		patterns[i].id = uplink_cmd_defs[i].cmd;
+	}
+	return rx_matcher_build(m, ground_callsign_buf, LEN_GROUND_CALLSIGN,
+		patterns, NUM_UPLINK_CMDS, LEN_UPLINK_BUF);
+}
+
+/************************************************************************/
+/* REPLY SCHEDULING                                                     */
+/************************************************************************/
+// (signed difference, so tick count overflow is handled)
+static bool tick_reached(TickType_t now, TickType_t t) {
+	return (int32_t) (now - t) >= 0;
+}
+
+void uplink_sched_init(uplink_reply_sched_t* s, TickType_t now) {
+	s->head = 0;
+	s->count = 0;
+	s->last_done = now;
+}
+
+/* queues the replies (if send_replies) and any follow-up action for def,
+   received at now; returns false (queuing nothing) if there isn't room */
+bool uplink_sched_add(uplink_reply_sched_t* s, const uplink_cmd_def_t* def,
+		const uint8_t* reply, bool send_replies, TickType_t now) {
+	uint8_t num_replies = send_replies ? min(def->reply_count, UPLINK_MAX_REPLIES) : 0;
+	uint8_t num_entries = num_replies + (def->after_replies != NULL);
+	if (s->count + num_entries > UPLINK_REPLY_QUEUE_LEN) {
+		return false;
+	}
+
+	// (earliest is the schedule if nothing runs late)
+	TickType_t earliest = now;
+	for (int i = 0; i < num_entries; i++) {
+		uplink_reply_t* e = &s->entries[(s->head + s->count) % UPLINK_REPLY_QUEUE_LEN];
+		e->def = def;
+		if (i < num_replies) {
+			e->buf = reply;
+			e->delay_ms = def->reply_spacing_ms;
+		} else {
+			e->buf = NULL;
+			e->delay_ms = def->after_replies_delay_ms;
+		}
+		earliest += e->delay_ms / portTICK_PERIOD_MS;
+		e->earliest = earliest;
+		s->count++;
+	}
+	return true;
+}
+
+uplink_reply_t* uplink_sched_peek(uplink_reply_sched_t* s) {
+	return s->count > 0 ? &s->entries[s->head] : NULL;
+}
+
+// when the next entry can be handled (only valid if there is one)
+TickType_t uplink_sched_ready_at(uplink_reply_sched_t* s) {
+	uplink_reply_t* e = &s->entries[s->head];
+	TickType_t after_last = s->last_done + e->delay_ms / portTICK_PERIOD_MS;
+	return tick_reached(e->earliest, after_last) ? e->earliest : after_last;
+}
+
+// marks the next entry as handled (finishing at now)
+void uplink_sched_pop(uplink_reply_sched_t* s, TickType_t now) {
+	if (s->count == 0) {
+		return;
+	}
+	s->head = (s->head + 1) % UPLINK_REPLY_QUEUE_LEN;
+	s->count--;
+	s->last_done = now;
+}
+
+/************************************************************************/
+/* TRANSMIT TASK SIDE                                                   */
+/************************************************************************/
+static uplink_reply_sched_t reply_sched;
+
+void uplink_commands_init(void) {
+	uplink_sched_init(&reply_sched, 0);
+}
+
+/* acts on a received command and schedules its replies */
+void handle_uplink_command(rx_cmd_type_t cmd) {
+	const uplink_cmd_def_t* def = get_uplink_cmd_def(cmd);
+	if (def == NULL) {
+		// CMD_NONE; nothing received
+		return;
+	}
+	bool is_killed = is_radio_killed();
+	if (def->handler != NULL) {
+		def->handler(cmd);
+	}
+	bool send_replies = !is_killed || def->reply_when_killed;
+	const uint8_t* reply = send_replies ? def->build_reply() : NULL;
+	if (!uplink_sched_add(&reply_sched, def, reply, send_replies, xTaskGetTickCount())) {
+		log_error(ELOC_RADIO_UPLINK, ECODE_OVERFLOW, false);
+	}
+}
+
+bool uplink_replies_pending(void) {
+	return reply_sched.count > 0;
+}
+
+// ticks until the next reply or action is due (0 if now; portMAX_DELAY if none)
+TickType_t ticks_until_uplink_reply_due(void) {
+	if (reply_sched.count == 0) {
+		return portMAX_DELAY;
+	}
+	TickType_t now = xTaskGetTickCount();
+	TickType_t ready_at = uplink_sched_ready_at(&reply_sched);
+	return tick_reached(now, ready_at) ? 0 : ready_at - now;
+}
+
+/* transmits the next reply (or runs the next follow-up action, unless replies_only)
+   if it's due; returns whether anything was done */
+bool send_due_uplink_reply(bool replies_only) {
+	uplink_reply_t* e = uplink_sched_peek(&reply_sched);
+	if (e == NULL || ticks_until_uplink_reply_due() > 0) {
+		return false;
+	}
+	if (e->buf != NULL) {
+		transmit_buf_wait(e->buf, CMD_RESPONSE_SIZE);
+	} else if (!replies_only) {
+		e->def->after_replies();
+	} else {
+		return false;
+	}
+	uplink_sched_pop(&reply_sched, xTaskGetTickCount());
+	return true;
+}
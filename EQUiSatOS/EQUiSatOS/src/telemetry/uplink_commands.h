@@ -0,0 +1,80 @@
+/*
+ * uplink_commands.h
+ *
+ * Table of uplink commands (what follows the ground callsign), each with what
+ * to do when it's received and how to reply, plus a scheduler for the replies.
+ * The command is acted on right away, but its replies are queued with their
+ * spacing and sent by the transmit task when due: during the RX window (while
+ * it keeps listening for more commands), or, if they're still pending when the
+ * next transmission starts, one between each pair of downlink packets.
+ *
+ * Adding a command: add its pattern buffer and rx_cmd_type_t (Radio_Commands)
+ * and a row in uplink_cmd_defs (uplink_commands.c); the RX matcher is built
+ * from the table.
+ *
+ * Created: 10/18/2026 11:08:15 PM
+ *  Author: BSE
+ */
+
+
+#ifndef UPLINK_COMMANDS_H_
+#define UPLINK_COMMANDS_H_
+
+#include <global.h>
+#include "Radio_Commands.h"
+#include "rx_matcher.h"
+#include "../rtos_tasks/transmit_task.h"
+
+#define UPLINK_MAX_REPLIES				3
+// replies and follow-up actions from a full RX command queue
+#define UPLINK_REPLY_QUEUE_LEN			(RX_CMD_QUEUE_LEN * (UPLINK_MAX_REPLIES + 1))
+// time a reply takes out of a transmission sequence (see TOTAL_PACKET_TRANS_TIME_MS)
+#define UPLINK_REPLY_TRANS_TIME_MS		(TOTAL_TRANSMIT_TIME_MS(CMD_RESPONSE_SIZE) + TIME_BTWN_MSGS_MS - IR_WAKE_DELAY_MS)
+
+typedef struct uplink_cmd_def {
+	rx_cmd_type_t cmd;
+	const char* pattern;					// LEN_UPLINK_BUF bytes following the ground callsign
+	void (*handler)(rx_cmd_type_t cmd);		// run as soon as it's received (NULL for none)
+	const uint8_t* (*build_reply)(void);	// fills in and returns the CMD_RESPONSE_SIZE reply
+	uint8_t reply_count;
+	uint16_t reply_spacing_ms;				// before each reply
+	bool reply_when_killed;					// reply even if the radio is killed
+	void (*after_replies)(void);			// run after the replies (NULL for none)
+	uint16_t after_replies_delay_ms;
+} uplink_cmd_def_t;
+
+typedef struct uplink_reply {
+	const uplink_cmd_def_t* def;
+	const uint8_t* buf;		// reply to transmit, or NULL to run def->after_replies
+	TickType_t earliest;	// not before this...
+	uint16_t delay_ms;		// ...nor before this long after the previous entry was handled
+} uplink_reply_t;
+
+typedef struct uplink_reply_sched {
+	uplink_reply_t entries[UPLINK_REPLY_QUEUE_LEN];
+	uint8_t head;
+	uint8_t count;
+	TickType_t last_done;
+} uplink_reply_sched_t;
+
+/* command table */
+const uplink_cmd_def_t* get_uplink_cmd_def(rx_cmd_type_t cmd);
+bool init_uplink_matcher(rx_matcher_t* m);
+
+/* scheduling (times passed in, so these don't depend on the RTOS running) */
+void uplink_sched_init(uplink_reply_sched_t* s, TickType_t now);
+bool uplink_sched_add(uplink_reply_sched_t* s, const uplink_cmd_def_t* def,
+	const uint8_t* reply, bool send_replies, TickType_t now);
+uplink_reply_t* uplink_sched_peek(uplink_reply_sched_t* s);
+TickType_t uplink_sched_ready_at(uplink_reply_sched_t* s);
+void uplink_sched_pop(uplink_reply_sched_t* s, TickType_t now);
+
+/* transmit task side */
+void uplink_commands_init(void);
+bool is_radio_killed(void);
+void handle_uplink_command(rx_cmd_type_t cmd);
+bool uplink_replies_pending(void);
+TickType_t ticks_until_uplink_reply_due(void);
+bool send_due_uplink_reply(bool replies_only);
+
+#endif /* UPLINK_COMMANDS_H_ */
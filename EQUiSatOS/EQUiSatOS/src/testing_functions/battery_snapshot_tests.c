@@ -0,0 +1,202 @@
+/*
+ * battery_snapshot_tests.c
+ *
+ * Created: 10/19/2026 7:41:17 PM
+ *  Author: BSE
+ *
+ * battery_snapshot_test checks the shared battery readings (battery_snapshot.c):
+ *	- groups never read aren't fresh, and others are for max_age ticks after
+ *	  they're read (across the tick count wrapping)
+ *	- an update only restamps its own group
+ *	- updates report just the levels they moved across (at a level is past it),
+ *	  and nothing the first time a group's read
+ * battery_snapshot_load_test counts the battery reads the battery charging and
+ * state handling tasks take over a day, at their flight periods and offsets,
+ * each reading for itself (as they used to) and sharing readings no older than
+ * a state handling period, and prints the ADC conversions (precise reads
+ * accumulate 1024 a channel) and I2C transactions per orbit. The battery
+ * charging logic's own reads (every BAT_CHARGING_ITERS_UNTIL_FULL runs) are
+ * counted the same way both times; no levels are crossed (which would add
+ * state checks, but no reads).
+ * Both only use battery_snapshot.c, so they run before the RTOS (from run_tests()) or on a host.
+ */
+
+#include "battery_snapshot_tests.h"
+
+// LI_LOW_POWER_MV, LF_FLASH_MIN_MV, LF_FULL_SUM_MV, LF_FULL_MAX_MV
+static const battery_levels_t levels = {3900, 6200, 6750, 3900};
+static battery_snapshot_t snap, readings;
+
+static void set_lf(uint16_t cell_1, uint16_t cell_2, uint16_t cell_3, uint16_t cell_4) {
+	readings.lf_mv[0] = cell_1;
+	readings.lf_mv[1] = cell_2;
+	readings.lf_mv[2] = cell_3;
+	readings.lf_mv[3] = cell_4;
+}
+
+/************************************************************************/
+/* SHARING RULES                                                        */
+/************************************************************************/
+void battery_snapshot_test(void) {
+	uint32_t crossed;
+
+	battery_snapshot_init(&snap);
+	// nothing's fresh, or past a level, before it's read
+	test_check(!battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LI, 0, 1000));
+	test_check(battery_snapshot_levels(&snap, &levels) == 0);
+
+	// the first reading of a group crosses nothing (there's nothing to cross from)
+	readings.li_mv[0] = 3800;
+	readings.li_mv[1] = 4000;
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LI, 5000, &levels);
+	test_check(crossed == 0);
+	test_check(battery_snapshot_levels(&snap, &levels) == BATTERY_LEVEL_LI_LOW_POWER(0));
+	// it's fresh up to max_age after, and only it is
+	test_check(battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LI, 5000, 0));
+	test_check(battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LI, 6000, 1000));
+	test_check(!battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LI, 6001, 1000));
+	test_check(!battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LF, 5000, 1000));
+	// (across the tick count wrapping)
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LI, UINT32_MAX - 100, &levels);
+	test_check(crossed == 0);
+	test_check(battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LI, 400, 1000));
+	test_check(!battery_snapshot_fresh(&snap, BATTERY_SNAPSHOT_LI, 1000, 1000));
+
+	// moving without crossing a level reports nothing; crossing, just what was crossed
+	readings.li_mv[0] = 3850;
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LI, 2000, &levels);
+	test_check(crossed == 0);
+	readings.li_mv[0] = 3950;
+	readings.li_mv[1] = 3900; // (at the level is past it)
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LI, 3000, &levels);
+	test_check(crossed == (BATTERY_LEVEL_LI_LOW_POWER(0) | BATTERY_LEVEL_LI_LOW_POWER(1)));
+
+	// the LiFePO banks go by the sum of their cells, and their highest cell
+	set_lf(3100, 3100, 3000, 3100);
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LF, 4000, &levels);
+	test_check(crossed == 0);
+	test_check(battery_snapshot_levels(&snap, &levels)
+		== (BATTERY_LEVEL_LI_LOW_POWER(1) | BATTERY_LEVEL_LF_BELOW_FLASH(1)));
+	set_lf(3400, 3360, 3100, 3100);
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LF, 5000, &levels);
+	test_check(crossed == (BATTERY_LEVEL_LF_FULL_SUM(0) | BATTERY_LEVEL_LF_BELOW_FLASH(1)));
+	set_lf(3950, 2900, 3100, 3100);
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_LF, 6000, &levels);
+	test_check(crossed == BATTERY_LEVEL_LF_FULL_MAX(0));
+	// (the LiOn readings weren't restamped)
+	test_check(snap.read_at[BATTERY_SNAPSHOT_LI] == 3000 && snap.read_at[BATTERY_SNAPSHOT_LF] == 6000);
+
+	// the charging signals and panel reference just come through
+	readings.dig_sigs = 0x1234;
+	readings.panel_ref = 1500;
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_SIGS, 7000, &levels);
+	test_check(crossed == 0);
+	crossed = battery_snapshot_update(&snap, &readings, BATTERY_SNAPSHOT_PANEL, 7000, &levels);
+	test_check(crossed == 0);
+	test_check(snap.dig_sigs == 0x1234 && snap.panel_ref == 1500);
+	test_check(snap.li_mv[1] == 3900 && snap.lf_mv[0] == 3950);
+	print("battery snapshot tests passed\n");
+}
+
+/************************************************************************/
+/* READS PER ORBIT                                                      */
+/************************************************************************/
+enum { LOAD_BATTERY_TASK, LOAD_STATE_TASK, LOAD_TASKS };
+
+static const char* load_task_names[LOAD_TASKS] = {"battery charging", "state handling"};
+static const uint32_t adc_conversions[BATTERY_SNAPSHOT_GROUPS] = {2 * 1024, 4 * 1024, 0, 0};
+static const uint32_t i2c_transactions[BATTERY_SNAPSHOT_GROUPS] = {0, 0, 1, 1};
+
+// [sharing][task][group]
+static uint32_t reads[2][LOAD_TASKS][BATTERY_SNAPSHOT_GROUPS];
+
+static void take(bool sharing, int task, battery_snapshot_group_t group, uint32_t now) {
+	reads[sharing][task][group]++;
+	battery_snapshot_update(&snap, &readings, group, now, &levels);
+}
+
+// takes a reading unless sharing and the shared one's recent enough
+static void need(bool sharing, int task, battery_snapshot_group_t group, uint32_t now) {
+	if (!sharing || !battery_snapshot_fresh(&snap, group, now, BATTERY_SNAPSHOT_TEST_STATE_PERIOD)) {
+		take(sharing, task, group, now);
+	}
+}
+
+static void run_day(bool sharing) {
+	uint32_t next_state = BATTERY_SNAPSHOT_TEST_STATE_OFFSET;
+	uint32_t next_battery = BATTERY_SNAPSHOT_TEST_BATTERY_OFFSET;
+	uint32_t battery_iter = 0;
+	battery_snapshot_init(&snap);
+
+	for (;;) {
+		uint32_t now = min(next_state, next_battery);
+		if (now >= BATTERY_SNAPSHOT_TEST_ORBITS * BATTERY_SNAPSHOT_TEST_ORBIT_MS) {
+			break;
+		}
+		if (now == next_battery) {
+			if (battery_iter++ % BATTERY_SNAPSHOT_TEST_ITERS_UNTIL_FULL == 0) {
+				// (battery_logic; the signals are read a couple of times along the way)
+				take(sharing, LOAD_BATTERY_TASK, BATTERY_SNAPSHOT_LI, now);
+				take(sharing, LOAD_BATTERY_TASK, BATTERY_SNAPSHOT_LF, now);
+				take(sharing, LOAD_BATTERY_TASK, BATTERY_SNAPSHOT_SIGS, now);
+				take(sharing, LOAD_BATTERY_TASK, BATTERY_SNAPSHOT_SIGS, now);
+				take(sharing, LOAD_BATTERY_TASK, BATTERY_SNAPSHOT_PANEL, now);
+			} else {
+				// (update_should_deploy_antenna)
+				need(sharing, LOAD_BATTERY_TASK, BATTERY_SNAPSHOT_LI, now);
+			}
+			next_battery += BATTERY_SNAPSHOT_TEST_BATTERY_PERIOD;
+		} else {
+			// (decide_next_state; the panel reference used to be read for each LiFePO bank)
+			need(sharing, LOAD_STATE_TASK, BATTERY_SNAPSHOT_LI, now);
+			need(sharing, LOAD_STATE_TASK, BATTERY_SNAPSHOT_LF, now);
+			need(sharing, LOAD_STATE_TASK, BATTERY_SNAPSHOT_SIGS, now);
+			need(sharing, LOAD_STATE_TASK, BATTERY_SNAPSHOT_PANEL, now);
+			if (!sharing) {
+				take(sharing, LOAD_STATE_TASK, BATTERY_SNAPSHOT_PANEL, now);
+			}
+			// it never decides on readings older than it would have read them
+			for (int group = 0; group < BATTERY_SNAPSHOT_GROUPS; group++) {
+				test_check(battery_snapshot_fresh(&snap, group, now, BATTERY_SNAPSHOT_TEST_STATE_PERIOD));
+			}
+			next_state += BATTERY_SNAPSHOT_TEST_STATE_PERIOD;
+		}
+	}
+}
+
+static void load_totals(bool sharing, int task, uint32_t* adc, uint32_t* i2c) {
+	*adc = *i2c = 0;
+	for (int group = 0; group < BATTERY_SNAPSHOT_GROUPS; group++) {
+		*adc += reads[sharing][task][group] * adc_conversions[group];
+		*i2c += reads[sharing][task][group] * i2c_transactions[group];
+	}
+	*adc /= BATTERY_SNAPSHOT_TEST_ORBITS;
+	*i2c /= BATTERY_SNAPSHOT_TEST_ORBITS;
+}
+
+void battery_snapshot_load_test(void) {
+	memset(reads, 0, sizeof(reads));
+	set_lf(3300, 3300, 3300, 3300);
+	readings.li_mv[0] = readings.li_mv[1] = 4000;
+	run_day(false);
+	run_day(true);
+
+	uint32_t adc_total[2] = {0, 0}, i2c_total[2] = {0, 0};
+	print("battery reads per orbit (%d orbits): ADC conversions / I2C transactions\n",
+		BATTERY_SNAPSHOT_TEST_ORBITS);
+	for (int task = 0; task < LOAD_TASKS; task++) {
+		uint32_t adc[2], i2c[2];
+		load_totals(false, task, &adc[0], &i2c[0]);
+		load_totals(true, task, &adc[1], &i2c[1]);
+		print("  %-16s each reading its own %6d / %3d, sharing %6d / %3d\n",
+			load_task_names[task], (int) adc[0], (int) i2c[0], (int) adc[1], (int) i2c[1]);
+		for (int sharing = 0; sharing < 2; sharing++) {
+			adc_total[sharing] += adc[sharing];
+			i2c_total[sharing] += i2c[sharing];
+		}
+	}
+	print("  %-16s each reading its own %6d / %3d, sharing %6d / %3d\n", "total",
+		(int) adc_total[0], (int) i2c_total[0], (int) adc_total[1], (int) i2c_total[1]);
+	test_check(adc_total[1] < adc_total[0] && i2c_total[1] < i2c_total[0]);
+	print("battery snapshot load test done\n");
+}
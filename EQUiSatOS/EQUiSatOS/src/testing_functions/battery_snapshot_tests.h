@@ -0,0 +1,28 @@
+/*
+ * battery_snapshot_tests.h
+ *
+ * Created: 10/19/2026 7:40:52 PM
+ *  Author: BSE
+ */
+
+
+#ifndef BATTERY_SNAPSHOT_TESTS_H_
+#define BATTERY_SNAPSHOT_TESTS_H_
+
+#include <global.h>
+#include "../rtos_tasks/battery_snapshot.h"
+#include "test_check.h"
+
+// (the flight settings, in ms)
+#define BATTERY_SNAPSHOT_TEST_STATE_PERIOD		(2*60*1000)		// STATE_HANDLING_TASK_FREQ
+#define BATTERY_SNAPSHOT_TEST_STATE_OFFSET		200
+#define BATTERY_SNAPSHOT_TEST_BATTERY_PERIOD	(9*60*1000)		// BATTERY_CHARGING_TASK_FREQ
+#define BATTERY_SNAPSHOT_TEST_BATTERY_OFFSET	30000
+#define BATTERY_SNAPSHOT_TEST_ITERS_UNTIL_FULL	5				// BAT_CHARGING_ITERS_UNTIL_FULL
+#define BATTERY_SNAPSHOT_TEST_ORBIT_MS			(5580*1000)		// ORBITAL_PERIOD_S
+#define BATTERY_SNAPSHOT_TEST_ORBITS			15
+
+void battery_snapshot_test(void);
+void battery_snapshot_load_test(void);
+
+#endif /* BATTERY_SNAPSHOT_TESTS_H_ */
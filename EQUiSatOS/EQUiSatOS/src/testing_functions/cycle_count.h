@@ -0,0 +1,41 @@
+/*
+ * cycle_count.h
+ *
+ * Created: 10/18/2026 3:02:40 PM
+ *  Author: BSE
+ *
+ * Crude cycle counter for benchmarking on the SAMD21. The M0+ has no DWT
+ * cycle counter, so this borrows SysTick as a free-running 24-bit down-counter
+ * at the CPU clock. That means it can ONLY be used before the RTOS scheduler
+ * is started (i.e. from run_tests()), and each measured span must be shorter
+ * than 2^24 cycles (~2 s at 8 MHz).
+ */
+
+#ifndef CYCLE_COUNT_H_
+#define CYCLE_COUNT_H_
+
+#include <global.h>
+
+#define CYCLE_COUNT_MASK		0x00FFFFFF
+
+static inline void cycle_count_start(void) {
+	SysTick->CTRL = 0;
+	SysTick->LOAD = CYCLE_COUNT_MASK;
+	SysTick->VAL = 0;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+static inline uint32_t cycle_count_now(void) {
+	return SysTick->VAL;
+}
+
+// cycles elapsed between two cycle_count_now() readings (counter counts down)
+static inline uint32_t cycle_count_since(uint32_t start) {
+	return (start - SysTick->VAL) & CYCLE_COUNT_MASK;
+}
+
+static inline void cycle_count_stop(void) {
+	SysTick->CTRL = 0;
+}
+
+#endif /* CYCLE_COUNT_H_ */
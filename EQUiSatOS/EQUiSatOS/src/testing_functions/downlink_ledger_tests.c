@@ -0,0 +1,285 @@
+/*
+ * downlink_ledger_tests.c
+ *
+ * Created: 10/19/2026 7:40:12 AM
+ *  Author: BSE
+ *
+ * Checks the reading ledger (IDs, the sent bitmap, and restoring after a reboot),
+ * then replays logging and transmission windows to compare how many distinct
+ * readings reach the ground per orbit when messages are filled
+ *	- by transmitted flags in the readings, retransmitting from the newest reading
+ *	  (write_data_section before the ledger)
+ *	- by the ledger, retransmitting from where the last retransmission left off
+ * The ground only hears messages sent during a pass once an orbit, and the
+ * satellite reboots every LEDGER_TEST_REBOOT_ORBITS (losing its equistacks; the
+ * ledger comes back from its last backup). Slots are planned by downlink_sched_plan
+ * at full battery. Runs before the RTOS (from run_tests()).
+ */
+
+#include "downlink_ledger_tests.h"
+
+typedef struct {
+	const char* name;
+	uint32_t log_period_s[NUM_MSG_TYPE]; // 0 if not logged
+} ledger_scenario_t;
+
+// (in msg_data_type_t order: idle, attitude, flash, flash cmp, low power; run time and mutex stats aren't logged)
+static const ledger_scenario_t scenarios[] = {
+	{"flight",			{IDLE_DATA_LOG_FREQ_S,	ATTITUDE_DATA_LOG_FREQ_S,	60,	FLASH_CMP_DATA_LOG_FREQ_S,	0}},
+	{"fast logging",	{5,						10,							60,	30,							0}},
+	{"flash burst",		{IDLE_DATA_LOG_FREQ_S,	ATTITUDE_DATA_LOG_FREQ_S,	10,	FLASH_CMP_DATA_LOG_FREQ_S,	0}},
+};
+#define NUM_SCENARIOS		(sizeof(scenarios) / sizeof(scenarios[0]))
+
+static const uint8_t stack_maxes[NUM_MSG_TYPE] = {
+	IDLE_STACK_MAX, ATTITUDE_STACK_MAX, FLASH_STACK_MAX, FLASH_CMP_STACK_MAX, LOW_POWER_STACK_MAX, RUNTIME_STATS_STACK_MAX,
+	MUTEX_STATS_STACK_MAX
+};
+static const uint8_t readings_per_msg[NUM_MSG_TYPE] = {
+	IDLE_DATA_PACKETS, ATTITUDE_DATA_PACKETS, FLASH_DATA_PACKETS, FLASH_CMP_DATA_PACKETS, LOW_POWER_DATA_PACKETS, RUNTIME_STATS_DATA_PACKETS,
+	MUTEX_STATS_DATA_PACKETS
+};
+
+typedef struct {
+	uint32_t id;
+	uint32_t timestamp;
+	bool transmitted;	// (the old flag)
+	bool received;		// by the ground
+} sim_reading_t;
+
+typedef struct {
+	sim_reading_t readings[LEDGER_TEST_MAX_STORED]; // most recent first
+	uint8_t size;
+	uint8_t capacity;
+} sim_stack_t;
+
+typedef struct {
+	uint32_t logged;
+	uint32_t sent;			// readings in messages
+	uint32_t heard;			// readings in messages the ground heard
+	uint32_t unique;		// distinct readings the ground heard
+} replay_result_t;
+
+static sim_stack_t stacks[NUM_MSG_TYPE];
+static downlink_ledger_t ledger;
+static downlink_ledger_t ledger_backup;
+static uint32_t last_id[NUM_MSG_TYPE];
+
+static void ledger_unit_test(void) {
+	downlink_ledger_t l, restored;
+	downlink_ledger_init(&l);
+
+	// IDs go up from 1, and nothing's sent until noted
+	uint32_t first = downlink_ledger_new_id(&l, FLASH_DATA);
+	test_check(first == READING_ID_NONE + 1);
+	for (uint32_t id = first + 1; id < first + 2 * DOWNLINK_LEDGER_WINDOW; id++) {
+		uint32_t new_id = downlink_ledger_new_id(&l, FLASH_DATA);
+		test_check(new_id == id);
+		test_check(!downlink_ledger_was_sent(&l, FLASH_DATA, id));
+	}
+	uint32_t newest = first + 2 * DOWNLINK_LEDGER_WINDOW - 1;
+	// (other types have their own IDs)
+	uint32_t other = downlink_ledger_new_id(&l, IDLE_DATA);
+	test_check(other == first);
+
+	downlink_ledger_note_sent(&l, FLASH_DATA, newest, false);
+	downlink_ledger_note_sent(&l, FLASH_DATA, newest - 3, false);
+	test_check(downlink_ledger_was_sent(&l, FLASH_DATA, newest));
+	test_check(!downlink_ledger_was_sent(&l, FLASH_DATA, newest - 1));
+	test_check(downlink_ledger_was_sent(&l, FLASH_DATA, newest - 3));
+	// the bits move along with new readings
+	uint32_t next = downlink_ledger_new_id(&l, FLASH_DATA);
+	test_check(!downlink_ledger_was_sent(&l, FLASH_DATA, next));
+	test_check(downlink_ledger_was_sent(&l, FLASH_DATA, newest));
+	test_check(downlink_ledger_was_sent(&l, FLASH_DATA, newest - 3));
+	// past the window is taken as sent, no reading / future IDs as not
+	test_check(downlink_ledger_was_sent(&l, FLASH_DATA, next - DOWNLINK_LEDGER_WINDOW));
+	test_check(!downlink_ledger_was_sent(&l, FLASH_DATA, next - DOWNLINK_LEDGER_WINDOW + 1));
+	test_check(!downlink_ledger_was_sent(&l, FLASH_DATA, READING_ID_NONE));
+	test_check(!downlink_ledger_was_sent(&l, FLASH_DATA, next + 1));
+
+	// retransmissions pick up below the last one
+	test_check(!downlink_ledger_retransmit_before(&l, FLASH_DATA, newest));
+	downlink_ledger_note_sent(&l, FLASH_DATA, newest - 1, true);
+	test_check(downlink_ledger_was_sent(&l, FLASH_DATA, newest - 1));
+	test_check(downlink_ledger_retransmit_before(&l, FLASH_DATA, newest - 2));
+	test_check(!downlink_ledger_retransmit_before(&l, FLASH_DATA, newest - 1));
+
+	// restoring skips a window of IDs, and clears what was sent
+	downlink_ledger_restore(&restored, &l);
+	test_check(restored.types[FLASH_DATA].next_id == l.types[FLASH_DATA].next_id + DOWNLINK_LEDGER_WINDOW);
+	test_check(restored.types[FLASH_DATA].sent_bits == 0);
+	test_check(!downlink_ledger_retransmit_before(&restored, FLASH_DATA, newest - 2));
+	other = downlink_ledger_new_id(&restored, IDLE_DATA);
+	test_check(other == first + 1 + DOWNLINK_LEDGER_WINDOW);
+	// and blank MRAM gives a fresh ledger
+	memset(&l, 0x00, sizeof(downlink_ledger_t));
+	downlink_ledger_restore(&restored, &l);
+	other = downlink_ledger_new_id(&restored, ATTITUDE_DATA);
+	test_check(other == first);
+	memset(&l, 0xFF, sizeof(downlink_ledger_t));
+	downlink_ledger_restore(&restored, &l);
+	other = downlink_ledger_new_id(&restored, ATTITUDE_DATA);
+	test_check(other == first);
+}
+
+static void log_reading(msg_data_type_t type, uint32_t now, replay_result_t* r) {
+	sim_stack_t* st = &stacks[type];
+	if (st->size == st->capacity) {
+		st->size--;
+	}
+	memmove(&st->readings[1], &st->readings[0], st->size * sizeof(sim_reading_t));
+	sim_reading_t* reading = &st->readings[0];
+	reading->id = downlink_ledger_new_id(&ledger, type);
+	// (IDs only go up, reboots included)
+	test_check(reading->id > last_id[type]);
+	last_id[type] = reading->id;
+	reading->timestamp = now;
+	reading->transmitted = false;
+	reading->received = false;
+	st->size++;
+	r->logged++;
+}
+
+static bool sim_was_sent(msg_data_type_t type, const sim_reading_t* reading, bool use_ledger) {
+	return use_ledger ? downlink_ledger_was_sent(&ledger, type, reading->id) : reading->transmitted;
+}
+
+// as in package_transmission.c
+static int sim_retransmit_start_index(msg_data_type_t type) {
+	for (int i = 0; i < stacks[type].size; i++) {
+		if (downlink_ledger_retransmit_before(&ledger, type, stacks[type].readings[i].id)) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+// like write_data_section, with (use_ledger) or without the ledger
+static void send_msg(msg_data_type_t type, bool heard, bool use_ledger, replay_result_t* r) {
+	sim_stack_t* st = &stacks[type];
+	if (st->size == 0) {
+		return;
+	}
+	uint8_t left = readings_per_msg[type];
+	int i = 0;
+	bool retransmit = false;
+	while (left > 0) {
+		sim_reading_t* reading = &st->readings[i];
+		if (retransmit || !sim_was_sent(type, reading, use_ledger)) {
+			reading->transmitted = true;
+			downlink_ledger_note_sent(&ledger, type, reading->id, retransmit);
+			r->sent++;
+			if (heard) {
+				r->heard++;
+				if (!reading->received) {
+					reading->received = true;
+					r->unique++;
+				}
+			}
+			left--;
+		}
+		i++;
+		if (i >= st->size) {
+			i = (retransmit || !use_ledger) ? 0 : sim_retransmit_start_index(type);
+			retransmit = true;
+		}
+	}
+}
+
+static void get_backlog(uint32_t now, bool use_ledger, downlink_backlog_t* backlog) {
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		downlink_backlog_t* b = &backlog[t];
+		b->unsent = 0;
+		b->stored = stacks[t].size;
+		b->capacity = stacks[t].capacity;
+		b->oldest_age_s = 0;
+		for (int i = 0; i < stacks[t].size; i++) {
+			if (!sim_was_sent(t, &stacks[t].readings[i], use_ledger)) {
+				b->unsent++;
+				b->oldest_age_s = now - stacks[t].readings[i].timestamp;
+			}
+		}
+	}
+}
+
+static void reboot(downlink_sched_t* sched) {
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		stacks[t].size = 0;
+	}
+	downlink_ledger_restore(&ledger, &ledger_backup);
+	downlink_sched_init(sched);
+}
+
+static void replay(const ledger_scenario_t* sc, bool use_ledger, replay_result_t* r) {
+	downlink_sched_t sched;
+	downlink_backlog_t backlog[NUM_MSG_TYPE];
+	downlink_plan_t plan;
+	uint32_t window_s = TRANSMIT_TASK_FREQ / 1000;
+	uint32_t backup_s = PERSISTENT_DATA_BACKUP_TASK_FREQ / 1000;
+	uint32_t end_s = LEDGER_TEST_ORBITS * ORBITAL_PERIOD_S;
+
+	memset(r, 0, sizeof(replay_result_t));
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		stacks[t].size = 0;
+		stacks[t].capacity = stack_maxes[t] - 1; // (the oldest is staged, not readable)
+		last_id[t] = READING_ID_NONE;
+	}
+	downlink_ledger_init(&ledger);
+	ledger_backup = ledger;
+	downlink_sched_init(&sched);
+
+	for (uint32_t now = 0; now < end_s; now++) {
+		uint32_t orbit_s = now % ORBITAL_PERIOD_S;
+		if (now > 0 && orbit_s == ORBITAL_PERIOD_S / 3 && (now / ORBITAL_PERIOD_S) % LEDGER_TEST_REBOOT_ORBITS == 0) {
+			reboot(&sched);
+		}
+		if (now % backup_s == 0) {
+			ledger_backup = ledger;
+		}
+		for (int t = 0; t < NUM_MSG_TYPE; t++) {
+			if (sc->log_period_s[t] != 0 && now % sc->log_period_s[t] == 0) {
+				log_reading(t, now, r);
+			}
+		}
+		if (now % window_s != 0) {
+			continue;
+		}
+		// (the pass is in the middle of the orbit)
+		bool heard = orbit_s >= ORBITAL_PERIOD_S / 2 && orbit_s < ORBITAL_PERIOD_S / 2 + LEDGER_TEST_PASS_S;
+		get_backlog(now, use_ledger, backlog);
+		downlink_sched_plan(&sched, backlog, false, 0, &plan);
+		for (int i = 0; i < plan.num_slots; i++) {
+			send_msg(plan.slots[i], heard, use_ledger, r);
+		}
+	}
+}
+
+static void print_result(const char* name, const replay_result_t* r) {
+	uint32_t dup_pct = r->heard == 0 ? 0 : 100 * (r->heard - r->unique) / r->heard;
+	print("  %s: %d unique readings heard / orbit (%d of %d logged; %d%% of those heard were repeats)\n",
+		name, r->unique / LEDGER_TEST_ORBITS, r->unique, r->logged, dup_pct);
+}
+
+void downlink_ledger_replay_test(void) {
+	replay_result_t flags;
+	replay_result_t ledgered;
+
+	ledger_unit_test();
+
+	for (uint8_t s = 0; s < NUM_SCENARIOS; s++) {
+		const ledger_scenario_t* sc = &scenarios[s];
+		print("%s:\n", sc->name);
+		replay(sc, false, &flags);
+		print_result("transmitted flags", &flags);
+		replay(sc, true, &ledgered);
+		print_result("reading ledger", &ledgered);
+
+		// the same readings are logged and the same number sent either way,
+		// and the ground never hears fewer distinct ones with the ledger
+		test_check(ledgered.logged == flags.logged);
+		test_check(ledgered.sent == flags.sent && ledgered.heard == flags.heard);
+		test_check(ledgered.unique >= flags.unique);
+	}
+	print("downlink ledger replay test passed\n");
+}
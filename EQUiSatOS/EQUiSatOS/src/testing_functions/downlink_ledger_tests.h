@@ -0,0 +1,28 @@
+/*
+ * downlink_ledger_tests.h
+ *
+ * Created: 10/19/2026 7:40:02 AM
+ *  Author: BSE
+ */
+
+
+#ifndef DOWNLINK_LEDGER_TESTS_H_
+#define DOWNLINK_LEDGER_TESTS_H_
+
+#include <global.h>
+#include "../telemetry/downlink_ledger.h"
+#include "../telemetry/downlink_sched.h"
+#include "test_check.h"
+
+// orbits replayed per scenario
+#define LEDGER_TEST_ORBITS			12
+// the satellite reboots this often (partway through an orbit)
+#define LEDGER_TEST_REBOOT_ORBITS	5
+// ground pass each orbit (as in equisim_radio.h)
+#define LEDGER_TEST_PASS_S			(8 * 60)
+// largest equistack modeled (see rtos_tasks_config.h)
+#define LEDGER_TEST_MAX_STORED		8
+
+void downlink_ledger_replay_test(void);
+
+#endif /* DOWNLINK_LEDGER_TESTS_H_ */
@@ -0,0 +1,238 @@
+/*
+ * downlink_sched_tests.c
+ *
+ * Created: 10/19/2026 1:48:36 AM
+ *  Author: BSE
+ *
+ * Replays logging and transmission windows against the downlink scheduler
+ * (downlink_sched_plan) and the fixed slots it replaced (IDLE, ATTITUDE, FLASH,
+ * FLASH_CMP every window, falling back through the priority chain for empty
+ * stacks, and two LOW_POWER messages per window in low power).
+ * Each message type is modeled as an equistack of readings logged at its rate,
+ * and each message is filled the way write_data_section does (unsent readings
+ * first, then retransmissions). For each logging scenario and battery voltage,
+ * reports slots used per orbit, the fraction of readings ever sent (the rest
+ * were overwritten first), and their age when first sent.
+ * The scheduler is given its inputs directly, so this runs before the RTOS (from run_tests()).
+ */
+
+#include "downlink_sched_tests.h"
+#include "../rtos_tasks/battery_charging_task.h"
+
+typedef struct {
+	const char* name;
+	bool low_power;
+	bool fits_min_budget; // whether one message per window is enough to send everything
+	uint32_t log_period_s[NUM_MSG_TYPE]; // 0 if not logged
+} logging_scenario_t;
+
+// (in msg_data_type_t order: idle, attitude, flash, flash cmp, low power; run time and mutex stats aren't logged)
+static const logging_scenario_t scenarios[] = {
+	{"flight",			false,	true,	{IDLE_DATA_LOG_FREQ_S,	ATTITUDE_DATA_LOG_FREQ_S,	60,	FLASH_CMP_DATA_LOG_FREQ_S,	0}},
+	{"fast logging",	false,	false,	{5,						10,							60,	30,							0}},
+	{"flash burst",		false,	false,	{IDLE_DATA_LOG_FREQ_S,	ATTITUDE_DATA_LOG_FREQ_S,	10,	FLASH_CMP_DATA_LOG_FREQ_S,	0}},
+	{"low power",		true,	true,	{0,						0,							0,	0,							120}},
+	{"fast low power",	true,	true,	{0,						0,							0,	0,							20}},
+};
+#define NUM_SCENARIOS		(sizeof(scenarios) / sizeof(scenarios[0]))
+
+// LiOn voltages to schedule at (the fixed slots don't look)
+static const uint16_t battery_mvs[] = {4150, 4050, 3950, 3850};
+#define NUM_BATTERY_MVS		(sizeof(battery_mvs) / sizeof(battery_mvs[0]))
+
+static const uint8_t stack_maxes[NUM_MSG_TYPE] = {
+	IDLE_STACK_MAX, ATTITUDE_STACK_MAX, FLASH_STACK_MAX, FLASH_CMP_STACK_MAX, LOW_POWER_STACK_MAX, RUNTIME_STATS_STACK_MAX,
+	MUTEX_STATS_STACK_MAX
+};
+static const uint8_t readings_per_msg[NUM_MSG_TYPE] = {
+	IDLE_DATA_PACKETS, ATTITUDE_DATA_PACKETS, FLASH_DATA_PACKETS, FLASH_CMP_DATA_PACKETS, LOW_POWER_DATA_PACKETS, RUNTIME_STATS_DATA_PACKETS,
+	MUTEX_STATS_DATA_PACKETS
+};
+
+typedef struct {
+	uint32_t timestamp;
+	bool transmitted;
+} sim_reading_t;
+
+typedef struct {
+	sim_reading_t readings[DOWNLINK_TEST_MAX_STORED]; // most recent first
+	uint8_t size;
+	uint8_t capacity;
+} sim_stack_t;
+
+typedef struct {
+	uint32_t slots;
+	uint32_t logged;
+	uint32_t sent;
+	uint32_t lost;			// overwritten before being sent
+	uint64_t age_sum_s;		// at first send
+	uint32_t age_max_s;
+} replay_result_t;
+
+static sim_stack_t stacks[NUM_MSG_TYPE];
+
+static void log_reading(sim_stack_t* st, uint32_t now, replay_result_t* r) {
+	if (st->size == st->capacity) {
+		if (!st->readings[st->size - 1].transmitted) {
+			r->lost++;
+		}
+		st->size--;
+	}
+	memmove(&st->readings[1], &st->readings[0], st->size * sizeof(sim_reading_t));
+	st->readings[0].timestamp = now;
+	st->readings[0].transmitted = false;
+	st->size++;
+	r->logged++;
+}
+
+// like write_data_section: unsent readings (most recent first), then fill with retransmissions
+static void send_msg(msg_data_type_t type, uint32_t now, replay_result_t* r) {
+	sim_stack_t* st = &stacks[type];
+	uint8_t left = readings_per_msg[type];
+	for (int i = 0; i < st->size && left > 0; i++) {
+		sim_reading_t* reading = &st->readings[i];
+		if (!reading->transmitted) {
+			reading->transmitted = true;
+			uint32_t age = now - reading->timestamp;
+			r->sent++;
+			r->age_sum_s += age;
+			r->age_max_s = max(r->age_max_s, age);
+			left--;
+		}
+	}
+	r->slots++;
+}
+
+// the slots before the scheduler (see determine_single_msg_to_transmit, removed)
+static msg_data_type_t fixed_slot_type(msg_data_type_t default_type, bool low_power) {
+	static const msg_data_type_t next_pri[NUM_MSG_TYPE] = {
+		FLASH_CMP_DATA /* idle */, FLASH_DATA /* attitude */, IDLE_DATA /* flash */, ATTITUDE_DATA /* flash cmp */, LOW_POWER_DATA,
+		RUNTIME_STATS_DATA, MUTEX_STATS_DATA /* (not in the fixed slots) */
+	};
+	if (low_power) {
+		return LOW_POWER_DATA;
+	}
+	msg_data_type_t type = default_type;
+	do {
+		if (stacks[type].size > 0) {
+			return type;
+		}
+		type = next_pri[type];
+	} while (type != default_type);
+	return default_type;
+}
+
+static void get_backlog(uint32_t now, downlink_backlog_t* backlog) {
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		downlink_backlog_t* b = &backlog[t];
+		b->unsent = 0;
+		b->stored = stacks[t].size;
+		b->capacity = stacks[t].capacity;
+		b->oldest_age_s = 0;
+		for (int i = 0; i < stacks[t].size; i++) {
+			if (!stacks[t].readings[i].transmitted) {
+				b->unsent++;
+				b->oldest_age_s = now - stacks[t].readings[i].timestamp;
+			}
+		}
+	}
+}
+
+// replays DOWNLINK_TEST_ORBITS of logging and windows, with the scheduler (at li_mv)
+// or the fixed slots (use_sched false)
+static void replay(const logging_scenario_t* sc, bool use_sched, uint16_t li_mv, replay_result_t* r) {
+	static const msg_data_type_t fixed_slots[DOWNLINK_MAX_SLOTS] = {IDLE_DATA, ATTITUDE_DATA, FLASH_DATA, FLASH_CMP_DATA};
+	downlink_sched_t sched;
+	downlink_backlog_t backlog[NUM_MSG_TYPE];
+	downlink_plan_t plan;
+	uint32_t window_s = (sc->low_power ? TRANSMIT_TASK_LESS_FREQ : TRANSMIT_TASK_FREQ) / 1000;
+	uint32_t end_s = DOWNLINK_TEST_ORBITS * ORBITAL_PERIOD_S;
+
+	memset(r, 0, sizeof(replay_result_t));
+	for (int t = 0; t < NUM_MSG_TYPE; t++) {
+		stacks[t].size = 0;
+		stacks[t].capacity = stack_maxes[t] - 1; // (the oldest is staged, not readable)
+	}
+	downlink_sched_init(&sched);
+
+	uint32_t next_window_s = window_s;
+	for (uint32_t now = 0; now < end_s; now++) {
+		for (int t = 0; t < NUM_MSG_TYPE; t++) {
+			if (sc->log_period_s[t] != 0 && now % sc->log_period_s[t] == 0) {
+				log_reading(&stacks[t], now, r);
+			}
+		}
+		if (now != next_window_s) {
+			continue;
+		}
+		next_window_s += window_s;
+
+		if (use_sched) {
+			get_backlog(now, backlog);
+			downlink_sched_plan(&sched, backlog, sc->low_power, li_mv, &plan);
+		} else {
+			plan.num_slots = sc->low_power ? DOWNLINK_LOW_POWER_MAX_SLOTS : DOWNLINK_MAX_SLOTS;
+			for (int i = 0; i < plan.num_slots; i++) {
+				plan.slots[i] = fixed_slot_type(fixed_slots[i], sc->low_power);
+			}
+		}
+		for (int i = 0; i < plan.num_slots; i++) {
+			send_msg(plan.slots[i], now, r);
+		}
+	}
+}
+
+static void print_result(const char* name, uint16_t li_mv, const replay_result_t* r) {
+	uint32_t slots_per_orbit = r->slots / DOWNLINK_TEST_ORBITS;
+	uint32_t sent_pct = r->logged == 0 ? 100 : 100 - (100 * r->lost + r->logged - 1) / r->logged;
+	uint32_t mean_age = r->sent == 0 ? 0 : r->age_sum_s / r->sent;
+	print("  %s @ %d mV: %d slots/orbit | %d/%d sent (%d lost, %d%%) | age at first send %d s mean, %d s max\n",
+		name, li_mv, slots_per_orbit, r->sent, r->logged, r->lost, sent_pct, mean_age, r->age_max_s);
+}
+
+void downlink_sched_replay_test(void) {
+	replay_result_t fixed;
+	replay_result_t sched;
+
+	// the slot budget follows the battery
+	test_check(downlink_energy_refill(0, false) == DOWNLINK_REFILL_FULL);
+	test_check(downlink_energy_refill(LI_FULL_LOWER_MV, false) == DOWNLINK_REFILL_FULL);
+	test_check(downlink_energy_refill(LI_DOWN_MV, false) == DOWNLINK_REFILL_CHARGED);
+	test_check(downlink_energy_refill(LI_LOW_POWER_MV - 1, false) == DOWNLINK_REFILL_LOW);
+	test_check(downlink_energy_refill(LI_FULL_LOWER_MV, true) == DOWNLINK_REFILL_LOW_POWER);
+
+	for (uint8_t s = 0; s < NUM_SCENARIOS; s++) {
+		const logging_scenario_t* sc = &scenarios[s];
+		uint32_t window_s = (sc->low_power ? TRANSMIT_TASK_LESS_FREQ : TRANSMIT_TASK_FREQ) / 1000;
+		uint32_t windows = (DOWNLINK_TEST_ORBITS * ORBITAL_PERIOD_S - 1) / window_s;
+		uint8_t max_slots = sc->low_power ? DOWNLINK_LOW_POWER_MAX_SLOTS : DOWNLINK_MAX_SLOTS;
+
+		print("%s:\n", sc->name);
+		replay(sc, false, 0, &fixed);
+		print_result("fixed slots", 0, &fixed);
+		test_check(fixed.slots == windows * max_slots);
+
+		uint32_t prev_slots = 0xFFFFFFFF;
+		for (uint8_t b = 0; b < NUM_BATTERY_MVS; b++) {
+			replay(sc, true, battery_mvs[b], &sched);
+			print_result("scheduler", battery_mvs[b], &sched);
+
+			test_check(sched.sent + sched.lost <= sched.logged);
+			// at least one message every window, and no more than the battery allows
+			test_check(sched.slots >= windows && sched.slots <= prev_slots);
+			prev_slots = sched.slots;
+			if (b == 0) {
+				// charged: a full window every time, and nothing lost the fixed slots didn't
+				test_check(sched.slots == fixed.slots);
+				test_check(sched.lost <= fixed.lost);
+				// (and no staler, unless it's because more old data made it out)
+				test_check(sched.lost < fixed.lost || sched.age_sum_s * fixed.sent <= fixed.age_sum_s * sched.sent);
+			}
+			if (sc->fits_min_budget) {
+				// (the smallest budget is enough, if it's spent on unsent data)
+				test_check(sched.lost == 0);
+			}
+		}
+	}
+	print("downlink scheduler replay test passed\n");
+}
@@ -0,0 +1,23 @@
+/*
+ * downlink_sched_tests.h
+ *
+ * Created: 10/19/2026 1:48:20 AM
+ *  Author: BSE
+ */
+
+
+#ifndef DOWNLINK_SCHED_TESTS_H_
+#define DOWNLINK_SCHED_TESTS_H_
+
+#include <global.h>
+#include "../telemetry/downlink_sched.h"
+#include "test_check.h"
+
+// orbits replayed per scenario
+#define DOWNLINK_TEST_ORBITS		4
+// largest equistack modeled (see rtos_tasks_config.h)
+#define DOWNLINK_TEST_MAX_STORED	8
+
+void downlink_sched_replay_test(void);
+
+#endif /* DOWNLINK_SCHED_TESTS_H_ */
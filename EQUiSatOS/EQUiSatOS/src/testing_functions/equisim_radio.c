@@ -0,0 +1,349 @@
+/*
+ * equisim_radio.c
+ *
+ * Created: 10/18/2026 11:58:41 PM
+ *  Author: BSE
+ */
+
+#include "equisim_radio.h"
+
+typedef enum {
+	RADIO_SIM_DATA,		// bytes go on air
+	RADIO_SIM_COMMAND,	// bytes are XDL command packets
+} radio_sim_mode_t;
+
+static const char sat_callsign[CALLSIGN_SIZE] = {'W', 'L', '9', 'X', 'Z', 'E'};
+
+// XDL commands we know the argument count for (the rest can't be parsed)
+typedef struct {
+	uint8_t cmd;
+	uint8_t num_args;
+} xdl_cmd_def_t;
+
+static const xdl_cmd_def_t xdl_cmds[] = {
+	{XDL_CMD_GET_TEMP,	0},
+	{XDL_CMD_RESET,		1}, // warm / cold
+	{0x03,				1}, // channel
+	{0x05,				1}, // link speed
+	{0x2B,				1}, // modulation format
+	{0x37,				5}, // TX frequency (channel, 4 byte Hz)
+	{0x39,				5}, // RX frequency
+	{0x44,				1}, // dealer mode
+};
+#define NUM_XDL_CMDS		(sizeof(xdl_cmds) / sizeof(xdl_cmds[0]))
+
+static equisim_radio_config_t cfg;
+static equisim_radio_stats_t stats;
+
+// pins (left alone by init; they're set whenever the firmware sets them)
+static bool powered = false;
+static bool tx_enabled = false;
+static bool rx_enabled = false;
+
+static radio_sim_mode_t mode;
+static uint32_t keyed_until;		// when the data handed over so far is all on air
+static uint32_t last_handoff;
+static uint32_t rebooting_until;
+static uint8_t cmd_buf[EQUISIM_RADIO_CMD_MAX_LEN];
+static uint8_t cmd_len;
+
+// channel
+static uint32_t rng_state;
+static bool in_burst;
+
+static uint8_t ground_frame[MSG_SIZE];
+
+/************************************************************************/
+/* INIT / PINS                                                          */
+/************************************************************************/
+void equisim_radio_default_config(equisim_radio_config_t* config) {
+	config->ber_ppm = 10;
+	config->burst_ber_ppm = 20000;
+	config->burst_start_ppm = 100;
+	config->burst_mean_bytes = 40;
+	config->orbit_ms = EQUISIM_RADIO_ORBIT_MS;
+	config->pass_ms = EQUISIM_RADIO_PASS_MS;
+	config->temp = EQUISIM_RADIO_DEFAULT_TEMP;
+	config->seed = 0x5A7E11;
+}
+
+/* resets the radio, channel and stats (NULL for the default config) */
+void equisim_radio_init(const equisim_radio_config_t* config) {
+	if (config == NULL) {
+		equisim_radio_default_config(&cfg);
+	} else {
+		cfg = *config;
+	}
+	memset(&stats, 0, sizeof(stats));
+	mode = RADIO_SIM_DATA;
+	keyed_until = 0;
+	last_handoff = 0;
+	rebooting_until = 0;
+	cmd_len = 0;
+	rng_state = cfg.seed != 0 ? cfg.seed : 1;
+	in_burst = false;
+}
+
+equisim_radio_stats_t* equisim_radio_get_stats(void) {
+	return &stats;
+}
+
+void equisim_radio_set_power(bool on) {
+	if (!on) {
+		// comes back up in data mode
+		mode = RADIO_SIM_DATA;
+		cmd_len = 0;
+	}
+	powered = on;
+}
+
+void equisim_radio_set_tx_enable(bool enable) {
+	tx_enabled = enable;
+}
+
+void equisim_radio_set_rx_enable(bool enable) {
+	rx_enabled = enable;
+}
+
+// (signed difference, so clock overflow is handled)
+static bool time_reached(uint32_t now, uint32_t t) {
+	return (int32_t) (now - t) >= 0;
+}
+
+/************************************************************************/
+/* CHANNEL                                                              */
+/************************************************************************/
+static uint32_t sim_rand(void) {
+	// xorshift32
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static bool chance_ppm(uint32_t ppm) {
+	return ppm > 0 && sim_rand() % 1000000 < ppm;
+}
+
+// a byte through the channel, with bit errors at the current state's BER
+static uint8_t channel_byte(uint8_t b) {
+	if (in_burst) {
+		in_burst = cfg.burst_mean_bytes > 1 && sim_rand() % cfg.burst_mean_bytes != 0;
+	} else {
+		in_burst = chance_ppm(cfg.burst_start_ppm);
+	}
+	uint32_t ber_ppm = in_burst ? cfg.burst_ber_ppm : cfg.ber_ppm;
+	for (int bit = 0; bit < 8 && ber_ppm > 0; bit++) {
+		if (chance_ppm(ber_ppm)) {
+			b ^= 1 << bit;
+			stats.bit_errors++;
+		}
+	}
+	return b;
+}
+
+static bool in_pass(uint32_t t) {
+	return cfg.orbit_ms == 0 || t % cfg.orbit_ms < cfg.pass_ms;
+}
+
+/************************************************************************/
+/* GROUND STATION                                                       */
+/************************************************************************/
+// full messages are RS-decoded; anything else is only counted if it got through intact
+static void ground_receive(const uint8_t* sent, int len, bool heard) {
+	if (len != MSG_SIZE) {
+		bool intact = heard;
+		for (int i = 0; i < len && intact; i++) {
+			intact = channel_byte(sent[i]) == sent[i];
+		}
+		if (intact) {
+			stats.other_heard++;
+		}
+		return;
+	}
+
+	stats.frames_sent++;
+	if (!heard) {
+		stats.frames_unheard++;
+		return;
+	}
+	for (int i = 0; i < MSG_SIZE; i++) {
+		ground_frame[i] = channel_byte(sent[i]);
+	}
+	// the decoder finds messages by their callsign (which isn't RS-encoded)
+	if (memcmp(ground_frame, sat_callsign, CALLSIGN_SIZE) != 0) {
+		stats.frames_lost++;
+		return;
+	}
+
+	bool corrected = false;
+	#ifdef USE_REED_SOLOMON
+		decode_data(ground_frame + CALLSIGN_SIZE, MSG_SIZE - CALLSIGN_SIZE);
+		if (check_syndrome() != 0) {
+			if (!correct_errors_erasures(ground_frame + CALLSIGN_SIZE, MSG_SIZE - CALLSIGN_SIZE, 0, NULL)) {
+				stats.frames_lost++;
+				return;
+			}
+			corrected = true;
+		}
+	#endif
+	if (memcmp(ground_frame + CALLSIGN_SIZE, sent + CALLSIGN_SIZE, EQUISIM_RADIO_PAYLOAD_SIZE) != 0) {
+		#ifdef USE_REED_SOLOMON
+			stats.frames_miscorrected++;
+		#else
+			stats.frames_lost++;
+		#endif
+		return;
+	}
+	if (corrected) {
+		stats.frames_corrected++;
+	} else {
+		stats.frames_clean++;
+	}
+	stats.payload_bytes += EQUISIM_RADIO_PAYLOAD_SIZE;
+}
+
+/************************************************************************/
+/* RADIO                                                                */
+/************************************************************************/
+static void send_on_air(const uint8_t* buf, int len, uint32_t now) {
+	uint32_t start;
+	if (!time_reached(now, keyed_until)) {
+		// still sending the last handoff; the radio buffers this and keeps going
+		start = keyed_until;
+		stats.handoffs_queued++;
+	} else {
+		start = now;
+		stats.transmissions++;
+		stats.tx_current_ms += TRANSMIT_CURRENT_RISE_TIME_MS + TRANSMIT_CURRENT_FALL_TIME_MS;
+	}
+	uint32_t air_ms = (len * 1000 + RADIO_BAUD_BYTES - 1) / RADIO_BAUD_BYTES;
+	keyed_until = start + air_ms;
+	stats.air_ms += air_ms;
+	stats.tx_current_ms += air_ms;
+
+	bool heard = in_pass(start) && in_pass(keyed_until - 1) && air_ms < cfg.pass_ms;
+	ground_receive(buf, len, heard);
+}
+
+static void respond(const uint8_t* response, int len) {
+	stats.cmd_responses++;
+	if (!rx_enabled) {
+		return;
+	}
+	for (int i = 0; i < len; i++) {
+		usart_receive_byte(response[i]);
+	}
+}
+
+// responses are 0x01, command | 0x80, data, checksum (~sum of the command and data)
+static void respond_with_data(uint8_t cmd, const uint8_t* data, int data_len) {
+	uint8_t response[EQUISIM_RADIO_CMD_MAX_LEN];
+	uint8_t checksum = cmd | XDL_RESPONSE_FLAG;
+	response[0] = XDL_CMD_START;
+	response[1] = cmd | XDL_RESPONSE_FLAG;
+	for (int i = 0; i < data_len; i++) {
+		response[2 + i] = data[i];
+		checksum += data[i];
+	}
+	response[2 + data_len] = ~checksum;
+	respond(response, 3 + data_len);
+}
+
+static void handle_command(uint8_t cmd, const uint8_t* args, uint32_t now) {
+	uint8_t data[2];
+	switch (cmd) {
+		case XDL_CMD_GET_TEMP:
+			data[0] = cfg.temp >> 8;
+			data[1] = cfg.temp & 0xFF;
+			respond_with_data(cmd, data, 2);
+			break;
+		case XDL_CMD_RESET:
+			data[0] = 0; // ok
+			respond_with_data(cmd, data, 1);
+			// drops out of command mode, and hears nothing until it's back up
+			mode = RADIO_SIM_DATA;
+			rebooting_until = now + WARM_RESET_REBOOT_TIME;
+			break;
+		default:
+			// settings; just acknowledge
+			data[0] = 0;
+			respond_with_data(cmd, data, 1);
+	}
+}
+
+static int xdl_cmd_num_args(uint8_t cmd) {
+	for (uint8_t i = 0; i < NUM_XDL_CMDS; i++) {
+		if (xdl_cmds[i].cmd == cmd) {
+			return xdl_cmds[i].num_args;
+		}
+	}
+	return -1;
+}
+
+static void command_byte(uint8_t b, uint32_t now) {
+	if (cmd_len == 0 && b != XDL_CMD_START) {
+		return; // between packets
+	}
+	cmd_buf[cmd_len++] = b;
+	if (cmd_len < 3) {
+		return;
+	}
+	int num_args = xdl_cmd_num_args(cmd_buf[1]);
+	if (num_args < 0) {
+		stats.cmd_bad++;
+		cmd_len = 0;
+		return;
+	}
+	if (cmd_len < 3 + num_args) {
+		return;
+	}
+	if (check_checksum(cmd_buf + 1, 1 + num_args, cmd_buf[2 + num_args])) {
+		handle_command(cmd_buf[1], cmd_buf + 2, now);
+	} else {
+		stats.cmd_bad++;
+	}
+	cmd_len = 0;
+}
+
+static bool is_escape(const uint8_t* buf, int len) {
+	return len == 3 && buf[0] == '+' && buf[1] == '+' && buf[2] == '+';
+}
+
+bool equisim_radio_tx_at(const uint8_t* buf, int len, uint32_t now_ms) {
+	if (!tx_enabled) {
+		return false;
+	}
+	if (!powered || !time_reached(now_ms, rebooting_until)) {
+		stats.bytes_lost += len;
+	} else if (mode == RADIO_SIM_COMMAND) {
+		for (int i = 0; i < len; i++) {
+			command_byte(buf[i], now_ms);
+		}
+	} else if (is_escape(buf, len)
+			&& time_reached(now_ms, last_handoff + EQUISIM_RADIO_CMD_GUARD_MS)
+			&& time_reached(now_ms, keyed_until + EQUISIM_RADIO_CMD_GUARD_MS)) {
+		mode = RADIO_SIM_COMMAND;
+		cmd_len = 0;
+	} else {
+		if (is_escape(buf, len)) {
+			stats.escapes_sent++;
+		}
+		send_on_air(buf, len, now_ms);
+	}
+	last_handoff = now_ms;
+	return true;
+}
+
+/* hook for the radio USART (times from the RTOS tick count) */
+bool equisim_radio_usart_tx(const uint8_t* buf, int len) {
+	return equisim_radio_tx_at(buf, len, xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+uint32_t equisim_radio_goodput_per_orbit(const equisim_radio_stats_t* s, uint32_t elapsed_ms) {
+	if (elapsed_ms == 0) {
+		return 0;
+	}
+	uint32_t orbit_ms = cfg.orbit_ms != 0 ? cfg.orbit_ms : EQUISIM_RADIO_ORBIT_MS;
+	return (uint32_t) ((uint64_t) s->payload_bytes * orbit_ms / elapsed_ms);
+}
@@ -0,0 +1,105 @@
+/*
+ * equisim_radio.h
+ *
+ * Virtual XDL radio and ground station, for exercising the radio path
+ * (transmit_buf_wait, set_command_mode, XDL_prepare_get_temp, warm_reset, ...)
+ * without a radio attached. With EQUISIM_SIMULATE_RADIO defined, bytes sent on
+ * the radio USART while the TX buffer is enabled go here instead of the SERCOM,
+ * and radio responses come back through the USART receive path.
+ *
+ * The radio side models:
+ *	- power and the TX/RX buffers (bytes are lost if the radio can't hear them)
+ *	- "+++" escapes into command mode (only after the guard time of silence;
+ *	  otherwise they're sent on air like any data) and the XDL command packets,
+ *	  answering get temp and resets
+ *	- air time at RADIO_BAUD_BYTES, with handoffs that arrive while the radio
+ *	  is still keyed queued onto the end of the current transmission, and the
+ *	  transmit current rise / fall around each transmission
+ * The channel applies random bit errors with a Gilbert-Elliott burst model
+ * (a good and a bad state, each with its own BER), and only delivers what goes
+ * out during a pass over the ground station. The ground station Reed-Solomon
+ * decodes each full message (as a real decoder would, from the callsign) and
+ * counts the telemetry that made it, for goodput per orbit.
+ *
+ * Created: 10/18/2026 11:58:20 PM
+ *  Author: BSE
+ */
+
+#ifndef EQUISIM_RADIO_H_
+#define EQUISIM_RADIO_H_
+
+#include <global.h>
+#include "../data_handling/package_transmission.h"
+
+/************************************************************************/
+/* CONFIG                                                               */
+/************************************************************************/
+// ISS-like orbit, and the time per orbit the ground station can hear us
+#define EQUISIM_RADIO_ORBIT_MS				(92UL * 60 * 1000)
+#define EQUISIM_RADIO_PASS_MS				(8UL * 60 * 1000)
+// silence needed before "+++" for the radio to take it as an escape
+// (must be below SET_CMD_MODE_WAIT_BEFORE_MS)
+#define EQUISIM_RADIO_CMD_GUARD_MS			500
+// radio temperature reported in command mode (1/10 degree C)
+#define EQUISIM_RADIO_DEFAULT_TEMP			235
+
+#define EQUISIM_RADIO_PAYLOAD_SIZE			(START_PARITY - CALLSIGN_SIZE) // RS-protected telemetry
+#define EQUISIM_RADIO_CMD_MAX_LEN			8
+
+// XDL command packets: 0x01, command, args, checksum (~sum of command and args)
+#define XDL_CMD_START						0x01
+#define XDL_CMD_GET_TEMP					0x50
+#define XDL_CMD_RESET						0x1d
+#define XDL_RESPONSE_FLAG					0x80
+
+typedef struct equisim_radio_config_t {
+	uint32_t ber_ppm;			// bit errors per million bits, normally
+	uint32_t burst_ber_ppm;		// ...and during a burst (fade)
+	uint32_t burst_start_ppm;	// chance per byte of a burst starting
+	uint16_t burst_mean_bytes;	// mean burst length
+	uint32_t orbit_ms;			// 0 to hear everything (no passes)
+	uint32_t pass_ms;
+	uint16_t temp;
+	uint32_t seed;
+} equisim_radio_config_t;
+
+typedef struct equisim_radio_stats_t {
+	// radio
+	uint32_t bytes_lost;		// sent while the radio was off or rebooting
+	uint32_t transmissions;		// times the radio keyed up
+	uint32_t handoffs_queued;	// handed over while the radio was still keyed
+	uint32_t air_ms;			// time keyed (sending)
+	uint32_t tx_current_ms;		// ...plus the current rise and fall
+	uint16_t escapes_sent;		// "+++" that went on air instead (guard time not met)
+	uint16_t cmd_responses;
+	uint16_t cmd_bad;			// bad checksum or unknown command
+	// channel / ground
+	uint32_t bit_errors;
+	uint32_t frames_sent;		// full messages
+	uint32_t frames_unheard;	// outside a pass
+	uint32_t frames_clean;
+	uint32_t frames_corrected;
+	uint32_t frames_lost;		// bad callsign or uncorrectable
+	uint32_t frames_miscorrected; // decoded to the wrong message
+	uint32_t other_heard;		// other transmissions (replies, ...) heard intact
+	uint32_t payload_bytes;		// telemetry decoded correctly
+} equisim_radio_stats_t;
+
+void equisim_radio_init(const equisim_radio_config_t* config);
+void equisim_radio_default_config(equisim_radio_config_t* config);
+equisim_radio_stats_t* equisim_radio_get_stats(void);
+
+/* pin state (from setRadioState / setTXEnable / setRXEnable) */
+void equisim_radio_set_power(bool on);
+void equisim_radio_set_tx_enable(bool enable);
+void equisim_radio_set_rx_enable(bool enable);
+
+/* bytes from the USART; returns whether the radio took them (the TX buffer is open),
+   otherwise they should go out the SERCOM as normal. now_ms is the time they were handed over. */
+bool equisim_radio_tx_at(const uint8_t* buf, int len, uint32_t now_ms);
+bool equisim_radio_usart_tx(const uint8_t* buf, int len);
+
+/* telemetry bytes decoded per orbit, over elapsed_ms of simulation */
+uint32_t equisim_radio_goodput_per_orbit(const equisim_radio_stats_t* stats, uint32_t elapsed_ms);
+
+#endif /* EQUISIM_RADIO_H_ */
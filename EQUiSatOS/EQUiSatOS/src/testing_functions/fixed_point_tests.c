@@ -0,0 +1,158 @@
+/*
+ * fixed_point_tests.c
+ *
+ * Created: 10/18/2026 3:10:30 PM
+ *  Author: BSE
+ *
+ * Checks the fixed-point conversions against the float / divide versions
+ * they replace, over each signal's full range, and times both.
+ * Run from run_tests() (before the scheduler starts; see cycle_count.h).
+ */
+
+#include "fixed_point_tests.h"
+
+// every signal that has a truncation line
+static const sig_id_t truncated_sigs[] = {
+	S_IR_AMB, S_LED_TEMP_REG, S_LED_SNS, S_LF_SNS_REG, S_L_SNS, S_LF_VOLT,
+	S_LF_OSNS_REG, S_L_VOLT, S_LREF, S_PANELREF, S_GYRO, S_ACCEL, S_MAG,
+	S_RAD_TEMP, S_IMU_TEMP
+};
+#define NUM_TRUNCATED_SIGS	(sizeof(truncated_sigs) / sizeof(sig_id_t))
+
+static void test_untruncate_exact(sig_id_t sig) {
+	uint16_t m = get_line_m_from_signal(sig);
+	int16_t b = get_line_b_from_signal(sig);
+	for (uint16_t val = 0; val <= 0xFF; val++) {
+		// the old divide-based untruncate
+		uint16_t u16 = ((uint16_t) val) << 8;
+		uint16_t expected = u16 / m - b;
+		uint16_t got = untruncate(val, sig);
+		test_check(got == expected);
+		// and the float line it approximates
+		float f = floorf(((float) u16) / m) - b;
+		test_check(got == (uint16_t)(int32_t) f);
+	}
+}
+
+// over every 16-bit reading that fits on the line without overflowing 8 bits,
+// truncating then untruncating should lose less than one 8-bit step
+static void test_truncation_round_trip(sig_id_t sig) {
+	uint16_t m = get_line_m_from_signal(sig);
+	int16_t b = get_line_b_from_signal(sig);
+	int32_t max_step = 256 / m + 1;
+	for (uint32_t src = 0; src <= 0xFFFF; src++) {
+		uint32_t shifted = (uint16_t)(src + b);
+		if (shifted * m > 0xFFFF) {
+			continue; // outside this signal's range
+		}
+		uint8_t t = truncate_16t(src, sig);
+		int32_t err = (int32_t) shifted - (int32_t)(uint16_t)(untruncate(t, sig) + b);
+		test_check(err >= 0 && err <= max_step);
+	}
+}
+
+static void test_mlx_temp(void) {
+	for (uint32_t data = 0; data <= 0xFFFF; data++) {
+		float expected = dataToTemp(data);
+		float got = fp_mlx_data_to_temp_cdeg(data) / 100.0;
+		test_check(fabs(got - expected) <= FP_TEST_TEMP_MAX_ERR_C);
+	}
+}
+
+static int32_t compass_err_cdeg(int16_t x, int16_t z) {
+	int32_t expected = (int32_t)(HMC5883L_computeCompassDir(x, 0, z) * 100 + 0.5);
+	int32_t err = (int32_t) fp_compass_dir_cdeg(x, z) - expected;
+	// headings are on a circle
+	if (err > FP_CDEG_180)	err -= FP_CDEG_360;
+	if (err < -FP_CDEG_180)	err += FP_CDEG_360;
+	return err;
+}
+
+static void test_compass(void) {
+	// coarse sweep over the whole input space, including the extremes
+	for (int32_t x = INT16_MIN; x <= INT16_MAX; x += 257) {
+		for (int32_t z = INT16_MIN; z <= INT16_MAX; z += 257) {
+			test_check(abs(compass_err_cdeg(x, z)) <= FP_TEST_COMPASS_MAX_ERR_CDEG);
+		}
+	}
+	// fine sweep at magnetometer-sized values
+	for (int32_t x = -600; x <= 600; x += 3) {
+		for (int32_t z = -600; z <= 600; z += 3) {
+			test_check(abs(compass_err_cdeg(x, z)) <= FP_TEST_COMPASS_MAX_ERR_CDEG);
+		}
+	}
+	test_check(fp_atan2_cdeg(0, -1) == FP_CDEG_180);
+	test_check(fp_atan2_cdeg(1, 0) == FP_CDEG_90);
+	test_check(fp_atan2_cdeg(-1, 0) == -FP_CDEG_90);
+	test_check(fp_atan2_cdeg(0, 0) == 0);
+}
+
+void test_fixed_point_conversions(void) {
+	for (uint8_t i = 0; i < NUM_TRUNCATED_SIGS; i++) {
+		test_untruncate_exact(truncated_sigs[i]);
+		test_truncation_round_trip(truncated_sigs[i]);
+	}
+	test_mlx_temp();
+	test_compass();
+	print("fixed point conversions: all within bounds\n");
+}
+
+/************************************************************************/
+/* BENCHMARKS                                                           */
+/************************************************************************/
+// sinks so the compiler can't drop the work being timed
+static volatile uint32_t bench_sink_u;
+static volatile float bench_sink_f;
+
+static uint32_t bench_untruncate_divide(sig_id_t sig) {
+	uint32_t start = cycle_count_now();
+	for (uint16_t i = 0; i < FP_BENCH_ITERS; i++) {
+		uint16_t u16 = ((uint16_t)(uint8_t) i) << 8;
+		bench_sink_u = u16 / get_line_m_from_signal(sig) - get_line_b_from_signal(sig);
+	}
+	return cycle_count_since(start) / FP_BENCH_ITERS;
+}
+
+static uint32_t bench_untruncate_fixed(sig_id_t sig) {
+	uint32_t start = cycle_count_now();
+	for (uint16_t i = 0; i < FP_BENCH_ITERS; i++) {
+		bench_sink_u = untruncate((uint8_t) i, sig);
+	}
+	return cycle_count_since(start) / FP_BENCH_ITERS;
+}
+
+void benchmark_fixed_point_conversions(void) {
+	uint32_t start;
+	cycle_count_start();
+
+	for (uint8_t i = 0; i < NUM_TRUNCATED_SIGS; i++) {
+		print("untruncate sig %d: divide %d cycles, fixed %d cycles\n", truncated_sigs[i],
+			bench_untruncate_divide(truncated_sigs[i]), bench_untruncate_fixed(truncated_sigs[i]));
+	}
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < FP_BENCH_ITERS; i++) {
+		bench_sink_f = dataToTemp(i * 61);
+	}
+	uint32_t temp_float = cycle_count_since(start) / FP_BENCH_ITERS;
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < FP_BENCH_ITERS; i++) {
+		bench_sink_u = fp_mlx_data_to_temp_cdeg(i * 61);
+	}
+	uint32_t temp_fixed = cycle_count_since(start) / FP_BENCH_ITERS;
+	print("MLX temp: float %d cycles, fixed %d cycles\n", temp_float, temp_fixed);
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < FP_BENCH_ITERS; i++) {
+		bench_sink_f = HMC5883L_computeCompassDir(i * 97 - 12000, 0, 9000 - i * 71);
+	}
+	uint32_t compass_float = cycle_count_since(start) / FP_BENCH_ITERS;
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < FP_BENCH_ITERS; i++) {
+		bench_sink_u = fp_compass_dir_cdeg(i * 97 - 12000, 9000 - i * 71);
+	}
+	uint32_t compass_fixed = cycle_count_since(start) / FP_BENCH_ITERS;
+	print("compass dir: float %d cycles, fixed %d cycles\n", compass_float, compass_fixed);
+
+	cycle_count_stop();
+}
@@ -0,0 +1,27 @@
+/*
+ * fixed_point_tests.h
+ *
+ * Created: 10/18/2026 3:10:12 PM
+ *  Author: BSE
+ */
+
+
+#ifndef FIXED_POINT_TESTS_H_
+#define FIXED_POINT_TESTS_H_
+
+#include <global.h>
+#include "../sensor_drivers/fixed_point.h"
+#include "../sensor_drivers/sensor_def.h"
+#include "cycle_count.h"
+#include "test_check.h"
+
+// worst-case disagreement allowed with the float versions
+#define FP_TEST_TEMP_MAX_ERR_C			0.01
+#define FP_TEST_COMPASS_MAX_ERR_CDEG	3
+
+#define FP_BENCH_ITERS					256
+
+void test_fixed_point_conversions(void);
+void benchmark_fixed_point_conversions(void);
+
+#endif /* FIXED_POINT_TESTS_H_ */
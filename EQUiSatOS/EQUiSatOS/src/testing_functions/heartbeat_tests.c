@@ -0,0 +1,173 @@
+/*
+ * heartbeat_tests.c
+ *
+ * Created: 10/19/2026 2:41:30 PM
+ *  Author: BSE
+ *
+ * heartbeat_test checks the watchdog's heartbeat bookkeeping (heartbeats.c):
+ *	- late tasks, and tasks reporting while checked out, are caught
+ *	- a stale report stored after a check in doesn't count against the task
+ *	- a check that a check in / out happens during asks to be retried
+ *	- six simulated hours of tasks reporting on their periods, with one stalling
+ *	  partway through, is only flagged once (and soon enough) after the stall
+ * It only uses heartbeats.c, so it runs before the RTOS (from run_tests()) or on a host.
+ * heartbeat_report_timing_test times report_task_running against the run time
+ * stats counter (which it starts), next to the watchdog mutex take / give every
+ * report used to do (uncontended; a contended one also waited out the holder).
+ */
+
+#include "heartbeat_tests.h"
+
+#define TEST_TASKS			4
+
+static heartbeats_t hb;
+static const uint32_t test_allowed_ms[TEST_TASKS] = {0, 1000, 5000, 60000};
+
+static void check_rules(void) {
+	int missed = -1;
+	heartbeats_result_t result;
+	heartbeats_init(&hb);
+	// nothing checked in, nothing reported
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 500, &missed);
+	test_check(result == HEARTBEATS_OK);
+
+	heartbeat_check_in(&hb, 1, 1000);
+	heartbeat_check_in(&hb, 2, 1000);
+	test_check(hb.transitions == 4);
+	// (the check in counts as a report)
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 2000, &missed);
+	test_check(result == HEARTBEATS_OK);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 2001, &missed);
+	test_check(result == HEARTBEATS_MISSED);
+	test_check(missed == 1);
+	heartbeat_beat(&hb, 1, 2500);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 3000, &missed);
+	test_check(result == HEARTBEATS_OK);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 6001, &missed);
+	test_check(result == HEARTBEATS_MISSED);
+	test_check(missed == 1); // (the first late one)
+
+	// reporting while checked out
+	heartbeat_check_out(&hb, 2);
+	heartbeat_beat(&hb, 1, 6000);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 6500, &missed);
+	test_check(result == HEARTBEATS_OK);
+	heartbeat_beat(&hb, 3, 6200);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 6500, &missed);
+	test_check(result == HEARTBEATS_MISSED);
+	test_check(missed == 3);
+	heartbeat_check_out(&hb, 3);
+
+	// a task preempted mid-report, suspended, and checked back in much later
+	// finishes storing the tick it read before
+	heartbeat_check_in(&hb, 2, 100000);
+	heartbeat_beat(&hb, 2, 5900);
+	heartbeat_beat(&hb, 1, 104500);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 105000, &missed);
+	test_check(result == HEARTBEATS_OK);
+	result = heartbeats_check(&hb, 1, TEST_TASKS, test_allowed_ms, 105001, &missed);
+	test_check(result == HEARTBEATS_MISSED);
+	test_check(missed == 2);
+
+	// across the tick wrapping
+	heartbeats_init(&hb);
+	heartbeat_check_in(&hb, 1, 0xFFFFFF00);
+	heartbeat_beat(&hb, 1, 0xFFFFFFF0);
+	result = heartbeats_check(&hb, 1, 2, test_allowed_ms, 0x100, &missed);
+	test_check(result == HEARTBEATS_OK);
+	result = heartbeats_check(&hb, 1, 2, test_allowed_ms, 0x3E0, &missed);
+	test_check(result == HEARTBEATS_MISSED);
+
+	// a check in / out underway
+	hb.transitions++;
+	result = heartbeats_check(&hb, 1, 2, test_allowed_ms, 0x100, &missed);
+	test_check(result == HEARTBEATS_CHANGING);
+	hb.transitions++;
+	result = heartbeats_check(&hb, 1, 2, test_allowed_ms, 0x100, &missed);
+	test_check(result == HEARTBEATS_OK);
+}
+
+typedef struct {
+	uint32_t every_ms;
+	uint32_t offset_ms;
+} sim_task_t;
+
+// roughly the flight periods (see rtos_tasks_config.h), allowed 5 minutes more
+static const sim_task_t sim_tasks[TEST_TASKS] = {
+	{0, 0}, {20*1000, 1500}, {3*60*1000, 10000}, {9*60*1000, 30000}
+};
+#define SIM_BUFFER_MS		(5*60*1000)
+#define SIM_WATCHDOG_MS		1500
+#define SIM_STALL_TASK		2
+#define SIM_STALL_MS		(HEARTBEAT_TEST_SIM_MS / 2)
+
+static void check_missed_heartbeat(void) {
+	uint32_t allowed_ms[TEST_TASKS];
+	for (int t = 0; t < TEST_TASKS; t++) {
+		allowed_ms[t] = sim_tasks[t].every_ms + SIM_BUFFER_MS;
+	}
+	heartbeats_init(&hb);
+	// (tick counts start at boot, but start near the wrap so it's covered)
+	uint32_t start = 0 - HEARTBEAT_TEST_SIM_MS / 3;
+	uint32_t last_stall_beat = 0;
+	for (int t = 1; t < TEST_TASKS; t++) {
+		heartbeat_check_in(&hb, t, start);
+	}
+
+	uint32_t caught_ms = 0;
+	for (uint32_t ms = 1; ms <= HEARTBEAT_TEST_SIM_MS && caught_ms == 0; ms++) {
+		for (int t = 1; t < TEST_TASKS; t++) {
+			if (ms % sim_tasks[t].every_ms != sim_tasks[t].offset_ms) {
+				continue;
+			}
+			if (t == SIM_STALL_TASK) {
+				if (ms >= SIM_STALL_MS) {
+					continue;
+				}
+				last_stall_beat = ms;
+			}
+			heartbeat_beat(&hb, t, start + ms);
+		}
+		if (ms % SIM_WATCHDOG_MS == 0) {
+			int missed = -1;
+			heartbeats_result_t result = heartbeats_check(&hb, 1, TEST_TASKS, allowed_ms, start + ms, &missed);
+			test_check(result != HEARTBEATS_CHANGING);
+			if (result == HEARTBEATS_MISSED) {
+				test_check(missed == SIM_STALL_TASK);
+				caught_ms = ms;
+			}
+		}
+	}
+	// caught after its allowance ran out, by the next watchdog run
+	test_check(caught_ms > last_stall_beat + allowed_ms[SIM_STALL_TASK]);
+	test_check(caught_ms <= last_stall_beat + allowed_ms[SIM_STALL_TASK] + SIM_WATCHDOG_MS);
+	print("heartbeats: stall after %d ms caught at %d ms\n", last_stall_beat, caught_ms);
+}
+
+void heartbeat_test(void) {
+	check_rules();
+	check_missed_heartbeat();
+	print("heartbeat tests passed\n");
+}
+
+void heartbeat_report_timing_test(void) {
+	configure_runtime_counter();
+	init_watchdog_task();
+
+	uint32_t start = runtime_counter_read();
+	for (int i = 0; i < HEARTBEAT_TEST_TIMED_REPORTS; i++) {
+		report_task_running(IDLE_DATA_TASK);
+	}
+	uint32_t report_us = runtime_counter_read() - start;
+
+	start = runtime_counter_read();
+	for (int i = 0; i < HEARTBEAT_TEST_TIMED_REPORTS; i++) {
+		mutex_take(watchdog_mutex, WATCHDOG_MUTEX_WAIT_TIME_TICKS);
+		mutex_give(watchdog_mutex);
+	}
+	uint32_t mutex_us = runtime_counter_read() - start;
+
+	print("watchdog reports: %d ns each (a watchdog mutex take / give was %d ns)\n",
+		report_us * 1000 / HEARTBEAT_TEST_TIMED_REPORTS, mutex_us * 1000 / HEARTBEAT_TEST_TIMED_REPORTS);
+	print("(in flight, the watchdog mutex stats show time still spent waiting on check ins / outs)\n");
+}
@@ -0,0 +1,26 @@
+/*
+ * heartbeat_tests.h
+ *
+ * Created: 10/19/2026 2:41:17 PM
+ *  Author: BSE
+ */
+
+
+#ifndef HEARTBEAT_TESTS_H_
+#define HEARTBEAT_TESTS_H_
+
+#include <global.h>
+#include "../rtos_tasks/heartbeats.h"
+#include "../rtos_tasks/watchdog_task.h"
+#include "../processor_drivers/TC_Commands.h"
+#include "test_check.h"
+
+// simulated time the missed heartbeat test runs for
+#define HEARTBEAT_TEST_SIM_MS			(6*60*60*1000)
+// reports timed to measure what report_task_running costs a task
+#define HEARTBEAT_TEST_TIMED_REPORTS	1000
+
+void heartbeat_test(void);
+void heartbeat_report_timing_test(void);
+
+#endif /* HEARTBEAT_TESTS_H_ */
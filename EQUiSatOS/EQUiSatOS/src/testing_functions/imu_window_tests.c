@@ -0,0 +1,117 @@
+/*
+ * imu_window_tests.c
+ *
+ * Created: 10/18/2026 7:13:02 PM
+ *  Author: BSE
+ *
+ * imu_window_reduce_test checks the window reduction against known data
+ * (no hardware; can run from run_tests()).
+ * imu_window_i2c_benchmark compares I2C bus transactions per attitude record
+ * between the old single accel/gyro/mag reads and the FIFO window, counting
+ * packets at the I2C_Commands layer. Must run with the RTOS started (call
+ * from run_rtos_tests()), with the other sensor-reading tasks suspended
+ * (OVERRIDE_INIT_TASK_STATES) so their bus traffic isn't counted.
+ */
+
+#include "imu_window_tests.h"
+
+static attitude_data_t test_attitude;
+static sensor_transaction_t test_txn;
+
+/************************************************************************/
+/* REDUCTION                                                            */
+/************************************************************************/
+static void check_axis(imu_axis_stats_t* s, int16_t mean, int16_t min, int16_t max, uint32_t variance) {
+	test_check(s->mean == mean);
+	test_check(s->min == min);
+	test_check(s->max == max);
+	test_check(s->variance == variance);
+}
+
+void imu_window_reduce_test(void) {
+	int16_t samples[8][3];
+	imu_axis_stats_t stats[3];
+
+	// x: constant, y: 0..7 ramp, z: alternating +-1000
+	for (int i = 0; i < 8; i++) {
+		samples[i][0] = -42;
+		samples[i][1] = i;
+		samples[i][2] = (i % 2) ? 1000 : -1000;
+	}
+	imu_window_reduce(samples, 8, stats);
+	check_axis(&stats[0], -42, -42, -42, 0);
+	check_axis(&stats[1], 4, 0, 7, 5); // mean 3.5 rounds up; sum of (i - 4)^2 = 44, / 8
+	check_axis(&stats[2], 0, -1000, 1000, 1000000);
+
+	// negative means round away from zero too
+	samples[0][0] = -3;
+	samples[1][0] = -4;
+	imu_window_reduce(samples, 2, stats);
+	test_check(stats[0].mean == -4);
+
+	// extremes can't overflow the variance
+	for (int i = 0; i < 8; i++) {
+		samples[i][0] = (i % 2) ? INT16_MAX : INT16_MIN;
+	}
+	imu_window_reduce(samples, 8, stats);
+	check_axis(&stats[0], -1, INT16_MIN, INT16_MAX, 1073709056); // mean -0.5; avg of 32767^2 and 32768^2
+
+	// empty window
+	imu_window_reduce(samples, 0, stats);
+	check_axis(&stats[0], 0, 0, 0, 0);
+}
+
+/************************************************************************/
+/* I2C TRANSACTIONS PER RECORD                                          */
+/************************************************************************/
+void imu_window_i2c_benchmark(void) {
+	uint32_t before, separate, windowed;
+	imu_window_stats_t stats;
+	imu_window_batches_t batches = {
+		.accel = test_attitude.accelerometer_data,
+		.gyro = &(test_attitude.gyro_data),
+		.mag = test_attitude.magnetometer_data
+	};
+
+	bool got_semaphore = enable_ir_pow_if_necessary();
+
+	/* old: single reads at the start and after the delay */
+	before = get_i2c_transaction_count();
+	read_gyro_batch(test_attitude.gyro_data);
+	read_accel_batch(test_attitude.accelerometer_data[0]);
+	read_magnetometer_batch(test_attitude.magnetometer_data[0]);
+	vTaskDelay(ATTITUDE_DATA_SECOND_SAMPLE_DELAY / portTICK_PERIOD_MS);
+	read_accel_batch(test_attitude.accelerometer_data[1]);
+	read_magnetometer_batch(test_attitude.magnetometer_data[1]);
+	separate = get_i2c_transaction_count() - before;
+
+	/* new: FIFO window over the same delay */
+	before = get_i2c_transaction_count();
+	sensor_txn_begin(&test_txn);
+	sensor_txn_add(&test_txn, SR_IMU_WINDOW_START, &batches, NULL);
+	bool window_started = sensor_txn_run(&test_txn, ELOC_ATTITUDE_DATA);
+	vTaskDelay(ATTITUDE_DATA_SECOND_SAMPLE_DELAY / portTICK_PERIOD_MS);
+	sensor_txn_begin(&test_txn);
+	sensor_txn_add(&test_txn, SR_IMU_WINDOW, &batches, NULL);
+	bool window_read = sensor_txn_run(&test_txn, ELOC_ATTITUDE_DATA);
+	windowed = get_i2c_transaction_count() - before;
+
+	disable_ir_pow_if_necessary(got_semaphore);
+
+	get_last_imu_window_stats(&stats);
+	print("IMU I2C transactions per attitude record: separate: %d (3 accel/gyro samples); window: %d (%d samples)\n",
+		separate, windowed, stats.num_samples);
+	for (int i = 0; i < 3; i++) {
+		print("\taccel[%d]: mean %d, min %d, max %d, var %d\n", i,
+			stats.accel[i].mean, stats.accel[i].min, stats.accel[i].max, stats.accel[i].variance);
+	}
+	for (int i = 0; i < 3; i++) {
+		print("\tgyro[%d]: mean %d, min %d, max %d, var %d\n", i,
+			stats.gyro[i].mean, stats.gyro[i].min, stats.gyro[i].max, stats.gyro[i].variance);
+	}
+	test_check(window_started && window_read);
+	test_check(separate == IMU_SEPARATE_I2C_TRANSACTIONS);
+	test_check(windowed == IMU_WINDOW_I2C_TRANSACTIONS);
+	// should have roughly filled the window (a few ms of slack either way)
+	test_check(stats.num_samples >= ATTITUDE_DATA_SECOND_SAMPLE_DELAY * MPU9250_FIFO_SAMPLE_RATE_HZ / 1000 - 1);
+}
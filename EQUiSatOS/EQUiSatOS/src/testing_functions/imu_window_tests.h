@@ -0,0 +1,28 @@
+/*
+ * imu_window_tests.h
+ *
+ * Created: 10/18/2026 7:12:44 PM
+ *  Author: BSE
+ */
+
+
+#ifndef IMU_WINDOW_TESTS_H_
+#define IMU_WINDOW_TESTS_H_
+
+#include <global.h>
+#include "../sensor_drivers/imu_window.h"
+#include "../sensor_drivers/sensor_transaction.h"
+#include "../data_handling/State_Structs.h"
+#include "test_check.h"
+
+// I2C packets per attitude record for the accel/gyro/mag reads done one at a time
+// (gyro once, accel and mag twice; each is a register-select write plus a read)
+#define IMU_SEPARATE_I2C_TRANSACTIONS	10
+// with the FIFO: reset + enable (2), then stop + count (3) + one burst read (2),
+// plus the two magnetometer reads (4)
+#define IMU_WINDOW_I2C_TRANSACTIONS		11
+
+void imu_window_reduce_test(void);
+void imu_window_i2c_benchmark(void);
+
+#endif /* IMU_WINDOW_TESTS_H_ */
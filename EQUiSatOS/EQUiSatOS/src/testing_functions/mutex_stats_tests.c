@@ -0,0 +1,86 @@
+/*
+ * mutex_stats_tests.c
+ *
+ * Created: 10/19/2026 1:32:24 PM
+ *  Author: BSE
+ *
+ * Checks the mutex contention accounting (wait buckets, timeouts and their
+ * holder, the longest wait and hold), the report's saturation, and its packing.
+ * Runs before the RTOS (from run_tests()).
+ */
+
+#include "mutex_stats_tests.h"
+
+static mutex_stats_t stats[MUTEX_STATS_NUM];
+static mutex_stats_report_t report, unpacked;
+
+static void check_buckets(void) {
+	test_check(mutex_stats_wait_bucket(0) == MUTEX_STATS_WAIT_BUCKETS);
+	test_check(mutex_stats_wait_bucket(MUTEX_STATS_WAIT_MIN_US - 1) == MUTEX_STATS_WAIT_BUCKETS);
+	test_check(mutex_stats_wait_bucket(MUTEX_STATS_WAIT_MIN_US) == 0);
+	test_check(mutex_stats_wait_bucket(999) == 0);
+	test_check(mutex_stats_wait_bucket(1000) == 1);
+	test_check(mutex_stats_wait_bucket(99999) == 2);
+	test_check(mutex_stats_wait_bucket(100000) == 3);
+	test_check(mutex_stats_wait_bucket(0xFFFFFFFF) == 3);
+}
+
+static void check_accounting(void) {
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		mutex_stats_clear(&stats[i]);
+	}
+	mutex_stats_t* s = &stats[MUTEX_STATS_I2C_IRPOW];
+	mutex_stats_note_take(s, 20, true, MUTEX_STATS_NO_OWNER);		// uncontended
+	mutex_stats_note_hold(s, 4500);
+	mutex_stats_note_take(s, 2500, true, MUTEX_STATS_NO_OWNER);		// 1-10 ms
+	mutex_stats_note_hold(s, 1200);
+	mutex_stats_note_take(s, 500000, false, 3);						// timed out on task 3
+	mutex_stats_note_take(s, 500000, false, 4);						// then task 4
+	test_check(s->takes == 4);
+	test_check(s->timeouts == 2);
+	test_check(s->waits[0] == 0 && s->waits[1] == 1 && s->waits[2] == 0);
+	test_check(s->waits[3] == 0); // (timeouts aren't in the histogram)
+	test_check(s->max_wait_us == 500000);
+	test_check(s->max_hold_us == 4500);
+	test_check(s->timeout_owner == 4);
+
+	// one that saturates everything
+	s = &stats[MUTEX_STATS_MRAM_SPI_CACHE];
+	for (int i = 0; i < 70000; i++) {
+		mutex_stats_note_take(s, 200000, i % 2 == 0, 1);
+	}
+	mutex_stats_note_hold(s, 0x7FFFFFFF);
+
+	mutex_stats_summarize(stats, &report);
+	mutex_stats_entry_t* e = &report.mutexes[MUTEX_STATS_I2C_IRPOW];
+	test_check(e->takes == 4 && e->timeouts == 2 && e->waits[1] == 1);
+	test_check(e->max_wait_ms == 500 && e->max_hold_ms == 4);
+	test_check(e->timeout_owner == 4);
+	e = &report.mutexes[MUTEX_STATS_MRAM_SPI_CACHE];
+	test_check(e->takes == 0xFFFF && e->timeouts == 0xFF && e->waits[3] == 0xFF);
+	test_check(e->max_hold_ms == 0xFFFF);
+	e = &report.mutexes[MUTEX_STATS_WATCHDOG];
+	test_check(e->takes == 0 && e->timeout_owner == MUTEX_STATS_NO_OWNER);
+}
+
+static void check_packing(void) {
+	uint8_t buf[MUTEX_STATS_REPORT_SIZE + 1];
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		report.mutexes[i].takes = 0x0102 * (i + 1);
+		report.mutexes[i].waits[2] = i;
+		report.mutexes[i].max_wait_ms = 0x8000 + i;
+	}
+	buf[MUTEX_STATS_REPORT_SIZE] = 0x5A;
+	mutex_stats_pack(&report, buf);
+	test_check(buf[MUTEX_STATS_REPORT_SIZE] == 0x5A); // (stays in its bytes)
+	test_check(buf[0] == 0x02 && buf[1] == 0x01); // little-endian
+	mutex_stats_unpack(buf, &unpacked);
+	test_check(memcmp(&report, &unpacked, sizeof(mutex_stats_report_t)) == 0);
+}
+
+void mutex_stats_test(void) {
+	check_buckets();
+	check_accounting();
+	check_packing();
+	print("mutex stats tests passed\n");
+}
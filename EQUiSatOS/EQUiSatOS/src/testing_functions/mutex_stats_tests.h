@@ -0,0 +1,18 @@
+/*
+ * mutex_stats_tests.h
+ *
+ * Created: 10/19/2026 1:32:10 PM
+ *  Author: BSE
+ */
+
+
+#ifndef MUTEX_STATS_TESTS_H_
+#define MUTEX_STATS_TESTS_H_
+
+#include <global.h>
+#include "../data_handling/mutex_stats.h"
+#include "test_check.h"
+
+void mutex_stats_test(void);
+
+#endif /* MUTEX_STATS_TESTS_H_ */
@@ -0,0 +1,92 @@
+/*
+ * mux_scan_tests.c
+ *
+ * Created: 10/18/2026 9:20:22 PM
+ *  Author: BSE
+ *
+ * Times each temperature batch (lifepo, lion, LED channels of the temperature
+ * mux) read the old way - blocking select, configure ADC, and poll for every
+ * channel - against the pipelined mux scan, and checks they read the same.
+ * Must run with the RTOS started (call from run_rtos_tests()), with other
+ * sensor-reading tasks suspended (OVERRIDE_INIT_TASK_STATES).
+ */
+
+#include "mux_scan_tests.h"
+
+static struct adc_module test_adc_instance;
+static uint16_t scan_mV[8];
+
+static void store_result(uint8_t mux_channel, enum status_code sc, uint16_t mV, void* arg) {
+	test_check(!is_error(sc));
+	scan_mV[mux_channel] = mV;
+}
+
+// the per-channel sequence the read functions used to do
+static void read_blocking(uint8_t first_channel, uint8_t num_channels, uint16_t* mV) {
+	for (int i = first_channel; i < first_channel + num_channels; i++) {
+		uint8_t rs;
+		enum status_code sc = LTC1380_channel_select(TEMP_MULTIPLEXER_I2C, i, &rs);
+		test_check(!is_error(sc));
+		sc = configure_adc(&test_adc_instance, P_AI_TEMP_OUT, false);
+		test_check(!is_error(sc));
+		sc = read_adc_mV(test_adc_instance, &mV[i]);
+		test_check(!is_error(sc));
+	}
+}
+
+static void compare_batch(const char* name, uint8_t first_channel, uint8_t num_channels) {
+	uint16_t blocking_mV[8];
+	mux_scan_t scan = {
+		.mux_addr = TEMP_MULTIPLEXER_I2C,
+		.pin = P_AI_TEMP_OUT,
+		.first_channel = first_channel,
+		.num_channels = num_channels,
+		.on_result = store_result,
+		.arg = NULL,
+	};
+
+	TickType_t start = xTaskGetTickCount();
+	for (int n = 0; n < MUX_SCAN_TEST_ITERS; n++) {
+		read_blocking(first_channel, num_channels, blocking_mV);
+	}
+	TickType_t blocking_ticks = xTaskGetTickCount() - start;
+
+	start = xTaskGetTickCount();
+	for (int n = 0; n < MUX_SCAN_TEST_ITERS; n++) {
+		enum status_code sc = mux_scan_run(&scan, &test_adc_instance);
+		test_check(!is_error(sc));
+	}
+	TickType_t scan_ticks = xTaskGetTickCount() - start;
+
+	// (in us per batch, since a batch is only a few ticks)
+	print("%s temps (%d channels): blocking: %d us/batch; scan: %d us/batch\n", name, num_channels,
+		blocking_ticks * portTICK_PERIOD_MS * 1000 / MUX_SCAN_TEST_ITERS,
+		scan_ticks * portTICK_PERIOD_MS * 1000 / MUX_SCAN_TEST_ITERS);
+	for (int i = first_channel; i < first_channel + num_channels; i++) {
+		int diff = blocking_mV[i] - scan_mV[i];
+		print("\tchannel %d: %d mV vs. %d mV\n", i, blocking_mV[i], scan_mV[i]);
+		test_check(diff <= MUX_SCAN_TEST_MAX_DIFF_MV && diff >= -MUX_SCAN_TEST_MAX_DIFF_MV);
+	}
+}
+
+void mux_scan_latency_test(void) {
+	bool got_i2c_irpow = i2c_irpow_mutex_take();
+	bool got_processor_adc = processor_adc_mutex_take();
+	test_check(got_i2c_irpow && got_processor_adc);
+	if (!got_i2c_irpow || !got_processor_adc) {
+		if (got_processor_adc) mutex_give(processor_adc_mutex);
+		if (got_i2c_irpow) mutex_give(i2c_irpow_mutex);
+		return;
+	}
+	bool got_semaphore = enable_ir_pow_if_necessary();
+	_set_5v_enable_unsafe(true);
+
+	compare_batch("lifepo", 0, 2);
+	compare_batch("lion", 2, 2);
+	compare_batch("LED", 4, 4);
+
+	_set_5v_enable_unsafe(false);
+	disable_ir_pow_if_necessary(got_semaphore);
+	mutex_give(processor_adc_mutex);
+	mutex_give(i2c_irpow_mutex);
+}
@@ -0,0 +1,24 @@
+/*
+ * mux_scan_tests.h
+ *
+ * Created: 10/18/2026 9:20:05 PM
+ *  Author: BSE
+ */
+
+
+#ifndef MUX_SCAN_TESTS_H_
+#define MUX_SCAN_TESTS_H_
+
+#include <global.h>
+#include "../sensor_drivers/mux_scan.h"
+#include "../sensor_drivers/sensor_read_commands.h"
+#include "test_check.h"
+
+// batches per timing run (a single batch is only a few ms)
+#define MUX_SCAN_TEST_ITERS			50
+// allowed difference (mV) between the blocking and pipelined readings of a channel
+#define MUX_SCAN_TEST_MAX_DIFF_MV	20
+
+void mux_scan_latency_test(void);
+
+#endif /* MUX_SCAN_TESTS_H_ */
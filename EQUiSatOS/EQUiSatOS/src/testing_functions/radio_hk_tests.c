@@ -0,0 +1,223 @@
+/*
+ * radio_hk_tests.c
+ *
+ * Created: 10/19/2026 2:40:31 AM
+ *  Author: BSE
+ *
+ * Tests for radio housekeeping (telemetry/radio_housekeeping):
+ *	- radio_hk_virtual_radio_test: runs each operation in the table against the
+ *	  virtual radio (equisim_radio) the way run_radio_housekeeping does, checking
+ *	  the responses are read (and that nothing is read with the radio off)
+ *	- radio_hk_busy_benchmark: replays orbits of transmit cycles, with the radio
+ *	  answering and with it not answering for a while, and reports the seconds per
+ *	  orbit the radio spends busy in command mode and how old the cached temperature
+ *	  gets, against reading the temperature every third cycle as the transmit task did
+ * The simulated clock is passed in, so both run before the RTOS (from run_tests()).
+ */
+
+#include "radio_hk_tests.h"
+
+/************************************************************************/
+/* VIRTUAL RADIO                                                        */
+/************************************************************************/
+// sends op's command to the virtual radio at t and reads the response
+static bool run_op_at(radio_hk_op_t op, uint32_t t, uint16_t* value) {
+	const radio_hk_op_def_t* def = get_radio_hk_op_def(op);
+	clear_USART_rx_buffer();
+	def->prepare();
+	equisim_radio_tx_at(radio_send_buffer, strlen((char*) radio_send_buffer), t);
+	*value = 0;
+	// (there's no capturing task before the RTOS, so the response is read where the
+	// receive interrupt also puts it)
+	return def->read_response(radio_receive_buffer, receiveIndex, value);
+}
+
+void radio_hk_virtual_radio_test(void) {
+	equisim_radio_config_t config;
+	equisim_radio_default_config(&config);
+	config.orbit_ms = 0;
+	equisim_radio_init(&config);
+	uint16_t value;
+	bool ok;
+
+	// the table is in order and only the last operation can end the session
+	for (uint8_t i = 0; i < NUM_RADIO_HK_OPS; i++) {
+		const radio_hk_op_def_t* def = get_radio_hk_op_def(i);
+		test_check(def != NULL && def->op == i && def->prepare != NULL && def->read_response != NULL);
+		test_check(def->after_ms == 0 || i == NUM_RADIO_HK_OPS - 1);
+	}
+	test_check(get_radio_hk_op_def(NUM_RADIO_HK_OPS) == NULL);
+
+	// a session with everything in it
+	uint32_t t = RADIO_HK_TEST_START_MS;
+	equisim_radio_set_power(true);
+	equisim_radio_set_tx_enable(true);
+	equisim_radio_set_rx_enable(true);
+	t += SET_CMD_MODE_WAIT_BEFORE_MS;
+	ok = equisim_radio_tx_at((const uint8_t*) "+++", 3, t);
+	test_check(ok);
+	t += SET_CMD_MODE_WAIT_AFTER_MS;
+	ok = run_op_at(RADIO_HK_TEMP, t, &value);
+	test_check(ok);
+	test_check(value == config.temp);
+	t += TEMP_RESPONSE_TIME_MS;
+	ok = run_op_at(RADIO_HK_WARM_RESET, t, &value);
+	test_check(ok);
+	test_check(equisim_radio_get_stats()->escapes_sent == 0 && equisim_radio_get_stats()->cmd_bad == 0);
+
+	// the radio's rebooting (and then out of command mode), so nothing's read
+	ok = run_op_at(RADIO_HK_TEMP, t + MAX_RADIO_CMD_TIME, &value);
+	test_check(!ok);
+	t += MAX_RADIO_CMD_TIME + RADIO_HK_WARM_RESET_AFTER_MS;
+	ok = run_op_at(RADIO_HK_TEMP, t, &value);
+	test_check(!ok);
+
+	// ...nor with it off
+	equisim_radio_set_power(false);
+	equisim_radio_set_power(true);
+	t += SET_CMD_MODE_WAIT_BEFORE_MS;
+	equisim_radio_tx_at((const uint8_t*) "+++", 3, t);
+	equisim_radio_set_power(false);
+	ok = run_op_at(RADIO_HK_TEMP, t + SET_CMD_MODE_WAIT_AFTER_MS, &value);
+	test_check(!ok);
+
+	equisim_radio_set_tx_enable(false);
+	equisim_radio_set_rx_enable(false);
+	equisim_radio_init(NULL);
+	print("radio housekeeping virtual radio test passed\n");
+}
+
+/************************************************************************/
+/* BUSY TIME BENCHMARK                                                  */
+/************************************************************************/
+typedef struct {
+	const char* name;
+	uint32_t outage_start_s;	// radio doesn't answer from here...
+	uint32_t outage_end_s;		// ...until here (until it's been reset, if it's stuck)
+	bool stuck;					// answers again only after a warm reset in the outage
+} hk_scenario_t;
+
+static const hk_scenario_t scenarios[] = {
+	{"answering",					0,		0,						false},
+	{"not answering for 30 min",	3000,	3000 + 30 * 60,			false},
+	{"stuck until reset",			3000,	RADIO_HK_TEST_ORBITS * ORBITAL_PERIOD_S,	true},
+};
+#define NUM_SCENARIOS		(sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct {
+	uint32_t busy_ms;
+	uint16_t sessions;
+	uint16_t warm_resets;
+	uint32_t temp_age_max_s;	// at each transmission
+	uint32_t temp_failures;
+} hk_result_t;
+
+static bool answers(const hk_scenario_t* sc, uint32_t now, bool was_reset) {
+	bool in_outage = now >= sc->outage_start_s && now < sc->outage_end_s;
+	return !in_outage || (sc->stuck && was_reset);
+}
+
+// replays RADIO_HK_TEST_ORBITS of transmit cycles, with housekeeping sessions
+// (use_hk) or a temperature read every RADIO_HK_TEST_OLD_PERIOD_S
+static void replay(const hk_scenario_t* sc, bool use_hk, hk_result_t* r) {
+	radio_hk_sched_t s;
+	radio_hk_session_t session;
+	uint32_t cycle_s = TRANSMIT_TASK_FREQ / 1000;
+	uint32_t end_s = RADIO_HK_TEST_ORBITS * ORBITAL_PERIOD_S;
+	uint32_t last_temp = 0;
+	bool was_reset = false;
+
+	memset(r, 0, sizeof(hk_result_t));
+	radio_hk_sched_init(&s);
+	for (uint32_t now = 0; now < end_s; now += cycle_s) {
+		// transmission (with the cached temperature)
+		if (now > 0) {
+			uint32_t temp_time = use_hk ? s.results[RADIO_HK_TEMP].timestamp : last_temp;
+			r->temp_age_max_s = max(r->temp_age_max_s, now - temp_time);
+		}
+
+		if (!use_hk) {
+			if (now % RADIO_HK_TEST_OLD_PERIOD_S == 0) {
+				r->busy_ms += SET_CMD_MODE_WAIT_BEFORE_MS + SET_CMD_MODE_WAIT_AFTER_MS + TEMP_RESPONSE_TIME_MS;
+				r->sessions++;
+				if (answers(sc, now, false)) {
+					last_temp = now;
+				} else {
+					r->temp_failures++;
+				}
+			}
+			continue;
+		}
+
+		if (!radio_hk_sched_due(&s, now)) {
+			continue;
+		}
+		radio_hk_sched_plan(&s, now, &session);
+		uint32_t session_ms = radio_hk_session_time_ms(&session);
+		test_check(session_ms <= RADIO_HK_MAX_SESSION_MS);
+		r->busy_ms += session_ms;
+		r->sessions++;
+		for (int i = 0; i < session.num_ops; i++) {
+			bool ok = answers(sc, now, was_reset);
+			radio_hk_sched_result(&s, session.ops[i], ok, ok ? EQUISIM_RADIO_DEFAULT_TEMP : 0, now);
+			if (session.ops[i] == RADIO_HK_WARM_RESET) {
+				r->warm_resets++;
+				was_reset = true;
+			} else if (!ok) {
+				r->temp_failures++;
+			}
+		}
+	}
+}
+
+static void print_result(const char* which, const hk_result_t* r) {
+	print("\t%s: %d s busy/orbit in %d sessions (%d warm resets, %d failed reads), temp up to %d s old\n",
+		which, r->busy_ms / 1000 / RADIO_HK_TEST_ORBITS, r->sessions, r->warm_resets,
+		r->temp_failures, r->temp_age_max_s);
+}
+
+void radio_hk_busy_benchmark(void) {
+	radio_hk_sched_t s;
+	radio_hk_session_t session;
+	hk_result_t old_res, new_res;
+
+	// requests make a session due, and go in it (in table order)
+	radio_hk_sched_init(&s);
+	radio_hk_sched_plan(&s, 100, &session);
+	test_check(session.num_ops == 1 && session.ops[0] == RADIO_HK_TEMP);
+	test_check(!radio_hk_sched_due(&s, 100 + RADIO_HK_INTERVAL_S - 1));
+	test_check(radio_hk_sched_due(&s, 100 + RADIO_HK_INTERVAL_S));
+	radio_hk_sched_request(&s, RADIO_HK_WARM_RESET);
+	test_check(radio_hk_sched_due(&s, 101));
+	radio_hk_sched_plan(&s, 101, &session);
+	test_check(session.num_ops == 2 && session.ops[1] == RADIO_HK_WARM_RESET);
+	test_check(radio_hk_session_time_ms(&session) == RADIO_HK_MAX_SESSION_MS);
+	// ...and so does a clock reset
+	test_check(radio_hk_sched_due(&s, 50));
+
+	for (uint8_t i = 0; i < NUM_SCENARIOS; i++) {
+		const hk_scenario_t* sc = &scenarios[i];
+		replay(sc, false, &old_res);
+		replay(sc, true, &new_res);
+		print("%s:\n", sc->name);
+		print_result("every 3rd cycle", &old_res);
+		print_result("housekeeping", &new_res);
+
+		// sessions are shared, so the radio's busy for much less of the orbit
+		test_check(new_res.busy_ms * (RADIO_HK_INTERVAL_S / RADIO_HK_TEST_OLD_PERIOD_S) <= old_res.busy_ms * 2);
+		if (sc->outage_end_s == 0) {
+			test_check(new_res.warm_resets == 0 && new_res.temp_failures == 0);
+			test_check(new_res.temp_age_max_s <= RADIO_HK_INTERVAL_S + TRANSMIT_TASK_FREQ / 1000);
+		} else {
+			// a radio that's stopped answering gets reset
+			test_check(new_res.warm_resets >= 1);
+			test_check(new_res.temp_failures >= RADIO_HK_MAX_FAILURES);
+		}
+		if (sc->stuck) {
+			// (the session with the reset reads the temperature first)
+			test_check(new_res.warm_resets == 1);
+			test_check(new_res.temp_failures == RADIO_HK_MAX_FAILURES + 1);
+		}
+	}
+	print("radio housekeeping busy benchmark passed\n");
+}
@@ -0,0 +1,27 @@
+/*
+ * radio_hk_tests.h
+ *
+ * Created: 10/19/2026 2:40:12 AM
+ *  Author: BSE
+ */
+
+
+#ifndef RADIO_HK_TESTS_H_
+#define RADIO_HK_TESTS_H_
+
+#include <global.h>
+#include "../telemetry/radio_housekeeping.h"
+#include "equisim_radio.h"
+#include "test_check.h"
+
+// orbits replayed per scenario
+#define RADIO_HK_TEST_ORBITS		4
+// start of the simulated clock (so the first escape has its guard time)
+#define RADIO_HK_TEST_START_MS		10000
+// how often the transmit task read the radio temperature before (every 3rd cycle)
+#define RADIO_HK_TEST_OLD_PERIOD_S	(3 * TRANSMIT_TASK_FREQ / 1000)
+
+void radio_hk_virtual_radio_test(void);
+void radio_hk_busy_benchmark(void);
+
+#endif /* RADIO_HK_TESTS_H_ */
@@ -0,0 +1,207 @@
+/*
+ * radio_link_tests.c
+ *
+ * Created: 10/19/2026 12:31:22 AM
+ *  Author: BSE
+ *
+ * Runs the radio path against the virtual radio and ground station (equisim_radio),
+ * handing it bytes at the times the transmit task would:
+ *	- radio_link_command_mode_test: escapes, reading the radio temperature and
+ *	  warm resets the way the transmit task does them, plus escapes sent too soon
+ *	- radio_link_goodput_test: an orbit of normal transmission cycles (4 messages
+ *	  every TRANSMIT_TASK_FREQ, spaced TOTAL_PACKET_TRANS_TIME_MS) over a range of
+ *	  channels, reporting the telemetry decoded per orbit with Reed-Solomon and
+ *	  what it would've been without (only the messages that arrived clean)
+ * The simulated clock is passed in, so both run before the RTOS (from run_tests()).
+ * Note they reset the virtual radio (and leave it at the default config).
+ */
+
+#include "radio_link_tests.h"
+
+typedef struct {
+	const char* name;
+	uint32_t ber_ppm;
+	uint32_t burst_ber_ppm;
+	uint32_t burst_start_ppm;
+	uint16_t burst_mean_bytes;
+} channel_scenario_t;
+
+static const channel_scenario_t channels[] = {
+	{"clean",						0,		0,		0,		0},
+	{"BER 1e-5",					10,		0,		0,		0},
+	{"BER 1e-4",					100,	0,		0,		0},
+	{"BER 1e-3",					1000,	0,		0,		0},
+	{"BER 5e-3",					5000,	0,		0,		0},
+	{"BER 2e-2",					20000,	0,		0,		0},
+	{"1e-5 with 40B fades",			10,		20000,	100,	40},
+	{"1e-5 with 120B fades",		10,		20000,	100,	120},
+};
+#define NUM_CHANNELS		(sizeof(channels) / sizeof(channels[0]))
+
+static uint8_t test_msg[MSG_SIZE];
+static uint32_t msg_rng = 0xC0FFEE;
+
+// a message with the real layout (callsign, RS over the rest) and random contents
+static void build_test_msg(void) {
+	memcpy(test_msg, "WL9XZE", CALLSIGN_SIZE);
+	for (int i = CALLSIGN_SIZE; i < START_PARITY; i++) {
+		msg_rng = msg_rng * 1103515245 + 12345;
+		test_msg[i] = msg_rng >> 16;
+	}
+	#ifdef USE_REED_SOLOMON
+		encode_data(test_msg + CALLSIGN_SIZE, START_PARITY - CALLSIGN_SIZE, test_msg + CALLSIGN_SIZE);
+	#endif
+}
+
+static void send(const char* bytes, uint32_t t) {
+	bool taken = equisim_radio_tx_at((const uint8_t*) bytes, strlen(bytes), t);
+	test_check(taken);
+}
+
+static bool temp_response_ok(uint16_t* temp) {
+	if (!check_checksum(radio_receive_buffer+1, 3, radio_receive_buffer[4])) {
+		return false;
+	}
+	*temp = (radio_receive_buffer[2] << 8) | radio_receive_buffer[3];
+	return true;
+}
+
+void radio_link_command_mode_test(void) {
+	equisim_radio_config_t config;
+	equisim_radio_default_config(&config);
+	config.orbit_ms = 0;
+	equisim_radio_init(&config);
+	equisim_radio_stats_t* stats = equisim_radio_get_stats();
+	uint16_t temp;
+	bool ok;
+
+	// nothing is taken while the TX buffer is closed (it goes out the SERCOM)
+	equisim_radio_set_tx_enable(false);
+	ok = equisim_radio_tx_at((const uint8_t*) "+++", 3, RADIO_LINK_TEST_START_MS);
+	test_check(!ok);
+
+	// read_radio_temp_mode
+	uint32_t t = RADIO_LINK_TEST_START_MS;
+	equisim_radio_set_power(true);
+	equisim_radio_set_tx_enable(true);
+	equisim_radio_set_rx_enable(true);
+	t += SET_CMD_MODE_WAIT_BEFORE_MS;
+	send("+++", t);
+	t += SET_CMD_MODE_WAIT_AFTER_MS;
+	clear_USART_rx_buffer();
+	XDL_prepare_get_temp();
+	send((char*) radio_send_buffer, t);
+	ok = temp_response_ok(&temp);
+	test_check(ok);
+	test_check(temp == config.temp);
+	test_check(stats->transmissions == 0 && stats->escapes_sent == 0);
+
+	// a corrupted command gets no response
+	clear_USART_rx_buffer();
+	XDL_prepare_get_temp();
+	radio_send_buffer[2] ^= 0x10;
+	send((char*) radio_send_buffer, t + 10);
+	ok = temp_response_ok(&temp);
+	test_check(!ok);
+	test_check(stats->cmd_bad == 1);
+
+	// warm reset: acknowledged, then deaf until it reboots, then back in data mode
+	clear_USART_rx_buffer();
+	warm_reset();
+	send((char*) radio_send_buffer, t + 20);
+	test_check(radio_receive_buffer[1] == (XDL_CMD_RESET | XDL_RESPONSE_FLAG));
+	test_check(check_checksum(radio_receive_buffer+1, 2, radio_receive_buffer[3]));
+	build_test_msg();
+	ok = equisim_radio_tx_at(test_msg, MSG_SIZE, t + 20 + WARM_RESET_REBOOT_TIME / 2);
+	test_check(ok);
+	test_check(stats->bytes_lost == MSG_SIZE);
+	t += 20 + WARM_RESET_REBOOT_TIME;
+	ok = equisim_radio_tx_at(test_msg, MSG_SIZE, t);
+	test_check(ok);
+	test_check(stats->transmissions == 1 && stats->frames_clean + stats->frames_corrected == 1);
+
+	// an escape right after a message goes out on air (and the radio stays in data mode)
+	send("+++", t + TRANSMIT_TIME_MS(MSG_SIZE) + 100);
+	test_check(stats->escapes_sent == 1);
+	clear_USART_rx_buffer();
+	XDL_prepare_get_temp();
+	send((char*) radio_send_buffer, t + TRANSMIT_TIME_MS(MSG_SIZE) + 200);
+	ok = temp_response_ok(&temp);
+	test_check(!ok);
+
+	// powering off drops command mode
+	t += 5000;
+	send("+++", t);
+	equisim_radio_set_power(false);
+	equisim_radio_set_power(true);
+	clear_USART_rx_buffer();
+	XDL_prepare_get_temp();
+	send((char*) radio_send_buffer, t + SET_CMD_MODE_WAIT_AFTER_MS);
+	ok = temp_response_ok(&temp);
+	test_check(!ok);
+
+	equisim_radio_set_tx_enable(false);
+	equisim_radio_set_rx_enable(false);
+	equisim_radio_set_power(false);
+	equisim_radio_init(NULL);
+	print("radio link command mode test passed\n");
+}
+
+// an orbit of transmit cycles; returns the simulated time
+static uint32_t run_orbit_of_cycles(uint32_t start) {
+	uint32_t cycles = RADIO_LINK_TEST_ORBITS * EQUISIM_RADIO_ORBIT_MS / TRANSMIT_TASK_FREQ;
+	for (uint32_t c = 0; c < cycles; c++) {
+		uint32_t cycle_start = start + c * TRANSMIT_TASK_FREQ;
+		for (int slot = 0; slot < 4; slot++) {
+			// (transmit_buf_wait hands the message to the radio after the IR power wake)
+			build_test_msg();
+			equisim_radio_tx_at(test_msg, MSG_SIZE, cycle_start + slot * TOTAL_PACKET_TRANS_TIME_MS + IR_WAKE_DELAY_MS);
+		}
+	}
+	return cycles * TRANSMIT_TASK_FREQ;
+}
+
+void radio_link_goodput_test(void) {
+	equisim_radio_config_t config;
+	uint32_t clean_goodput = 0;
+	uint32_t prev_goodput = 0xFFFFFFFF;
+
+	for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+		equisim_radio_default_config(&config);
+		config.ber_ppm = channels[i].ber_ppm;
+		config.burst_ber_ppm = channels[i].burst_ber_ppm;
+		config.burst_start_ppm = channels[i].burst_start_ppm;
+		config.burst_mean_bytes = channels[i].burst_mean_bytes;
+		equisim_radio_init(&config);
+		equisim_radio_set_power(true);
+		equisim_radio_set_tx_enable(true);
+
+		uint32_t elapsed = run_orbit_of_cycles(0);
+		equisim_radio_stats_t* s = equisim_radio_get_stats();
+		uint32_t heard = s->frames_sent - s->frames_unheard;
+		uint32_t goodput = equisim_radio_goodput_per_orbit(s, elapsed);
+		uint32_t uncoded = (uint32_t) ((uint64_t) s->frames_clean * EQUISIM_RADIO_PAYLOAD_SIZE
+			* EQUISIM_RADIO_ORBIT_MS / elapsed);
+		print("%s: %d bytes/orbit (%d uncoded) | %d heard: %d clean, %d corrected, %d lost, %d miscorrected | %d bit errors\n",
+			channels[i].name, goodput, uncoded, heard, s->frames_clean, s->frames_corrected,
+			s->frames_lost, s->frames_miscorrected, s->bit_errors);
+
+		// the task's spacing leaves the radio idle between messages
+		test_check(s->handoffs_queued == 0 && s->transmissions == s->frames_sent);
+		test_check(s->frames_clean + s->frames_corrected + s->frames_lost + s->frames_miscorrected == heard);
+		test_check(goodput >= uncoded);
+		if (i == 0) {
+			clean_goodput = goodput;
+			test_check(s->frames_clean == heard && heard > 0);
+		}
+		test_check(goodput <= clean_goodput);
+		// uniform errors only get worse down the list
+		if (channels[i].burst_start_ppm == 0) {
+			test_check(goodput <= prev_goodput);
+			prev_goodput = goodput;
+		}
+	}
+	equisim_radio_set_tx_enable(false);
+	equisim_radio_set_power(false);
+	equisim_radio_init(NULL);
+}
@@ -0,0 +1,24 @@
+/*
+ * radio_link_tests.h
+ *
+ * Created: 10/19/2026 12:31:05 AM
+ *  Author: BSE
+ */
+
+
+#ifndef RADIO_LINK_TESTS_H_
+#define RADIO_LINK_TESTS_H_
+
+#include <global.h>
+#include "equisim_radio.h"
+#include "test_check.h"
+
+// orbits simulated per channel setting
+#define RADIO_LINK_TEST_ORBITS		1
+// start of the simulated clock (so the first escape has its guard time)
+#define RADIO_LINK_TEST_START_MS	10000
+
+void radio_link_command_mode_test(void);
+void radio_link_goodput_test(void);
+
+#endif /* RADIO_LINK_TESTS_H_ */
@@ -0,0 +1,116 @@
+/*
+ * regulator_cache_tests.c
+ *
+ * Created: 10/18/2026 8:02:36 PM
+ *  Author: BSE
+ *
+ * Scenario for the regulator verification cache: bursts of back-to-back
+ * verify_regulators calls (like a transmit followed by data tasks) in a
+ * steady state, after a hardware state change, right after a transmit (while
+ * the radio current is still falling), and after the cache goes stale.
+ * Each burst should do one real check and skip the rest; the I2C transactions
+ * and time of the checks that were done give the bus time saved.
+ * Must run with the RTOS started (call from run_rtos_tests()), with the radio
+ * on and idle, the 5V rail in a steady state, and other tasks suspended
+ * (OVERRIDE_INIT_TASK_STATES).
+ */
+
+#include "regulator_cache_tests.h"
+
+typedef struct {
+	uint32_t performed;
+	uint32_t skipped;
+	uint32_t i2c_transactions;
+	TickType_t ticks;
+} burst_result_t;
+
+static void run_burst(burst_result_t* res) {
+	regulator_verify_counts_t before, after;
+	get_regulator_verify_counts(&before);
+	uint32_t i2c_before = get_i2c_transaction_count();
+	TickType_t start = xTaskGetTickCount();
+
+	for (int i = 0; i < REG_CACHE_TEST_BURST; i++) {
+		verify_regulators();
+	}
+
+	res->ticks = xTaskGetTickCount() - start;
+	res->i2c_transactions = get_i2c_transaction_count() - i2c_before;
+	get_regulator_verify_counts(&after);
+	res->performed = after.performed - before.performed;
+	res->skipped = after.skipped - before.skipped;
+}
+
+// "changes" the hardware state (without touching hardware) to bump the generation
+static void bump_hw_state(void) {
+	for (int i = 0; i < 2; i++) {
+		bool got_mutex = hardware_state_mutex_take(ELOC_VERIFY_REGS);
+		test_check(got_mutex);
+		if (!got_mutex) {
+			return;
+		}
+		get_hw_states()->antenna_deploying = !get_hw_states()->antenna_deploying;
+		hardware_state_mutex_give();
+	}
+}
+
+// leaves the radio state as transmit_buf_wait does after a transmission
+// (without transmitting), to settle back to idle once the current's fallen
+static void end_transmit_state(void) {
+	bool got_mutex = hardware_state_mutex_take(ELOC_VERIFY_REGS);
+	test_check(got_mutex);
+	if (!got_mutex) {
+		return;
+	}
+	test_check(get_hw_states()->radio_state == RADIO_IDLE);
+	get_hw_states()->radio_trans_done_target_time = xTaskGetTickCount() + (TRANSMIT_CURRENT_FALL_TIME_MS / portTICK_PERIOD_MS);
+	get_hw_states()->radio_state = RADIO_IDLE_TRANS_TRANSITION;
+	hardware_state_mutex_give();
+}
+
+static void print_burst(const char* name, burst_result_t* res) {
+	print("%s: %d performed, %d skipped (%d%% hit rate); %d I2C transactions, %d ms\n",
+		name, res->performed, res->skipped, res->skipped * 100 / (res->performed + res->skipped),
+		res->i2c_transactions, res->ticks * portTICK_PERIOD_MS);
+}
+
+void regulator_cache_scenario_test(void) {
+	burst_result_t steady, changed, transmitted, stale;
+
+	// start from a clean slate
+	uint32_t gen_before = get_hw_state_generation();
+	bump_hw_state();
+	test_check(get_hw_state_generation() == gen_before + 2);
+
+	run_burst(&steady);
+	print_burst("steady state", &steady);
+
+	bump_hw_state();
+	run_burst(&changed);
+	print_burst("after state change", &changed);
+
+	// the first check waits out the transition and settles it, so is cached
+	end_transmit_state();
+	run_burst(&transmitted);
+	print_burst("after transmit", &transmitted);
+
+	vTaskDelay(VERIFY_REGS_CACHE_FRESH_MS / portTICK_PERIOD_MS);
+	run_burst(&stale);
+	print_burst("after cache expiry", &stale);
+
+	burst_result_t* bursts[] = {&steady, &changed, &transmitted, &stale};
+	uint32_t performed = 0, skipped = 0, i2c = 0;
+	TickType_t ticks = 0;
+	for (int i = 0; i < 4; i++) {
+		test_check(bursts[i]->performed == 1);
+		test_check(bursts[i]->skipped == REG_CACHE_TEST_BURST - 1);
+		performed += bursts[i]->performed;
+		skipped += bursts[i]->skipped;
+		i2c += bursts[i]->i2c_transactions;
+		ticks += bursts[i]->ticks;
+	}
+
+	// without the cache every call would cost what the performed ones did
+	print("total: %d checks performed, %d skipped; saved ~%d I2C transactions, ~%d ms of bus time\n",
+		performed, skipped, (i2c / performed) * skipped, (ticks * portTICK_PERIOD_MS / performed) * skipped);
+}
@@ -0,0 +1,23 @@
+/*
+ * regulator_cache_tests.h
+ *
+ * Created: 10/18/2026 8:02:17 PM
+ *  Author: BSE
+ */
+
+
+#ifndef REGULATOR_CACHE_TESTS_H_
+#define REGULATOR_CACHE_TESTS_H_
+
+#include <global.h>
+#include "../sensor_drivers/sensor_read_commands.h"
+#include "../runnable_configurations/satellite_state_control.h"
+#include "../telemetry/Radio_Commands.h"
+#include "test_check.h"
+
+// back-to-back verifications in each phase of the scenario
+#define REG_CACHE_TEST_BURST		4
+
+void regulator_cache_scenario_test(void);
+
+#endif /* REGULATOR_CACHE_TESTS_H_ */
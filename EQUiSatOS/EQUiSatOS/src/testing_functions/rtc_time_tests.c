@@ -0,0 +1,165 @@
+/*
+ * rtc_time_tests.c
+ *
+ * Created: 10/19/2026 8:41:37 PM
+ *  Author: BSE
+ *
+ * rtc_time_test checks the RTC time service (rtc_time.h):
+ *	- seconds and ms from counts match dividing, up to 2^42 counts (~136 years)
+ *	- the extended count is exact and never goes back across overflows, with
+ *	  the overflow interrupt held off up to RTC_TIME_TEST_MAX_ISR_DELAY counts
+ *	  and the count read back lagging up to RTC_TIME_TEST_MAX_READ_LAG
+ *	- the timestamps on it stay in step (the ms over 1000 are the seconds) and
+ *	  keep going up past the RTC overflowing (~48.5 days) and the tick count
+ *	  wrapping (~49.7 days), which the timestamps used to go by
+ * It only uses rtc_time.h, so it runs before the RTOS (from run_tests()) or on a host.
+ * benchmark_rtc_time times the timestamp calls against the divides they replace
+ * (before the scheduler starts; see cycle_count.h).
+ */
+
+#include "rtc_time_tests.h"
+
+/************************************************************************/
+/* CONVERSIONS                                                          */
+/************************************************************************/
+static void check_conversions(uint64_t counts) {
+	uint64_t ms = rtc_time_counts_to_ms(counts);
+	uint32_t s = rtc_time_counts_to_s(counts);
+	test_check(ms == counts * 1000 / RTC_TIME_TEST_COUNTS_PER_S);
+	test_check(s == counts / RTC_TIME_TEST_COUNTS_PER_S);
+	test_check(ms / 1000 == s);
+}
+
+/************************************************************************/
+/* EXTENDING THE COUNT                                                  */
+/************************************************************************/
+/* what rtc_read_counts_64 reads at true count now, with the RTC having
+   overflowed at each multiple of 2^32 and RTC_Handler counting it isr_delay
+   counts later (or once the count read back shows it, if later), and the
+   count read back read_lag behind */
+static uint64_t sim_read(uint64_t now, uint32_t isr_delay, uint32_t read_lag) {
+	uint32_t overflows = now >> 32;
+	uint64_t since_overflow = now - ((uint64_t) overflows << 32);
+	uint32_t counted_after = isr_delay > read_lag ? isr_delay : read_lag;
+	bool pending = false;
+	if (overflows > 0 && since_overflow < counted_after) {
+		overflows--;
+		pending = true;
+	}
+	return rtc_time_extend(overflows, (uint32_t) (now - read_lag), pending);
+}
+
+static const uint32_t isr_delays[] = {0, 1, 50, RTC_TIME_TEST_MAX_ISR_DELAY};
+#define NUM_ISR_DELAYS		(sizeof(isr_delays) / sizeof(uint32_t))
+
+static void test_extend(void) {
+	for (uint32_t overflow = 1; overflow <= 2; overflow++) {
+		uint64_t at = (uint64_t) overflow << 32;
+		for (uint8_t d = 0; d < NUM_ISR_DELAYS; d++) {
+			for (uint32_t lag = 0; lag <= RTC_TIME_TEST_MAX_READ_LAG; lag++) {
+				uint64_t prev = 0;
+				for (uint64_t now = at - RTC_TIME_TEST_WINDOW; now <= at + RTC_TIME_TEST_WINDOW; now++) {
+					uint64_t read = sim_read(now, isr_delays[d], lag);
+					test_check(read == now - lag);
+					test_check(read >= prev);
+					prev = read;
+				}
+			}
+		}
+	}
+}
+
+/************************************************************************/
+/* TIMESTAMPS                                                           */
+/************************************************************************/
+// (as get_current_timestamp and get_current_timestamp_ms put them together)
+static void check_timestamps(uint64_t counts, uint64_t* prev_ms) {
+	uint32_t s = rtc_time_counts_to_s(counts) + RTC_TIME_TEST_BOOT_S;
+	uint64_t ms = rtc_time_counts_to_ms(counts) + 1000 * (uint64_t) RTC_TIME_TEST_BOOT_S;
+	test_check(ms / 1000 == s);
+	test_check(ms >= *prev_ms);
+	*prev_ms = ms;
+}
+
+static void check_timestamps_around(uint64_t at) {
+	uint64_t prev_ms = 0;
+	for (uint64_t counts = at - RTC_TIME_TEST_WINDOW; counts <= at + RTC_TIME_TEST_WINDOW; counts++) {
+		check_timestamps(counts, &prev_ms);
+	}
+}
+
+void rtc_time_test(void) {
+	for (uint64_t counts = 0; counts < 4 * RTC_TIME_TEST_COUNTS_PER_S; counts++) {
+		check_conversions(counts);
+	}
+	for (uint64_t counts = 4 * RTC_TIME_TEST_COUNTS_PER_S; counts < ((uint64_t) 1 << 42); counts += counts / 64 + 1) {
+		check_conversions(counts);
+	}
+	// (the top of the 32-bit count, and the bottom of the next)
+	check_conversions((uint64_t) UINT32_MAX);
+	check_conversions((uint64_t) UINT32_MAX + 1);
+
+	test_extend();
+
+	// every ~16 min since boot, then every count around the RTC overflowing
+	// and the tick count wrapping (2^32 ms)
+	uint64_t prev_ms = 0;
+	uint64_t end = (uint64_t) RTC_TIME_TEST_SIM_S * RTC_TIME_TEST_COUNTS_PER_S;
+	for (uint64_t counts = 0; counts < end; counts += 997 * RTC_TIME_TEST_COUNTS_PER_S + 13) {
+		check_timestamps(counts, &prev_ms);
+	}
+	check_timestamps_around((uint64_t) 1 << 32);
+	check_timestamps_around(((uint64_t) 1 << 32) * RTC_TIME_TEST_COUNTS_PER_S / 1000);
+	print("rtc time tests passed\n");
+}
+
+/************************************************************************/
+/* BENCHMARK                                                            */
+/************************************************************************/
+// sinks so the compiler can't drop the work being timed
+static volatile uint32_t bench_sink_u;
+static volatile uint64_t bench_sink_u64;
+// (volatile, so these are divided as the old timestamps did, not shifted)
+static volatile uint32_t bench_ms_per_s = 1000;
+static volatile uint32_t bench_counts_per_s = RTC_TIME_TEST_COUNTS_PER_S;
+
+void benchmark_rtc_time(void) {
+	uint32_t start;
+	cycle_count_start();
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < RTC_TIME_BENCH_ITERS; i++) {
+		bench_sink_u64 = rtc_read_counts_64();
+	}
+	uint32_t read = cycle_count_since(start) / RTC_TIME_BENCH_ITERS;
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < RTC_TIME_BENCH_ITERS; i++) {
+		bench_sink_u = get_current_timestamp();
+	}
+	uint32_t timestamp = cycle_count_since(start) / RTC_TIME_BENCH_ITERS;
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < RTC_TIME_BENCH_ITERS; i++) {
+		bench_sink_u64 = get_current_timestamp_ms();
+	}
+	uint32_t timestamp_ms = cycle_count_since(start) / RTC_TIME_BENCH_ITERS;
+
+	// the old timestamps' tick count in seconds (done twice a call), and ms by dividing
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < RTC_TIME_BENCH_ITERS; i++) {
+		bench_sink_u = (xTaskGetTickCount() / portTICK_PERIOD_MS) / bench_ms_per_s;
+	}
+	uint32_t tick_s = cycle_count_since(start) / RTC_TIME_BENCH_ITERS;
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < RTC_TIME_BENCH_ITERS; i++) {
+		bench_sink_u64 = rtc_read_counts_64() * 1000 / bench_counts_per_s;
+	}
+	uint32_t divided_ms = cycle_count_since(start) / RTC_TIME_BENCH_ITERS;
+
+	print("rtc_read_counts_64: %d cycles\n", read);
+	print("get_current_timestamp: %d cycles (tick count in seconds: %d)\n", timestamp, tick_s);
+	print("get_current_timestamp_ms: %d cycles (dividing the count: %d)\n", timestamp_ms, divided_ms);
+	cycle_count_stop();
+}
@@ -0,0 +1,34 @@
+/*
+ * rtc_time_tests.h
+ *
+ * Created: 10/19/2026 8:40:53 PM
+ *  Author: BSE
+ */
+
+
+#ifndef RTC_TIME_TESTS_H_
+#define RTC_TIME_TESTS_H_
+
+#include <global.h>
+#include "../processor_drivers/rtc_time.h"
+#include "../data_handling/persistent_storage.h"
+#include "cycle_count.h"
+#include "test_check.h"
+
+#define RTC_TIME_TEST_COUNTS_PER_S		1024	// RTC_COUNTS_PER_S
+// counts checked either side of each overflow (and other edge)
+#define RTC_TIME_TEST_WINDOW			3000
+// how long an overflow's interrupt can be held off (a long critical section)
+#define RTC_TIME_TEST_MAX_ISR_DELAY		2000
+// how far behind the count read back can be
+#define RTC_TIME_TEST_MAX_READ_LAG		2
+// simulated time since boot the timestamps are checked over, and the seconds since launch at boot
+#define RTC_TIME_TEST_SIM_S				(120UL*24*60*60)
+#define RTC_TIME_TEST_BOOT_S			31536000UL
+
+#define RTC_TIME_BENCH_ITERS			256
+
+void rtc_time_test(void);
+void benchmark_rtc_time(void);
+
+#endif /* RTC_TIME_TESTS_H_ */
@@ -5,6 +5,7 @@
  *  Author: mcken
  */ 
 #include "rtos_system_test.h"
+#include "../telemetry/downlink_ledger.h"
 
 #ifdef RTOS_SYSTEM_TEST_ONLY_NEW
 	const bool only_print_recent_data = true;
@@ -146,7 +147,7 @@ static void print_stack_type_header(const char* header, int i, uint32_t timestam
 }
 
 void print_idle_data(idle_data_t* data, int i) {
-	print_stack_type_header("Idle Data Packet", i, data->timestamp, data->transmitted);
+	print_stack_type_header("Idle Data Packet", i, data->timestamp, reading_was_sent(IDLE_DATA, data->reading_id));
 	print_satellite_state_history_batch(data->satellite_history);
 	print_lion_volts_batch(data->lion_volts_data);
 	print_lion_current_batch(data->lion_current_data);
@@ -159,7 +160,7 @@ void print_idle_data(idle_data_t* data, int i) {
 }
 
 void print_attitude_data(attitude_data_t* data, int i) {
-	print_stack_type_header("Attitude Data Packet", i, data->timestamp, data->transmitted);
+	print_stack_type_header("Attitude Data Packet", i, data->timestamp, reading_was_sent(ATTITUDE_DATA, data->reading_id));
 	print_ir_object_temps_batch(data->ir_obj_temps_data);
 	print_pdiode_batch(data->pdiode_data);
 	print("accel batches (500ms apart):\n");
@@ -173,7 +174,7 @@ void print_attitude_data(attitude_data_t* data, int i) {
 
 void print_flash_data(flash_data_t* data, int i_global) {
 	print("---------LED BURST Data---------\n");
-	print_stack_type_header("Flash Data Packet", i_global, data->timestamp, data->transmitted);
+	print_stack_type_header("Flash Data Packet", i_global, data->timestamp, reading_was_sent(FLASH_DATA, data->reading_id));
 	//print("---LED Temp Burst Data---\n");
 	for (int i = 0; i < FLASH_DATA_ARR_LEN; i++) {
 		print_led_temps_batch(data->led_temps_data[i]);
@@ -203,7 +204,7 @@ void print_flash_data(flash_data_t* data, int i_global) {
 
 void print_flash_cmp_data(flash_cmp_data_t* data, int i) {
 	print("---------END LED COMPARISON Data---------\n");
-	print_stack_type_header("Flash Compare Data Packet", i, data->timestamp, data->transmitted);
+	print_stack_type_header("Flash Compare Data Packet", i, data->timestamp, reading_was_sent(FLASH_CMP_DATA, data->reading_id));
 	print_led_temps_batch(data->led_temps_avg_data);
 	print_lifepo_temps_batch(data->lifepo_bank_temps_avg_data);
 	print_led_current_batch(data->lifepo_current_avg_data);
@@ -214,7 +215,7 @@ void print_flash_cmp_data(flash_cmp_data_t* data, int i) {
 }
 
 void print_low_power_data(low_power_data_t* data, int i) {
-	print_stack_type_header("Low Power Data Packet", i, data->timestamp, data->transmitted);
+	print_stack_type_header("Low Power Data Packet", i, data->timestamp, reading_was_sent(LOW_POWER_DATA, data->reading_id));
 	print_satellite_state_history_batch(data->satellite_history);
 	print_lion_volts_batch(data->lion_volts_data);
 	print_lion_current_batch(data->lion_current_data);
@@ -225,6 +226,41 @@ void print_low_power_data(low_power_data_t* data, int i) {
 	print_gyro_batch(data->gyro_data);
 }
 
+void print_runtime_stats_data(runtime_stats_data_t* data, int i) {
+	print_stack_type_header("Run Time Stats Packet", i, data->timestamp, reading_was_sent(RUNTIME_STATS_DATA, data->reading_id));
+	const runtime_report_t* r = &data->report;
+	print("period: %d ms, idle %d.%d%%\n", r->period_ms, r->idle_permille / 10, r->idle_permille % 10);
+	for (int t = 0; t < RUNTIME_STATS_SLOTS; t++) {
+		const char* name = t == RUNTIME_STATS_IDLE_SLOT ? "(idle)                     "
+			: t == RUNTIME_STATS_OTHER_SLOT ? "(other)                    " : get_task_str(t);
+		print("%s total %10d ms\t%3d.%d%%\tmax run %5d00 us\tmin free stack %5d B\n", name, r->slots[t].total_ms,
+			r->slots[t].period_permille / 10, r->slots[t].period_permille % 10, r->slots[t].max_slice,
+			data->stack_min_free[t]);
+	}
+}
+
+// in mutex_stats_id_t order
+static const char* mutex_stats_names[MUTEX_STATS_NUM] = {
+	"critical_action    ", "i2c_irpow          ", "processor_adc      ", "hardware_state     ",
+	"watchdog           ", "mram_spi_cache     ", "idle_equistack     ", "attitude_equistack ",
+	"flash_equistack    ", "flash_cmp_equistack", "low_power_equistack", "runtime_equistack  ",
+	"mutex_equistack    ", "error_equistack    "
+};
+
+void print_mutex_stats_data(mutex_stats_data_t* data, int i) {
+	print_stack_type_header("Mutex Stats Packet", i, data->timestamp, reading_was_sent(MUTEX_STATS_DATA, data->reading_id));
+	for (int m = 0; m < MUTEX_STATS_NUM; m++) {
+		const mutex_stats_entry_t* e = &data->report.mutexes[m];
+		uint8_t owner = e->timeout_owner;
+		const char* owner_name = owner == MUTEX_STATS_NO_OWNER ? "none"
+			: owner == RUNTIME_STATS_IDLE_SLOT ? "(idle)"
+			: owner >= NUM_TASKS ? "(other)" : get_task_str(owner);
+		print("%s takes %5d	timeouts %3d	waits %3d %3d %3d %3d	max wait %5d ms	max hold %5d ms	last timeout holder %s\n",
+			mutex_stats_names[m], e->takes, e->timeouts, e->waits[0], e->waits[1], e->waits[2], e->waits[3],
+			e->max_wait_ms, e->max_hold_ms, owner_name);
+	}
+}
+
 void print_sat_error(sat_error_t* err, int i) {
 	print("%2d: error (%s): loc=%s (%d)\t code=%s (%d)\t @ %d\n", i, 
 		is_priority_error(*err) ? "priority" : "normal  ", 
@@ -285,6 +321,8 @@ const char* get_msg_type_str(msg_data_type_t msg_type) {
 		case FLASH_DATA:		return "FLASH_DATA    ";
 		case FLASH_CMP_DATA:	return "FLASH_CMP_DATA";
 		case LOW_POWER_DATA:	return "LOW_POWER_DATA";
+		case RUNTIME_STATS_DATA:	return "RUNTIME_STATS ";
+		case MUTEX_STATS_DATA:	return "MUTEX_STATS   ";
 		case NUM_MSG_TYPE:
 		default:				return "[invalid]     ";
 	}
@@ -571,6 +609,8 @@ static void print_equistacks(void) {
 	print_equistack(&flash_readings_equistack,		print_flash_data,		"Flash Data Stack",			max_size);
 	print_equistack(&flash_cmp_readings_equistack,	print_flash_cmp_data,	"Flash Cmp Data Stack",		max_size);
 	print_equistack(&low_power_readings_equistack,	print_low_power_data,	"Low Power Data Stack",		max_size);
+	print_equistack(&runtime_stats_equistack,		print_runtime_stats_data,	"Run Time Stats Stack",	max_size);
+	print_equistack(&mutex_stats_equistack,		print_mutex_stats_data,		"Mutex Stats Stack",	max_size);
 }
 
 void print_task_info(void) {
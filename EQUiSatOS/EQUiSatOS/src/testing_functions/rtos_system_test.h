@@ -38,6 +38,8 @@ void print_attitude_data(attitude_data_t* data, int i);
 void print_flash_data(flash_data_t* data, int i);
 void print_flash_cmp_data(flash_cmp_data_t* data, int i);
 void print_low_power_data(low_power_data_t* data, int i);
+void print_runtime_stats_data(runtime_stats_data_t* data, int i);
+void print_mutex_stats_data(mutex_stats_data_t* data, int i);
 
 const char* get_sat_state_str(sat_state_t state);
 const char* get_task_str(task_type_t task);
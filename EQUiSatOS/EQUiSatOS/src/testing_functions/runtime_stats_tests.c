@@ -0,0 +1,109 @@
+/*
+ * runtime_stats_tests.c
+ *
+ * Created: 10/19/2026 10:05:52 AM
+ *  Author: BSE
+ *
+ * Checks the run time stats accounting (charging time to slots across counter
+ * wraparound, the longest runs, closing periods, the report and its packing),
+ * then times the work the scheduler hook does on a switch against the counter
+ * (which must be running; this starts it). Runs before the RTOS (from run_tests()).
+ */
+
+#include "runtime_stats_tests.h"
+
+static runtime_stats_t stats;
+static runtime_period_t period;
+static runtime_report_t report, unpacked;
+
+static void check_accounting(void) {
+	// start just before the counter wraps
+	uint32_t t = 0xFFFFF000;
+	runtime_stats_init(&stats, RUNTIME_STATS_OTHER_SLOT, t);
+	runtime_stats_switch(&stats, 0, t += 1000);					// other: 1000
+	runtime_stats_switch(&stats, 0, t += 500);					// (same slot again)
+	runtime_stats_switch(&stats, RUNTIME_STATS_IDLE_SLOT, t += 2500);	// 0: one run of 3000
+	runtime_stats_switch(&stats, 1, t += 10000);				// idle: 10000 (wrapped)
+	runtime_stats_switch(&stats, 0, t += 200);					// 1: 200
+	runtime_stats_switch(&stats, RUNTIME_STATS_IDLE_SLOT, t += 700);	// 0: another run of 700
+	runtime_stats_close_period(&stats, t += 5800, &period);		// idle: 5800 more
+
+	test_check(period.period_us[RUNTIME_STATS_OTHER_SLOT] == 1000);
+	test_check(period.period_us[0] == 3700);
+	test_check(period.max_slice_us[0] == 3000);
+	test_check(period.period_us[1] == 200);
+	test_check(period.period_us[RUNTIME_STATS_IDLE_SLOT] == 15800);
+	test_check(period.max_slice_us[RUNTIME_STATS_IDLE_SLOT] == 10000);
+	test_check(period.total_us[0] == 3700);
+
+	runtime_stats_summarize(&period, &report);
+	test_check(report.period_ms == 20);		// 20700 us
+	test_check(report.slots[0].period_permille == 179);
+	test_check(report.slots[RUNTIME_STATS_IDLE_SLOT].period_permille == 763);
+	test_check(report.idle_permille == 763);
+	test_check(report.slots[0].max_slice == 3000 / RUNTIME_STATS_SLICE_US);
+
+	// the next period starts over, except for the totals (idle is still running)
+	runtime_stats_switch(&stats, 0, t += 4000);
+	runtime_stats_close_period(&stats, t += 1000, &period);
+	test_check(period.period_us[RUNTIME_STATS_IDLE_SLOT] == 4000);
+	test_check(period.max_slice_us[RUNTIME_STATS_IDLE_SLOT] == 4000);
+	test_check(period.period_us[0] == 1000);
+	test_check(period.max_slice_us[0] == 1000);
+	test_check(period.period_us[1] == 0);
+	test_check(period.total_us[0] == 4700);
+	test_check(period.total_us[RUNTIME_STATS_IDLE_SLOT] == 19800);
+
+	// a run too long for max_slice saturates it
+	runtime_stats_init(&stats, 2, 0);
+	runtime_stats_close_period(&stats, 0x80000000, &period);
+	runtime_stats_summarize(&period, &report);
+	test_check(report.slots[2].max_slice == 0xFFFF);
+	test_check(report.slots[2].period_permille == 1000);
+	test_check(report.idle_permille == 0);
+}
+
+static void check_packing(void) {
+	uint8_t buf[RUNTIME_STATS_REPORT_SIZE + 1];
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		report.slots[i].total_ms = 0x01020304 * (i + 1);
+		report.slots[i].period_permille = 10 * i;
+		report.slots[i].max_slice = 0x8000 + i;
+	}
+	report.period_ms = 0xA1B2C3D4;
+	report.idle_permille = 999;
+	buf[RUNTIME_STATS_REPORT_SIZE] = 0x5A;
+	runtime_stats_pack(&report, buf);
+	test_check(buf[RUNTIME_STATS_REPORT_SIZE] == 0x5A); // (stays in its bytes)
+	test_check(buf[0] == 0xD4 && buf[3] == 0xA1); // little-endian
+	runtime_stats_unpack(buf, &unpacked);
+	test_check(memcmp(&report, &unpacked, sizeof(runtime_report_t)) == 0);
+}
+
+static void time_switches(void) {
+	configure_runtime_counter();
+	runtime_stats_init(&stats, RUNTIME_STATS_OTHER_SLOT, runtime_counter_read());
+	taskDISABLE_INTERRUPTS();
+	uint32_t start = runtime_counter_read();
+	for (int i = 0; i < RUNTIME_TEST_TIMED_SWITCHES; i++) {
+		runtime_stats_switch(&stats, i % RUNTIME_STATS_SLOTS, runtime_counter_read());
+	}
+	uint32_t elapsed = runtime_counter_read() - start;
+	taskENABLE_INTERRUPTS();
+	print("run time stats: %d switches in %d us (%d ns each)\n", RUNTIME_TEST_TIMED_SWITCHES, elapsed,
+		elapsed * 1000 / RUNTIME_TEST_TIMED_SWITCHES);
+
+	runtime_stats_close_period(&stats, runtime_counter_read(), &period);
+	uint64_t sum = 0;
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		sum += period.period_us[i];
+	}
+	test_check(sum >= elapsed);
+}
+
+void runtime_stats_test(void) {
+	check_accounting();
+	check_packing();
+	time_switches();
+	print("run time stats tests passed\n");
+}
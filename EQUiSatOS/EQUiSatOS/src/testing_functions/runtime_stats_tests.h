@@ -0,0 +1,22 @@
+/*
+ * runtime_stats_tests.h
+ *
+ * Created: 10/19/2026 10:05:41 AM
+ *  Author: BSE
+ */
+
+
+#ifndef RUNTIME_STATS_TESTS_H_
+#define RUNTIME_STATS_TESTS_H_
+
+#include <global.h>
+#include "../data_handling/runtime_stats.h"
+#include "../processor_drivers/TC_Commands.h"
+#include "test_check.h"
+
+// switches timed to measure the scheduler hook's cost
+#define RUNTIME_TEST_TIMED_SWITCHES		1000
+
+void runtime_stats_test(void);
+
+#endif /* RUNTIME_STATS_TESTS_H_ */
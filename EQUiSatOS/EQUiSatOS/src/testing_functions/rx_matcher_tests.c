@@ -0,0 +1,216 @@
+/*
+ * rx_matcher_tests.c
+ *
+ * Created: 10/18/2026 10:41:44 PM
+ *  Author: BSE
+ *
+ * rx_matcher_fuzz_test feeds random, noise-heavy byte streams (mostly callsign
+ * and command characters, with real uplinks mixed in) through both the
+ * streaming uplink matcher and the old matcher (a copy of the previous
+ * check_rx_received, which rescanned the whole receive ring on every byte),
+ * with the ring filled exactly like SERCOM3_Handler does. On every byte:
+ *	- the streaming matcher must report a command iff the last bytes received
+ *	  are the callsign followed by that command
+ *	- whenever those bytes sit in the ring without crossing its end, the old
+ *	  matcher must have found exactly the same command there
+ * The cases where the old matcher differed (missed uplinks across the end of
+ * the ring, matches spliced from old and new bytes, and repeat reports of a
+ * command still in the ring) are counted and printed.
+ * benchmark_rx_matcher compares the cycles each spends per received byte.
+ * Neither uses hardware besides SysTick; run before the RTOS (from run_tests()).
+ */
+
+#include "rx_matcher_tests.h"
+
+#define PATTERN_LEN		(LEN_GROUND_CALLSIGN + LEN_UPLINK_BUF)
+
+static char* cmd_bufs[] = {echo_buf, flash_buf, reboot_buf, kill_3days_buf, kill_week_buf,
+	kill_forever_buf, revive_buf, flash_kill_buf, flash_revive_buf};
+static const rx_cmd_type_t cmd_types[] = {CMD_ECHO, CMD_FLASH, CMD_REBOOT, CMD_KILL_3DAYS, CMD_KILL_WEEK,
+	CMD_KILL_FOREVER, CMD_REVIVE, CMD_FLASH_KILL, CMD_FLASH_REVIVE};
+#define NUM_CMDS		(sizeof(cmd_types) / sizeof(cmd_types[0]))
+
+static const char noise_chars[] = "K1ADECFLRVK23";
+
+static rx_matcher_t test_matcher;
+static uint8_t ring[LEN_RECEIVEBUFFER];
+static uint8_t ring_index;
+static uint8_t stream[RX_FUZZ_STREAM_LEN];
+
+/************************************************************************/
+/* OLD MATCHER                                                          */
+/************************************************************************/
+// returns the command at ring position i (same checks, same order as before)
+static rx_cmd_type_t legacy_match_at(uint8_t i) {
+	for (int j = 0; j < LEN_GROUND_CALLSIGN; j++) {
+		if (ring[(i+j) % LEN_RECEIVEBUFFER] != ground_callsign_buf[j]) {
+			return CMD_NONE;
+		}
+	}
+	uint8_t start = (i+LEN_GROUND_CALLSIGN) % LEN_RECEIVEBUFFER;
+	for (uint8_t c = 0; c < NUM_CMDS; c++) {
+		bool match = true;
+		for (int j = 0; j < LEN_UPLINK_BUF; j++) {
+			if (cmd_bufs[c][j] != ring[(start+j) % LEN_RECEIVEBUFFER]) {
+				match = false;
+				break;
+			}
+		}
+		if (match) {
+			return cmd_types[c];
+		}
+	}
+	return CMD_NONE;
+}
+
+// the whole rescan done per byte (returns the last command found, like before)
+static rx_cmd_type_t legacy_check_rx(void) {
+	rx_cmd_type_t command = CMD_NONE;
+	for (uint8_t i = 0; i < LEN_RECEIVEBUFFER; i++) {
+		rx_cmd_type_t c = legacy_match_at(i);
+		if (c != CMD_NONE) {
+			command = c;
+		}
+	}
+	return command;
+}
+
+// same as SERCOM3_Handler
+static void ring_put(uint8_t byte) {
+	ring[ring_index] = byte;
+	ring_index++;
+	if (ring_index >= LEN_RECEIVEBUFFER - 1) {
+		ring_index = 0;
+	}
+}
+
+static void ring_clear(void) {
+	memset(ring, 0, LEN_RECEIVEBUFFER);
+	ring_index = 0;
+}
+
+/************************************************************************/
+/* STREAMS                                                              */
+/************************************************************************/
+static void fill_noisy_stream(void) {
+	int i = 0;
+	while (i < RX_FUZZ_STREAM_LEN) {
+		int r = rand() % 16;
+		if (r == 0 && i + PATTERN_LEN <= RX_FUZZ_STREAM_LEN) {
+			// a real uplink
+			memcpy(stream + i, ground_callsign_buf, LEN_GROUND_CALLSIGN);
+			memcpy(stream + i + LEN_GROUND_CALLSIGN, cmd_bufs[rand() % NUM_CMDS], LEN_UPLINK_BUF);
+			i += PATTERN_LEN;
+		} else if (r == 1 && i + LEN_GROUND_CALLSIGN <= RX_FUZZ_STREAM_LEN) {
+			// a callsign followed by whatever
+			memcpy(stream + i, ground_callsign_buf, LEN_GROUND_CALLSIGN);
+			i += LEN_GROUND_CALLSIGN;
+		} else if (r < 4) {
+			stream[i++] = rand() % 256;
+		} else {
+			stream[i++] = noise_chars[rand() % (sizeof(noise_chars) - 1)];
+		}
+	}
+}
+
+// the command the last PATTERN_LEN bytes of stream[0..end] spell, if any
+static rx_cmd_type_t stream_match_ending_at(int end) {
+	if (end < PATTERN_LEN - 1) {
+		return CMD_NONE;
+	}
+	const uint8_t* p = stream + end - PATTERN_LEN + 1;
+	if (memcmp(p, ground_callsign_buf, LEN_GROUND_CALLSIGN) != 0) {
+		return CMD_NONE;
+	}
+	for (uint8_t c = 0; c < NUM_CMDS; c++) {
+		if (memcmp(p + LEN_GROUND_CALLSIGN, cmd_bufs[c], LEN_UPLINK_BUF) == 0) {
+			return cmd_types[c];
+		}
+	}
+	return CMD_NONE;
+}
+
+/************************************************************************/
+/* TESTS                                                                */
+/************************************************************************/
+void rx_matcher_fuzz_test(void) {
+	uint32_t uplinks = 0, old_missed = 0, old_spliced = 0, old_repeats = 0;
+
+	bool built = init_uplink_matcher(&test_matcher);
+	test_check(built);
+	srand(RX_FUZZ_SEED);
+
+	for (int s = 0; s < RX_FUZZ_STREAMS; s++) {
+		fill_noisy_stream();
+		rx_matcher_reset(&test_matcher);
+		ring_clear();
+
+		for (int i = 0; i < RX_FUZZ_STREAM_LEN; i++) {
+			uint8_t written = ring_index;
+			ring_put(stream[i]);
+			rx_cmd_type_t expected = stream_match_ending_at(i);
+			uint8_t matched = rx_matcher_step(&test_matcher, stream[i]);
+			rx_cmd_type_t got = matched;
+			test_check(got == expected);
+			if (expected != CMD_NONE) {
+				uplinks++;
+			}
+
+			// the window ending at the byte just written, if it doesn't cross the end
+			// (ring_put never writes the last index, so a window through it can't match)
+			bool window_in_ring = written >= PATTERN_LEN - 1;
+			if (window_in_ring) {
+				test_check(legacy_match_at(written - PATTERN_LEN + 1) == expected);
+			} else if (expected != CMD_NONE) {
+				old_missed++;
+			}
+
+			// anything else the old matcher would have reported on this byte
+			for (uint8_t w = 0; w < LEN_RECEIVEBUFFER; w++) {
+				if ((!window_in_ring || w != written - PATTERN_LEN + 1) && legacy_match_at(w) != CMD_NONE) {
+					// windows holding the byte just written are spliced from new and old bytes
+					bool holds_new_byte = ((written - w + LEN_RECEIVEBUFFER) % LEN_RECEIVEBUFFER) < PATTERN_LEN;
+					if (holds_new_byte) {
+						old_spliced++;
+					} else {
+						old_repeats++;
+					}
+				}
+			}
+		}
+	}
+
+	print("rx matcher fuzz: %d bytes, %d uplinks; old matcher missed %d, spliced %d, repeated %d\n",
+		RX_FUZZ_STREAMS * RX_FUZZ_STREAM_LEN, uplinks, old_missed, old_spliced, old_repeats);
+	test_check(uplinks > 0);
+}
+
+void benchmark_rx_matcher(void) {
+	uint32_t start, old_cycles = 0, new_cycles = 0;
+	volatile rx_cmd_type_t sink;
+
+	bool built = init_uplink_matcher(&test_matcher);
+	test_check(built);
+	srand(RX_FUZZ_SEED);
+	fill_noisy_stream();
+	rx_matcher_reset(&test_matcher);
+	ring_clear();
+	cycle_count_start();
+
+	for (int i = 0; i < RX_FUZZ_STREAM_LEN; i++) {
+		start = cycle_count_now();
+		ring_put(stream[i]);
+		sink = legacy_check_rx();
+		old_cycles += cycle_count_since(start);
+
+		start = cycle_count_now();
+		uint8_t matched = rx_matcher_step(&test_matcher, stream[i]);
+		sink = matched;
+		new_cycles += cycle_count_since(start);
+	}
+	cycle_count_stop();
+	(void) sink;
+
+	print("rx matcher per byte: rescan %d cycles, streaming %d cycles\n",
+		old_cycles / RX_FUZZ_STREAM_LEN, new_cycles / RX_FUZZ_STREAM_LEN);
+}
@@ -0,0 +1,24 @@
+/*
+ * rx_matcher_tests.h
+ *
+ * Created: 10/18/2026 10:41:19 PM
+ *  Author: BSE
+ */
+
+
+#ifndef RX_MATCHER_TESTS_H_
+#define RX_MATCHER_TESTS_H_
+
+#include <global.h>
+#include "../telemetry/uplink_commands.h"
+#include "cycle_count.h"
+#include "test_check.h"
+
+#define RX_FUZZ_STREAMS				200
+#define RX_FUZZ_STREAM_LEN			400
+#define RX_FUZZ_SEED				0xEC5A7
+
+void rx_matcher_fuzz_test(void);
+void benchmark_rx_matcher(void);
+
+#endif /* RX_MATCHER_TESTS_H_ */
@@ -49,6 +49,8 @@ void populate_equistacks(void) {
 	populate_equistack(&flash_readings_equistack);
 	populate_equistack(&flash_cmp_readings_equistack);
 	populate_equistack(&low_power_readings_equistack);
+	populate_equistack(&runtime_stats_equistack);
+	populate_equistack(&mutex_stats_equistack);
 }
 
 void clear_equistacks(void) {
@@ -57,6 +59,8 @@ void clear_equistacks(void) {
 	__equistack_Clear(&flash_readings_equistack);
 	__equistack_Clear(&flash_cmp_readings_equistack);
 	__equistack_Clear(&low_power_readings_equistack);
+	__equistack_Clear(&runtime_stats_equistack);
+	__equistack_Clear(&mutex_stats_equistack);
 }
 
 // fills all data equistacks and then tests packaging that data
@@ -72,6 +76,8 @@ void test_message_packaging(void) {
 	write_packet(msg_buffer, FLASH_DATA, current_timestamp, cur_data_buf);
 	write_packet(msg_buffer, FLASH_CMP_DATA, current_timestamp, cur_data_buf);
 	write_packet(msg_buffer, LOW_POWER_DATA, current_timestamp, cur_data_buf);
+	write_packet(msg_buffer, RUNTIME_STATS_DATA, current_timestamp, cur_data_buf);
+	write_packet(msg_buffer, MUTEX_STATS_DATA, current_timestamp, cur_data_buf);
 }
 
 void stress_test_message_packaging(void) {
@@ -89,6 +95,8 @@ void stress_test_message_packaging(void) {
 	write_packet(msg_buffer, FLASH_DATA, current_timestamp, cur_data_buf);
 	write_packet(msg_buffer, FLASH_CMP_DATA, current_timestamp, cur_data_buf);
 	write_packet(msg_buffer, LOW_POWER_DATA, current_timestamp, cur_data_buf);
+	write_packet(msg_buffer, RUNTIME_STATS_DATA, current_timestamp, cur_data_buf);
+	write_packet(msg_buffer, MUTEX_STATS_DATA, current_timestamp, cur_data_buf);
 }
 
 static void print_transmission_info(msg_data_type_t type, uint32_t current_timestamp, uint8_t* cur_data_buf) {
@@ -115,6 +123,12 @@ static void print_transmission_info(msg_data_type_t type, uint32_t current_times
 		case LOW_POWER_DATA:
 			print_equistack(&low_power_readings_equistack,	print_low_power_data,	"Low Power Data Stack", -1);
 			return;
+		case RUNTIME_STATS_DATA:
+			print_equistack(&runtime_stats_equistack,		print_runtime_stats_data,	"Run Time Stats Stack", -1);
+			return;
+		case MUTEX_STATS_DATA:
+			print_equistack(&mutex_stats_equistack,		print_mutex_stats_data,		"Mutex Stats Stack", -1);
+			return;
 		default: return;
 	}
 }
@@ -146,6 +160,8 @@ void print_sample_transmissions(void) {
 	generate_print_sample_transmission(FLASH_DATA, current_timestamp, cur_data_buf);
 	generate_print_sample_transmission(FLASH_CMP_DATA, current_timestamp, cur_data_buf);
 	generate_print_sample_transmission(LOW_POWER_DATA, current_timestamp, cur_data_buf);
+	generate_print_sample_transmission(RUNTIME_STATS_DATA, current_timestamp, cur_data_buf);
+	generate_print_sample_transmission(MUTEX_STATS_DATA, current_timestamp, cur_data_buf);
 	suppress_other_prints(false);
 }
 
@@ -0,0 +1,135 @@
+/*
+ * sensor_transaction_tests.c
+ *
+ * Created: 10/18/2026 5:02:30 PM
+ *  Author: BSE
+ *
+ * Compares the idle and attitude data reads done with the separately-locking
+ * read_*_batch functions against the same reads done in sensor transactions:
+ * number of hardware mutex acquisitions and total time.
+ * Must run with the RTOS started (call from run_rtos_tests()), and with the
+ * other sensor-reading tasks suspended (OVERRIDE_INIT_TASK_STATES) so the
+ * lock counts aren't mixed with theirs.
+ */
+
+#include "sensor_transaction_tests.h"
+
+static idle_data_t test_idle;
+static attitude_data_t test_attitude;
+static sensor_transaction_t test_txn;
+
+static uint32_t locks_since(sensor_lock_counts_t* before) {
+	sensor_lock_counts_t now;
+	get_sensor_lock_counts(&now);
+	return (now.i2c_irpow - before->i2c_irpow) + (now.processor_adc - before->processor_adc);
+}
+
+static void read_idle_separately(void) {
+	read_lion_volts_batch(			test_idle.lion_volts_data);
+	bool got_semaphore = enable_ir_pow_if_necessary();
+	en_and_read_lion_temps_batch(	test_idle.lion_temps_data);
+	read_ad7991_batbrd(				test_idle.lion_current_data, test_idle.panelref_lref_data);
+	read_bat_charge_dig_sigs_batch(	&(test_idle.bat_charge_dig_sigs_data));
+	read_imu_temp_batch(			&(test_idle.imu_temp_data));
+	read_radio_temp_batch(			&(test_idle.radio_temp_data));
+	read_ir_ambient_temps_batch(	test_idle.ir_amb_temps_data);
+	verify_regulators();
+	verify_flash_readings(false);
+	disable_ir_pow_if_necessary(got_semaphore);
+}
+
+static void read_idle_txn(void) {
+	sensor_txn_begin(&test_txn);
+	sensor_txn_add(&test_txn, SR_LION_VOLTS,			test_idle.lion_volts_data, NULL);
+	sensor_txn_add(&test_txn, SR_LION_TEMPS,			test_idle.lion_temps_data, NULL);
+	sensor_txn_add(&test_txn, SR_AD7991_BATBRD,		test_idle.lion_current_data, test_idle.panelref_lref_data);
+	sensor_txn_add(&test_txn, SR_BAT_CHARGE_DIG_SIGS,	&(test_idle.bat_charge_dig_sigs_data), NULL);
+	sensor_txn_add(&test_txn, SR_IMU_TEMP,				&(test_idle.imu_temp_data), NULL);
+	sensor_txn_add(&test_txn, SR_RADIO_TEMP,			&(test_idle.radio_temp_data), NULL);
+	sensor_txn_add(&test_txn, SR_IR_AMBIENT_TEMPS,		test_idle.ir_amb_temps_data, NULL);
+	sensor_txn_add(&test_txn, SR_VERIFY_FLASH_READINGS, NULL, NULL);
+	bool ran = sensor_txn_run(&test_txn, ELOC_IDLE_DATA);
+	test_check(ran);
+	verify_regulators();
+}
+
+static void read_attitude_separately(void) {
+	bool got_semaphore = enable_ir_pow_if_necessary();
+	read_ir_object_temps_batch(	test_attitude.ir_obj_temps_data);
+	read_pdiode_batch(			&(test_attitude.pdiode_data));
+	read_gyro_batch(			test_attitude.gyro_data);
+	read_accel_batch(			test_attitude.accelerometer_data[0]);
+	read_magnetometer_batch(	test_attitude.magnetometer_data[0]);
+	read_accel_batch(			test_attitude.accelerometer_data[1]);
+	read_magnetometer_batch(	test_attitude.magnetometer_data[1]);
+	disable_ir_pow_if_necessary(got_semaphore);
+}
+
+static void read_attitude_txn(void) {
+	bool got_semaphore = enable_ir_pow_if_necessary();
+	sensor_txn_begin(&test_txn);
+	sensor_txn_add(&test_txn, SR_IR_OBJECT_TEMPS,	test_attitude.ir_obj_temps_data, NULL);
+	sensor_txn_add(&test_txn, SR_PDIODE,			&(test_attitude.pdiode_data), NULL);
+	sensor_txn_add(&test_txn, SR_GYRO,				test_attitude.gyro_data, NULL);
+	sensor_txn_add(&test_txn, SR_ACCEL,			test_attitude.accelerometer_data[0], NULL);
+	sensor_txn_add(&test_txn, SR_MAGNETOMETER,		test_attitude.magnetometer_data[0], NULL);
+	bool ran = sensor_txn_run(&test_txn, ELOC_ATTITUDE_DATA);
+	test_check(ran);
+	sensor_txn_begin(&test_txn);
+	sensor_txn_add(&test_txn, SR_ACCEL,			test_attitude.accelerometer_data[1], NULL);
+	sensor_txn_add(&test_txn, SR_MAGNETOMETER,		test_attitude.magnetometer_data[1], NULL);
+	ran = sensor_txn_run(&test_txn, ELOC_ATTITUDE_DATA);
+	test_check(ran);
+	disable_ir_pow_if_necessary(got_semaphore);
+}
+
+static void print_txn_timing(void) {
+	for (int i = 0; i < test_txn.num_reads; i++) {
+		print("\tread %d (type %d): %d ms\n", i, test_txn.reads[i].type, test_txn.reads[i].duration_ms);
+	}
+	print("\tlocking: %d ms, total: %d ms\n", test_txn.lock_wait_ms, test_txn.total_ms);
+}
+
+void sensor_transaction_test(void) {
+	sensor_lock_counts_t before;
+	TickType_t start;
+	uint32_t locks_separate, locks_txn;
+	TickType_t time_separate, time_txn;
+
+	/* idle data */
+	get_sensor_lock_counts(&before);
+	start = xTaskGetTickCount();
+	read_idle_separately();
+	time_separate = xTaskGetTickCount() - start;
+	locks_separate = locks_since(&before);
+
+	get_sensor_lock_counts(&before);
+	start = xTaskGetTickCount();
+	read_idle_txn();
+	time_txn = xTaskGetTickCount() - start;
+	locks_txn = locks_since(&before);
+
+	print("idle data: separate: %d locks, %d ms; transaction: %d locks, %d ms\n",
+		locks_separate, time_separate, locks_txn, time_txn);
+	print_txn_timing();
+	test_check(locks_separate == IDLE_DATA_SEPARATE_LOCKS);
+	test_check(locks_txn == 2);
+
+	/* attitude data (without the delay between samples, which is the same either way) */
+	get_sensor_lock_counts(&before);
+	start = xTaskGetTickCount();
+	read_attitude_separately();
+	time_separate = xTaskGetTickCount() - start;
+	locks_separate = locks_since(&before);
+
+	get_sensor_lock_counts(&before);
+	start = xTaskGetTickCount();
+	read_attitude_txn();
+	time_txn = xTaskGetTickCount() - start;
+	locks_txn = locks_since(&before);
+
+	print("attitude data: separate: %d locks, %d ms; transaction: %d locks, %d ms\n",
+		locks_separate, time_separate, locks_txn, time_txn);
+	test_check(locks_separate == ATTITUDE_DATA_SEPARATE_LOCKS);
+	test_check(locks_txn == 3);
+}
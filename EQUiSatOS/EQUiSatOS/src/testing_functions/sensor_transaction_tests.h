@@ -0,0 +1,23 @@
+/*
+ * sensor_transaction_tests.h
+ *
+ * Created: 10/18/2026 5:02:11 PM
+ *  Author: BSE
+ */
+
+
+#ifndef SENSOR_TRANSACTION_TESTS_H_
+#define SENSOR_TRANSACTION_TESTS_H_
+
+#include <global.h>
+#include "../sensor_drivers/sensor_transaction.h"
+#include "../data_handling/State_Structs.h"
+#include "test_check.h"
+
+// lock acquisitions (i2c_irpow + processor_adc) needed by the old per-read functions
+#define IDLE_DATA_SEPARATE_LOCKS		10
+#define ATTITUDE_DATA_SEPARATE_LOCKS	8
+
+void sensor_transaction_test(void);
+
+#endif /* SENSOR_TRANSACTION_TESTS_H_ */
@@ -0,0 +1,366 @@
+/*
+ * task_transition_tests.c
+ *
+ * Created: 10/19/2026 5:40:31 PM
+ *  Author: BSE
+ *
+ * task_transition_test checks the safe point bookkeeping (task_transitions.c):
+ *	- only tasks at safe points count as safe to suspend
+ *	- tasks asked by a state change acknowledge once, at their next safe point
+ *	  (even if they were at one when asked), and others never do
+ * task_transition_latency_test simulates state changes at random times, with
+ * the tasks at random phases, both the way they used to be done (taking every
+ * mutex in order, waiting up to 4 s for each and starting over on a timeout)
+ * and at safe points, and prints the distributions of how long each change
+ * took and how long the other tasks were held up waiting on mutexes the
+ * change held, and how many changes suspended a task partway through a run
+ * (with the IR power on, say, or in the middle of a transmission). What the tasks hold, and for how long, is a rough model of the
+ * flight tasks (below).
+ * Both only use task_transitions.c, so they run before the RTOS (from run_tests()) or on a host.
+ */
+
+#include "task_transition_tests.h"
+#include <stdlib.h>
+
+static task_transitions_t tt;
+
+/************************************************************************/
+/* PROTOCOL RULES                                                       */
+/************************************************************************/
+void task_transition_test(void) {
+	uint32_t both = TASK_TRANSITIONS_BIT(2) | TASK_TRANSITIONS_BIT(5);
+	bool acked;
+	task_transitions_init(&tt);
+	// nothing's at a safe point yet
+	test_check(task_transitions_unsafe(&tt, both) == both);
+	// a task between runs can be suspended, and doesn't acknowledge with no change pending
+	acked = task_transitions_enter_safe_point(&tt, 2);
+	test_check(!acked);
+	test_check(task_transitions_unsafe(&tt, both) == TASK_TRANSITIONS_BIT(5));
+	// a change asks both; the one at a safe point may still leave it before the change is made
+	task_transitions_request(&tt, both);
+	task_transitions_leave_safe_point(&tt, 2);
+	test_check(task_transitions_unsafe(&tt, both) == both);
+	// each acknowledges (once) on getting to its next one
+	acked = task_transitions_enter_safe_point(&tt, 5);
+	test_check(acked);
+	test_check(task_transitions_unsafe(&tt, both) == TASK_TRANSITIONS_BIT(2));
+	acked = task_transitions_enter_safe_point(&tt, 2);
+	test_check(acked);
+	test_check(task_transitions_unsafe(&tt, both) == 0);
+	task_transitions_leave_safe_point(&tt, 5);
+	acked = task_transitions_enter_safe_point(&tt, 5);
+	test_check(!acked);
+	// tasks it didn't ask don't
+	acked = task_transitions_enter_safe_point(&tt, 3);
+	test_check(!acked);
+	// and once the change is made, nothing does
+	task_transitions_request(&tt, TASK_TRANSITIONS_BIT(7));
+	task_transitions_finish(&tt);
+	acked = task_transitions_enter_safe_point(&tt, 7);
+	test_check(!acked);
+	print("task transition tests passed\n");
+}
+
+/************************************************************************/
+/* LATENCY SIMULATION                                                   */
+/************************************************************************/
+// the mutexes the tasks hold, in the order state changes take them
+// (all_mutexes_ordered, with the equistack ones lumped together)
+enum { SIM_CRITICAL, SIM_I2C, SIM_ADC, SIM_HW_STATE, SIM_MRAM, SIM_EQUISTACKS, SIM_MUTEXES };
+#define SIM_NONE		-1
+#define SIM_SAFE		-2	// holding nothing, at a safe point (partway through a run)
+#define SIM_FREE		-1
+#define SIM_CHANGER		100
+
+#define SIM_MAX_STEPS	5
+
+typedef struct {
+	int8_t mutex;	// held through the step (SIM_NONE or SIM_SAFE for none)
+	uint32_t ms;	// (0 ends the run)
+} sim_step_t;
+
+typedef struct {
+	uint32_t period_ms;
+	uint32_t low_power_period_ms;
+	sim_step_t steps[SIM_MAX_STEPS];
+} sim_task_t;
+
+// roughly what each task holds through a run (the flight periods, restated to run on a host)
+enum { SIM_WATCHDOG, SIM_BATTERY, SIM_TRANSMIT, SIM_FLASH, SIM_IDLE, SIM_LOW_POWER, SIM_ATTITUDE, SIM_BACKUP, SIM_TASKS };
+static const sim_task_t sim_tasks[SIM_TASKS] = {
+	{1500,		1500,		{{SIM_NONE, 1}}},
+	{9*60000,	9*60000,	{{SIM_I2C, 150}, {SIM_ADC, 50}, {SIM_HW_STATE, 5}}},
+	// (transmitting holds the critical action mutex; most of the rest is the RX window, waiting on uplinks)
+	{20000,		40000,		{{SIM_HW_STATE, 5}, {SIM_CRITICAL, 2500}, {SIM_MRAM, 20}, {SIM_SAFE, 15000}, {SIM_HW_STATE, 5}}},
+	{60000,		60000,		{{SIM_HW_STATE, 5}, {SIM_CRITICAL, 1200}, {SIM_EQUISTACKS, 2}}},
+	// (IR power coming on, then the reads)
+	{3*60000,	3*60000,	{{SIM_NONE, 400}, {SIM_I2C, 400}, {SIM_ADC, 30}, {SIM_EQUISTACKS, 2}}},
+	{2*60000,	2*60000,	{{SIM_NONE, 400}, {SIM_I2C, 600}, {SIM_ADC, 30}, {SIM_EQUISTACKS, 2}}},
+	{4*60000,	4*60000,	{{SIM_I2C, 150}, {SIM_NONE, 500}, {SIM_I2C, 150}, {SIM_EQUISTACKS, 2}}},
+	{60000,		60000,		{{SIM_MRAM, 80}}},
+};
+
+typedef struct {
+	const char* name;
+	bool low_power;
+	uint32_t running;		// tasks running before the change
+	uint32_t to_suspend;	// those it suspends
+} sim_scenario_t;
+
+#define SIM_BIT(task)	TASK_TRANSITIONS_BIT(task)
+#define SIM_ALWAYS		(SIM_BIT(SIM_WATCHDOG) | SIM_BIT(SIM_BATTERY) | SIM_BIT(SIM_BACKUP))
+#define SIM_IDLE_FLASH	(SIM_ALWAYS | SIM_BIT(SIM_TRANSMIT) | SIM_BIT(SIM_FLASH) | SIM_BIT(SIM_IDLE) | SIM_BIT(SIM_ATTITUDE))
+#define SIM_LOW_POWER_S	(SIM_ALWAYS | SIM_BIT(SIM_TRANSMIT) | SIM_BIT(SIM_LOW_POWER))
+
+static const sim_scenario_t sim_scenarios[] = {
+	{"IDLE_FLASH -> LOW_POWER",		false,	SIM_IDLE_FLASH,
+		SIM_BIT(SIM_FLASH) | SIM_BIT(SIM_IDLE) | SIM_BIT(SIM_ATTITUDE)},
+	{"IDLE_FLASH -> IDLE_NO_FLASH",	false,	SIM_IDLE_FLASH,		SIM_BIT(SIM_FLASH)},
+	{"LOW_POWER -> IDLE_NO_FLASH",	true,	SIM_LOW_POWER_S,	SIM_BIT(SIM_LOW_POWER)},
+	{"LOW_POWER -> ANTENNA_DEPLOY",	true,	SIM_LOW_POWER_S,
+		SIM_BIT(SIM_TRANSMIT) | SIM_BIT(SIM_LOW_POWER)},
+};
+#define SIM_SCENARIOS	(sizeof(sim_scenarios) / sizeof(sim_scenario_t))
+
+typedef struct {
+	bool in_run;
+	uint8_t step;
+	uint32_t left;		// ms left in the step
+	bool holding;		// the step's mutex
+	uint32_t next_start;
+} sim_run_t;
+
+typedef struct {
+	uint32_t latency_ms;	// from the change starting to it being made
+	uint32_t stall_ms;		// time other tasks spent waiting on mutexes the change held
+	bool gave_up;			// the change went ahead without everything it waited for
+							// (at safe points, took the mutexes of tasks that didn't get to one)
+	bool cut_off;			// a task was suspended partway through a run
+} sim_result_t;
+
+static sim_run_t runs[SIM_TASKS];
+static int8_t owners[SIM_MUTEXES];
+static uint32_t sim_seed;
+static uint32_t latencies[TASK_TRANSITION_TEST_TRIALS];
+static uint32_t stalls[TASK_TRANSITION_TEST_TRIALS];
+
+static uint32_t sim_rand(uint32_t below) {
+	sim_seed = sim_seed * 1103515245 + 12345;
+	return (sim_seed >> 8) % below;
+}
+
+static uint32_t sim_period(const sim_scenario_t* sc, int task) {
+	return sc->low_power ? sim_tasks[task].low_power_period_ms : sim_tasks[task].period_ms;
+}
+
+static void sim_trial(const sim_scenario_t* sc, bool safe_points, uint32_t seed, sim_result_t* r) {
+	sim_seed = seed;
+	memset(runs, 0, sizeof(runs));
+	memset(r, 0, sizeof(sim_result_t));
+	for (int m = 0; m < SIM_MUTEXES; m++) {
+		owners[m] = SIM_FREE;
+	}
+	task_transitions_init(&tt);
+	for (int i = 0; i < SIM_TASKS; i++) {
+		runs[i].next_start = sim_rand(sim_period(sc, i));
+		task_transitions_enter_safe_point(&tt, i);
+	}
+
+	// (late enough that the tasks have settled into their phases)
+	uint32_t trigger = 30000 + sim_rand(60000);
+	bool changing = false;
+	uint32_t change_start = 0;
+	uint8_t target = 0;				// next mutex to take (taking them all)
+	uint32_t target_since = 0;
+	uint8_t retries = 0;
+
+	for (uint32_t t = 0; ; ) {
+		// finished steps give up their mutex; finished runs wait for their next
+		for (int i = 0; i < SIM_TASKS; i++) {
+			sim_run_t* run = &runs[i];
+			if (!run->in_run || run->left > 0) {
+				continue;
+			}
+			if (run->holding) {
+				owners[sim_tasks[i].steps[run->step].mutex] = SIM_FREE;
+				run->holding = false;
+			}
+			if (sim_tasks[i].steps[run->step].mutex == SIM_SAFE) {
+				task_transitions_leave_safe_point(&tt, i);
+			}
+			run->step++;
+			if (run->step == SIM_MAX_STEPS || sim_tasks[i].steps[run->step].ms == 0) {
+				run->in_run = false;
+				run->next_start += sim_period(sc, i);
+				task_transitions_enter_safe_point(&tt, i);
+			} else {
+				run->left = sim_tasks[i].steps[run->step].ms;
+				if (sim_tasks[i].steps[run->step].mutex == SIM_SAFE) {
+					task_transitions_enter_safe_point(&tt, i);
+				}
+			}
+		}
+		// due runs start
+		for (int i = 0; i < SIM_TASKS; i++) {
+			sim_run_t* run = &runs[i];
+			if ((sc->running & SIM_BIT(i)) && !run->in_run && (int32_t) (t - run->next_start) >= 0) {
+				run->in_run = true;
+				run->step = 0;
+				run->left = sim_tasks[i].steps[0].ms;
+				if (sim_tasks[i].steps[0].mutex != SIM_SAFE) {
+					task_transitions_leave_safe_point(&tt, i);
+				}
+			}
+		}
+
+		// the state change (higher priority than the tasks, so it gets mutexes first)
+		if (!changing && t >= trigger) {
+			changing = true;
+			change_start = t;
+			target_since = t;
+			task_transitions_request(&tt, sc->to_suspend);
+		}
+		if (changing) {
+			bool done = false;
+			if (safe_points) {
+				uint32_t late = task_transitions_unsafe(&tt, sc->to_suspend);
+				if (late == 0) {
+					done = true;
+				} else if (t - change_start >= TASK_TRANSITION_TEST_SAFE_WAIT_MS) {
+					// go ahead once the late tasks hold no mutexes
+					// (taking each they hold as it's given up; none are held long enough to matter)
+					r->gave_up = true;
+					done = true;
+					for (int m = 0; m < SIM_MUTEXES; m++) {
+						if (owners[m] >= 0 && owners[m] < SIM_TASKS && (late & SIM_BIT(owners[m]))) {
+							done = false;
+						}
+					}
+				}
+			} else {
+				while (target < SIM_MUTEXES && owners[target] == SIM_FREE) {
+					owners[target++] = SIM_CHANGER;
+					target_since = t;
+				}
+				if (target == SIM_MUTEXES) {
+					done = true;
+				} else if (t - target_since >= TASK_TRANSITION_TEST_MUTEX_WAIT_MS) {
+					// give back what we got and start over
+					while (target > 0) {
+						owners[--target] = SIM_FREE;
+					}
+					target_since = t;
+					if (++retries >= TASK_TRANSITION_TEST_RETRIES) {
+						r->gave_up = done = true;
+					}
+				}
+			}
+			if (done) {
+				for (int i = 0; i < SIM_TASKS; i++) {
+					if ((sc->to_suspend & SIM_BIT(i)) && runs[i].in_run
+						&& sim_tasks[i].steps[runs[i].step].mutex != SIM_SAFE) {
+						r->cut_off = true;
+					}
+				}
+				r->latency_ms = t - change_start;
+				return;
+			}
+		}
+
+		// waiting tasks take free mutexes
+		for (int i = 0; i < SIM_TASKS; i++) {
+			sim_run_t* run = &runs[i];
+			if (!run->in_run) {
+				continue;
+			}
+			int8_t m = sim_tasks[i].steps[run->step].mutex;
+			if (m >= 0 && !run->holding && owners[m] == SIM_FREE) {
+				owners[m] = i;
+				run->holding = true;
+			}
+		}
+
+		// on to the next thing that happens
+		uint32_t dt = UINT32_MAX;
+		for (int i = 0; i < SIM_TASKS; i++) {
+			sim_run_t* run = &runs[i];
+			if (!(sc->running & SIM_BIT(i))) {
+				continue;
+			}
+			if (!run->in_run) {
+				dt = min(dt, run->next_start - t);
+			} else if (sim_tasks[i].steps[run->step].mutex < 0 || run->holding) {
+				dt = min(dt, run->left);
+			}
+		}
+		if (!changing) {
+			dt = min(dt, trigger - t);
+		} else if (safe_points) {
+			if (!r->gave_up) {
+				dt = min(dt, change_start + TASK_TRANSITION_TEST_SAFE_WAIT_MS - t);
+			}
+		} else {
+			dt = min(dt, target_since + TASK_TRANSITION_TEST_MUTEX_WAIT_MS - t);
+		}
+		test_check(dt > 0 && dt != UINT32_MAX);
+
+		for (int i = 0; i < SIM_TASKS; i++) {
+			sim_run_t* run = &runs[i];
+			if (!run->in_run) {
+				continue;
+			}
+			int8_t m = sim_tasks[i].steps[run->step].mutex;
+			if (m < 0 || run->holding) {
+				run->left -= dt;
+			} else if (owners[m] == SIM_CHANGER) {
+				r->stall_ms += dt;
+			}
+		}
+		t += dt;
+	}
+}
+
+static int compare_ms(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+	return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(const uint32_t* sorted, int pct) {
+	return sorted[(TASK_TRANSITION_TEST_TRIALS - 1) * pct / 100];
+}
+
+static void run_scenario(const sim_scenario_t* sc, bool safe_points) {
+	int gave_up = 0, cut_off = 0;
+	for (int trial = 0; trial < TASK_TRANSITION_TEST_TRIALS; trial++) {
+		sim_result_t r;
+		// (the same phasing for both ways)
+		sim_trial(sc, safe_points, 1 + trial * 7919, &r);
+		latencies[trial] = r.latency_ms;
+		stalls[trial] = r.stall_ms;
+		gave_up += r.gave_up;
+		cut_off += r.cut_off;
+		if (safe_points) {
+			// nothing waits on a change made at safe points, and it only stops a task
+			// partway through a run (never holding a mutex) if the task doesn't get to one in time
+			test_check(r.stall_ms == 0 && (r.gave_up || !r.cut_off));
+		}
+	}
+	qsort(latencies, TASK_TRANSITION_TEST_TRIALS, sizeof(uint32_t), compare_ms);
+	qsort(stalls, TASK_TRANSITION_TEST_TRIALS, sizeof(uint32_t), compare_ms);
+	print("  %-18s latency p50 %5d / p90 %5d / p99 %5d / max %5d ms | others held up p50 %5d / p90 %5d / max %5d ms | gave up %d, cut off a run %d\n",
+		safe_points ? "at safe points:" : "taking all mutexes:",
+		(int) percentile(latencies, 50), (int) percentile(latencies, 90),
+		(int) percentile(latencies, 99), (int) latencies[TASK_TRANSITION_TEST_TRIALS - 1],
+		(int) percentile(stalls, 50), (int) percentile(stalls, 90),
+		(int) stalls[TASK_TRANSITION_TEST_TRIALS - 1], gave_up, cut_off);
+}
+
+void task_transition_latency_test(void) {
+	for (unsigned s = 0; s < SIM_SCENARIOS; s++) {
+		print("%s (%d changes):\n", sim_scenarios[s].name, TASK_TRANSITION_TEST_TRIALS);
+		run_scenario(&sim_scenarios[s], false);
+		run_scenario(&sim_scenarios[s], true);
+	}
+	print("task transition latency test done\n");
+}
@@ -0,0 +1,26 @@
+/*
+ * task_transition_tests.h
+ *
+ * Created: 10/19/2026 5:40:08 PM
+ *  Author: BSE
+ */
+
+
+#ifndef TASK_TRANSITION_TESTS_H_
+#define TASK_TRANSITION_TESTS_H_
+
+#include <global.h>
+#include "../runnable_configurations/task_transitions.h"
+#include "test_check.h"
+
+// state changes simulated (each at a random time, with random task phasing) per scenario
+#define TASK_TRANSITION_TEST_TRIALS			500
+// (the flight TASK_STATE_CHANGE_* settings)
+#define TASK_TRANSITION_TEST_MUTEX_WAIT_MS	4000
+#define TASK_TRANSITION_TEST_RETRIES		10
+#define TASK_TRANSITION_TEST_SAFE_WAIT_MS	3000
+
+void task_transition_test(void);
+void task_transition_latency_test(void);
+
+#endif /* TASK_TRANSITION_TESTS_H_ */
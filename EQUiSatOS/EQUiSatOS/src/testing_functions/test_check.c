@@ -0,0 +1,20 @@
+/*
+ * test_check.c
+ *
+ * Created: 10/20/2026 10:12:58 AM
+ *  Author: BSE
+ */
+
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void test_check_failed(const char* file, int line, const char* cond) {
+	print("TEST FAILED %s:%d: %s\n", file, line, cond);
+	#ifdef __arm__
+	while (true) {}
+	#else
+	fflush(stdout);
+	abort();
+	#endif
+}
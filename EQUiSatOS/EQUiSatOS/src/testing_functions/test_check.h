@@ -0,0 +1,24 @@
+/*
+ * test_check.h
+ *
+ * test_check(cond) is assert() for the unit tests run from run_tests(), but it
+ * stays in with NDEBUG, which both build configurations define. A failed check
+ * prints where it was and what failed, then hangs there (as ASF's Assert does)
+ * so it can't be missed; on a host it aborts instead.
+ * Keep calls with side effects out of the condition all the same.
+ *
+ * Created: 10/20/2026 10:12:31 AM
+ *  Author: BSE
+ */
+
+
+#ifndef TEST_CHECK_H_
+#define TEST_CHECK_H_
+
+#include <global.h>
+
+#define test_check(cond)	((cond) ? (void) 0 : test_check_failed(__FILE__, __LINE__, #cond))
+
+void test_check_failed(const char* file, int line, const char* cond);
+
+#endif /* TEST_CHECK_H_ */
@@ -0,0 +1,92 @@
+/*
+ * tickless_tests.c
+ *
+ * Created: 10/19/2026 4:31:20 PM
+ *  Author: BSE
+ *
+ * tickless_test checks the tick correction after a tickless sleep (tickless_idle.h):
+ *	- sleeps are never longer than the time to the next task, or a watchdog period
+ *	- whole ticks slept are counted, and the rest carried into the next tick period
+ *	- waking late never steps the tick past the next task
+ *	- a simulated day of sleeps of assorted lengths (woken early now and then)
+ *	  keeps the tick count within TICKLESS_TEST_MAX_DRIFT_TICKS of true time
+ *	  (each sleep's cycles are rounded down, losing half a cycle every other one)
+ * It only uses tickless_idle.h, so it runs before the RTOS (from run_tests()) or on a host.
+ */
+
+#include "tickless_tests.h"
+
+static void check_sleep_lengths(void) {
+	// (no sleep when the next task is due next tick)
+	test_check(tickless_sleep_counts(1) == 0);
+	test_check(tickless_sleep_counts(11) == 10);
+	test_check(tickless_sleep_counts(1001) == TICKLESS_COUNTS_PER_S);
+	// never past the next task...
+	for (uint32_t idle = 2; idle < 3 * TICKLESS_MAX_SLEEP_TICKS; idle += 7) {
+		uint32_t counts = tickless_sleep_counts(idle);
+		test_check(counts * 1000 / TICKLESS_COUNTS_PER_S < idle);
+	}
+	// ...or a watchdog period
+	test_check(tickless_sleep_counts(60000) == tickless_sleep_counts(TICKLESS_MAX_SLEEP_TICKS));
+}
+
+static void check_corrections(void) {
+	uint32_t rest, slept;
+	// asleep for less than what's left of the tick period
+	slept = tickless_ticks_slept(100, 1, 9, &rest);
+	test_check(slept == 0);
+	test_check(rest == 100 + 7812);
+	// a second from the start of a tick period (1024 counts = 1000 ticks exactly)
+	slept = tickless_ticks_slept(0, TICKLESS_COUNTS_PER_S, 1499, &rest);
+	test_check(slept == 1000);
+	test_check(rest == 0);
+	// from partway through one, landing partway through another
+	slept = tickless_ticks_slept(6000, 1, 99, &rest);
+	test_check(slept == 1);
+	test_check(rest == 6000 + 7812 - TICKLESS_CYCLES_PER_TICK);
+	// landing right at the end of one still leaves the SysTick something to count
+	slept = tickless_ticks_slept(TICKLESS_CYCLES_PER_TICK - 1, 0, 9, &rest);
+	test_check(slept == 0);
+	test_check(rest == TICKLESS_CYCLES_PER_TICK - 2);
+	// waking late (the RTC compare missed) catches up to the next task and no further
+	slept = tickless_ticks_slept(0, 100000, 1499, &rest);
+	test_check(slept == 1499);
+	test_check(rest == TICKLESS_CYCLES_PER_TICK - 2);
+}
+
+static void check_drift(void) {
+	// sleeps of assorted lengths, some cut short; track true time in processor
+	// cycles and see the stepped ticks keep up with it
+	uint64_t cycles = 0;
+	uint64_t ticks = 0;
+	uint32_t in_tick = 0;
+	uint32_t seed = 12345;
+	while (ticks < TICKLESS_TEST_SIM_MS) {
+		seed = seed * 1103515245 + 12345;
+		uint32_t idle = 10 + (seed >> 16) % TICKLESS_MAX_SLEEP_TICKS;
+		uint32_t counts = tickless_sleep_counts(idle);
+		if ((seed >> 8) % 4 == 0) {
+			counts = (seed >> 4) % (counts + 1); // woken early
+		}
+		uint32_t rest;
+		uint32_t stepped = tickless_ticks_slept(in_tick, counts, idle - 1, &rest);
+		test_check(stepped <= idle - 1);
+		// (the RTC only counts whole counts, so true time is in half cycles)
+		cycles += (uint64_t) counts * TICKLESS_CYCLES_PER_2_COUNTS;
+		ticks += stepped;
+		in_tick = rest;
+
+		// a tick period runs out before the next sleep
+		ticks++;
+		cycles += 2 * (uint64_t) (TICKLESS_CYCLES_PER_TICK - in_tick);
+		in_tick = 0;
+		uint64_t true_ticks = cycles / (2 * TICKLESS_CYCLES_PER_TICK);
+		test_check(ticks <= true_ticks + 1 && true_ticks <= ticks + TICKLESS_TEST_MAX_DRIFT_TICKS);
+	}
+}
+
+void tickless_test(void) {
+	check_sleep_lengths();
+	check_corrections();
+	check_drift();
+}
@@ -0,0 +1,23 @@
+/*
+ * tickless_tests.h
+ *
+ * Created: 10/19/2026 4:31:02 PM
+ *  Author: BSE
+ */
+
+
+#ifndef TICKLESS_TESTS_H_
+#define TICKLESS_TESTS_H_
+
+#include <global.h>
+#include "../rtos_tasks/tickless_idle.h"
+#include "test_check.h"
+
+// simulated time the tick drift test sleeps through
+#define TICKLESS_TEST_SIM_MS		(24*60*60*1000)
+// how far behind true time the tick may get over that
+#define TICKLESS_TEST_MAX_DRIFT_TICKS	10
+
+void tickless_test(void);
+
+#endif /* TICKLESS_TESTS_H_ */
@@ -0,0 +1,148 @@
+/*
+ * trace_ring_tests.c
+ *
+ * Created: 10/19/2026 9:48:40 PM
+ *  Author: BSE
+ *
+ * trace_ring_test checks the trace ring (trace_ring.h):
+ *	- the records come back oldest first, before and after it wraps
+ *	- freezing adds the FROZEN record last and fills in the snapshot, and
+ *	  nothing's recorded (or frozen again) after
+ *	- the snapshot is the layout trace_convert.py reads (and fits one MRAM field)
+ *	- the format hash matches trace_convert.py's
+ * It only uses trace_ring.c, so it runs before the RTOS (from run_tests()) or on a host.
+ * benchmark_trace_ring times recording an event (before the scheduler starts;
+ * see cycle_count.h), and dump_trace_snapshot prints the one in MRAM for
+ * trace_convert.py (it takes the MRAM mutex, so run it from a task).
+ */
+
+#include "trace_ring_tests.h"
+
+static trace_snapshot_t test_ring;
+
+// the record the i'th one put in the ring gets
+static void check_record(const trace_record_t* r, uint16_t i) {
+	test_check(r->time_us == 1000UL * i);
+	test_check(r->task == i % 12);
+	test_check(r->event == TRACE_EV_SWITCHED_IN + i % TRACE_EV_PRINT);
+	test_check(r->arg == (uint16_t) (i * 7));
+}
+
+static void record(uint16_t i) {
+	trace_ring_record(&test_ring, 1000UL * i, i % 12, TRACE_EV_SWITCHED_IN + i % TRACE_EV_PRINT, i * 7);
+}
+
+void trace_ring_test(void) {
+	// (the layout trace_convert.py reads)
+	test_check(sizeof(trace_record_t) == 8);
+	test_check(sizeof(trace_snapshot_t) == 16 + 8 * TRACE_RING_LEN);
+	test_check(sizeof(trace_snapshot_t) <= STORAGE_MAX_FIELD_SIZE);
+
+	trace_ring_init(&test_ring);
+	test_check(test_ring.count == 0);
+	test_check(test_ring.reason == TRACE_NOT_FROZEN);
+
+	// filling up, then wrapping
+	for (uint16_t n = 0; n < TRACE_RING_TEST_RECORDS; n++) {
+		record(n);
+		uint16_t kept = n + 1 < TRACE_RING_LEN ? n + 1 : TRACE_RING_LEN;
+		test_check(test_ring.count == kept);
+		for (uint16_t i = 0; i < kept; i++) {
+			check_record(trace_ring_get(&test_ring, i), n + 1 - kept + i);
+		}
+	}
+
+	// freezing
+	uint16_t put = TRACE_RING_TEST_RECORDS;
+	bool froze;
+	froze = trace_ring_freeze(&test_ring, 1000UL * put, 3, TRACE_FROZEN_WATCHDOG, 123456, 9);
+	test_check(froze);
+	test_check(test_ring.magic == TRACE_SNAPSHOT_MAGIC);
+	test_check(test_ring.timestamp == 123456);
+	test_check(test_ring.reboot_count == 9);
+	test_check(test_ring.reason == TRACE_FROZEN_WATCHDOG);
+	const trace_record_t* last = trace_ring_get(&test_ring, TRACE_RING_LEN - 1);
+	test_check(last->event == TRACE_EV_FROZEN);
+	test_check(last->arg == TRACE_FROZEN_WATCHDOG);
+	test_check(last->task == 3);
+	test_check(last->time_us == 1000UL * put);
+
+	// nothing after (the first reason's kept)
+	trace_snapshot_t frozen = test_ring;
+	record(put + 1);
+	froze = trace_ring_freeze(&test_ring, 0, 0, TRACE_FROZEN_STACK_OVERFLOW, 0, 0);
+	test_check(!froze);
+	test_check(memcmp(&frozen, &test_ring, sizeof(trace_snapshot_t)) == 0);
+	for (uint16_t i = 0; i < TRACE_RING_LEN - 1; i++) {
+		check_record(trace_ring_get(&test_ring, i), put + 1 - TRACE_RING_LEN + i);
+	}
+
+	// freezing a ring that hasn't filled up
+	trace_ring_init(&test_ring);
+	record(0);
+	froze = trace_ring_freeze(&test_ring, 5, 1, TRACE_FROZEN_STACK_OVERFLOW, 0, 0);
+	test_check(froze);
+	test_check(test_ring.count == 2);
+	check_record(trace_ring_get(&test_ring, 0), 0);
+	test_check(trace_ring_get(&test_ring, 1)->event == TRACE_EV_FROZEN);
+
+	test_check(trace_ring_hash("transmitting...") == TRACE_RING_TEST_HASH);
+	test_check(trace_ring_hash("") == (uint16_t) ((2166136261UL >> 16) ^ 2166136261UL));
+	print("trace ring tests passed\n");
+}
+
+/************************************************************************/
+/* BENCHMARK                                                            */
+/************************************************************************/
+void benchmark_trace_ring(void) {
+	uint32_t start;
+	trace_ring_init(&test_ring);
+	cycle_count_start();
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < TRACE_RING_BENCH_ITERS; i++) {
+		trace_ring_record(&test_ring, i, 1, TRACE_EV_DELAY, i);
+	}
+	uint32_t recorded = cycle_count_since(start) / TRACE_RING_BENCH_ITERS;
+	print("trace_ring_record: %d cycles\n", recorded);
+
+	#ifdef TRACE_RING
+	// with the time, task and interrupt masking (what each hook costs)
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < TRACE_RING_BENCH_ITERS; i++) {
+		trace_ring_event(TRACE_EV_DELAY, i);
+	}
+	uint32_t event = cycle_count_since(start) / TRACE_RING_BENCH_ITERS;
+
+	start = cycle_count_now();
+	for (uint16_t i = 0; i < TRACE_RING_BENCH_ITERS; i++) {
+		trace_print("transmitting...");
+	}
+	uint32_t printed = cycle_count_since(start) / TRACE_RING_BENCH_ITERS;
+	print("trace_ring_event: %d cycles, trace_print: %d cycles\n", event, printed);
+	#endif
+	cycle_count_stop();
+}
+
+/************************************************************************/
+/* DUMP                                                                 */
+/************************************************************************/
+// (static, as it's more than the stack of most tasks)
+static trace_snapshot_t dump_snapshot;
+
+void dump_trace_snapshot(void) {
+	if (!read_trace_snapshot(&dump_snapshot)) {
+		print("no trace snapshot\n");
+		return;
+	}
+	const uint8_t* bytes = (const uint8_t*) &dump_snapshot;
+	for (uint16_t i = 0; i < sizeof(trace_snapshot_t); i++) {
+		if (i % TRACE_RING_DUMP_LINE == 0) {
+			print("TRACE");
+		}
+		print(" %02x", bytes[i]);
+		if (i % TRACE_RING_DUMP_LINE == TRACE_RING_DUMP_LINE - 1) {
+			print("\n");
+		}
+	}
+}
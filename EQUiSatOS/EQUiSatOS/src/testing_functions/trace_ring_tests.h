@@ -0,0 +1,31 @@
+/*
+ * trace_ring_tests.h
+ *
+ * Created: 10/19/2026 9:48:12 PM
+ *  Author: BSE
+ */
+
+
+#ifndef TRACE_RING_TESTS_H_
+#define TRACE_RING_TESTS_H_
+
+#include <global.h>
+#include "../data_handling/trace_ring.h"
+#include "../data_handling/persistent_storage.h"
+#include "cycle_count.h"
+#include "test_check.h"
+
+// records put through the ring in the test (so it wraps a few times)
+#define TRACE_RING_TEST_RECORDS			(3 * TRACE_RING_LEN + 5)
+// trace_ring_hash("transmitting...") (also from trace_convert.py's trace_hash)
+#define TRACE_RING_TEST_HASH			0x79f8
+
+#define TRACE_RING_BENCH_ITERS			256
+// snapshot bytes per line of dump_trace_snapshot
+#define TRACE_RING_DUMP_LINE			16
+
+void trace_ring_test(void);
+void benchmark_trace_ring(void);
+void dump_trace_snapshot(void);
+
+#endif /* TRACE_RING_TESTS_H_ */
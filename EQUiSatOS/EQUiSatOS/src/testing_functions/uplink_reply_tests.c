@@ -0,0 +1,284 @@
+/*
+ * uplink_reply_tests.c
+ *
+ * Created: 10/18/2026 11:46:52 PM
+ *  Author: BSE
+ *
+ * Replays captured uplink byte streams through the uplink matcher into a
+ * timing model of the transmit task (packet slots, RX window, cycle period
+ * from the real constants), once handling commands the old way (the task
+ * blocks through each command's delays and replies, leaving the rest in the
+ * RX queue) and once through the reply scheduler. For each it reports:
+ *	- the worst delay of a telemetry packet past its normal slot time
+ *	  (and separately the first packet of each cycle)
+ *	- the worst time from a command arriving to its first reply
+ *	- commands dropped (RX queue / reply queue full) or missed (not listening)
+ * (the radio temperature read is left out of both)
+ * Only models time (nothing is transmitted, no handlers run), so it can run
+ * before the RTOS (from run_tests()).
+ */
+
+#include "uplink_reply_tests.h"
+
+#define FOREVER			0xFFFFFFFF
+#define SLOT_MS			TOTAL_PACKET_TRANS_TIME_MS
+#define REPLY_TX_MS		TOTAL_TRANSMIT_TIME_MS(CMD_RESPONSE_SIZE) // transmit_buf_wait blocking time
+
+typedef struct {
+	const char* name;
+	const char* stream;		// as captured
+	uint32_t offset_ms;		// from the start of the RX window
+} uplink_scenario_t;
+
+static const uplink_scenario_t scenarios[] = {
+	{"single echo",				"K1ADEC",												100},
+	{"repeated flash",			"K1ADFLK1ADFLK1ADFL",									50},
+	{"noisy burst of five",		"zzK1AK1ADEC\x01\x7fK1ADFKK1xK1ADFR#K1ADRV..K1ADEC",	0},
+	{"late in window",			"K1ADFK..K1ADFR",										RX_READY_PERIOD_MS - 30},
+};
+#define NUM_SCENARIOS		(sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct {
+	uint32_t worst_packet_delay;
+	uint32_t worst_first_packet_delay;
+	uint32_t worst_reply_latency;
+	uint8_t dropped;
+	uint8_t missed;
+} uplink_result_t;
+
+static rx_matcher_t test_matcher;
+static uplink_reply_sched_t test_sched;
+
+// commands in the stream, and the time each finished arriving
+static rx_cmd_type_t arrival_cmds[UPLINK_TEST_MAX_CMDS];
+static uint32_t arrival_times[UPLINK_TEST_MAX_CMDS];
+static uint8_t num_arrivals;
+static uint8_t next_arrival;
+
+// old: the RX command queue (carries over between cycles)
+static rx_cmd_type_t rx_queue[RX_CMD_QUEUE_LEN];
+static uint32_t rx_queue_times[RX_CMD_QUEUE_LEN];
+static uint8_t rx_queue_head, rx_queue_count;
+
+// new: arrival times of the scheduled commands, and their replies yet to be sent (in order)
+static uint32_t sched_arrivals[UPLINK_REPLY_QUEUE_LEN];
+static uint8_t sched_replies_left[UPLINK_REPLY_QUEUE_LEN];
+static uint8_t sched_head, sched_count;
+
+static void replay_stream(const uplink_scenario_t* sc, uint32_t rx_start) {
+	num_arrivals = 0;
+	next_arrival = 0;
+	rx_matcher_reset(&test_matcher);
+	for (int i = 0; sc->stream[i] != '\0'; i++) {
+		uint8_t matched = rx_matcher_step(&test_matcher, sc->stream[i]);
+		rx_cmd_type_t cmd = matched;
+		if (cmd != CMD_NONE) {
+			test_check(num_arrivals < UPLINK_TEST_MAX_CMDS);
+			arrival_cmds[num_arrivals] = cmd;
+			arrival_times[num_arrivals] = rx_start + sc->offset_ms + i * UPLINK_TEST_BYTE_MS;
+			num_arrivals++;
+		}
+	}
+}
+
+static uint32_t next_arrival_time(void) {
+	return next_arrival < num_arrivals ? arrival_times[next_arrival] : FOREVER;
+}
+
+static void note_packet(uplink_result_t* res, uint32_t sent, uint32_t nominal, bool first) {
+	uint32_t delay = sent - nominal;
+	res->worst_packet_delay = max(res->worst_packet_delay, delay);
+	if (first) {
+		res->worst_first_packet_delay = max(res->worst_first_packet_delay, delay);
+	}
+}
+
+static void note_reply_latency(uplink_result_t* res, uint32_t arrived, uint32_t replied) {
+	res->worst_reply_latency = max(res->worst_reply_latency, replied - arrived);
+}
+
+/************************************************************************/
+/* OLD: BLOCKING HANDLING                                               */
+/************************************************************************/
+// everything that arrived by t went into the RX queue (or was dropped)
+static void old_receive_until(uplink_result_t* res, uint32_t t) {
+	while (next_arrival_time() <= t) {
+		if (rx_queue_count < RX_CMD_QUEUE_LEN) {
+			uint8_t i = (rx_queue_head + rx_queue_count) % RX_CMD_QUEUE_LEN;
+			rx_queue[i] = arrival_cmds[next_arrival];
+			rx_queue_times[i] = arrival_times[next_arrival];
+			rx_queue_count++;
+		} else {
+			res->dropped++;
+		}
+		next_arrival++;
+	}
+}
+
+static uint32_t old_handle_uplinks(uplink_result_t* res, uint32_t rx_start) {
+	uint32_t t = rx_start;
+	uint32_t deadline = rx_start + RX_READY_PERIOD_MS;
+
+	while (t < deadline) {
+		old_receive_until(res, t);
+		if (rx_queue_count == 0) {
+			if (next_arrival_time() >= deadline) {
+				break;
+			}
+			t = next_arrival_time();
+			continue;
+		}
+		const uplink_cmd_def_t* def = get_uplink_cmd_def(rx_queue[rx_queue_head]);
+		uint32_t arrived = rx_queue_times[rx_queue_head];
+		rx_queue_head = (rx_queue_head + 1) % RX_CMD_QUEUE_LEN;
+		rx_queue_count--;
+
+		// the task sits in here through every delay and reply
+		for (int r = 0; r < def->reply_count; r++) {
+			t += def->reply_spacing_ms;
+			if (r == 0) {
+				note_reply_latency(res, arrived, t);
+			}
+			t += REPLY_TX_MS;
+		}
+		t += def->after_replies_delay_ms;
+	}
+	// (what's left in the RX queue is handled next window)
+	old_receive_until(res, t);
+	return t;
+}
+
+/************************************************************************/
+/* NEW: REPLY SCHEDULER                                                 */
+/************************************************************************/
+// handles the next scheduled entry at t; returns the time it finished
+static uint32_t new_handle_entry(uplink_result_t* res, uint32_t t) {
+	uplink_reply_t* e = uplink_sched_peek(&test_sched);
+	if (e->buf != NULL) {
+		test_check(sched_count > 0);
+		if (sched_replies_left[sched_head] == e->def->reply_count) {
+			note_reply_latency(res, sched_arrivals[sched_head], t);
+		}
+		if (--sched_replies_left[sched_head] == 0) {
+			sched_head = (sched_head + 1) % UPLINK_REPLY_QUEUE_LEN;
+			sched_count--;
+		}
+		t += REPLY_TX_MS;
+	}
+	uplink_sched_pop(&test_sched, t);
+	return t;
+}
+
+static uint32_t new_handle_uplinks(uplink_result_t* res, uint32_t rx_start, uint32_t hold_until) {
+	uint32_t t = rx_start;
+	uint32_t deadline = rx_start + RX_READY_PERIOD_MS;
+
+	for (;;) {
+		uint32_t bound = deadline;
+		if (t >= deadline) {
+			if (uplink_sched_peek(&test_sched) == NULL || t >= hold_until) {
+				break;
+			}
+			bound = hold_until;
+		}
+		uint32_t due = uplink_sched_peek(&test_sched) != NULL ? uplink_sched_ready_at(&test_sched) : FOREVER;
+		uint32_t arrival = next_arrival_time();
+
+		if (arrival <= due && arrival < bound) {
+			t = max(t, arrival);
+			const uplink_cmd_def_t* def = get_uplink_cmd_def(arrival_cmds[next_arrival]);
+			if (uplink_sched_add(&test_sched, def, (const uint8_t*) "reply", true, t)) {
+				uint8_t i = (sched_head + sched_count) % UPLINK_REPLY_QUEUE_LEN;
+				sched_arrivals[i] = arrival;
+				sched_replies_left[i] = def->reply_count;
+				sched_count++;
+			} else {
+				res->dropped++;
+			}
+			next_arrival++;
+		} else if (due < bound) {
+			t = new_handle_entry(res, max(t, due));
+		} else {
+			t = bound;
+		}
+	}
+	return t;
+}
+
+// slots 2-4 of a transmission, with a due reply (if any) sent before each
+static uint32_t new_wait_for_next_slot(uplink_result_t* res, uint32_t prev) {
+	prev += SLOT_MS;
+	uplink_reply_t* e = uplink_sched_peek(&test_sched);
+	if (e != NULL && e->buf != NULL && uplink_sched_ready_at(&test_sched) <= prev) {
+		new_handle_entry(res, prev);
+		prev += UPLINK_REPLY_TRANS_TIME_MS;
+	}
+	return prev;
+}
+
+/************************************************************************/
+/* CYCLES                                                               */
+/************************************************************************/
+static void run_scenario(const uplink_scenario_t* sc, bool use_sched, uplink_result_t* res) {
+	memset(res, 0, sizeof(uplink_result_t));
+	uplink_sched_init(&test_sched, 0);
+	sched_head = 0;
+	sched_count = 0;
+	rx_queue_head = 0;
+	rx_queue_count = 0;
+
+	uint32_t cycle_start = 0;
+	for (int c = 0; c < UPLINK_TEST_CYCLES; c++) {
+		uint32_t nominal = c * TRANSMIT_TASK_FREQ;
+		// the task waits until its next period, unless it's already late
+		cycle_start = max(cycle_start, nominal);
+
+		uint32_t t = cycle_start;
+		note_packet(res, t, nominal, true);
+		for (int slot = 1; slot < 4; slot++) {
+			t = use_sched ? new_wait_for_next_slot(res, t) : t + SLOT_MS;
+			note_packet(res, t, nominal + slot * SLOT_MS, false);
+		}
+		uint32_t rx_start = t + SLOT_MS;
+
+		if (c == 0) {
+			replay_stream(sc, rx_start);
+		}
+		uint32_t end = use_sched ?
+			new_handle_uplinks(res, rx_start, cycle_start + TRANSMIT_TASK_FREQ - UPLINK_REPLY_HOLD_MARGIN_MS) :
+			old_handle_uplinks(res, rx_start);
+
+		// anything that arrived after we stopped listening was missed
+		while (next_arrival_time() < FOREVER) {
+			res->missed++;
+			next_arrival++;
+		}
+		cycle_start = max(end, cycle_start + TRANSMIT_TASK_FREQ);
+	}
+}
+
+static void print_result(const char* which, uplink_result_t* res) {
+	print("\t%s: worst packet delay %d ms (first packet %d ms), worst reply latency %d ms, %d dropped, %d missed\n",
+		which, res->worst_packet_delay, res->worst_first_packet_delay, res->worst_reply_latency,
+		res->dropped, res->missed);
+}
+
+void uplink_reply_replay_test(void) {
+	uplink_result_t old_res, new_res;
+	bool built = init_uplink_matcher(&test_matcher);
+	test_check(built);
+
+	for (uint8_t i = 0; i < NUM_SCENARIOS; i++) {
+		run_scenario(&scenarios[i], false, &old_res);
+		run_scenario(&scenarios[i], true, &new_res);
+		print("%s (%d commands):\n", scenarios[i].name, num_arrivals);
+		print_result("blocking", &old_res);
+		print_result("scheduled", &new_res);
+
+		// replies never hold up the start of a transmission
+		test_check(new_res.worst_first_packet_delay == 0);
+		// ...and push each later packet back by at most one reply per slot before it
+		test_check(new_res.worst_packet_delay <= 3 * UPLINK_REPLY_TRANS_TIME_MS);
+		test_check(new_res.dropped + new_res.missed <= old_res.dropped + old_res.missed);
+	}
+}
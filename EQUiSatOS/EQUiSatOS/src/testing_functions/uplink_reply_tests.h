@@ -0,0 +1,25 @@
+/*
+ * uplink_reply_tests.h
+ *
+ * Created: 10/18/2026 11:46:30 PM
+ *  Author: BSE
+ */
+
+
+#ifndef UPLINK_REPLY_TESTS_H_
+#define UPLINK_REPLY_TESTS_H_
+
+#include <global.h>
+#include "../telemetry/uplink_commands.h"
+#include "test_check.h"
+
+// transmission cycles simulated per scenario (uplinks arrive in the first)
+#define UPLINK_TEST_CYCLES			3
+// most commands a scenario's stream can hold
+#define UPLINK_TEST_MAX_CMDS		8
+// time per received byte (~9600 baud)
+#define UPLINK_TEST_BYTE_MS			1
+
+void uplink_reply_replay_test(void);
+
+#endif /* UPLINK_REPLY_TESTS_H_ */
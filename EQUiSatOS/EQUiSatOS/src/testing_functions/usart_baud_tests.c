@@ -0,0 +1,96 @@
+/*
+ * usart_baud_tests.c
+ *
+ * Created: 10/19/2026 4:32:10 AM
+ *  Author: BSE
+ *
+ * usart_baud_table_test checks the BAUD register values in usart_baud.h/.c
+ * against calculate_baud_value (the 64-bit long division ASF's driver does):
+ *	- every entry of the compile-time table
+ *	- usart_baud_value, which init and usart_set_baud_rate use
+ *	- usart_baud_value_fast (the fallback for anything not in the table) for
+ *	  every table rate and clock at each oversampling, the edges of the valid
+ *	  range, and a run of pseudo-random rates / clocks
+ * Nothing here touches the SERCOM, so it runs before the RTOS (from run_tests())
+ * or on a host.
+ */
+
+#include "usart_baud_tests.h"
+
+static const uint32_t test_clocks[] = {
+	USART_BAUD_CLK_OSC8M, USART_BAUD_CLK_OSC8M_DIV2, USART_BAUD_CLK_OSC8M_DIV4,
+	USART_BAUD_CLK_DFLL, 1000000, 32768, 12000000, 0x80000000
+};
+static const uint8_t test_samples[] = {16, 8, 3};
+
+static uint32_t rng = 0xBA0D;
+
+static uint32_t rand32(void) {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static bool check_fast(uint32_t baudrate, uint32_t clock_hz, uint8_t samples) {
+	uint16_t expected = calculate_baud_value(baudrate, clock_hz, samples);
+	uint16_t actual = usart_baud_value_fast(baudrate, clock_hz, samples);
+	if (actual != expected) {
+		print("baud %d clock %d samples %d: fast %d, expected %d\n",
+			baudrate, clock_hz, samples, actual, expected);
+		return false;
+	}
+	return true;
+}
+
+void usart_baud_table_test(void) {
+	uint8_t num_entries;
+	const usart_baud_entry_t* table = get_usart_baud_table(&num_entries);
+	int checked = 0, mismatches = 0;
+
+	// (38400 off OSC8M, what the radio runs at: 65536 * (1 - 16 * 38400 / 8 MHz) = 60502.85)
+	test_check(USART_BAUD_REG(38400, 8000000, 16) == 60502);
+
+	for (int i = 0; i < num_entries; i++) {
+		const usart_baud_entry_t* e = &table[i];
+		uint16_t expected = calculate_baud_value(e->baudrate, e->clock_hz, USART_BAUD_TABLE_SAMPLES);
+		test_check(e->baud_reg == expected);
+		test_check(usart_baud_lookup(e->baudrate, e->clock_hz) == e);
+		test_check(usart_baud_value(e->baudrate, e->clock_hz, USART_BAUD_TABLE_SAMPLES) == expected);
+		checked++;
+	}
+	test_check(usart_baud_lookup(31250, USART_BAUD_CLK_OSC8M) == NULL);
+
+	// fallback, at the table's rates and other clocks / oversampling
+	for (uint8_t c = 0; c < sizeof(test_clocks) / sizeof(test_clocks[0]); c++) {
+		for (uint8_t s = 0; s < sizeof(test_samples); s++) {
+			uint32_t clock_hz = test_clocks[c];
+			uint8_t samples = test_samples[s];
+			for (int i = 0; i < num_entries; i++) {
+				if ((uint64_t) table[i].baudrate * samples < clock_hz) {
+					mismatches += !check_fast(table[i].baudrate, clock_hz, samples);
+					checked++;
+				}
+			}
+			// (edges: slowest, and fastest the clock allows)
+			uint32_t fastest = (clock_hz - 1) / samples;
+			mismatches += !check_fast(1, clock_hz, samples);
+			mismatches += !check_fast(fastest, clock_hz, samples);
+			mismatches += !check_fast(fastest - 1, clock_hz, samples);
+			checked += 3;
+			// (past the fastest there's no BAUD value)
+			test_check(usart_baud_value_fast(fastest + 1, clock_hz, samples) == 0);
+		}
+	}
+	for (int i = 0; i < USART_BAUD_TEST_RANDOM_CASES; i++) {
+		uint32_t clock_hz = 1000 + rand32() % 0x7FFFFC18;
+		uint8_t samples = test_samples[rand32() % sizeof(test_samples)];
+		uint32_t baudrate = 1 + rand32() % ((clock_hz - 1) / samples);
+		mismatches += !check_fast(baudrate, clock_hz, samples);
+		checked++;
+	}
+
+	print("usart baud: %d values checked against calculate_baud_value, %d mismatches\n",
+		checked, mismatches);
+	test_check(mismatches == 0);
+}
@@ -0,0 +1,21 @@
+/*
+ * usart_baud_tests.h
+ *
+ * Created: 10/19/2026 4:31:52 AM
+ *  Author: BSE
+ */
+
+
+#ifndef USART_BAUD_TESTS_H_
+#define USART_BAUD_TESTS_H_
+
+#include <global.h>
+#include "../processor_drivers/usart_baud.h"
+#include "test_check.h"
+
+// pseudo-random (baud rate, clock, samples) triples checked against the fast path
+#define USART_BAUD_TEST_RANDOM_CASES	20000
+
+void usart_baud_table_test(void);
+
+#endif /* USART_BAUD_TESTS_H_ */
@@ -0,0 +1,189 @@
+/*
+ * usart_rx_ring_tests.c
+ *
+ * Created: 10/19/2026 3:31:30 AM
+ *  Author: BSE
+ *
+ * usart_rx_ring_stress_test pushes byte streams at USART_BAUD_RATE through the
+ * receive ring the way the radio USART does (a put per byte from the receive
+ * interrupt, and a ring tick every 1 ms tick), with a consumer task that's
+ * woken by the events after a random scheduling latency and then reads out
+ * everything waiting. For each stream / latency it checks:
+ *	- within the ring's slack (the time to fill what's left above the notify
+ *	  threshold), no byte is lost and every byte comes out once, in order
+ *	- beyond it, every byte is either delivered or counted as an overrun
+ *	- everything left when the line goes quiet is delivered (the idle event)
+ *	- the consumer is woken once per threshold or idle event, not once per byte
+ * Everything runs on simulated time, so it runs before the RTOS (from run_tests()).
+ */
+
+#include "usart_rx_ring_tests.h"
+
+#define BYTE_TIME_US(i)		((uint32_t) ((uint64_t) (i) * USART_RX_TEST_BITS_PER_BYTE * 1000000 / USART_BAUD_RATE))
+#define RING_SLACK_US		BYTE_TIME_US(USART_RX_RING_SIZE - USART_RX_NOTIFY_THRESHOLD)
+#define NEVER				0xFFFFFFFF
+
+typedef struct {
+	const char* name;
+	uint16_t burst_len;			// bytes back to back (0 for one continuous stream)
+	uint16_t gap_ms;			// silence between bursts
+	uint32_t min_latency_us;	// consumer wakes this long after an event...
+	uint32_t max_latency_us;	// ...up to this
+	bool lossless;
+} rx_scenario_t;
+
+static const rx_scenario_t scenarios[] = {
+	{"continuous, 0-5 ms latency",			0,		0,		0,		5000,	true},
+	{"continuous, 0-20 ms latency",			0,		0,		0,		20000,	true},
+	{"uplink-sized bursts, 0-20 ms",		10,		100,	0,		20000,	true},
+	{"200 B payloads, 0-20 ms",				200,	50,		0,		20000,	true},
+	{"single bytes, 0-20 ms",				1,		7,		0,		20000,	true},
+	{"continuous, 30-60 ms latency",		0,		0,		30000,	60000,	false},
+};
+#define NUM_SCENARIOS		(sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct {
+	uint32_t sent;
+	uint32_t delivered;
+	uint32_t wakes;
+	uint32_t bursts;
+	uint16_t max_waiting;	// in the ring when the consumer woke
+	bool in_order;
+} rx_result_t;
+
+static usart_rx_ring_t ring;
+static uint32_t rng = 0x5EED;
+
+static uint32_t rand_latency(const rx_scenario_t* sc) {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return sc->min_latency_us + rng % (sc->max_latency_us - sc->min_latency_us + 1);
+}
+
+static void run_scenario(const rx_scenario_t* sc, rx_result_t* res) {
+	uint32_t end_us = USART_RX_TEST_DURATION_MS * 1000;
+	uint32_t next_byte_us = 0;
+	uint32_t next_tick_us = 1000;
+	uint32_t wake_us = NEVER;	// consumer's blocked until an event when NEVER
+	bool event_pending = false;	// notified while awake (the notification value stays set)
+	uint16_t in_burst = 0;
+	uint8_t next_tx = 0, next_rx = 0;
+	uint8_t chunk[16];
+
+	usart_rx_ring_init(&ring);
+	memset(res, 0, sizeof(rx_result_t));
+	res->in_order = true;
+
+	// (run past the end of the stream so the idle event delivers the rest)
+	while (true) {
+		uint32_t now = min(min(next_byte_us, next_tick_us), wake_us);
+		if (now >= end_us + 2 * RING_SLACK_US + sc->max_latency_us) {
+			break;
+		}
+		bool event = false;
+		if (now == next_byte_us) {
+			// receive interrupt
+			event = usart_rx_ring_put(&ring, next_tx++);
+			res->sent++;
+			if (sc->burst_len == 0) {
+				next_byte_us = BYTE_TIME_US(res->sent);
+			} else if (++in_burst < sc->burst_len) {
+				next_byte_us += BYTE_TIME_US(1);
+			} else {
+				in_burst = 0;
+				res->bursts++;
+				next_byte_us += BYTE_TIME_US(1) + sc->gap_ms * 1000;
+			}
+			if (next_byte_us >= end_us) {
+				next_byte_us = NEVER;
+			}
+		} else if (now == next_tick_us) {
+			event = usart_rx_ring_tick(&ring);
+			next_tick_us += 1000;
+		} else {
+			// consumer runs and reads everything out
+			res->wakes++;
+			res->max_waiting = max(res->max_waiting, usart_rx_ring_count(&ring));
+			uint16_t n;
+			while ((n = usart_rx_ring_read(&ring, chunk, sizeof(chunk))) > 0) {
+				for (int i = 0; i < n; i++) {
+					if (chunk[i] != next_rx) {
+						res->in_order = false;
+					}
+					next_rx = chunk[i] + 1;
+				}
+				res->delivered += n;
+			}
+			wake_us = NEVER;
+			if (event_pending) {
+				event_pending = false;
+				wake_us = now + rand_latency(sc);
+			}
+		}
+		if (event) {
+			if (wake_us == NEVER) {
+				wake_us = now + rand_latency(sc);
+			} else {
+				event_pending = true;
+			}
+		}
+	}
+}
+
+void usart_rx_ring_stress_test(void) {
+	rx_result_t res;
+
+	// the ring itself
+	uint8_t out[USART_RX_RING_SIZE + 1];
+	usart_rx_ring_init(&ring);
+	for (int i = 0; i < USART_RX_RING_SIZE + 3; i++) {
+		bool event = usart_rx_ring_put(&ring, i);
+		// (an event every threshold's worth, none once it's full)
+		test_check(event == ((i + 1) % USART_RX_NOTIFY_THRESHOLD == 0 && i < USART_RX_RING_SIZE));
+	}
+	test_check(ring.overruns == 3 && usart_rx_ring_count(&ring) == USART_RX_RING_SIZE);
+	uint16_t num_read = usart_rx_ring_read(&ring, out, sizeof(out));
+	test_check(num_read == USART_RX_RING_SIZE);
+	for (int i = 0; i < USART_RX_RING_SIZE; i++) {
+		test_check(out[i] == (uint8_t) i);
+	}
+	// (idle: reported after USART_RX_IDLE_TICKS quiet ticks, once)
+	usart_rx_ring_put(&ring, 0xAA);
+	bool idle = usart_rx_ring_tick(&ring);
+	test_check(!idle);
+	for (int i = 1; i < USART_RX_IDLE_TICKS; i++) {
+		idle = usart_rx_ring_tick(&ring);
+		test_check(!idle);
+	}
+	idle = usart_rx_ring_tick(&ring);
+	test_check(idle);
+	idle = usart_rx_ring_tick(&ring);
+	test_check(!idle);
+	usart_rx_ring_flush(&ring);
+	test_check(usart_rx_ring_count(&ring) == 0);
+
+	print("ring slack: %d us at %d baud\n", RING_SLACK_US, USART_BAUD_RATE);
+	for (uint8_t i = 0; i < NUM_SCENARIOS; i++) {
+		const rx_scenario_t* sc = &scenarios[i];
+		run_scenario(sc, &res);
+		print("%s: %d sent, %d delivered, %d overruns | %d events, %d wakes (%d bytes / wake) | up to %d waiting\n",
+			sc->name, res.sent, res.delivered, ring.overruns, ring.events, res.wakes,
+			res.wakes == 0 ? 0 : res.delivered / res.wakes, res.max_waiting);
+
+		// every byte's accounted for, and the idle event got the last of them out
+		test_check(res.sent == ring.received);
+		test_check(res.delivered + ring.overruns == res.sent);
+		test_check(usart_rx_ring_count(&ring) == 0);
+		if (sc->lossless) {
+			test_check(sc->max_latency_us < RING_SLACK_US);
+			test_check(ring.overruns == 0 && res.in_order);
+		} else {
+			test_check(ring.overruns > 0);
+		}
+		// one event per threshold's worth or burst, not per byte
+		test_check(ring.events <= res.sent / USART_RX_NOTIFY_THRESHOLD + res.bursts + 1);
+		test_check(res.wakes <= ring.events);
+	}
+	print("usart rx ring stress test passed\n");
+}
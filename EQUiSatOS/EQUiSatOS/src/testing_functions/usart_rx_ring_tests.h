@@ -0,0 +1,23 @@
+/*
+ * usart_rx_ring_tests.h
+ *
+ * Created: 10/19/2026 3:31:08 AM
+ *  Author: BSE
+ */
+
+
+#ifndef USART_RX_RING_TESTS_H_
+#define USART_RX_RING_TESTS_H_
+
+#include <global.h>
+#include "../processor_drivers/usart_rx_ring.h"
+#include "test_check.h"
+
+// simulated time per scenario
+#define USART_RX_TEST_DURATION_MS	10000
+// bit times per byte (start, 8 data, stop)
+#define USART_RX_TEST_BITS_PER_BYTE	10
+
+void usart_rx_ring_stress_test(void);
+
+#endif /* USART_RX_RING_TESTS_H_ */
@@ -0,0 +1,97 @@
+/*
+ * usart_tx_tests.c
+ *
+ * Created: 10/18/2026 9:53:08 PM
+ *  Author: BSE
+ *
+ * Compares the old radio transmit (scheduler suspended while usart_send_buf
+ * busy-waits on every byte) against the DMA transmit, per message:
+ *	- how long the scheduler was suspended
+ *	- how many times a probe task (standing in for the watchdog, flash and
+ *	  battery tasks) got to run while the message was going out
+ * Sends on the radio USART directly, so the radio should be off (or PRINT_DEBUG
+ * on, with TX disabled). Must run with the RTOS started (call from run_rtos_tests()).
+ */
+
+#include "usart_tx_tests.h"
+
+static uint8_t test_buf[USART_TX_TEST_LEN];
+
+static volatile uint32_t probe_runs = 0;
+static TaskHandle_t probe_task_handle = NULL;
+static StackType_t probe_task_stack[configMINIMAL_STACK_SIZE];
+static StaticTask_t probe_task_buffer;
+
+static void probe_task(void *pvParameters) {
+	for (;;) {
+		probe_runs++;
+		vTaskDelay(1);
+	}
+}
+
+typedef struct {
+	TickType_t suspended_ticks;
+	TickType_t total_ticks;
+	uint32_t probe_runs;
+} tx_result_t;
+
+static void send_suspended(tx_result_t* res) {
+	uint32_t runs_before = probe_runs;
+	TickType_t start = xTaskGetTickCount();
+	vTaskSuspendAll();
+	{
+		usart_send_buf(test_buf, USART_TX_TEST_LEN);
+	}
+	xTaskResumeAll(); // (catches up on the ticks missed while suspended)
+	res->total_ticks = xTaskGetTickCount() - start;
+	res->suspended_ticks = res->total_ticks;
+	res->probe_runs = probe_runs - runs_before;
+}
+
+static void send_dma(tx_result_t* res) {
+	uint32_t runs_before = probe_runs;
+	TickType_t start = xTaskGetTickCount();
+	bool started = usart_tx_dma_start(test_buf, USART_TX_TEST_LEN);
+	bool sent = started && usart_tx_dma_wait(USART_TX_DMA_TIMEOUT_MS(USART_TX_TEST_LEN) / portTICK_PERIOD_MS);
+	res->total_ticks = xTaskGetTickCount() - start;
+	test_check(started);
+	test_check(sent);
+	res->suspended_ticks = 0;
+	res->probe_runs = probe_runs - runs_before;
+}
+
+static void run(const char* name, void (*send)(tx_result_t*)) {
+	tx_result_t res, sum = {0, 0, 0};
+	for (int i = 0; i < USART_TX_TEST_ITERS; i++) {
+		send(&res);
+		sum.suspended_ticks += res.suspended_ticks;
+		sum.total_ticks += res.total_ticks;
+		sum.probe_runs += res.probe_runs;
+		vTaskDelay(10 / portTICK_PERIOD_MS); // let the last bytes clear
+	}
+	print("%s: per %d byte message: %d ms suspended, %d ms to send, probe task ran %d times\n",
+		name, USART_TX_TEST_LEN,
+		sum.suspended_ticks * portTICK_PERIOD_MS / USART_TX_TEST_ITERS,
+		sum.total_ticks * portTICK_PERIOD_MS / USART_TX_TEST_ITERS,
+		sum.probe_runs / USART_TX_TEST_ITERS);
+}
+
+void usart_tx_suspension_test(void) {
+	for (int i = 0; i < USART_TX_TEST_LEN; i++) {
+		test_buf[i] = 'A' + (i % 26);
+	}
+	if (probe_task_handle == NULL) {
+		// above the testing task, like the tasks that used to be frozen out
+		probe_task_handle = xTaskCreateStatic(probe_task,
+			"usart tx probe task",
+			configMINIMAL_STACK_SIZE,
+			NULL,
+			FLASH_PRIORITY,
+			probe_task_stack,
+			&probe_task_buffer);
+	}
+
+	run("scheduler suspended", send_suspended);
+	run("DMA", send_dma);
+	test_check(!usart_tx_dma_in_progress());
+}
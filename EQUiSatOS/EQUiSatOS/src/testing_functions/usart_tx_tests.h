@@ -0,0 +1,22 @@
+/*
+ * usart_tx_tests.h
+ *
+ * Created: 10/18/2026 9:52:41 PM
+ *  Author: BSE
+ */
+
+
+#ifndef USART_TX_TESTS_H_
+#define USART_TX_TESTS_H_
+
+#include <global.h>
+#include "test_check.h"
+
+// a full-size radio message
+#define USART_TX_TEST_LEN			255
+// transmissions per path
+#define USART_TX_TEST_ITERS			4
+
+void usart_tx_suspension_test(void);
+
+#endif /* USART_TX_TESTS_H_ */
@@ -0,0 +1,180 @@
+#!/usr/bin/python
+
+# Estimates what tickless idle (TICKLESS_IDLE in config.h; see tickless_idle.h)
+# saves: for each satellite state, simulates one orbit of the tasks running in
+# that state on the periods and offsets in rtos_tasks_config.h and
+# rtos_tasks_offsets.h, and reports the fraction of time the processor is awake
+# and the number of tick interrupts, with the 1 kHz tick always running and
+# with tickless idle.
+#
+#   python tickless_model.py [src directory]
+#
+# Task periods, offsets, the state task sets and the sleep limits come from
+# the source; how long each task keeps the processor awake per run (RUN_MS
+# below) is an estimate, which the run time stats reports (telem_runtime in
+# the telemetry decoder) can replace with measured numbers. Radio uplinks
+# (which keep the tick running while bytes come in) are rare and ignored.
+
+import os
+import re
+import sys
+
+SRC = sys.argv[1] if len(sys.argv) > 1 else "./src"
+
+# per task: (ms into the run, ms awake) for each burst of work in a run
+# (tasks that wait on hardware partway through sleep in between)
+RUN_MS = {
+    "WATCHDOG_TASK":                [(0, 1)],
+    "STATE_HANDLING_TASK":          [(0, 5)],
+    "ANTENNA_DEPLOY_TASK":          [(0, 2)],
+    "BATTERY_CHARGING_TASK":        [(0, 40)],
+    "TRANSMIT_TASK":                [(0, 20), (500, 5), (1000, 5), (1500, 5)],
+    "FLASH_ACTIVATE_TASK":          [(0, 5)] + [(20 * i, 1) for i in range(1, 8)],
+    "IDLE_DATA_TASK":               [(0, 10), (400, 30)],
+    "LOW_POWER_DATA_TASK":          [(0, 10), (400, 30)],
+    "ATTITUDE_DATA_TASK":           [(0, 30), (500, 30)],
+    "PERSISTENT_DATA_BACKUP_TASK":  [(0, 15)],
+}
+TICK_ISR_US = 20        # tick interrupt (and tick hook)
+SLEEP_ENTRY_US = 550    # entering / leaving a tickless sleep (waits ~half an RTC count)
+RTC_WAKE_US = 10        # the RTC wake interrupt
+
+# states and how the tasks' periods differ in them
+STATES = [
+    ("INITIAL",         "INITIAL_TASK_STATES"),
+    ("ANTENNA_DEPLOY",  "ANTENNA_DEPLOY_TASK_STATES"),
+    ("HELLO_WORLD",     "HELLO_WORLD_TASK_STATES"),
+    ("IDLE_NO_FLASH",   "IDLE_NO_FLASH_TASK_STATES"),
+    ("IDLE_FLASH",      "IDLE_FLASH_TASK_STATES"),
+    ("LOW_POWER",       "LOW_POWER_TASK_STATES"),
+]
+DEFINE = re.compile(r"^\s*#define\s+(\w+)(?:\s+(.*?))?\s*$")
+
+
+def read_defines(*paths):
+    # the first definition of each (the TESTING_SPEEDUP overrides come after)
+    defines = {}
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                line = re.sub(r"//.*", "", line)
+                m = DEFINE.match(line)
+                if m and m.group(1) not in defines:
+                    defines[m.group(1)] = m.group(2) or ""
+    return defines
+
+
+def value(defines, name, seen=()):
+    if name in seen:
+        raise ValueError("%s is defined in terms of itself" % name)
+    expr = defines[name]
+    expr = re.sub(r"\b[A-Za-z_]\w*\b",
+                  lambda m: m.group(0) if m.group(0) == "max"
+                  else str(value(defines, m.group(0), seen + (name,))), expr)
+    expr = re.sub(r"\(\s*TickType_t\s*\)|\(\s*uint\d+_t\s*\)", "", expr)
+    return int(eval(expr.replace("/", "//"), {"max": max}))
+
+
+def read_tasks(path):
+    with open(path) as f:
+        text = f.read()
+    enum = re.search(r"typedef enum\s*{([^}]*)}\s*task_type_t", text).group(1)
+    enum = re.sub(r"//.*", "", enum)
+    return [t.strip().split("=")[0].strip() for t in enum.split(",")
+            if t.strip() and t.strip() != "NUM_TASKS"]
+
+
+def task_states(defines, name):
+    expr = defines[name]
+    while re.match(r"^\w+$", expr):
+        expr = defines[expr]
+    return [b.strip() == "true" for b in re.search(r"{{(.*)}}", expr).group(1).split(",")]
+
+
+def period_ms(defines, task, state):
+    if task == "ANTENNA_DEPLOY_TASK" and state != "ANTENNA_DEPLOY":
+        return value(defines, "ANTENNA_DEPLOY_TASK_LESS_FREQ")
+    if task == "TRANSMIT_TASK" and state == "LOW_POWER":
+        return value(defines, "TRANSMIT_TASK_LESS_FREQ")
+    return value(defines, task + "_FREQ")
+
+
+def busy_intervals(defines, tasks, running, state, orbit_ms):
+    busy = []
+    for task, on in zip(tasks, running):
+        if not on:
+            continue
+        period = period_ms(defines, task, state)
+        t = value(defines, task + "_FREQ_OFFSET")
+        while t < orbit_ms:
+            for at, ms in RUN_MS[task]:
+                busy.append((t + at, min(t + at + ms, orbit_ms)))
+            t += period
+    # merge overlapping work
+    merged = []
+    for start, end in sorted(busy):
+        if start >= orbit_ms:
+            continue
+        if merged and start <= merged[-1][1]:
+            merged[-1][1] = max(merged[-1][1], end)
+        else:
+            merged.append([start, end])
+    return merged
+
+
+def model(defines, tasks, running, state, orbit_ms):
+    min_sleep = value(defines, "configEXPECTED_IDLE_TIME_BEFORE_SLEEP")
+    max_sleep = value(defines, "TICKLESS_MAX_SLEEP_TICKS")
+    busy = busy_intervals(defines, tasks, running, state, orbit_ms)
+    busy_ms = sum(end - start for start, end in busy)
+
+    # always ticking: every ms has a tick
+    ticking_us = busy_ms * 1000 + orbit_ms * TICK_ISR_US
+
+    # tickless: ticks while busy and in short gaps; sleeps (each ending on a tick) in long ones
+    ticks, sleeps = busy_ms, 0
+    prev_end = 0
+    for start, end in busy + [[orbit_ms, orbit_ms]]:
+        gap = start - prev_end
+        if gap >= min_sleep:
+            n = (gap + max_sleep - 1) // max_sleep
+            sleeps += n
+            ticks += n
+        else:
+            ticks += gap
+        prev_end = end
+    tickless_us = busy_ms * 1000 + ticks * TICK_ISR_US + sleeps * (SLEEP_ENTRY_US + RTC_WAKE_US)
+    return {
+        "runs": len(busy),
+        "ticking_awake": ticking_us / (orbit_ms * 10.0),
+        "ticking_ticks": orbit_ms,
+        "tickless_awake": tickless_us / (orbit_ms * 10.0),
+        "tickless_ticks": ticks,
+        "sleeps": sleeps,
+    }
+
+
+def main():
+    config = os.path.join(SRC, "rtos_tasks", "rtos_tasks_config.h")
+    defines = read_defines(config,
+                           os.path.join(SRC, "rtos_tasks", "rtos_tasks_offsets.h"),
+                           os.path.join(SRC, "runnable_configurations", "satellite_state_control.h"),
+                           os.path.join(SRC, "config", "FreeRTOSConfig.h"),
+                           os.path.join(SRC, "rtos_tasks", "tickless_idle.h"))
+    tasks = read_tasks(config)
+    orbit_ms = value(defines, "ORBITAL_PERIOD_S") * 1000
+
+    print("one orbit (%d s); awake %% and tick interrupts with the 1 kHz tick vs tickless idle"
+          % (orbit_ms // 1000))
+    print("\n%-16s %6s | %-19s | %s" % ("", "", "1 kHz tick", "tickless"))
+    print("%-16s %6s | %8s %10s | %8s %10s %8s" %
+          ("state", "busy", "awake", "ticks", "awake", "ticks", "sleeps"))
+    for state, states_name in STATES:
+        r = model(defines, tasks, task_states(defines, states_name), state, orbit_ms)
+        print("%-16s %6d | %7.2f%% %10d | %7.2f%% %10d %8d" %
+              (state, r["runs"], r["ticking_awake"], r["ticking_ticks"],
+               r["tickless_awake"], r["tickless_ticks"], r["sleeps"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+#!/usr/bin/python
+
+# Turns a trace ring snapshot (TRACE_RING in config.h; see trace_ring.h) into
+# a timeline in the Trace Event Format, which chrome://tracing and Perfetto
+# (ui.perfetto.dev) open: a track per task with the spans it ran, and its
+# blocks, suspensions and trace_prints marked along them.
+#
+#   python trace_convert.py <snapshot> [output json] [src directory]
+#
+# The snapshot is either the raw field (sizeof(trace_snapshot_t) bytes from
+# STORAGE_TRACE_SNAPSHOT_ADDR in an MRAM dump) or the output of
+# dump_trace_snapshot (the lines starting with TRACE; anything else is
+# skipped, so a whole USART log will do). The events, freeze reasons and task
+# slots come from the source, as do the trace_print formats, which are
+# matched up with the hashes in the records. Also prints a summary.
+
+import json
+import os
+import re
+import struct
+import sys
+
+SNAPSHOT = sys.argv[1] if len(sys.argv) > 1 else None
+OUTPUT = sys.argv[2] if len(sys.argv) > 2 else "trace.json"
+SRC = sys.argv[3] if len(sys.argv) > 3 else "./src"
+
+HEADER = struct.Struct("<IIHHBB2x")
+RECORD = struct.Struct("<IBBH")
+PRINT_CALL = re.compile(r'trace_print\(\s*"((?:[^"\\]|\\.)*)"')
+
+
+def read_source(path):
+    with open(path) as f:
+        return re.sub(r"//.*", "", f.read())
+
+
+def read_trace_defines(path):
+    text = read_source(path)
+    defines = dict((m.group(1), int(m.group(2), 0)) for m in
+                   re.finditer(r"#define\s+(TRACE_\w+)\s+(0x[0-9a-fA-F]+|\d+)", text))
+    events = dict((v, k[len("TRACE_EV_"):].lower()) for k, v in defines.items()
+                  if k.startswith("TRACE_EV_"))
+    enum = re.search(r"typedef enum\s*{([^}]*)}\s*trace_freeze_reason_t", text).group(1)
+    reasons = [r.strip().split("=")[0].strip().replace("TRACE_FROZEN_", "").lower()
+               for r in enum.split(",") if r.strip()]
+    return defines, events, reasons
+
+
+def read_slots(src):
+    text = read_source(os.path.join(src, "rtos_tasks", "rtos_tasks_config.h"))
+    enum = re.search(r"typedef enum\s*{([^}]*)}\s*task_type_t", text).group(1)
+    tasks = [t.strip().split("=")[0].strip() for t in enum.split(",")
+             if t.strip() and t.strip() != "NUM_TASKS"]
+    # (see runtime_stats.h)
+    return [t.lower() for t in tasks] + ["idle", "other"]
+
+
+def trace_hash(s):
+    # trace_ring_hash: 16-bit folded FNV-1a
+    h = 2166136261
+    for c in bytearray(s.encode("utf-8")):
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return ((h >> 16) ^ h) & 0xFFFF
+
+
+def read_prints(src):
+    prints = {}
+    for root, dirs, files in os.walk(src):
+        dirs[:] = [d for d in dirs if d != "ASF"]
+        for name in files:
+            if name.endswith((".c", ".h")):
+                with open(os.path.join(root, name)) as f:
+                    for fmt in PRINT_CALL.findall(f.read()):
+                        prints[trace_hash(fmt)] = fmt
+    return prints
+
+
+def read_snapshot(path, size):
+    with open(path, "rb") as f:
+        data = f.read()
+    lines = [l for l in data.decode("latin-1").splitlines() if l.startswith("TRACE ")]
+    if lines:
+        data = bytes(bytearray(int(b, 16) for l in lines for b in l.split()[1:]))
+    if len(data) != size:
+        raise ValueError("snapshot is %d bytes, not %d" % (len(data), size))
+    return data
+
+
+def main():
+    if SNAPSHOT is None:
+        print("usage: python trace_convert.py <snapshot> [output json] [src directory]")
+        sys.exit(1)
+    defines, events, reasons = read_trace_defines(os.path.join(SRC, "data_handling", "trace_ring.h"))
+    slots = read_slots(SRC)
+    prints = read_prints(SRC)
+    ring_len = defines["TRACE_RING_LEN"]
+
+    data = read_snapshot(SNAPSHOT, HEADER.size + ring_len * RECORD.size)
+    magic, timestamp, next_rec, count, reason, reboot_count = HEADER.unpack_from(data)
+    if magic != defines["TRACE_SNAPSHOT_MAGIC"]:
+        print("no trace snapshot (it's never been frozen)")
+        sys.exit(1)
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(ring_len)]
+    oldest = 0 if count < ring_len else next_rec
+    records = [records[(oldest + i) % ring_len] for i in range(count)]
+
+    def slot_name(slot):
+        return slots[slot] if slot < len(slots) else "slot %d" % slot
+
+    # times from the first record (the counter wraps every ~71 minutes)
+    times = [0]
+    for prev, rec in zip(records, records[1:]):
+        times.append(times[-1] + ((rec[0] - prev[0]) & 0xFFFFFFFF))
+    end = times[-1]
+
+    trace = [{"ph": "M", "pid": 1, "name": "process_name",
+              "args": {"name": "EQUiSat (reboot %d, frozen at %d s: %s)"
+                       % (reboot_count, timestamp, reasons[reason])}}]
+    for slot in sorted(set(r[1] for r in records) |
+                       set(r[3] for r in records if events.get(r[2]) in ("suspend", "resume"))):
+        trace.append({"ph": "M", "pid": 1, "tid": slot, "name": "thread_name",
+                      "args": {"name": slot_name(slot)}})
+        trace.append({"ph": "M", "pid": 1, "tid": slot, "name": "thread_sort_index",
+                      "args": {"sort_index": slot}})
+
+    ran = {}
+    switches = [(t, r[1]) for t, r in zip(times, records) if events.get(r[2]) == "switched_in"]
+    for (t, slot), (t_next, _) in zip(switches, switches[1:] + [(end, None)]):
+        trace.append({"ph": "X", "pid": 1, "tid": slot, "name": slot_name(slot),
+                      "ts": t, "dur": t_next - t})
+        ran[slot] = ran.get(slot, 0) + t_next - t
+
+    for t, (_, task, event, arg) in zip(times, records):
+        name = events.get(event, "event %d" % event)
+        args = {}
+        if name == "switched_in":
+            continue
+        elif name == "delay":
+            args["until tick (low 16 bits)"] = arg
+        elif name == "delay_for":
+            args["ticks"] = arg
+        elif name in ("block_receive", "block_send"):
+            args["queue"] = "0x2000%04x" % arg
+        elif name in ("suspend", "resume"):
+            name += " " + slot_name(arg)
+        elif name == "print":
+            name = prints.get(arg, "print #%04x" % arg)
+        elif name == "frozen":
+            name = "frozen: " + reasons[arg]
+        trace.append({"ph": "i", "s": "g" if event == defines["TRACE_EV_FROZEN"] else "t",
+                      "pid": 1, "tid": task, "name": name, "ts": t, "args": args})
+
+    with open(OUTPUT, "w") as f:
+        json.dump({"traceEvents": trace, "displayTimeUnit": "ms"}, f, indent=1)
+
+    print("%d events over %.3f ms before the %s (reboot %d, %d s since launch)"
+          % (count, end / 1000.0, reasons[reason], reboot_count, timestamp))
+    for slot in sorted(ran, key=lambda s: -ran[s]):
+        print("  %-28s ran %8.3f ms (%5.1f%%)" % (slot_name(slot), ran[slot] / 1000.0,
+                                                   100.0 * ran[slot] / end if end else 0))
+    print("wrote %s (open in chrome://tracing or ui.perfetto.dev)" % OUTPUT)
+
+
+if __name__ == "__main__":
+    main()
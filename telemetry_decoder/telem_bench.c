@@ -0,0 +1,249 @@
+/*
+ * telem_bench.c
+ *
+ * Throughput benchmark (and end-to-end check) for the decoder:
+ *	telem_bench [MB [capture]]
+ * builds a synthetic capture of about MB megabytes (default 16) of messages
+ * laid out like write_packet's, with random noise between them and:
+ *	- 60% of messages clean
+ *	- 30% with 1-16 corrupted bytes (correctable)
+ *	- 5% with 40 corrupted bytes (not correctable)
+ *	- 5% with a corrupted callsign (not found)
+ * then decodes it, checking every message that should come out does (at the
+ * right offset, byte for byte) and nothing else does, and that the tables get
+ * the expected number of rows. Decoding is timed alone, with rows formatted as
+ * CSV, and with rows formatted as binary (in memory; no files are written).
+ * The synthetic capture is also written to capture if given (to try telem_decode on).
+ *
+ * Created: 10/19/2026 6:44:27 AM
+ *  Author: BSE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "telem_decoder.h"
+#include "telem_output.h"
+#include "../EQUiSatOS/EQUiSatOS/src/telemetry/rscode-1.3/ecc.h"
+
+#define DEFAULT_ARCHIVE_MB		16
+#define FEED_CHUNK_SIZE			(64 * 1024)
+#define MAX_NOISE_BYTES			64
+#define MAX_CORRECTABLE			(MSG_PARITY_LENGTH / 2)
+#define UNCORRECTABLE_ERRORS	40
+
+typedef struct {
+	uint64_t offset;
+	bool decodable;
+	uint8_t frame[MSG_SIZE];	// as sent
+} expected_msg_t;
+
+static uint8_t* archive;
+static size_t archive_len;
+static expected_msg_t* expected;
+static size_t num_expected;
+static uint64_t expected_rows[TELEM_NUM_TABLES];
+
+static uint64_t rng = 0x0123456789ABCDEFULL;
+
+static uint32_t rand32(void) {
+	rng ^= rng << 13;
+	rng ^= rng >> 7;
+	rng ^= rng << 17;
+	return (uint32_t) (rng >> 32);
+}
+
+/************************************************************************/
+/* SYNTHETIC ARCHIVE                                                    */
+/************************************************************************/
+static void build_frame(uint8_t* frame, uint32_t timestamp, uint8_t msg_type, int* nonzero_errors) {
+	const telem_packet_def_t* def = telem_get_packet_def(msg_type);
+	memset(frame, 0, MSG_SIZE);
+	memcpy(frame, MSG_CALLSIGN, CALLSIGN_SIZE);
+	for (int i = 0; i < 4; i++) {
+		frame[PREAMBLE_TIMESTAMP_OFFSET + i] = timestamp >> (8 * i);
+	}
+	frame[PREAMBLE_STATES_OFFSET] = (msg_type << MSG_STATE_TYPE_SHIFT)
+		| ((rand32() % 6) << MSG_STATE_SAT_STATE_SHIFT) | (rand32() & 0xC0);
+	frame[PREAMBLE_DATA_LEN_OFFSET] = def->num_packets * def->size;
+	frame[PREAMBLE_NUM_ERRORS_OFFSET] = rand32() % 52;
+
+	// current data and data packets are just random bytes (everything decodes)
+	for (int i = START_CUR_DATA; i < START_DATA + def->num_packets * def->size; i++) {
+		frame[i] = rand32();
+	}
+	// some of the error slots filled in
+	*nonzero_errors = 0;
+	uint8_t* errors = frame + START_DATA + def->num_packets * def->size;
+	int filled = rand32() % (def->num_errors + 1);
+	for (int e = 0; e < filled; e++) {
+		errors[e * ERROR_PACKET_SIZE] = 1 + rand32() % 0xFF;
+		errors[e * ERROR_PACKET_SIZE + 1] = rand32();
+		errors[e * ERROR_PACKET_SIZE + 2] = rand32();
+		(*nonzero_errors)++;
+	}
+	encode_data(frame + CALLSIGN_SIZE, START_PARITY - CALLSIGN_SIZE, frame + CALLSIGN_SIZE);
+}
+
+static void corrupt(uint8_t* frame, int num_bytes) {
+	bool hit[MSG_SIZE] = {false};
+	for (int n = 0; n < num_bytes; ) {
+		int i = CALLSIGN_SIZE + rand32() % (MSG_SIZE - CALLSIGN_SIZE);
+		if (!hit[i]) {
+			hit[i] = true;
+			frame[i] ^= 1 + rand32() % 0xFF;
+			n++;
+		}
+	}
+}
+
+static void build_archive(size_t target_len) {
+	size_t max_msgs = target_len / MSG_SIZE + 1;
+	archive = malloc(target_len + max_msgs * MAX_NOISE_BYTES + MSG_SIZE);
+	expected = malloc(max_msgs * sizeof(expected_msg_t));
+	archive_len = 0;
+	num_expected = 0;
+	uint32_t timestamp = 1000000;
+
+	while (archive_len < target_len) {
+		int noise = rand32() % MAX_NOISE_BYTES;
+		for (int i = 0; i < noise; i++) {
+			archive[archive_len++] = rand32();
+		}
+
+		expected_msg_t* e = &expected[num_expected++];
+		uint8_t msg_type = rand32() % TELEM_NUM_MSG_TYPES;
+		int nonzero_errors;
+		build_frame(e->frame, timestamp, msg_type, &nonzero_errors);
+		timestamp += 20 + rand32() % 100;
+		e->offset = archive_len;
+
+		uint8_t* sent = archive + archive_len;
+		memcpy(sent, e->frame, MSG_SIZE);
+		archive_len += MSG_SIZE;
+		int r = rand32() % 100;
+		e->decodable = r < 90;
+		if (r >= 60 && r < 90) {
+			corrupt(sent, 1 + rand32() % MAX_CORRECTABLE);
+		} else if (r >= 90 && r < 95) {
+			corrupt(sent, UNCORRECTABLE_ERRORS);
+		} else if (r >= 95) {
+			sent[rand32() % CALLSIGN_SIZE] ^= 0x20;
+		}
+
+		if (e->decodable) {
+			const telem_packet_def_t* def = telem_get_packet_def(msg_type);
+			expected_rows[TELEM_TABLE_MESSAGES]++;
+			expected_rows[def->table] += def->num_packets * def->samples;
+			expected_rows[TELEM_TABLE_ERRORS] += nonzero_errors;
+		}
+	}
+}
+
+/************************************************************************/
+/* DECODING                                                             */
+/************************************************************************/
+typedef struct {
+	size_t next;				// into expected
+	uint32_t mismatched;		// came out, but not as expected
+	uint32_t unexpected;		// came out, but shouldn't have
+	telem_output_t* out;		// rows formatted here, if set
+} bench_ctx_t;
+
+static void on_message(const telem_msg_t* msg, void* ctx) {
+	bench_ctx_t* b = (bench_ctx_t*) ctx;
+	while (b->next < num_expected && expected[b->next].offset < msg->stream_offset) {
+		b->next++;
+	}
+	if (b->next == num_expected || expected[b->next].offset != msg->stream_offset
+			|| !expected[b->next].decodable) {
+		b->unexpected++;
+	} else if (memcmp(msg->bytes, expected[b->next].frame, MSG_SIZE) != 0) {
+		b->mismatched++;
+	}
+	if (b->out != NULL) {
+		telem_emit_rows(msg, telem_output_row, b->out);
+	}
+}
+
+static double now_s(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static telem_decoder_t decoder;
+
+/* returns whether everything checked out */
+static bool run_pass(const char* name, telem_output_t* out) {
+	bench_ctx_t b = {0, 0, 0, out};
+	telem_decoder_init(&decoder, on_message, &b);
+	double start = now_s();
+	for (size_t pos = 0; pos < archive_len; pos += FEED_CHUNK_SIZE) {
+		size_t n = archive_len - pos < FEED_CHUNK_SIZE ? archive_len - pos : FEED_CHUNK_SIZE;
+		telem_decoder_feed(&decoder, archive + pos, n);
+	}
+	telem_decoder_finish(&decoder);
+	if (out != NULL) {
+		telem_output_close(out);
+	}
+	double secs = now_s() - start;
+
+	const telem_decoder_stats_t* s = &decoder.stats;
+	printf("%-14s %7.2f MB/s  %8.0f msgs/s | %u messages (%u corrected), %u uncorrectable, %u unexpected, %u mismatched",
+		name, archive_len / secs / 1e6, s->messages / secs, s->messages, s->corrected_messages,
+		s->uncorrectable, b.unexpected, b.mismatched);
+	if (out != NULL) {
+		printf(" | %.1f MB out", out->bytes_out / 1e6);
+	}
+	printf("\n");
+
+	bool ok = b.unexpected == 0 && b.mismatched == 0;
+	uint32_t decodable = 0;
+	for (size_t i = 0; i < num_expected; i++) {
+		decodable += expected[i].decodable;
+	}
+	ok = ok && s->messages == decodable;
+	if (out != NULL) {
+		for (int t = 0; t < TELEM_NUM_TABLES; t++) {
+			if (out->rows[t] != expected_rows[t]) {
+				printf("  %s: %llu rows, expected %llu\n", telem_get_table(t)->name,
+					(unsigned long long) out->rows[t], (unsigned long long) expected_rows[t]);
+				ok = false;
+			}
+		}
+	}
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	int mb = argc > 1 ? atoi(argv[1]) : DEFAULT_ARCHIVE_MB;
+	if (mb <= 0) {
+		fprintf(stderr, "usage: telem_bench [MB [capture]]\n");
+		return 2;
+	}
+	initialize_ecc();
+	build_archive((size_t) mb * 1000000);
+	printf("synthetic archive: %.1f MB, %zu messages\n", archive_len / 1e6, num_expected);
+	if (argc > 2) {
+		FILE* f = fopen(argv[2], "wb");
+		if (f == NULL || fwrite(archive, 1, archive_len, f) != archive_len) {
+			perror(argv[2]);
+			return 1;
+		}
+		fclose(f);
+	}
+
+	telem_output_t out;
+	bool ok = run_pass("decode", NULL);
+	telem_output_init(&out, TELEM_OUT_CSV, NULL);
+	ok = run_pass("decode + csv", &out) && ok;
+	telem_output_init(&out, TELEM_OUT_BIN, NULL);
+	ok = run_pass("decode + bin", &out) && ok;
+
+	printf(ok ? "all messages decoded as expected\n" : "FAILED\n");
+	free(archive);
+	free(expected);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/*
+ * telem_decoder.c
+ *
+ * Created: 10/19/2026 5:34:48 AM
+ *  Author: BSE
+ */
+
+#include "telem_decoder.h"
+#include <string.h>
+#include "../EQUiSatOS/EQUiSatOS/src/telemetry/rscode-1.3/ecc.h"
+
+#define CODEWORD_SIZE		(MSG_SIZE - CALLSIGN_SIZE)
+
+// (rscode keeps its state in globals, so decoding isn't reentrant)
+static bool ecc_initialized = false;
+// syndrome_mul[j][x] = alpha^(j+1) * x, so syndromes are a lookup per byte
+// rather than a gmult (which is most of the time decoding clean messages)
+static uint8_t syndrome_mul[NPAR][256];
+
+static void init_ecc(void) {
+	initialize_ecc();
+	for (int j = 0; j < NPAR; j++) {
+		for (int x = 0; x < 256; x++) {
+			syndrome_mul[j][x] = gmult(gexp[j + 1], x);
+		}
+	}
+	ecc_initialized = true;
+}
+
+/* rscode's decode_data (the syndromes go in synBytes the same way);
+   returns whether they're all zero, i.e. codeword is a codeword */
+static bool compute_syndromes(const uint8_t* codeword) {
+	// (all the syndromes at once, byte by byte, so the lookups don't wait on each other)
+	uint8_t sums[NPAR] = {0};
+	for (int i = 0; i < CODEWORD_SIZE; i++) {
+		uint8_t b = codeword[i];
+		for (int j = 0; j < NPAR; j++) {
+			sums[j] = b ^ syndrome_mul[j][sums[j]];
+		}
+	}
+	int nonzero = 0;
+	for (int j = 0; j < NPAR; j++) {
+		synBytes[j] = sums[j];
+		nonzero |= sums[j];
+	}
+	return nonzero == 0;
+}
+
+static uint32_t read_u32_le(const uint8_t* p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/************************************************************************/
+/* SINGLE MESSAGE                                                       */
+/************************************************************************/
+/* corrects and parses the MSG_SIZE bytes at frame (starting with the callsign)
+   into msg; returns whether it checked out */
+bool telem_decode_frame(const uint8_t* frame, telem_msg_t* msg) {
+	if (!ecc_initialized) {
+		init_ecc();
+	}
+	memcpy(msg->bytes, frame, MSG_SIZE);
+
+	// the callsign isn't RS-encoded
+	uint8_t* codeword = msg->bytes + CALLSIGN_SIZE;
+	msg->corrected = 0;
+	if (!compute_syndromes(codeword)) {
+		if (!correct_errors_erasures(codeword, CODEWORD_SIZE, 0, NULL)) {
+			return false;
+		}
+		// (past what it can correct, the decoder can still "correct" to a non-codeword)
+		if (!compute_syndromes(codeword)) {
+			return false;
+		}
+		for (int i = CALLSIGN_SIZE; i < MSG_SIZE; i++) {
+			msg->corrected += frame[i] != msg->bytes[i];
+		}
+	}
+
+	msg->timestamp = read_u32_le(msg->bytes + PREAMBLE_TIMESTAMP_OFFSET);
+	msg->states = msg->bytes[PREAMBLE_STATES_OFFSET];
+	msg->msg_type = (msg->states >> MSG_STATE_TYPE_SHIFT) & MSG_STATE_FIELD_MASK;
+	msg->sat_state = (msg->states >> MSG_STATE_SAT_STATE_SHIFT) & MSG_STATE_FIELD_MASK;
+	msg->flash_killed = (msg->states >> MSG_STATE_FLASH_KILLED_BIT) & 1;
+	msg->prog_mem_rewritten = (msg->states >> MSG_STATE_PROG_MEM_BIT) & 1;
+	msg->data_len = msg->bytes[PREAMBLE_DATA_LEN_OFFSET];
+	msg->num_errors = msg->bytes[PREAMBLE_NUM_ERRORS_OFFSET];
+	return true;
+}
+
+/************************************************************************/
+/* STREAM                                                               */
+/************************************************************************/
+void telem_decoder_init(telem_decoder_t* d, telem_msg_cb cb, void* ctx) {
+	memset(d, 0, sizeof(telem_decoder_t));
+	d->cb = cb;
+	d->ctx = ctx;
+}
+
+/* decodes every message that's entirely in the buffer, then drops everything
+   before the first byte that could still start one */
+static void scan(telem_decoder_t* d) {
+	size_t pos = 0;
+	while (pos < d->len) {
+		const uint8_t* p = memchr(d->buf + pos, MSG_CALLSIGN[0], d->len - pos);
+		if (p == NULL) {
+			pos = d->len;
+			break;
+		}
+		size_t i = p - d->buf;
+		size_t avail = d->len - i;
+		if (memcmp(p, MSG_CALLSIGN, avail < CALLSIGN_SIZE ? avail : CALLSIGN_SIZE) != 0) {
+			pos = i + 1;
+			continue;
+		}
+		if (avail < MSG_SIZE) {
+			// wait for the rest of it
+			pos = i;
+			break;
+		}
+
+		if (!telem_decode_frame(p, &d->msg)) {
+			// resync on the next callsign (which may be inside this "message")
+			d->stats.uncorrectable++;
+			pos = i + 1;
+			continue;
+		}
+		d->msg.stream_offset = d->buf_offset + i;
+		d->stats.messages++;
+		if (d->msg.corrected > 0) {
+			d->stats.corrected_messages++;
+			d->stats.corrected_bytes += d->msg.corrected;
+		}
+		if (d->msg.msg_type >= TELEM_NUM_MSG_TYPES) {
+			d->stats.bad_type++;
+		}
+		if (d->cb != NULL) {
+			d->cb(&d->msg, d->ctx);
+		}
+		pos = i + MSG_SIZE;
+	}
+
+	memmove(d->buf, d->buf + pos, d->len - pos);
+	d->len -= pos;
+	d->buf_offset += pos;
+}
+
+void telem_decoder_feed(telem_decoder_t* d, const uint8_t* data, size_t len) {
+	d->stats.bytes_in += len;
+	while (len > 0) {
+		// (after a scan, less than a message is left, so there's always room)
+		size_t n = TELEM_DECODER_BUF_SIZE - d->len;
+		if (n > len) {
+			n = len;
+		}
+		memcpy(d->buf + d->len, data, n);
+		d->len += n;
+		data += n;
+		len -= n;
+		scan(d);
+	}
+}
+
+/* end of the stream; whatever's left can't be a whole message */
+void telem_decoder_finish(telem_decoder_t* d) {
+	d->buf_offset += d->len;
+	d->len = 0;
+	d->stats.bytes_skipped = d->stats.bytes_in - (uint64_t) d->stats.messages * MSG_SIZE;
+}
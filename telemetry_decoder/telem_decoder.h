@@ -0,0 +1,152 @@
+/*
+ * telem_decoder.h
+ *
+ * Streaming decoder for EQUiSat downlink messages (as put together by
+ * write_packet in EQUiSatOS/.../data_handling/package_transmission.c).
+ *
+ * Raw capture bytes are fed in any sized pieces; the decoder finds messages by
+ * their callsign, Reed-Solomon corrects everything after it, and hands each
+ * message that checks out to a callback. If a message can't be corrected,
+ * the decoder resynchronizes on the next callsign (it doesn't trust the
+ * length it "found"). The tables below then turn a message into rows:
+ *	- messages: one per message; preamble and current data
+ *	- errors: one per (non-empty) error entry
+ *	- idle / attitude / flash / flash_cmp / low_power: one per data packet
+ *	  (and per sample, for flash data)
+ *	- runtime_stats: one per run time stats slot (task) in the report
+ *	- mutex_stats: one per profiled mutex (see mutex_stats.h) in the report
+ * with truncated readings undone using the sensor_def.h line coefficients.
+ *
+ * Created: 10/19/2026 5:20:11 AM
+ *  Author: BSE
+ */
+
+
+#ifndef TELEM_DECODER_H_
+#define TELEM_DECODER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../EQUiSatOS/EQUiSatOS/src/data_handling/msg_format.h"
+
+/************************************************************************/
+/* STREAM DECODING                                                      */
+/************************************************************************/
+// bytes buffered between feeds (must hold at least a message)
+#define TELEM_DECODER_BUF_SIZE		(64 * 1024)
+
+// message type (the 3 low bits of the state string); same order as msg_data_type_t
+typedef enum {
+	TELEM_IDLE_DATA,
+	TELEM_ATTITUDE_DATA,
+	TELEM_FLASH_DATA,
+	TELEM_FLASH_CMP_DATA,
+	TELEM_LOW_POWER_DATA,
+	TELEM_RUNTIME_STATS_DATA,
+	TELEM_MUTEX_STATS_DATA,
+	TELEM_NUM_MSG_TYPES
+} telem_msg_type_t;
+
+typedef struct telem_msg {
+	uint64_t stream_offset;			// of the callsign, in bytes fed
+	int corrected;					// bytes the RS decoder fixed
+	uint32_t timestamp;
+	uint8_t states;
+	uint8_t msg_type;				// telem_msg_type_t (or garbage, if >= TELEM_NUM_MSG_TYPES)
+	uint8_t sat_state;
+	bool flash_killed;
+	bool prog_mem_rewritten;
+	uint8_t data_len;
+	uint8_t num_errors;
+	uint8_t bytes[MSG_SIZE];		// corrected
+} telem_msg_t;
+
+typedef void (*telem_msg_cb)(const telem_msg_t* msg, void* ctx);
+
+typedef struct telem_decoder_stats {
+	uint64_t bytes_in;
+	uint64_t bytes_skipped;			// not part of any good message
+	uint32_t messages;
+	uint32_t corrected_messages;	// messages that needed correcting
+	uint32_t corrected_bytes;
+	uint32_t uncorrectable;			// callsigns followed by something we couldn't correct
+	uint32_t bad_type;				// corrected, but the type isn't one we know
+} telem_decoder_stats_t;
+
+typedef struct telem_decoder {
+	telem_msg_cb cb;
+	void* ctx;
+	uint8_t buf[TELEM_DECODER_BUF_SIZE];
+	size_t len;
+	uint64_t buf_offset;			// stream offset of buf[0]
+	telem_decoder_stats_t stats;
+	telem_msg_t msg;
+} telem_decoder_t;
+
+void telem_decoder_init(telem_decoder_t* d, telem_msg_cb cb, void* ctx);
+void telem_decoder_feed(telem_decoder_t* d, const uint8_t* data, size_t len);
+void telem_decoder_finish(telem_decoder_t* d);
+bool telem_decode_frame(const uint8_t* frame, telem_msg_t* msg);
+
+/************************************************************************/
+/* TABLES                                                               */
+/************************************************************************/
+typedef enum {
+	TELEM_TABLE_MESSAGES,
+	TELEM_TABLE_ERRORS,
+	TELEM_TABLE_IDLE,
+	TELEM_TABLE_ATTITUDE,
+	TELEM_TABLE_FLASH,
+	TELEM_TABLE_FLASH_CMP,
+	TELEM_TABLE_LOW_POWER,
+	TELEM_TABLE_RUNTIME_STATS,
+	TELEM_TABLE_MUTEX_STATS,
+	TELEM_NUM_TABLES
+} telem_table_id_t;
+
+// most columns any table has
+#define TELEM_MAX_COLUMNS			64
+
+typedef enum {
+	TELEM_RAW,		// little-endian unsigned, width bytes
+	TELEM_TRUNC,	// 8-bit reading truncated along the line (m, b); untruncated
+	TELEM_BIT		// bit m of a byte
+} telem_conv_t;
+
+typedef struct telem_field {
+	const char* name;
+	uint8_t offset;			// in the packet (of sample 0)
+	uint8_t width;			// bytes per value
+	uint8_t count;			// values (columns name_0, name_1, ...; just name if 1)
+	telem_conv_t conv;
+	uint16_t m;				// (the bit, for TELEM_BIT)
+	int16_t b;
+	uint32_t m_recip_q24;	// FP_RECIP_Q24(m)
+	uint8_t stride;			// bytes between samples (0: the same bytes every sample)
+} telem_field_t;
+
+typedef struct telem_packet_def {
+	telem_table_id_t table;
+	uint8_t size;
+	uint8_t num_packets;
+	uint8_t num_errors;
+	uint8_t samples;		// per packet (see telem_field_t.stride)
+	const telem_field_t* fields;
+	uint8_t num_fields;
+} telem_packet_def_t;
+
+typedef struct telem_table {
+	const char* name;
+	uint8_t num_columns;
+	const char* columns[TELEM_MAX_COLUMNS];
+} telem_table_t;
+
+// called with each row; values are in the table's column order
+typedef void (*telem_row_cb)(telem_table_id_t table, const int64_t* values, void* ctx);
+
+const telem_table_t* telem_get_table(telem_table_id_t table);
+const telem_packet_def_t* telem_get_packet_def(uint8_t msg_type);
+int telem_emit_rows(const telem_msg_t* msg, telem_row_cb cb, void* ctx);
+
+#endif /* TELEM_DECODER_H_ */
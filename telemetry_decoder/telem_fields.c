@@ -0,0 +1,336 @@
+/*
+ * telem_fields.c
+ *
+ * Where everything is in a message (see write_packet, read_current_data and
+ * the write_*_packet functions in package_transmission.c, and the batch types
+ * in Sensor_Structs.h), and which sensor_def.h line each truncated reading was
+ * truncated along (see the truncate_16t calls in sensor_read_commands.c).
+ *
+ * Created: 10/19/2026 5:51:02 AM
+ *  Author: BSE
+ */
+
+#include "telem_decoder.h"
+#include <stdio.h>
+#include <string.h>
+#include "../EQUiSatOS/EQUiSatOS/src/sensor_drivers/sensor_def.h"
+
+// (b is cast like get_line_b_from_signal does, so e.g. A_ACCEL_B wraps the same way)
+#define TRUNC_S(name, off, n, sig, stride) \
+	{name, off, 1, n, TELEM_TRUNC, A_##sig##_M, (int16_t) A_##sig##_B, FP_RECIP_Q24(A_##sig##_M), stride}
+#define TRUNC(name, off, n, sig)			TRUNC_S(name, off, n, sig, 0)
+#define RAW_S(name, off, width, n, stride)	{name, off, width, n, TELEM_RAW, 0, 0, 0, stride}
+#define RAW(name, off, width, n)			RAW_S(name, off, width, n, 0)
+#define BIT(name, off, bit)					{name, off, 1, 1, TELEM_BIT, bit, 0, 0, 0}
+
+// satellite_history_batch (bitfield, first member in the LSB)
+#define SAT_HISTORY_FIELDS(off) \
+	BIT("antenna_deployed", off, 0), \
+	BIT("lion_1_charged", off, 1), \
+	BIT("lion_2_charged", off, 2), \
+	BIT("lifepo_b1_charged", off, 3), \
+	BIT("lifepo_b2_charged", off, 4), \
+	BIT("first_flash", off, 5), \
+	BIT("prog_mem_rewritten", off, 6)
+
+// lifepo_current_batch alternates sense / output sense per bank
+#define LIFEPO_CURRENT_FIELDS(off, stride) \
+	TRUNC_S("lifepo_b1_sns", off, 1, LF_SNS, stride), \
+	TRUNC_S("lifepo_b1_osns", off + 1, 1, LF_OSNS, stride), \
+	TRUNC_S("lifepo_b2_sns", off + 2, 1, LF_SNS, stride), \
+	TRUNC_S("lifepo_b2_osns", off + 3, 1, LF_OSNS, stride)
+
+#define NUM_FIELDS(fields)		(sizeof(fields) / sizeof(fields[0]))
+
+/************************************************************************/
+/* FIELDS                                                               */
+/************************************************************************/
+// current data section (offsets from START_CUR_DATA)
+static const telem_field_t current_fields[] = {
+	RAW("secs_to_next_flash", 0, 1, 1),
+	RAW("reboot_count", 1, 1, 1),
+	TRUNC("lion_volts", 2, 2, L_VOLT),
+	TRUNC("lion_current", 4, 2, L_SNS),
+	TRUNC("lion_temps", 6, 2, TEMP),
+	TRUNC("panelref", 8, 1, PANELREF),
+	TRUNC("lref", 9, 1, LREF),
+	RAW("bat_charge_dig_sigs", 10, 2, 1),
+	TRUNC("lifepo_volts", 12, 4, LF_VOLT),
+};
+
+static const telem_field_t idle_fields[] = {
+	SAT_HISTORY_FIELDS(0),
+	TRUNC("lion_volts", 1, 2, L_VOLT),
+	TRUNC("lion_current", 3, 2, L_SNS),
+	TRUNC("lion_temps", 5, 2, TEMP),
+	TRUNC("panelref", 7, 1, PANELREF),
+	TRUNC("lref", 8, 1, LREF),
+	RAW("bat_charge_dig_sigs", 9, 2, 1),
+	TRUNC("radio_temp", 11, 1, RAD_TEMP),
+	TRUNC("imu_temp", 12, 1, IMU_TEMP),
+	TRUNC("ir_amb_temps", 13, 6, IR_AMB),
+	RAW("timestamp", 19, 4, 1),
+};
+
+static const telem_field_t attitude_fields[] = {
+	RAW("ir_obj_temps", 0, 2, 6),
+	RAW("pdiode", 12, 2, 1),
+	TRUNC("accelerometer", 14, 6, ACCEL),	// two readings of x, y, z
+	TRUNC("gyro", 20, 3, GYRO),
+	TRUNC("magnetometer", 23, 6, MAG),		// two readings of x, y, z
+	RAW("timestamp", 29, 4, 1),
+};
+
+static const telem_field_t flash_fields[] = {
+	TRUNC_S("led_temps", 0, 4, TEMP, 4),
+	TRUNC_S("lifepo_bank_temps", 28, 2, TEMP, 2),
+	LIFEPO_CURRENT_FIELDS(42, 4),
+	TRUNC_S("lifepo_volts", 70, 4, LF_VOLT, 4),
+	TRUNC_S("led_current", 98, 4, LED_SNS, 4),
+	TRUNC_S("gyro", 126, 3, GYRO, 3),
+	RAW("timestamp", 147, 4, 1),
+};
+
+static const telem_field_t flash_cmp_fields[] = {
+	// (averages over the flash)
+	TRUNC("led_temps", 0, 4, TEMP),
+	TRUNC("lifepo_bank_temps", 4, 2, TEMP),
+	LIFEPO_CURRENT_FIELDS(6, 0),
+	TRUNC("lifepo_volts", 10, 4, LF_VOLT),
+	TRUNC("led_current", 14, 4, LED_SNS),
+	TRUNC("mag_before", 18, 3, MAG),
+	RAW("timestamp", 21, 4, 1),
+};
+
+static const telem_field_t low_power_fields[] = {
+	SAT_HISTORY_FIELDS(0),
+	TRUNC("lion_volts", 1, 2, L_VOLT),
+	TRUNC("lion_current", 3, 2, L_SNS),
+	TRUNC("lion_temps", 5, 2, TEMP),
+	TRUNC("panelref", 7, 1, PANELREF),
+	TRUNC("lref", 8, 1, LREF),
+	RAW("bat_charge_dig_sigs", 9, 2, 1),
+	RAW("ir_obj_temps", 11, 2, 6),
+	TRUNC("gyro", 23, 3, GYRO),
+	RAW("timestamp", 27, 4, 1),
+};
+
+// one sample per slot (see msg_format.h; max_slice is in RUNTIME_STATS_SLICE_US,
+// stack_min_free in bytes)
+static const telem_field_t runtime_stats_fields[] = {
+	RAW("period_ms", 0, 4, 1),
+	RAW_S("total_ms", 4, 4, 1, RUNTIME_STATS_SLOT_SIZE),
+	RAW_S("period_permille", 8, 2, 1, RUNTIME_STATS_SLOT_SIZE),
+	RAW_S("max_slice", 10, 2, 1, RUNTIME_STATS_SLOT_SIZE),
+	RAW("idle_permille", 4 + RUNTIME_STATS_SLOTS * RUNTIME_STATS_SLOT_SIZE, 2, 1),
+	RAW_S("stack_min_free", 6 + RUNTIME_STATS_SLOTS * RUNTIME_STATS_SLOT_SIZE, STACK_MIN_FREE_SIZE, 1, STACK_MIN_FREE_SIZE),
+	RAW("timestamp", 6 + RUNTIME_STATS_SLOTS * (RUNTIME_STATS_SLOT_SIZE + STACK_MIN_FREE_SIZE), 4, 1),
+};
+
+// one sample per mutex, in mutex_stats_id_t order (see msg_format.h; waits are the
+// wait histogram buckets, and timeout_owner a run time stats slot)
+static const telem_field_t mutex_stats_fields[] = {
+	RAW_S("takes", 0, 2, 1, MUTEX_STATS_ENTRY_SIZE),
+	RAW_S("timeouts", 2, 1, 1, MUTEX_STATS_ENTRY_SIZE),
+	RAW_S("waits", 3, 1, MUTEX_STATS_WAIT_BUCKETS, MUTEX_STATS_ENTRY_SIZE),
+	RAW_S("max_wait_ms", 7, 2, 1, MUTEX_STATS_ENTRY_SIZE),
+	RAW_S("max_hold_ms", 9, 2, 1, MUTEX_STATS_ENTRY_SIZE),
+	RAW_S("timeout_owner", 11, 1, 1, MUTEX_STATS_ENTRY_SIZE),
+	RAW("timestamp", MUTEX_STATS_NUM * MUTEX_STATS_ENTRY_SIZE, 4, 1),
+};
+
+// indexed by message type
+static const telem_packet_def_t packet_defs[TELEM_NUM_MSG_TYPES] = {
+	{TELEM_TABLE_IDLE, IDLE_DATA_PACKET_SIZE, IDLE_DATA_PACKETS, IDLE_DATA_NUM_ERRORS, 1,
+		idle_fields, NUM_FIELDS(idle_fields)},
+	{TELEM_TABLE_ATTITUDE, ATTITUDE_DATA_PACKET_SIZE, ATTITUDE_DATA_PACKETS, ATTITUDE_DATA_NUM_ERRORS, 1,
+		attitude_fields, NUM_FIELDS(attitude_fields)},
+	{TELEM_TABLE_FLASH, FLASH_DATA_PACKET_SIZE, FLASH_DATA_PACKETS, FLASH_DATA_NUM_ERRORS, 7 /* FLASH_DATA_ARR_LEN */,
+		flash_fields, NUM_FIELDS(flash_fields)},
+	{TELEM_TABLE_FLASH_CMP, FLASH_CMP_DATA_PACKET_SIZE, FLASH_CMP_DATA_PACKETS, FLASH_CMP_DATA_NUM_ERRORS, 1,
+		flash_cmp_fields, NUM_FIELDS(flash_cmp_fields)},
+	{TELEM_TABLE_LOW_POWER, LOW_POWER_DATA_PACKET_SIZE, LOW_POWER_DATA_PACKETS, LOW_POWER_DATA_NUM_ERRORS, 1,
+		low_power_fields, NUM_FIELDS(low_power_fields)},
+	{TELEM_TABLE_RUNTIME_STATS, RUNTIME_STATS_DATA_PACKET_SIZE, RUNTIME_STATS_DATA_PACKETS, RUNTIME_STATS_DATA_NUM_ERRORS, RUNTIME_STATS_SLOTS,
+		runtime_stats_fields, NUM_FIELDS(runtime_stats_fields)},
+	{TELEM_TABLE_MUTEX_STATS, MUTEX_STATS_DATA_PACKET_SIZE, MUTEX_STATS_DATA_PACKETS, MUTEX_STATS_DATA_NUM_ERRORS, MUTEX_STATS_NUM,
+		mutex_stats_fields, NUM_FIELDS(mutex_stats_fields)},
+};
+
+const telem_packet_def_t* telem_get_packet_def(uint8_t msg_type) {
+	if (msg_type >= TELEM_NUM_MSG_TYPES) {
+		return NULL;
+	}
+	return &packet_defs[msg_type];
+}
+
+/************************************************************************/
+/* TABLES                                                               */
+/************************************************************************/
+static const char* message_columns[] = {
+	"stream_offset", "timestamp", "msg_type", "sat_state", "flash_killed",
+	"prog_mem_rewritten", "data_len", "num_errors", "rs_corrected"
+};
+#define NUM_MESSAGE_COLUMNS		(sizeof(message_columns) / sizeof(message_columns[0]))
+
+static const char* error_columns[] = {
+	"msg_timestamp", "slot", "ecode", "priority", "eloc", "age_buckets", "approx_timestamp"
+};
+#define NUM_ERROR_COLUMNS		(sizeof(error_columns) / sizeof(error_columns[0]))
+
+// leading columns of the data tables
+static const char* data_columns[] = {"msg_timestamp", "packet", "sample"};
+#define NUM_DATA_COLUMNS		(sizeof(data_columns) / sizeof(data_columns[0]))
+
+static const char* table_names[TELEM_NUM_TABLES] = {
+	"messages", "errors", "idle", "attitude", "flash", "flash_cmp", "low_power", "runtime_stats",
+	"mutex_stats"
+};
+
+static telem_table_t tables[TELEM_NUM_TABLES];
+static bool tables_built = false;
+// (backing for the column names with indices)
+static char column_name_pool[4096];
+static size_t column_name_pool_used = 0;
+
+static void add_column(telem_table_t* t, const char* name) {
+	if (t->num_columns < TELEM_MAX_COLUMNS) {
+		t->columns[t->num_columns++] = name;
+	}
+}
+
+static void add_field_columns(telem_table_t* t, const telem_field_t* fields, int num_fields) {
+	for (int f = 0; f < num_fields; f++) {
+		if (fields[f].count == 1) {
+			add_column(t, fields[f].name);
+			continue;
+		}
+		for (int i = 0; i < fields[f].count; i++) {
+			char* name = column_name_pool + column_name_pool_used;
+			int len = snprintf(name, sizeof(column_name_pool) - column_name_pool_used, "%s_%d", fields[f].name, i);
+			column_name_pool_used += len + 1;
+			add_column(t, name);
+		}
+	}
+}
+
+static void build_tables(void) {
+	for (int i = 0; i < TELEM_NUM_TABLES; i++) {
+		tables[i].name = table_names[i];
+		tables[i].num_columns = 0;
+	}
+	for (size_t i = 0; i < NUM_MESSAGE_COLUMNS; i++) {
+		add_column(&tables[TELEM_TABLE_MESSAGES], message_columns[i]);
+	}
+	add_field_columns(&tables[TELEM_TABLE_MESSAGES], current_fields, NUM_FIELDS(current_fields));
+	for (size_t i = 0; i < NUM_ERROR_COLUMNS; i++) {
+		add_column(&tables[TELEM_TABLE_ERRORS], error_columns[i]);
+	}
+	for (int type = 0; type < TELEM_NUM_MSG_TYPES; type++) {
+		telem_table_t* t = &tables[packet_defs[type].table];
+		for (size_t i = 0; i < NUM_DATA_COLUMNS; i++) {
+			add_column(t, data_columns[i]);
+		}
+		add_field_columns(t, packet_defs[type].fields, packet_defs[type].num_fields);
+	}
+	tables_built = true;
+}
+
+const telem_table_t* telem_get_table(telem_table_id_t table) {
+	if (table >= TELEM_NUM_TABLES) {
+		return NULL;
+	}
+	if (!tables_built) {
+		build_tables();
+	}
+	return &tables[table];
+}
+
+/************************************************************************/
+/* ROWS                                                                 */
+/************************************************************************/
+static int64_t read_value(const uint8_t* p, const telem_field_t* field) {
+	switch (field->conv) {
+		case TELEM_TRUNC:
+			return fp_untruncate_q8(*p, field->m, field->m_recip_q24, field->b);
+		case TELEM_BIT:
+			return (*p >> field->m) & 1;
+		default: ;
+			uint32_t v = 0;
+			for (int i = field->width - 1; i >= 0; i--) {
+				v = (v << 8) | p[i];
+			}
+			return v;
+	}
+}
+
+/* appends the field values for a sample of the packet at p to values; returns the new count */
+static int read_fields(const uint8_t* p, const telem_field_t* fields, int num_fields, int sample,
+		int64_t* values, int n) {
+	for (int f = 0; f < num_fields; f++) {
+		const telem_field_t* field = &fields[f];
+		const uint8_t* v = p + field->offset + sample * field->stride;
+		for (int i = 0; i < field->count; i++) {
+			values[n++] = read_value(v + i * field->width, field);
+		}
+	}
+	return n;
+}
+
+/* calls cb with every row in msg; returns how many */
+int telem_emit_rows(const telem_msg_t* msg, telem_row_cb cb, void* ctx) {
+	int64_t values[TELEM_MAX_COLUMNS];
+	int rows = 0;
+	if (!tables_built) {
+		build_tables();
+	}
+
+	int n = 0;
+	values[n++] = msg->stream_offset;
+	values[n++] = msg->timestamp;
+	values[n++] = msg->msg_type;
+	values[n++] = msg->sat_state;
+	values[n++] = msg->flash_killed;
+	values[n++] = msg->prog_mem_rewritten;
+	values[n++] = msg->data_len;
+	values[n++] = msg->num_errors;
+	values[n++] = msg->corrected;
+	read_fields(msg->bytes + START_CUR_DATA, current_fields, NUM_FIELDS(current_fields), 0, values, n);
+	cb(TELEM_TABLE_MESSAGES, values, ctx);
+	rows++;
+
+	const telem_packet_def_t* def = telem_get_packet_def(msg->msg_type);
+	if (def == NULL) {
+		return rows;
+	}
+	for (int p = 0; p < def->num_packets; p++) {
+		const uint8_t* packet = msg->bytes + START_DATA + p * def->size;
+		for (int s = 0; s < def->samples; s++) {
+			n = 0;
+			values[n++] = msg->timestamp;
+			values[n++] = p;
+			values[n++] = s;
+			read_fields(packet, def->fields, def->num_fields, s, values, n);
+			cb(def->table, values, ctx);
+			rows++;
+		}
+	}
+
+	const uint8_t* errors = msg->bytes + START_DATA + def->num_packets * def->size;
+	for (int e = 0; e < def->num_errors; e++) {
+		const uint8_t* err = errors + e * ERROR_PACKET_SIZE;
+		if (err[0] == 0 && err[1] == 0 && err[2] == 0) {
+			continue; // (unused slot)
+		}
+		values[0] = msg->timestamp;
+		values[1] = e;
+		values[2] = err[0] & 0x7F;
+		values[3] = err[0] >> 7;
+		values[4] = err[1];
+		values[5] = err[2];	// 0xff means at least that long ago
+		values[6] = (int64_t) msg->timestamp - (int64_t) err[2] * ERROR_TIME_BUCKET_SIZE;
+		cb(TELEM_TABLE_ERRORS, values, ctx);
+		rows++;
+	}
+	return rows;
+}
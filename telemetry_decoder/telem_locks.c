@@ -0,0 +1,298 @@
+/*
+ * telem_locks.c
+ *
+ * Mutex contention report from downlinked mutex stats (see mutex_stats.h):
+ *	telem_locks [capture ...]
+ * decodes the captures (or stdin, for "-") as one stream and adds up the
+ * mutex stats messages in them per mutex: takes, timeouts, the wait
+ * histogram, the worst wait and hold seen, and which task held the mutex the
+ * last time a take timed out. Mutexes are listed worst wait first. The same
+ * report is downlinked many times, so reports are counted once (by timestamp).
+ * Without captures, it checks itself: synthetic periods go through the flight
+ * accounting (data_handling/mutex_stats.c), out as messages (like write_packet
+ * does, one of them twice) and back through the decoder, and the totals must
+ * match.
+ *
+ * Created: 10/19/2026 1:05:44 PM
+ *  Author: BSE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "telem_decoder.h"
+#include "../EQUiSatOS/EQUiSatOS/src/data_handling/mutex_stats.h"
+#include "../EQUiSatOS/EQUiSatOS/src/telemetry/rscode-1.3/ecc.h"
+
+#define READ_CHUNK_SIZE		(256 * 1024)
+// reports told apart by timestamp (more are counted, but not checked for repeats)
+#define MAX_REPORTS			4096
+
+// in mutex_stats_id_t order
+static const char* mutex_names[MUTEX_STATS_NUM] = {
+	"critical_action", "i2c_irpow", "processor_adc", "hardware_state", "watchdog",
+	"mram_spi_cache", "idle_equistack", "attitude_equistack", "flash_equistack",
+	"flash_cmp_equistack", "low_power_equistack", "runtime_stats_equistack",
+	"mutex_stats_equistack", "error_equistack"
+};
+
+// run time stats slots: task_type_t order, then (idle), (other)
+static const char* owner_names[] = {
+	"watchdog", "state_handling", "antenna_deploy", "battery_charging", "transmit",
+	"flash_activate", "idle_data", "low_power_data", "attitude_data", "persistent_data_backup",
+	"(idle)", "(other)"
+};
+#define NUM_OWNER_NAMES		(sizeof(owner_names) / sizeof(owner_names[0]))
+
+typedef struct {
+	uint64_t takes;
+	uint64_t timeouts;
+	uint64_t waits[MUTEX_STATS_WAIT_BUCKETS];
+	uint32_t max_wait_ms;
+	uint32_t max_hold_ms;
+	uint8_t timeout_owner;
+	uint32_t timeout_timestamp;		// of the report timeout_owner is from
+} lock_totals_t;
+
+typedef struct {
+	lock_totals_t locks[MUTEX_STATS_NUM];
+	uint32_t reports;
+	uint32_t repeats;
+	uint32_t seen[MAX_REPORTS];
+	// the message being added up (rows come one mutex at a time)
+	mutex_stats_report_t current;
+} totals_t;
+
+static telem_decoder_t decoder;
+static uint8_t chunk[READ_CHUNK_SIZE];
+
+/************************************************************************/
+/* ADDING UP                                                            */
+/************************************************************************/
+static void clear_totals(totals_t* t) {
+	memset(t, 0, sizeof(totals_t));
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		t->locks[i].timeout_owner = MUTEX_STATS_NO_OWNER;
+	}
+}
+
+static void add_report(totals_t* t, const mutex_stats_report_t* r, uint32_t timestamp) {
+	for (uint32_t i = 0; i < t->reports && i < MAX_REPORTS; i++) {
+		if (t->seen[i] == timestamp) {
+			t->repeats++;
+			return;
+		}
+	}
+	if (t->reports < MAX_REPORTS) {
+		t->seen[t->reports] = timestamp;
+	}
+	t->reports++;
+
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		const mutex_stats_entry_t* e = &r->mutexes[i];
+		lock_totals_t* l = &t->locks[i];
+		l->takes += e->takes;
+		l->timeouts += e->timeouts;
+		for (int b = 0; b < MUTEX_STATS_WAIT_BUCKETS; b++) {
+			l->waits[b] += e->waits[b];
+		}
+		if (e->max_wait_ms > l->max_wait_ms) {
+			l->max_wait_ms = e->max_wait_ms;
+		}
+		if (e->max_hold_ms > l->max_hold_ms) {
+			l->max_hold_ms = e->max_hold_ms;
+		}
+		// (captures aren't necessarily in order)
+		if (e->timeouts > 0 && timestamp >= l->timeout_timestamp) {
+			l->timeout_owner = e->timeout_owner;
+			l->timeout_timestamp = timestamp;
+		}
+	}
+}
+
+// mutex_stats rows: msg_timestamp, packet, mutex, then the fields (see telem_fields.c)
+static void on_row(telem_table_id_t table, const int64_t* values, void* ctx) {
+	totals_t* t = (totals_t*) ctx;
+	if (table != TELEM_TABLE_MUTEX_STATS) {
+		return;
+	}
+	int m = values[2];
+	mutex_stats_entry_t* e = &t->current.mutexes[m];
+	e->takes = values[3];
+	e->timeouts = values[4];
+	for (int b = 0; b < MUTEX_STATS_WAIT_BUCKETS; b++) {
+		e->waits[b] = values[5 + b];
+	}
+	e->max_wait_ms = values[5 + MUTEX_STATS_WAIT_BUCKETS];
+	e->max_hold_ms = values[6 + MUTEX_STATS_WAIT_BUCKETS];
+	e->timeout_owner = values[7 + MUTEX_STATS_WAIT_BUCKETS];
+	if (m == MUTEX_STATS_NUM - 1) {
+		add_report(t, &t->current, values[8 + MUTEX_STATS_WAIT_BUCKETS]);
+	}
+}
+
+static void on_message(const telem_msg_t* msg, void* ctx) {
+	if (msg->msg_type == TELEM_MUTEX_STATS_DATA) {
+		telem_emit_rows(msg, on_row, ctx);
+	}
+}
+
+/************************************************************************/
+/* REPORT                                                               */
+/************************************************************************/
+static const char* owner_name(uint8_t owner) {
+	if (owner == MUTEX_STATS_NO_OWNER) {
+		return "-";
+	}
+	return owner < NUM_OWNER_NAMES ? owner_names[owner] : "?";
+}
+
+// (for qsort)
+static const lock_totals_t* sorting_locks;
+
+static int worst_wait_first(const void* a, const void* b) {
+	const lock_totals_t* locks = sorting_locks;
+	const lock_totals_t* la = &locks[*(const int*) a];
+	const lock_totals_t* lb = &locks[*(const int*) b];
+	if (la->max_wait_ms != lb->max_wait_ms) {
+		return la->max_wait_ms < lb->max_wait_ms ? 1 : -1;
+	}
+	return la->timeouts < lb->timeouts ? 1 : la->timeouts > lb->timeouts ? -1 : 0;
+}
+
+static void print_totals(const totals_t* t) {
+	int order[MUTEX_STATS_NUM];
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		order[i] = i;
+	}
+	sorting_locks = t->locks;
+	qsort(order, MUTEX_STATS_NUM, sizeof(int), worst_wait_first);
+
+	printf("%u reports (%u repeats ignored)\n", t->reports, t->repeats);
+	printf("%-24s %10s %8s %8s %8s %8s %8s %10s %10s  %s\n", "mutex", "takes", "timeouts",
+		"<1ms", "<10ms", "<100ms", ">=100ms", "max wait", "max hold", "last timeout holder");
+	for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+		const lock_totals_t* l = &t->locks[order[i]];
+		printf("%-24s %10llu %8llu", mutex_names[order[i]],
+			(unsigned long long) l->takes, (unsigned long long) l->timeouts);
+		for (int b = 0; b < MUTEX_STATS_WAIT_BUCKETS; b++) {
+			printf(" %8llu", (unsigned long long) l->waits[b]);
+		}
+		printf(" %7u ms %7u ms  %s\n", l->max_wait_ms, l->max_hold_ms, owner_name(l->timeout_owner));
+	}
+}
+
+/************************************************************************/
+/* SELF CHECK                                                           */
+/************************************************************************/
+static uint32_t rand_state = 0x5eed1234;
+
+static uint32_t rand32(void) {
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static void build_frame(uint8_t* frame, const mutex_stats_report_t* r, uint32_t timestamp) {
+	memset(frame, 0, MSG_SIZE);
+	memcpy(frame, MSG_CALLSIGN, CALLSIGN_SIZE);
+	for (int i = 0; i < 4; i++) {
+		frame[PREAMBLE_TIMESTAMP_OFFSET + i] = timestamp >> (8 * i);
+	}
+	frame[PREAMBLE_STATES_OFFSET] = TELEM_MUTEX_STATS_DATA << MSG_STATE_TYPE_SHIFT;
+	frame[PREAMBLE_DATA_LEN_OFFSET] = MUTEX_STATS_DATA_PACKETS * MUTEX_STATS_DATA_PACKET_SIZE;
+	mutex_stats_pack(r, frame + START_DATA);
+	uint8_t* p = frame + START_DATA + MUTEX_STATS_REPORT_SIZE;
+	for (int i = 0; i < 4; i++) {
+		*p++ = timestamp >> (8 * i);
+	}
+	encode_data(frame + CALLSIGN_SIZE, START_PARITY - CALLSIGN_SIZE, frame + CALLSIGN_SIZE);
+}
+
+#define SELF_CHECK_PERIODS		5
+
+static bool self_check(void) {
+	static mutex_stats_t stats[MUTEX_STATS_NUM];
+	static totals_t expected, decoded;
+	clear_totals(&expected);
+	clear_totals(&decoded);
+	telem_decoder_init(&decoder, on_message, &decoded);
+
+	uint8_t frame[MSG_SIZE];
+	for (int period = 0; period < SELF_CHECK_PERIODS; period++) {
+		for (int i = 0; i < MUTEX_STATS_NUM; i++) {
+			mutex_stats_clear(&stats[i]);
+			// (some mutexes are taken enough to saturate the counts)
+			int takes = rand32() % (i == MUTEX_STATS_I2C_IRPOW ? 80000 : 400);
+			for (int n = 0; n < takes; n++) {
+				// mostly uncontended, with a long tail
+				uint32_t wait_us = rand32() % 8 == 0 ? rand32() % (1 << (rand32() % 22)) : rand32() % 50;
+				bool got = rand32() % 200 != 0;
+				mutex_stats_note_take(&stats[i], wait_us, got, got ? MUTEX_STATS_NO_OWNER : rand32() % NUM_OWNER_NAMES);
+				if (got) {
+					mutex_stats_note_hold(&stats[i], rand32() % (1 << (rand32() % 20)));
+				}
+			}
+		}
+		mutex_stats_report_t r;
+		mutex_stats_summarize(stats, &r);
+		uint32_t timestamp = 50000 + 1800 * period;
+		add_report(&expected, &r, timestamp);
+		build_frame(frame, &r, timestamp);
+		telem_decoder_feed(&decoder, frame, MSG_SIZE);
+		if (period == 1) {
+			// (heard again)
+			telem_decoder_feed(&decoder, frame, MSG_SIZE);
+			expected.repeats++;
+		}
+	}
+	telem_decoder_finish(&decoder);
+	print_totals(&decoded);
+
+	bool ok = decoded.reports == expected.reports && decoded.repeats == expected.repeats
+		&& memcmp(decoded.locks, expected.locks, sizeof(expected.locks)) == 0;
+	printf(ok ? "self check: decoded totals as expected\n" : "self check: FAILED\n");
+	return ok;
+}
+
+/************************************************************************/
+/* CAPTURES                                                             */
+/************************************************************************/
+static bool decode_file(FILE* f) {
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+		telem_decoder_feed(&decoder, chunk, n);
+	}
+	return !ferror(f);
+}
+
+int main(int argc, char** argv) {
+	initialize_ecc();
+	if (argc == 1) {
+		return self_check() ? 0 : 1;
+	}
+
+	static totals_t totals;
+	clear_totals(&totals);
+	telem_decoder_init(&decoder, on_message, &totals);
+	bool ok = true;
+	for (int i = 1; i < argc; i++) {
+		FILE* f = strcmp(argv[i], "-") == 0 ? stdin : fopen(argv[i], "rb");
+		if (f == NULL) {
+			perror(argv[i]);
+			ok = false;
+			continue;
+		}
+		if (!decode_file(f)) {
+			perror(argv[i]);
+			ok = false;
+		}
+		if (f != stdin) {
+			fclose(f);
+		}
+	}
+	telem_decoder_finish(&decoder);
+	print_totals(&totals);
+	return ok ? 0 : 1;
+}
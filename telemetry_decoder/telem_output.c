@@ -0,0 +1,130 @@
+/*
+ * telem_output.c
+ *
+ * Created: 10/19/2026 6:13:02 AM
+ *  Author: BSE
+ */
+
+#include "telem_output.h"
+#include <stdlib.h>
+#include <string.h>
+
+void telem_output_init(telem_output_t* out, telem_out_format_t format, const char* prefix) {
+	memset(out, 0, sizeof(telem_output_t));
+	out->format = format;
+	out->prefix = prefix;
+}
+
+static void flush_table(telem_output_t* out, telem_table_id_t table) {
+	if (out->files[table] != NULL && out->buf_lens[table] > 0
+			&& fwrite(out->bufs[table], 1, out->buf_lens[table], out->files[table]) != out->buf_lens[table]) {
+		out->failed = true;
+	}
+	out->bytes_out += out->buf_lens[table];
+	out->buf_lens[table] = 0;
+}
+
+static void put_bytes(telem_output_t* out, telem_table_id_t table, const void* data, size_t len) {
+	if (out->buf_lens[table] + len > TELEM_OUTPUT_BUF_SIZE) {
+		flush_table(out, table);
+	}
+	memcpy(out->bufs[table] + out->buf_lens[table], data, len);
+	out->buf_lens[table] += len;
+}
+
+/* opens the table's file and writes its header, the first time it gets a row */
+static bool start_table(telem_output_t* out, telem_table_id_t table) {
+	const telem_table_t* t = telem_get_table(table);
+	out->bufs[table] = malloc(TELEM_OUTPUT_BUF_SIZE);
+	if (out->bufs[table] == NULL) {
+		out->failed = true;
+		return false;
+	}
+	if (out->prefix != NULL) {
+		char path[1024];
+		snprintf(path, sizeof(path), "%s_%s.%s", out->prefix, t->name,
+			out->format == TELEM_OUT_CSV ? "csv" : "bin");
+		out->files[table] = fopen(path, "wb");
+		if (out->files[table] == NULL) {
+			out->failed = true;
+		}
+	}
+
+	if (out->format == TELEM_OUT_CSV) {
+		for (int c = 0; c < t->num_columns; c++) {
+			if (c > 0) {
+				put_bytes(out, table, ",", 1);
+			}
+			put_bytes(out, table, t->columns[c], strlen(t->columns[c]));
+		}
+		put_bytes(out, table, "\n", 1);
+	} else {
+		uint8_t header[] = {TELEM_BIN_VERSION, t->num_columns};
+		put_bytes(out, table, TELEM_BIN_MAGIC, 4);
+		put_bytes(out, table, header, sizeof(header));
+		for (int c = 0; c < t->num_columns; c++) {
+			put_bytes(out, table, t->columns[c], strlen(t->columns[c]) + 1);
+		}
+	}
+	return true;
+}
+
+// (formats backwards from the end of buf; returns the start)
+static char* format_int(int64_t v, char* end) {
+	uint64_t u = v < 0 ? -(uint64_t) v : (uint64_t) v;
+	do {
+		*--end = '0' + u % 10;
+		u /= 10;
+	} while (u > 0);
+	if (v < 0) {
+		*--end = '-';
+	}
+	return end;
+}
+
+/* telem_row_cb; ctx is the telem_output_t */
+void telem_output_row(telem_table_id_t table, const int64_t* values, void* ctx) {
+	telem_output_t* out = (telem_output_t*) ctx;
+	if (out->bufs[table] == NULL && !start_table(out, table)) {
+		return;
+	}
+	const telem_table_t* t = telem_get_table(table);
+	if (out->format == TELEM_OUT_CSV) {
+		char line[TELEM_MAX_COLUMNS * 21 + 1];
+		size_t len = 0;
+		for (int c = 0; c < t->num_columns; c++) {
+			char digits[20];
+			char* start = format_int(values[c], digits + sizeof(digits));
+			size_t n = digits + sizeof(digits) - start;
+			memcpy(line + len, start, n);
+			len += n;
+			line[len++] = c + 1 < t->num_columns ? ',' : '\n';
+		}
+		put_bytes(out, table, line, len);
+	} else {
+		uint8_t row[TELEM_MAX_COLUMNS * 8];
+		for (int c = 0; c < t->num_columns; c++) {
+			uint64_t v = values[c];
+			for (int i = 0; i < 8; i++) {
+				row[c * 8 + i] = v >> (8 * i);
+			}
+		}
+		put_bytes(out, table, row, t->num_columns * 8);
+	}
+	out->rows[table]++;
+}
+
+void telem_output_close(telem_output_t* out) {
+	for (int table = 0; table < TELEM_NUM_TABLES; table++) {
+		if (out->bufs[table] == NULL) {
+			continue;
+		}
+		flush_table(out, table);
+		if (out->files[table] != NULL && fclose(out->files[table]) != 0) {
+			out->failed = true;
+		}
+		free(out->bufs[table]);
+		out->files[table] = NULL;
+		out->bufs[table] = NULL;
+	}
+}
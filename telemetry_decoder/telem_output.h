@@ -0,0 +1,47 @@
+/*
+ * telem_output.h
+ *
+ * Writes decoded rows (see telem_emit_rows) out as one file per table:
+ *	- CSV: <prefix>_<table>.csv, a header line then one line per row
+ *	- binary: <prefix>_<table>.bin, "EQTB", a version byte, the number of
+ *	  columns (1 byte), the column names (each NUL-terminated), then every
+ *	  row as that many little-endian int64s
+ * Files are only created for tables that get rows.
+ *
+ * Created: 10/19/2026 6:12:40 AM
+ *  Author: BSE
+ */
+
+
+#ifndef TELEM_OUTPUT_H_
+#define TELEM_OUTPUT_H_
+
+#include <stdio.h>
+#include "telem_decoder.h"
+
+#define TELEM_BIN_MAGIC				"EQTB"
+#define TELEM_BIN_VERSION			1
+// rows are formatted into this before they're written
+#define TELEM_OUTPUT_BUF_SIZE		(64 * 1024)
+
+typedef enum {
+	TELEM_OUT_CSV,
+	TELEM_OUT_BIN
+} telem_out_format_t;
+
+typedef struct telem_output {
+	telem_out_format_t format;
+	const char* prefix;				// NULL to format rows but not write them (benchmarking)
+	FILE* files[TELEM_NUM_TABLES];
+	char* bufs[TELEM_NUM_TABLES];
+	size_t buf_lens[TELEM_NUM_TABLES];
+	uint64_t rows[TELEM_NUM_TABLES];
+	uint64_t bytes_out;
+	bool failed;					// couldn't open or write a file
+} telem_output_t;
+
+void telem_output_init(telem_output_t* out, telem_out_format_t format, const char* prefix);
+void telem_output_row(telem_table_id_t table, const int64_t* values, void* ctx);
+void telem_output_close(telem_output_t* out);
+
+#endif /* TELEM_OUTPUT_H_ */
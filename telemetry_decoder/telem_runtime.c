@@ -0,0 +1,249 @@
+/*
+ * telem_runtime.c
+ *
+ * Host build of the satellite's run time stats (data_handling/runtime_stats.c):
+ *	telem_runtime [trace]
+ * replays a task switch trace through the same accounting the scheduler hook
+ * does, and reports the counters as the satellite would downlink them: each
+ * period is packed into a run time stats message (like write_packet does),
+ * decoded back with the decoder, and printed, checking the decoded counters
+ * match the computed ones and the time each slot was given in the trace
+ * (the stack minimums, which a trace doesn't cover, are made up).
+ * A trace is lines of "<microseconds> <slot>" (slot switched in at that counter
+ * value; the counter is 32 bits and wraps) or "<microseconds> report" (closes
+ * the period). Without one, a synthetic trace of the flight task set is used.
+ *
+ * Created: 10/19/2026 9:48:33 AM
+ *  Author: BSE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "telem_decoder.h"
+#include "../EQUiSatOS/EQUiSatOS/src/data_handling/runtime_stats.h"
+#include "../EQUiSatOS/EQUiSatOS/src/telemetry/rscode-1.3/ecc.h"
+
+#define REPORT			-1
+
+// in task_type_t order, then the runtime_stats.h slots
+static const char* slot_names[RUNTIME_STATS_SLOTS] = {
+	"watchdog", "state_handling", "antenna_deploy", "battery_charging", "transmit",
+	"flash_activate", "idle_data", "low_power_data", "attitude_data", "persistent_data_backup",
+	"(idle)", "(other)"
+};
+
+static runtime_stats_t stats;
+static uint64_t given_us[RUNTIME_STATS_SLOTS];	// per the trace, this period
+static uint64_t given_total_us[RUNTIME_STATS_SLOTS];
+static uint32_t last_now;
+static int last_slot = RUNTIME_STATS_OTHER_SLOT;
+static int reports = 0;
+static int failures = 0;
+
+/************************************************************************/
+/* DOWNLINK                                                             */
+/************************************************************************/
+static void build_frame(uint8_t* frame, const runtime_report_t* r, const uint16_t* stack_min_free, uint32_t timestamp) {
+	memset(frame, 0, MSG_SIZE);
+	memcpy(frame, MSG_CALLSIGN, CALLSIGN_SIZE);
+	for (int i = 0; i < 4; i++) {
+		frame[PREAMBLE_TIMESTAMP_OFFSET + i] = timestamp >> (8 * i);
+	}
+	frame[PREAMBLE_STATES_OFFSET] = TELEM_RUNTIME_STATS_DATA << MSG_STATE_TYPE_SHIFT;
+	frame[PREAMBLE_DATA_LEN_OFFSET] = RUNTIME_STATS_DATA_PACKETS * RUNTIME_STATS_DATA_PACKET_SIZE;
+	runtime_stats_pack(r, frame + START_DATA);
+	uint8_t* p = frame + START_DATA + RUNTIME_STATS_REPORT_SIZE;
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		*p++ = stack_min_free[i];
+		*p++ = stack_min_free[i] >> 8;
+	}
+	for (int i = 0; i < 4; i++) {
+		*p++ = timestamp >> (8 * i);
+	}
+	encode_data(frame + CALLSIGN_SIZE, START_PARITY - CALLSIGN_SIZE, frame + CALLSIGN_SIZE);
+}
+
+typedef struct {
+	runtime_report_t report;
+	uint16_t stack_min_free[RUNTIME_STATS_SLOTS];
+} decoded_t;
+
+// runtime_stats rows: msg_timestamp, packet, slot, then the fields (see telem_fields.c)
+static void on_row(telem_table_id_t table, const int64_t* values, void* ctx) {
+	decoded_t* decoded = (decoded_t*) ctx;
+	if (table != TELEM_TABLE_RUNTIME_STATS) {
+		return;
+	}
+	runtime_slot_report_t* slot = &decoded->report.slots[values[2]];
+	decoded->report.period_ms = values[3];
+	slot->total_ms = values[4];
+	slot->period_permille = values[5];
+	slot->max_slice = values[6];
+	decoded->report.idle_permille = values[7];
+	decoded->stack_min_free[values[2]] = values[8];
+}
+
+static bool same_report(const runtime_report_t* a, const runtime_report_t* b) {
+	if (a->period_ms != b->period_ms || a->idle_permille != b->idle_permille) {
+		return false;
+	}
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		if (a->slots[i].total_ms != b->slots[i].total_ms
+				|| a->slots[i].period_permille != b->slots[i].period_permille
+				|| a->slots[i].max_slice != b->slots[i].max_slice) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/************************************************************************/
+/* REPLAY                                                               */
+/************************************************************************/
+static void check(bool ok, const char* what) {
+	if (!ok) {
+		printf("  MISMATCH: %s\n", what);
+		failures++;
+	}
+}
+
+static void report(uint32_t now) {
+	runtime_period_t period;
+	runtime_report_t r;
+	decoded_t decoded;
+	uint16_t stack_min_free[RUNTIME_STATS_SLOTS];
+	given_us[last_slot] += (uint32_t) (now - last_now);
+	last_now = now;
+	runtime_stats_close_period(&stats, now, &period);
+	runtime_stats_summarize(&period, &r);
+
+	uint8_t frame[MSG_SIZE];
+	telem_msg_t msg;
+	uint32_t timestamp = 1000 + reports;
+	// (the trace doesn't cover stacks; these just check they come through)
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		stack_min_free[i] = i == RUNTIME_STATS_OTHER_SLOT ? STACK_MIN_FREE_NONE : 64 + 16 * i + reports;
+	}
+	build_frame(frame, &r, stack_min_free, timestamp);
+	memset(&decoded, 0, sizeof(decoded));
+	check(telem_decode_frame(frame, &msg), "message didn't decode");
+	telem_emit_rows(&msg, on_row, &decoded);
+
+	printf("report %d: period %u ms, idle %u.%u%%\n", reports, r.period_ms,
+		r.idle_permille / 10, r.idle_permille % 10);
+	printf("  %-24s %12s %8s %12s %10s\n", "slot", "total ms", "period", "max run us", "min free");
+	for (int i = 0; i < RUNTIME_STATS_SLOTS; i++) {
+		given_total_us[i] += given_us[i];
+		const runtime_slot_report_t* s = &decoded.report.slots[i];
+		printf("  %-24s %12u %6u.%u%% %12u %10u\n", slot_names[i], s->total_ms,
+			s->period_permille / 10, s->period_permille % 10, s->max_slice * RUNTIME_STATS_SLICE_US,
+			decoded.stack_min_free[i]);
+		check(decoded.stack_min_free[i] == stack_min_free[i], "stack minimum");
+		check(period.period_us[i] == given_us[i], "period time charged to a slot");
+		check(period.total_us[i] == given_total_us[i], "total time charged to a slot");
+		given_us[i] = 0;
+	}
+	check(same_report(&r, &decoded.report), "decoded report");
+	reports++;
+}
+
+static void event(uint32_t now, int slot) {
+	if (slot == REPORT) {
+		report(now);
+		return;
+	}
+	given_us[last_slot] += (uint32_t) (now - last_now);
+	last_now = now;
+	last_slot = slot;
+	runtime_stats_switch(&stats, slot, now);
+}
+
+typedef struct {
+	int slot;
+	uint32_t every_ms;
+	uint32_t run_us;
+	uint32_t offset_ms;
+} synthetic_task_t;
+
+// roughly the flight task set (see rtos_tasks_config.h); data reads block
+// on I2C, so they run in a few bursts rather than one long one
+static const synthetic_task_t synthetic_tasks[] = {
+	{0 /* watchdog */,				1500,			150,	100},
+	{1 /* state handling */,		2*60*1000,		400,	200},
+	{3 /* battery charging */,		9*60*1000,		3000,	30000},
+	{4 /* transmit */,				20*1000,		12000,	1500},
+	{5 /* flash activate */,		60*1000,		800,	600},
+	{6 /* idle data */,				3*60*1000,		6000,	10000},
+	{8 /* attitude data */,			4*60*1000,		9000,	900},
+	{9 /* persistent data backup */, 60*1000,		2500,	500},
+};
+#define NUM_SYNTHETIC_TASKS		(sizeof(synthetic_tasks) / sizeof(synthetic_tasks[0]))
+#define SYNTHETIC_REPORT_MS		(30*60*1000)
+#define SYNTHETIC_REPORTS		4
+// (so the counter wraps partway through)
+#define SYNTHETIC_START_US		0xFF000000
+
+static void replay_synthetic(void) {
+	uint32_t now = SYNTHETIC_START_US;
+	runtime_stats_init(&stats, RUNTIME_STATS_OTHER_SLOT, now);
+	last_now = now;
+	event(now += 20000, RUNTIME_STATS_IDLE_SLOT); // (boot)
+	for (uint32_t ms = 1; ms <= SYNTHETIC_REPORTS * SYNTHETIC_REPORT_MS; ms++) {
+		for (size_t t = 0; t < NUM_SYNTHETIC_TASKS; t++) {
+			const synthetic_task_t* task = &synthetic_tasks[t];
+			if (ms % task->every_ms == task->offset_ms % task->every_ms) {
+				event(now + ms * 1000, task->slot);
+				event(now + ms * 1000 + task->run_us, RUNTIME_STATS_IDLE_SLOT);
+				now += task->run_us; // (the run pushes later events back)
+			}
+		}
+		if (ms % SYNTHETIC_REPORT_MS == 0) {
+			event(now + ms * 1000, REPORT);
+		}
+	}
+}
+
+static bool replay_file(FILE* f) {
+	char line[128];
+	bool started = false;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		char what[32];
+		unsigned long long now;
+		if (line[0] == '#' || sscanf(line, "%llu %31s", &now, what) != 2) {
+			continue;
+		}
+		if (!started) {
+			runtime_stats_init(&stats, RUNTIME_STATS_OTHER_SLOT, (uint32_t) now);
+			last_now = now;
+			started = true;
+		}
+		int slot = strcmp(what, "report") == 0 ? REPORT : atoi(what);
+		if (slot != REPORT && (slot < 0 || slot >= RUNTIME_STATS_SLOTS)) {
+			fprintf(stderr, "bad slot: %s", line);
+			return false;
+		}
+		event((uint32_t) now, slot);
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+	initialize_ecc();
+	if (argc > 1) {
+		FILE* f = fopen(argv[1], "r");
+		if (f == NULL) {
+			perror(argv[1]);
+			return 1;
+		}
+		bool ok = replay_file(f);
+		fclose(f);
+		if (!ok) {
+			return 1;
+		}
+	} else {
+		replay_synthetic();
+	}
+	printf(failures == 0 ? "%d reports, all counters as expected\n" : "%d reports, FAILED\n", reports);
+	return failures == 0 ? 0 : 1;
+}